@@ -0,0 +1,131 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    bench.c
+ * \brief
+ *    Kernel micro-benchmark harness. Every kernel is run on synthetic
+ *    data until roughly the requested amount of work is done; the
+ *    fastest of several measurements is reported in cycles and
+ *    nanoseconds per unit. Cycles are read from the time stamp counter
+ *    on x86 and equal nanoseconds on other architectures.
+ ***********************************************************************
+ */
+
+#include "bench.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+# define bench_cycles()  ((int64) __rdtsc())
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+# define bench_cycles()  ((int64) __rdtsc())
+#else
+# define bench_cycles()  gettime_ns()
+#endif
+
+volatile int bench_sink = 0;
+
+static unsigned int bench_seed = 12345;
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    deterministic pseudo random numbers for the synthetic data
+ ***********************************************************************
+ */
+unsigned int bench_rand(void)
+{
+  bench_seed = bench_seed * 1103515245 + 12345;
+  return (bench_seed >> 8) & 0xFFFFFF;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    times one kernel and prints a report line
+ ***********************************************************************
+ */
+void bench_run(BenchOptions *opt, const char *name, BenchKernel kernel, void *ctx, int units_per_call, const char *unit)
+{
+  int   calls = imax(1, opt->work / units_per_call);
+  int64 units = (int64) calls * units_per_call;
+  int64 best_cycles = 0, best_ns = 0;
+  int rep;
+
+  if (opt->filter && strstr(name, opt->filter) == NULL)
+    return;
+
+  kernel(ctx, imin(calls, 64));   // warm up caches and branch predictors
+
+  for (rep = 0; rep < opt->repeats; rep++)
+  {
+    int64 ns     = gettime_ns();
+    int64 cycles = bench_cycles();
+
+    kernel(ctx, calls);
+
+    cycles = bench_cycles() - cycles;
+    ns     = gettime_ns() - ns;
+    if (rep == 0 || cycles < best_cycles)
+    {
+      best_cycles = cycles;
+      best_ns     = ns;
+    }
+  }
+
+  printf("%-28s %10.3f cycles/%-6s %10.3f ns/%-6s %12.1f cycles/call\n", name,
+    (double) best_cycles / units, unit, (double) best_ns / units, unit, (double) best_cycles / calls);
+
+  if (opt->csv)
+    fprintf(opt->csv, "%s,%s,%d,%d,%.4f,%.4f,%.2f\n", name, unit, units_per_call, calls,
+      (double) best_cycles / units, (double) best_ns / units, (double) best_cycles / calls);
+}
+
+static void usage(char *prog)
+{
+  printf("Usage: %s [-n units] [-r repeats] [-k name] [-o file.csv]\n"
+         "  -n  units (pixels, bins) processed per measurement (default 16777216)\n"
+         "  -r  measurements per kernel, the fastest is reported (default 5)\n"
+         "  -k  only run kernels whose name contains the given string\n"
+         "  -o  additionally write the results as CSV\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+  BenchOptions opt;
+  int i;
+
+  memset(&opt, 0, sizeof(BenchOptions));
+  opt.work    = 1 << 24;
+  opt.repeats = 5;
+
+  for (i = 1; i < argc; i++)
+  {
+    if (i + 1 < argc && strcmp(argv[i], "-n") == 0)
+      opt.work = imax(1, atoi(argv[++i]));
+    else if (i + 1 < argc && strcmp(argv[i], "-r") == 0)
+      opt.repeats = imax(1, atoi(argv[++i]));
+    else if (i + 1 < argc && strcmp(argv[i], "-k") == 0)
+      opt.filter = argv[++i];
+    else if (i + 1 < argc && strcmp(argv[i], "-o") == 0)
+    {
+      if ((opt.csv = fopen(argv[++i], "w")) == NULL)
+      {
+        fprintf(stderr, "Error open file %s for writing the benchmark results\n", argv[i]);
+        return 1;
+      }
+      fprintf(opt.csv, "kernel,unit,units_per_call,calls,cycles_per_unit,ns_per_unit,cycles_per_call\n");
+    }
+    else
+    {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  run_benchmarks(&opt);
+
+  if (opt.csv)
+    fclose(opt.csv);
+  return 0;
+}
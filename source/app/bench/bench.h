@@ -0,0 +1,32 @@
+/*!
+ **************************************************************************
+ *  \file bench.h
+ *
+ *  \brief
+ *     Kernel micro-benchmark harness shared by lencod_bench and ldecod_bench
+ *
+ **************************************************************************
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+#include "global.h"
+
+typedef struct bench_options
+{
+  int    work;          //!< units (pixels, bins) processed per measurement
+  int    repeats;       //!< measurements per kernel, the fastest one is reported
+  char  *filter;        //!< only kernels whose name contains this string
+  FILE  *csv;           //!< optional CSV report
+} BenchOptions;
+
+//! runs a kernel "calls" times on the synthetic data in ctx
+typedef void (*BenchKernel)(void *ctx, int calls);
+
+extern volatile int bench_sink;   //!< results are accumulated here so that the kernels are not optimized away
+
+extern void bench_run      (BenchOptions *opt, const char *name, BenchKernel kernel, void *ctx, int units_per_call, const char *unit);
+extern void run_benchmarks (BenchOptions *opt);
+extern unsigned int bench_rand(void);
+
+#endif
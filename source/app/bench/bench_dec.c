@@ -0,0 +1,253 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    bench_dec.c
+ * \brief
+ *    Decoder kernel micro-benchmarks: luma motion compensation,
+ *    inverse transform, deblocking edge filters and CABAC decoding.
+ *    Every kernel works on a synthetic CIF picture with just enough
+ *    of the decoder state set up to run it.
+ ***********************************************************************
+ */
+
+#include "global.h"
+#include "memalloc.h"
+#include "mbuffer.h"
+#include "mc_prediction.h"
+#include "biaridecod.h"
+#include "transform.h"
+#include "bench.h"
+
+#define BENCH_WIDTH       352
+#define BENCH_HEIGHT      288
+#define BENCH_QP           28
+#define BENCH_CANDIDATES   64   //!< motion vectors cycled through by the motion compensation kernel
+#define BENCH_BINS       4096   //!< bins decoded before the arithmetic decoder is restarted
+
+extern void set_loop_filter_functions_normal(VideoParameters *p_Vid);
+
+typedef struct dec_bench
+{
+  VideoParameters  *p_Vid;
+  Slice            *currSlice;
+  StorablePicture  *ref;               //!< padded reference picture for motion compensation
+  StorablePicture  *pic;               //!< picture being deblocked
+  Macroblock       *mbs;
+  int               num_mbs;
+  MotionVector      mv[BENCH_CANDIDATES];
+  imgpel          **block;
+  int             **tmp_res;
+  byte              strength[16];
+
+  int             **coef;              //!< 8x16 coefficients of two 8x8 blocks
+  int             **residual;
+
+  DecodingEnvironment dep;
+  BiContextType     contexts[64];
+  byte              code_buffer[4 * BENCH_BINS];
+  int               code_len;
+} DecBench;
+
+static void fill_plane(imgpel **img, int x0, int y0, int size_x, int size_y)
+{
+  int i, j;
+
+  for (j = y0; j < y0 + size_y; j++)
+    for (i = x0; i < x0 + size_x; i++)
+      img[j][i] = (imgpel) iClip3(0, 255, (((i - x0) + 2 * (j - y0)) & 255) / 2 + 64 + (int) (bench_rand() % 17) - 8);
+}
+
+static void init_dec_bench(DecBench *b)
+{
+  VideoParameters *p_Vid;
+  int i, j, k, uv;
+
+  memset(b, 0, sizeof(DecBench));
+
+  p_Vid = b->p_Vid = (VideoParameters *) calloc(1, sizeof(VideoParameters));
+  b->currSlice     = (Slice *) calloc(1, sizeof(Slice));
+  b->ref           = (StorablePicture *) calloc(1, sizeof(StorablePicture));
+  b->pic           = (StorablePicture *) calloc(1, sizeof(StorablePicture));
+  b->num_mbs       = (BENCH_WIDTH / MB_BLOCK_SIZE) * (BENCH_HEIGHT / MB_BLOCK_SIZE);
+  b->mbs           = (Macroblock *) calloc(b->num_mbs, sizeof(Macroblock));
+  if (!p_Vid || !b->currSlice || !b->ref || !b->pic || !b->mbs)
+    no_mem_exit("init_dec_bench");
+
+  p_Vid->bitdepth_scale[IS_LUMA] = p_Vid->bitdepth_scale[IS_CHROMA] = 1;
+  p_Vid->max_pel_value_comp[0] = p_Vid->max_pel_value_comp[1] = p_Vid->max_pel_value_comp[2] = 255;
+  p_Vid->mb_cr_size_x = MB_BLOCK_SIZE / 2;
+  p_Vid->mb_cr_size_y = MB_BLOCK_SIZE / 2;
+  set_loop_filter_functions_normal(p_Vid);
+
+  // padded reference picture, filled including the padding
+  get_mem2Dpel_pad(&b->ref->imgY, BENCH_HEIGHT, BENCH_WIDTH, MCBUF_LUMA_PAD_Y, MCBUF_LUMA_PAD_X);
+  b->ref->cur_imgY    = b->ref->imgY;
+  b->ref->iLumaStride = BENCH_WIDTH + 2 * MCBUF_LUMA_PAD_X;
+  fill_plane(b->ref->imgY, -MCBUF_LUMA_PAD_X, -MCBUF_LUMA_PAD_Y, BENCH_WIDTH + 2 * MCBUF_LUMA_PAD_X, BENCH_HEIGHT + 2 * MCBUF_LUMA_PAD_Y);
+  get_mem2Dpel(&b->block, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+  get_mem2Dint(&b->tmp_res, MB_BLOCK_SIZE + 5, MB_BLOCK_SIZE + 5);
+  for (k = 0; k < BENCH_CANDIDATES; k++)
+  {
+    b->mv[k].mv_x = (short) (((int) (bench_rand() % (BENCH_WIDTH  - MB_BLOCK_SIZE)) << 2) + (bench_rand() & 3));
+    b->mv[k].mv_y = (short) (((int) (bench_rand() % (BENCH_HEIGHT - MB_BLOCK_SIZE)) << 2) + (bench_rand() & 3));
+  }
+
+  // 4:2:0 picture and macroblocks for the deblocking filter
+  get_mem2Dpel(&b->pic->imgY, BENCH_HEIGHT, BENCH_WIDTH);
+  get_mem3Dpel(&b->pic->imgUV, 2, BENCH_HEIGHT / 2, BENCH_WIDTH / 2);
+  b->pic->iLumaStride       = BENCH_WIDTH;
+  b->pic->iChromaStride     = BENCH_WIDTH / 2;
+  b->pic->chroma_format_idc = YUV420;
+  fill_plane(b->pic->imgY, 0, 0, BENCH_WIDTH, BENCH_HEIGHT);
+  for (uv = 0; uv < 2; uv++)
+    fill_plane(b->pic->imgUV[uv], 0, 0, BENCH_WIDTH / 2, BENCH_HEIGHT / 2);
+  for (k = 0; k < b->num_mbs; k++)
+  {
+    Macroblock *MbQ = &b->mbs[k];
+    MbQ->p_Vid   = p_Vid;
+    MbQ->p_Slice = b->currSlice;
+    MbQ->pix_x   = (k % (BENCH_WIDTH / MB_BLOCK_SIZE)) * MB_BLOCK_SIZE;
+    MbQ->pix_y   = (k / (BENCH_WIDTH / MB_BLOCK_SIZE)) * MB_BLOCK_SIZE;
+    MbQ->pix_c_x = MbQ->pix_x >> 1;
+    MbQ->pix_c_y = MbQ->pix_y >> 1;
+    MbQ->qp      = BENCH_QP;
+    MbQ->qpc[0]  = MbQ->qpc[1] = BENCH_QP - 1;
+  }
+  for (i = 0; i < 16; i++)
+    b->strength[i] = (byte) (1 + (i >> 2) % 3);
+
+  // coefficients of two 8x8 blocks
+  get_mem2Dint(&b->coef,     BLOCK_SIZE_8x8, MB_BLOCK_SIZE);
+  get_mem2Dint(&b->residual, BLOCK_SIZE_8x8, MB_BLOCK_SIZE);
+  for (j = 0; j < BLOCK_SIZE_8x8; j++)
+    for (i = 0; i < MB_BLOCK_SIZE; i++)
+      b->coef[j][i] = ((i & 7) + j < 6) ? (int) (bench_rand() % 129) - 64 : 0;
+
+  // CABAC: random code bytes over 64 contexts
+  for (k = 0; k < (int) sizeof(b->code_buffer); k++)
+    b->code_buffer[k] = (byte) bench_rand();
+  for (k = 0; k < 64; k++)
+  {
+    b->contexts[k].state = (uint16) (bench_rand() % 63);
+    b->contexts[k].MPS   = (unsigned char) (bench_rand() & 1);
+  }
+}
+
+static void free_dec_bench(DecBench *b)
+{
+  free_mem2Dint(b->residual);
+  free_mem2Dint(b->coef);
+  free_mem3Dpel(b->pic->imgUV);
+  free_mem2Dpel(b->pic->imgY);
+  free_mem2Dint(b->tmp_res);
+  free_mem2Dpel(b->block);
+  free_mem2Dpel_pad(b->ref->imgY, MCBUF_LUMA_PAD_Y, MCBUF_LUMA_PAD_X);
+  free(b->mbs);
+  free(b->pic);
+  free(b->ref);
+  free(b->currSlice);
+  free(b->p_Vid);
+}
+
+static void bench_get_block_luma(void *ctx, int calls)
+{
+  DecBench *b = (DecBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+  {
+    MotionVector *mv = &b->mv[k & (BENCH_CANDIDATES - 1)];
+    get_block_luma(b->ref, mv->mv_x, mv->mv_y, MB_BLOCK_SIZE, MB_BLOCK_SIZE, b->block, b->ref->iLumaStride,
+      BENCH_WIDTH - 1, BENCH_HEIGHT - 1, b->tmp_res, 255, 128, &b->mbs[0]);
+  }
+  bench_sink += b->block[0][0];
+}
+
+static void bench_inverse8x8(void *ctx, int calls)
+{
+  DecBench *b = (DecBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    inverse8x8(b->coef, b->residual, (k & 1) << 3);
+  bench_sink += b->residual[0][0];
+}
+
+//! internal edges only, so that every macroblock is its own neighbour
+static void bench_edge_loop_luma_ver(void *ctx, int calls)
+{
+  DecBench *b = (DecBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    b->p_Vid->EdgeLoopLumaVer(PLANE_Y, b->pic->imgY, b->strength, &b->mbs[k % b->num_mbs], 4 + ((k / b->num_mbs) % 3) * 4);
+  bench_sink += b->pic->imgY[0][0];
+}
+
+static void bench_edge_loop_luma_hor(void *ctx, int calls)
+{
+  DecBench *b = (DecBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    b->p_Vid->EdgeLoopLumaHor(PLANE_Y, b->pic->imgY, b->strength, &b->mbs[k % b->num_mbs], 4 + ((k / b->num_mbs) % 3) * 4, b->pic);
+  bench_sink += b->pic->imgY[0][0];
+}
+
+static void bench_edge_loop_chroma_ver(void *ctx, int calls)
+{
+  DecBench *b = (DecBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    b->p_Vid->EdgeLoopChromaVer(b->pic->imgUV[k & 1], b->strength, &b->mbs[(k >> 1) % b->num_mbs], 4, k & 1, b->pic);
+  bench_sink += b->pic->imgUV[0][0][0];
+}
+
+static void bench_edge_loop_chroma_hor(void *ctx, int calls)
+{
+  DecBench *b = (DecBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    b->p_Vid->EdgeLoopChromaHor(b->pic->imgUV[k & 1], b->strength, &b->mbs[(k >> 1) % b->num_mbs], 4, k & 1, b->pic);
+  bench_sink += b->pic->imgUV[0][0][0];
+}
+
+static void bench_biari_decode_symbol(void *ctx, int calls)
+{
+  DecBench *b = (DecBench *) ctx;
+  unsigned int sum = 0;
+  int k;
+
+  for (k = 0; k < calls; k++)
+  {
+    if ((k & (BENCH_BINS - 1)) == 0)
+      arideco_start_decoding(&b->dep, b->code_buffer, 0, &b->code_len);
+    sum += biari_decode_symbol(&b->dep, &b->contexts[k & 63]);
+  }
+  bench_sink += (int) sum;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    runs the decoder kernel benchmarks
+ ***********************************************************************
+ */
+void run_benchmarks(BenchOptions *opt)
+{
+  DecBench b;
+
+  init_dec_bench(&b);
+
+  bench_run(opt, "get_block_luma_16x16",  bench_get_block_luma,       &b, MB_PIXELS,     "pixel");
+  bench_run(opt, "inverse8x8",            bench_inverse8x8,           &b, 64,            "pixel");
+  bench_run(opt, "EdgeLoopLumaVer",       bench_edge_loop_luma_ver,   &b, MB_BLOCK_SIZE, "pixel");
+  bench_run(opt, "EdgeLoopLumaHor",       bench_edge_loop_luma_hor,   &b, MB_BLOCK_SIZE, "pixel");
+  bench_run(opt, "EdgeLoopChromaVer",     bench_edge_loop_chroma_ver, &b, BLOCK_SIZE_8x8, "pixel");
+  bench_run(opt, "EdgeLoopChromaHor",     bench_edge_loop_chroma_hor, &b, BLOCK_SIZE_8x8, "pixel");
+  bench_run(opt, "biari_decode_symbol",   bench_biari_decode_symbol,  &b, 1,             "bin");
+
+  free_dec_bench(&b);
+}
@@ -0,0 +1,430 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    bench_enc.c
+ * \brief
+ *    Encoder kernel micro-benchmarks: motion search distortion,
+ *    sub-pel interpolation, forward transform, quantization (normal
+ *    and CAVLC trellis), CABAC encoding and input format conversion.
+ *    Every kernel works on a synthetic CIF picture with just enough
+ *    of the encoder state set up to run it.
+ ***********************************************************************
+ */
+
+#include <math.h>
+#include "global.h"
+#include "memalloc.h"
+#include "mbuffer.h"
+#include "mb_access.h"
+#include "me_distortion.h"
+#include "img_luma.h"
+#include "transform.h"
+#include "quant4x4.h"
+#include "biariencode.h"
+#include "input.h"
+#include "bench.h"
+
+#define BENCH_WIDTH       352
+#define BENCH_HEIGHT      288
+#define BENCH_QP           28
+#define BENCH_CANDIDATES   64   //!< motion vector candidates cycled through by the distortion kernels
+#define BENCH_BLOCKS       16   //!< 4x4 / 8x8 blocks cycled through by the block kernels
+#define BENCH_BINS       4096   //!< bins coded before the arithmetic coder is restarted
+
+//! single scan pattern
+static const byte SNGL_SCAN[16][2] =
+{
+  {0,0},{1,0},{0,1},{0,2},
+  {1,1},{2,0},{3,0},{2,1},
+  {1,2},{0,3},{1,3},{2,2},
+  {3,1},{3,2},{2,3},{3,3}
+};
+
+static const byte COEFF_COST4x4[16] = {3,2,2,1,1,1,0,0,0,0,0,0,0,0,0,0};
+
+static const int quant_coef[6][3] =
+{
+  {13107, 5243, 8066}, {11916, 4660, 7490}, {10082, 4194, 6554},
+  { 9362, 3647, 5825}, { 8192, 3355, 5243}, { 7282, 2893, 4559}
+};
+
+static const int dequant_coef[6][3] =
+{
+  {10, 16, 13}, {11, 18, 14}, {13, 20, 16},
+  {14, 23, 18}, {16, 25, 20}, {18, 29, 23}
+};
+
+typedef struct enc_bench
+{
+  VideoParameters  *p_Vid;
+  Slice            *currSlice;
+  Macroblock       *currMB;
+  StorablePicture  *ref;
+  MEBlock           mv_block;
+  MotionVector      cand[BENCH_CANDIDATES];
+
+  short             diff[BENCH_BLOCKS][64];
+  int             **residual;          //!< 16x16 residual
+  int             **coef;              //!< 16x16 transform coefficients
+  int             **tblock;            //!< 4x16 working block of the quantizers
+  int               qp_per_matrix[MAX_QP + 1];
+  int               qp_rem_matrix[MAX_QP + 1];
+  LevelQuantParams  q_params[4][4];
+  LevelQuantParams *q_rows[4];
+  int               ACLevel[17];
+  int               ACRun[17];
+  int               coeff_cost;
+  QuantMethods      q_method;
+
+  EncodingEnvironment eep;
+  BiContextType     contexts[64];
+  byte              symbols[BENCH_BINS];
+  byte              code_buffer[4 * BENCH_BINS];
+  int               code_len;
+
+  unsigned char    *file_buf;
+  imgpel          **img;
+} EncBench;
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    fills a picture with a smooth gradient plus noise
+ ***********************************************************************
+ */
+static void fill_picture(imgpel **img, int size_x, int size_y)
+{
+  int i, j;
+
+  for (j = 0; j < size_y; j++)
+    for (i = 0; i < size_x; i++)
+      img[j][i] = (imgpel) iClip3(0, 255, ((i + 2 * j) & 255) / 2 + 64 + (int) (bench_rand() % 33) - 16);
+}
+
+static void init_enc_bench(EncBench *b)
+{
+  VideoParameters *p_Vid;
+  QuantParameters *p_Quant;
+  int i, j, k, qp;
+
+  memset(b, 0, sizeof(EncBench));
+
+  p_Vid = b->p_Vid = (VideoParameters *) calloc(1, sizeof(VideoParameters));
+  p_Vid->p_Inp     = (InputParameters *) calloc(1, sizeof(InputParameters));
+  p_Quant = p_Vid->p_Quant = (QuantParameters *) calloc(1, sizeof(QuantParameters));
+  b->currSlice     = (Slice *) calloc(1, sizeof(Slice));
+  b->currMB        = (Macroblock *) calloc(1, sizeof(Macroblock));
+  b->ref           = (StorablePicture *) calloc(1, sizeof(StorablePicture));
+  if (!p_Vid || !p_Vid->p_Inp || !p_Quant || !b->currSlice || !b->currMB || !b->ref)
+    no_mem_exit("init_enc_bench");
+
+  p_Vid->width              = BENCH_WIDTH;
+  p_Vid->height             = BENCH_HEIGHT;
+  p_Vid->max_imgpel_value   = 255;
+  p_Vid->yuv_format         = YUV420;
+  p_Vid->type               = P_SLICE;
+  p_Vid->masterQP           = BENCH_QP;
+  p_Vid->padded_size_x      = BENCH_WIDTH + 2 * IMG_PAD_SIZE_X;
+  p_Vid->padded_size_x_m8x8 = p_Vid->padded_size_x - BLOCK_SIZE_8x8;
+  p_Vid->padded_size_x_m4x4 = p_Vid->padded_size_x - BLOCK_SIZE;
+  p_Vid->mb_size[IS_LUMA][0] = p_Vid->mb_size[IS_LUMA][1] = MB_BLOCK_SIZE;
+  p_Vid->getNeighbour       = getNonAffNeighbour;
+  p_Vid->PicPos             = (BlockPos *) calloc(1, sizeof(BlockPos));
+  get_mem2Dint_pad(&p_Vid->imgY_sub_tmp, BENCH_HEIGHT, BENCH_WIDTH, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
+  get_mem3Dint(&p_Vid->nz_coeff, 1, 4, 4 + 2);
+
+  // reference picture with all sixteen sub-pel planes
+  b->ref->size_x        = BENCH_WIDTH;
+  b->ref->size_y        = BENCH_HEIGHT;
+  b->ref->size_x_padded = BENCH_WIDTH  + 2 * IMG_PAD_SIZE_X;
+  b->ref->size_y_padded = BENCH_HEIGHT + 2 * IMG_PAD_SIZE_Y;
+  b->ref->size_x_pad    = BENCH_WIDTH  + 2 * IMG_PAD_SIZE_X - 1 - MB_BLOCK_SIZE - IMG_PAD_SIZE_X;
+  b->ref->size_y_pad    = BENCH_HEIGHT + 2 * IMG_PAD_SIZE_Y - 1 - MB_BLOCK_SIZE - IMG_PAD_SIZE_Y;
+  get_mem4Dpel_pad(&b->ref->imgY_sub, 4, 4, BENCH_HEIGHT, BENCH_WIDTH, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
+  b->ref->imgY           = b->ref->imgY_sub[0][0];
+  b->ref->p_curr_img     = b->ref->imgY;
+  b->ref->p_curr_img_sub = b->ref->imgY_sub;
+  fill_picture(b->ref->imgY, BENCH_WIDTH, BENCH_HEIGHT);
+  getSubImagesLuma(p_Vid, b->ref);
+
+  // 16x16 motion search block and candidates around the picture centre
+  b->mv_block.p_Vid       = p_Vid;
+  b->mv_block.blocksize_x = MB_BLOCK_SIZE;
+  b->mv_block.blocksize_y = MB_BLOCK_SIZE;
+  get_mem2Dpel(&b->mv_block.orig_pic, 1, MB_PIXELS);
+  for (i = 0; i < MB_PIXELS; i++)
+    b->mv_block.orig_pic[0][i] = b->ref->imgY[BENCH_HEIGHT / 2 + (i >> 4)][BENCH_WIDTH / 2 + (i & 15)];
+  for (k = 0; k < BENCH_CANDIDATES; k++)
+  {
+    b->cand[k].mv_x = (short) (((BENCH_WIDTH  / 2 + (int) (bench_rand() % 33) - 16) << 2) + (bench_rand() & 3));
+    b->cand[k].mv_y = (short) (((BENCH_HEIGHT / 2 + (int) (bench_rand() % 33) - 16) << 2) + (bench_rand() & 3));
+  }
+
+  for (k = 0; k < BENCH_BLOCKS; k++)
+    for (i = 0; i < 64; i++)
+      b->diff[k][i] = (short) ((int) (bench_rand() % 41) - 20);
+
+  // residual, coefficients and quantization tables
+  get_mem2Dint(&b->residual, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+  get_mem2Dint(&b->coef,     MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+  get_mem2Dint(&b->tblock,   BLOCK_SIZE,    MB_BLOCK_SIZE);
+  for (j = 0; j < MB_BLOCK_SIZE; j++)
+    for (i = 0; i < MB_BLOCK_SIZE; i++)
+      b->residual[j][i] = (int) (bench_rand() % 41) - 20;
+  for (j = 0; j < MB_BLOCK_SIZE; j += BLOCK_SIZE)
+    for (i = 0; i < MB_BLOCK_SIZE; i += BLOCK_SIZE)
+      forward4x4(b->residual, b->coef, j, i);
+
+  p_Quant->qp_per_matrix = b->qp_per_matrix;
+  p_Quant->qp_rem_matrix = b->qp_rem_matrix;
+  for (qp = 0; qp <= MAX_QP; qp++)
+  {
+    p_Quant->qp_per_matrix[qp] = qp / 6;
+    p_Quant->qp_rem_matrix[qp] = qp % 6;
+  }
+  for (j = 0; j < 4; j++)
+  {
+    for (i = 0; i < 4; i++)
+    {
+      int pos = ((i & 1) == 0 && (j & 1) == 0) ? 0 : (((i & 1) == 1 && (j & 1) == 1) ? 1 : 2);
+      b->q_params[j][i].ScaleComp    = quant_coef  [BENCH_QP % 6][pos];
+      b->q_params[j][i].InvScaleComp = dequant_coef[BENCH_QP % 6][pos] << 4;
+      b->q_params[j][i].OffsetComp   = (1 << (Q_BITS + BENCH_QP / 6)) / 6;
+    }
+    b->q_rows[j] = b->q_params[j];
+  }
+  b->q_method.qp         = BENCH_QP;
+  b->q_method.ACLevel    = b->ACLevel;
+  b->q_method.ACRun      = b->ACRun;
+  b->q_method.q_params   = b->q_rows;
+  b->q_method.coeff_cost = &b->coeff_cost;
+  b->q_method.pos_scan   = SNGL_SCAN;
+  b->q_method.c_cost     = COEFF_COST4x4;
+
+  // CAVLC trellis state: one inter macroblock of a P slice
+  get_mem2Ddouble(&p_Vid->lambda_rdoq, NUM_SLICE_TYPES, MAX_QP + 1);
+  for (qp = 0; qp <= MAX_QP; qp++)
+    p_Vid->lambda_rdoq[P_SLICE][qp] = 0.85 * pow(2, (qp - SHIFT_QP) / 3.0);
+  b->currSlice->p_Vid          = p_Vid;
+  b->currSlice->symbol_mode    = CAVLC;
+  b->currSlice->rdoq_4x4       = rdoq_4x4_CAVLC;
+  b->currSlice->norm_factor_4x4 = pow(2, (2 * DQ_BITS + 19));
+  b->currMB->p_Vid   = p_Vid;
+  b->currMB->p_Slice = b->currSlice;
+  b->currMB->mb_type = P16x16;
+
+  // CABAC: skewed symbols over 64 contexts
+  b->eep.p_Vid = p_Vid;
+  for (k = 0; k < 64; k++)
+  {
+    b->contexts[k].state = (byte) (bench_rand() % 63);
+    b->contexts[k].MPS   = 1;
+  }
+  for (k = 0; k < BENCH_BINS; k++)
+    b->symbols[k] = (byte) ((bench_rand() % 100) < 80);
+
+  // 16 bit source file buffer and picture
+  if ((b->file_buf = (unsigned char *) malloc(BENCH_WIDTH * BENCH_HEIGHT * 2)) == NULL)
+    no_mem_exit("init_enc_bench: file_buf");
+  for (i = 0; i < BENCH_WIDTH * BENCH_HEIGHT * 2; i++)
+    b->file_buf[i] = (unsigned char) bench_rand();
+  get_mem2Dpel(&b->img, BENCH_HEIGHT, BENCH_WIDTH);
+}
+
+static void free_enc_bench(EncBench *b)
+{
+  VideoParameters *p_Vid = b->p_Vid;
+
+  free_mem2Dpel(b->img);
+  free(b->file_buf);
+  free_mem2Ddouble(p_Vid->lambda_rdoq);
+  free_mem2Dint(b->tblock);
+  free_mem2Dint(b->coef);
+  free_mem2Dint(b->residual);
+  free_mem2Dpel(b->mv_block.orig_pic);
+  free_mem4Dpel_pad(b->ref->imgY_sub, 16, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
+  free_mem3Dint(p_Vid->nz_coeff);
+  free_mem2Dint_pad(p_Vid->imgY_sub_tmp, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
+  free(p_Vid->PicPos);
+  free(b->ref);
+  free(b->currMB);
+  free(b->currSlice);
+  free(p_Vid->p_Quant);
+  free(p_Vid->p_Inp);
+  free(p_Vid);
+}
+
+static void bench_compute_sad(void *ctx, int calls)
+{
+  EncBench *b = (EncBench *) ctx;
+  distblk sum = 0;
+  int k;
+
+  for (k = 0; k < calls; k++)
+  {
+    MotionVector cand = b->cand[k & (BENCH_CANDIDATES - 1)];
+    cand.mv_x &= ~3;
+    cand.mv_y &= ~3;
+    sum += computeSAD(b->ref, &b->mv_block, DISTBLK_MAX, &cand);
+  }
+  bench_sink += (int) sum;
+}
+
+static void bench_compute_satd(EncBench *b, int calls, int test8x8)
+{
+  distblk sum = 0;
+  int k;
+
+  b->mv_block.test8x8 = test8x8;
+  for (k = 0; k < calls; k++)
+    sum += computeSATD(b->ref, &b->mv_block, DISTBLK_MAX, &b->cand[k & (BENCH_CANDIDATES - 1)]);
+  bench_sink += (int) sum;
+}
+
+static void bench_compute_satd4x4(void *ctx, int calls)
+{
+  bench_compute_satd((EncBench *) ctx, calls, 0);
+}
+
+static void bench_compute_satd8x8(void *ctx, int calls)
+{
+  bench_compute_satd((EncBench *) ctx, calls, 1);
+}
+
+static void bench_hadamard_sad8x8(void *ctx, int calls)
+{
+  EncBench *b = (EncBench *) ctx;
+  int sum = 0;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    sum += HadamardSAD8x8(b->diff[k & (BENCH_BLOCKS - 1)]);
+  bench_sink += sum;
+}
+
+static void bench_get_sub_images_luma(void *ctx, int calls)
+{
+  EncBench *b = (EncBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    getSubImagesLuma(b->p_Vid, b->ref);
+  bench_sink += b->ref->imgY_sub[2][2][0][0];
+}
+
+static void bench_forward4x4(void *ctx, int calls)
+{
+  EncBench *b = (EncBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    forward4x4(b->residual, b->coef, ((k >> 2) & 3) << 2, (k & 3) << 2);
+  bench_sink += b->coef[0][0];
+}
+
+//! quantizes one 4x4 block of the coefficient macroblock; the copy into the working block is included in the timing
+static void bench_quant_4x4(EncBench *b, int calls, int (*quant)(Macroblock *currMB, int **tblock, struct quant_methods *q_method))
+{
+  int sum = 0;
+  int k, j;
+
+  for (k = 0; k < calls; k++)
+  {
+    int block_y = ((k >> 2) & 3) << 2;
+    int block_x = (k & 3) << 2;
+
+    for (j = 0; j < BLOCK_SIZE; j++)
+      memcpy(&b->tblock[j][block_x], &b->coef[block_y + j][block_x], BLOCK_SIZE * sizeof(int));
+    b->q_method.block_y = block_y;
+    b->q_method.block_x = block_x;
+    b->coeff_cost = 0;
+    sum += quant(b->currMB, b->tblock, &b->q_method) + b->coeff_cost;
+  }
+  bench_sink += sum;
+}
+
+static void bench_quant_4x4_normal(void *ctx, int calls)
+{
+  bench_quant_4x4((EncBench *) ctx, calls, quant_4x4_normal);
+}
+
+static void bench_quant_4x4_trellis(void *ctx, int calls)
+{
+  bench_quant_4x4((EncBench *) ctx, calls, quant_4x4_trellis);
+}
+
+static void bench_biari_encode_symbol(void *ctx, int calls)
+{
+  EncBench *b = (EncBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+  {
+    if ((k & (BENCH_BINS - 1)) == 0)
+    {
+      b->code_len = 0;
+      arienco_start_encoding(&b->eep, b->code_buffer, &b->code_len);
+    }
+    biari_encode_symbol(&b->eep, b->symbols[k & (BENCH_BINS - 1)], &b->contexts[k & 63]);
+  }
+  bench_sink += b->code_len;
+}
+
+static void bench_buf2img_basic(void *ctx, int calls)
+{
+  EncBench *b = (EncBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    buf2img_basic(b->img, b->file_buf, BENCH_WIDTH, BENCH_HEIGHT, BENCH_WIDTH, BENCH_HEIGHT, 1, 0);
+  bench_sink += b->img[0][0];
+}
+
+static void bench_buf2img_bitshift(void *ctx, int calls)
+{
+  EncBench *b = (EncBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    buf2img_bitshift(b->img, b->file_buf, BENCH_WIDTH, BENCH_HEIGHT, BENCH_WIDTH, BENCH_HEIGHT, 1, -2);
+  bench_sink += b->img[0][0];
+}
+
+static void bench_buf2img_endian(void *ctx, int calls)
+{
+  EncBench *b = (EncBench *) ctx;
+  int k;
+
+  for (k = 0; k < calls; k++)
+    buf2img_endian(b->img, b->file_buf, BENCH_WIDTH, BENCH_HEIGHT, BENCH_WIDTH, BENCH_HEIGHT, 2, 0);
+  bench_sink += b->img[0][0];
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    runs the encoder kernel benchmarks
+ ***********************************************************************
+ */
+void run_benchmarks(BenchOptions *opt)
+{
+  EncBench b;
+  int pic_size = BENCH_WIDTH * BENCH_HEIGHT;
+
+  init_enc_bench(&b);
+
+  bench_run(opt, "computeSAD_16x16",      bench_compute_sad,         &b, MB_PIXELS, "pixel");
+  bench_run(opt, "computeSATD_16x16_4x4", bench_compute_satd4x4,     &b, MB_PIXELS, "pixel");
+  bench_run(opt, "computeSATD_16x16_8x8", bench_compute_satd8x8,     &b, MB_PIXELS, "pixel");
+  bench_run(opt, "HadamardSAD8x8",        bench_hadamard_sad8x8,     &b, 64,        "pixel");
+  bench_run(opt, "getSubImagesLuma",      bench_get_sub_images_luma, &b, pic_size,  "pixel");
+  bench_run(opt, "forward4x4",            bench_forward4x4,          &b, 16,        "pixel");
+  bench_run(opt, "quant_4x4_normal",      bench_quant_4x4_normal,    &b, 16,        "pixel");
+  bench_run(opt, "quant_4x4_trellis",     bench_quant_4x4_trellis,   &b, 16,        "pixel");
+  bench_run(opt, "biari_encode_symbol",   bench_biari_encode_symbol, &b, 1,         "bin");
+  bench_run(opt, "buf2img_basic",         bench_buf2img_basic,       &b, pic_size,  "pixel");
+  bench_run(opt, "buf2img_bitshift",      bench_buf2img_bitshift,    &b, pic_size,  "pixel");
+  bench_run(opt, "buf2img_endian",        bench_buf2img_endian,      &b, pic_size,  "pixel");
+
+  free_enc_bench(&b);
+}
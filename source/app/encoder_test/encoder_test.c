@@ -0,0 +1,139 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    encoder_test.c
+ * \brief
+ *    Example and test of the encoder library (h264encoder.h). Reads an
+ *    8 bit 4:2:0 YUV file, encodes it through OpenEncoder / EncodeFrame /
+ *    FlushEncoder / CloseEncoder and compares the NAL units with a
+ *    bitstream written by lencod with the same parameters.
+ *
+ *    Usage: encoder_test input.yuv width height reference.264 [lencod parameters]
+ ***********************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "h264encoder.h"
+
+typedef struct
+{
+  unsigned char *buf;   //!< bitstream of the NAL units received so far
+  int            size;
+  int            max_size;
+  int            nalus;
+} StreamBuffer;
+
+static void store_nalu(void *opaque, const unsigned char *buf, int len, long long pts)
+{
+  StreamBuffer *stream = (StreamBuffer *) opaque;
+
+  (void) pts;
+  if (stream->size + len > stream->max_size)
+  {
+    stream->max_size = 2 * (stream->size + len);
+    if ((stream->buf = (unsigned char *) realloc(stream->buf, stream->max_size)) == NULL)
+    {
+      fprintf(stderr, "encoder_test: out of memory\n");
+      exit(1);
+    }
+  }
+  memcpy(stream->buf + stream->size, buf, len);
+  stream->size += len;
+  stream->nalus++;
+}
+
+static int compare_stream(StreamBuffer *stream, char *filename)
+{
+  FILE *f = fopen(filename, "rb");
+  int pos = 0, c;
+
+  if (f == NULL)
+  {
+    fprintf(stderr, "encoder_test: cannot open %s\n", filename);
+    return 1;
+  }
+  while ((c = getc(f)) != EOF)
+  {
+    if (pos >= stream->size || stream->buf[pos] != c)
+      break;
+    pos++;
+  }
+  fclose(f);
+
+  if (c != EOF || pos != stream->size)
+  {
+    printf("encoder_test: bitstream differs from %s at byte %d\n", filename, pos);
+    return 1;
+  }
+  printf("encoder_test: %d NAL units, %d bytes, identical to %s\n", stream->nalus, stream->size, filename);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  StreamBuffer stream;
+  EncoderParams *encoder;
+  FILE *input;
+  unsigned char *frame;
+  char *reference;
+  const unsigned char *planes[3];
+  int strides[3];
+  int width, height, frame_size, ret;
+  long long pts = 0;
+
+  if (argc < 5)
+  {
+    printf("Usage: %s input.yuv width height reference.264 [lencod parameters]\n", argv[0]);
+    return 1;
+  }
+
+  reference = argv[4];
+  width  = atoi(argv[2]);
+  height = atoi(argv[3]);
+  frame_size = width * height * 3 / 2;
+  if (width <= 0 || height <= 0 || (frame = (unsigned char *) malloc(frame_size)) == NULL)
+  {
+    fprintf(stderr, "encoder_test: invalid frame size %sx%s\n", argv[2], argv[3]);
+    return 1;
+  }
+  if ((input = fopen(argv[1], "rb")) == NULL)
+  {
+    fprintf(stderr, "encoder_test: cannot open %s\n", argv[1]);
+    return 1;
+  }
+
+  memset(&stream, 0, sizeof(StreamBuffer));
+
+  // the lencod parameters follow the program name as on the lencod command line
+  argv[4] = argv[0];
+  if (OpenEncoder(&encoder, argc - 4, argv + 4, store_nalu, &stream) != ENC_OPEN_NOERR)
+  {
+    fprintf(stderr, "encoder_test: OpenEncoder failed\n");
+    return 1;
+  }
+
+  planes[0]  = frame;
+  planes[1]  = frame + width * height;
+  planes[2]  = frame + width * height * 5 / 4;
+  strides[0] = width;
+  strides[1] = strides[2] = width / 2;
+
+  do
+  {
+    if (fread(frame, 1, frame_size, input) != (size_t) frame_size)
+      break;
+    ret = EncodeFrame(encoder, planes, strides, pts++);
+  } while (ret == ENC_SUCCEED);
+
+  FlushEncoder(encoder);
+  CloseEncoder(encoder);
+  fclose(input);
+  free(frame);
+
+  ret = compare_stream(&stream, reference);
+  free(stream.buf);
+  return ret;
+}
@@ -0,0 +1,18 @@
+# encodes cfg/foreman_part_qcif.yuv with lencod and through the encoder library
+# and fails if the bitstreams differ
+
+set( PARAMS -d ${CFG_DIR}/encoder.cfg -p InputFile=${CFG_DIR}/foreman_part_qcif.yuv -p FramesToBeEncoded=3 -p ReconFile=rec.yuv )
+
+file( MAKE_DIRECTORY ${WORK_DIR}/cli ${WORK_DIR}/lib )
+
+execute_process( COMMAND ${LENCOD} ${PARAMS} -p OutputFile=cli.264
+                 WORKING_DIRECTORY ${WORK_DIR}/cli OUTPUT_QUIET RESULT_VARIABLE RESULT )
+if( NOT RESULT EQUAL 0 )
+  message( FATAL_ERROR "lencod failed (${RESULT})" )
+endif()
+
+execute_process( COMMAND ${ENCODER_TEST} ${CFG_DIR}/foreman_part_qcif.yuv 176 144 ${WORK_DIR}/cli/cli.264 ${PARAMS}
+                 WORKING_DIRECTORY ${WORK_DIR}/lib RESULT_VARIABLE RESULT )
+if( NOT RESULT EQUAL 0 )
+  message( FATAL_ERROR "encoder library output differs from lencod (${RESULT})" )
+endif()
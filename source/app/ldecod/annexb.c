@@ -42,6 +42,9 @@ void init_annex_b(ANNEXB_t *annex_b)
   annex_b->is_eof = FALSE;
   annex_b->IsFirstByteStreamNALU = 1;
   annex_b->nextstartcodebytes = 0;
+  annex_b->chunk_offset = 0;
+  annex_b->chunk_size = 0;
+  annex_b->nalu_offset = 0;
 }
 
 void free_annex_b(ANNEXB_t **p_annex_b)
@@ -61,6 +64,8 @@ void free_annex_b(ANNEXB_t **p_annex_b)
 static inline size_t getChunk(ANNEXB_t *annex_b)
 {
   size_t readbytes = read (annex_b->BitStreamFile, annex_b->iobuffer, annex_b->iIOBufferSize);
+  annex_b->chunk_offset += annex_b->chunk_size;
+  annex_b->chunk_size = 0;
   if (0==readbytes)
   {
     annex_b->is_eof = TRUE;
@@ -69,6 +74,7 @@ static inline size_t getChunk(ANNEXB_t *annex_b)
 
   annex_b->bytesinbuffer = readbytes;
   annex_b->iobufferread = annex_b->iobuffer;
+  annex_b->chunk_size = readbytes;
   return readbytes;
 }
 
@@ -151,6 +157,9 @@ int get_annex_b_NALU (VideoParameters *p_Vid, NALU_t *nalu, ANNEXB_t *annex_b)
   int LeadingZero8BitsCount = 0;
   byte *pBuf = annex_b->Buf;
 
+  // the start code of this NALU has already been read if nextstartcodebytes is set
+  annex_b->nalu_offset = annex_b->chunk_offset + (annex_b->iobufferread - annex_b->iobuffer) - annex_b->nextstartcodebytes;
+
   if (annex_b->nextstartcodebytes != 0)
   {
     for (i=0; i<annex_b->nextstartcodebytes-1; i++)
@@ -322,6 +331,8 @@ void open_annex_b (char *fn, ANNEXB_t *annex_b)
     error ("open_annex_b: cannot allocate IO buffer",500);
   }
   annex_b->is_eof = FALSE;
+  annex_b->chunk_offset = 0;
+  annex_b->chunk_size = 0;
   getChunk(annex_b);
 }
 
@@ -350,3 +361,28 @@ void reset_annex_b(ANNEXB_t *annex_b)
   annex_b->bytesinbuffer = 0;
   annex_b->iobufferread = annex_b->iobuffer;
 }
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Continues reading the bit stream at the start code at byte
+ *    position offset of the file
+ ************************************************************************
+ */
+void seek_annex_b(ANNEXB_t *annex_b, int64 offset)
+{
+  if (lseek(annex_b->BitStreamFile, offset, SEEK_SET) != offset)
+  {
+    snprintf (errortext, ET_SIZE, "seek_annex_b: cannot seek to byte %lld", (long long) offset);
+    error(errortext, 500);
+  }
+
+  annex_b->chunk_offset = offset;
+  annex_b->chunk_size = 0;
+  annex_b->bytesinbuffer = 0;
+  annex_b->iobufferread = annex_b->iobuffer;
+  annex_b->is_eof = FALSE;
+  annex_b->IsFirstByteStreamNALU = 1;
+  annex_b->nextstartcodebytes = 0;
+  getChunk(annex_b);
+}
@@ -26,6 +26,10 @@ typedef struct annex_b_struct
   int IsFirstByteStreamNALU;
   int nextstartcodebytes;
   byte *Buf;  
+
+  int64 chunk_offset;                //!< file offset of iobuffer
+  size_t chunk_size;                 //!< number of bytes read into iobuffer
+  int64 nalu_offset;                 //!< file offset of the start code of the last NALU read
 } ANNEXB_t;
 
 extern int  get_annex_b_NALU (VideoParameters *p_Vid, NALU_t *nalu, ANNEXB_t *annex_b);
@@ -36,5 +40,6 @@ extern void malloc_annex_b   (VideoParameters *p_Vid, ANNEXB_t **p_annex_b);
 extern void free_annex_b     (ANNEXB_t **p_annex_b);
 extern void init_annex_b     (ANNEXB_t *annex_b);
 extern void reset_annex_b    (ANNEXB_t *annex_b);
+extern void seek_annex_b     (ANNEXB_t *annex_b, int64 offset);
 #endif
 
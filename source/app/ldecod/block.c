@@ -24,6 +24,7 @@
 #include "transform.h"
 #include "quant.h"
 #include "memalloc.h"
+#include "dec_profile.h"
 
 /*!
  ***********************************************************************
@@ -44,6 +45,81 @@ void itrans4x4(Macroblock *currMB,   //!< current macroblock
   sample_reconstruct (&currSlice->mb_rec[pl][joff], &currSlice->mb_pred[pl][joff], &mb_rres[joff], ioff, ioff, BLOCK_SIZE, BLOCK_SIZE, currMB->p_Vid->max_pel_value_comp[pl], DQ_BITS);
 }
 
+/*!
+ ***********************************************************************
+ * \brief
+ *    Inverse 4x4 transformation of cof[pos_y..][pos_x..] fused with the
+ *    reconstruction. The residual is added to the prediction
+ *    mpr[pos_y..][pos_x..], clipped and stored to img[0..3][img_x..].
+ *    All passes work on whole rows of the block.
+ ***********************************************************************
+ */
+static inline void inverse4x4_recon(int **cof, imgpel **mpr, imgpel **img, int pos_y, int pos_x, int img_x, int max_imgpel_value)
+{
+  int tmp[BLOCK_SIZE][BLOCK_SIZE];
+  int res[BLOCK_SIZE][BLOCK_SIZE];
+  int i, j;
+
+  // Horizontal
+  for (j = 0; j < BLOCK_SIZE; j++)
+  {
+    int *blk = &cof[pos_y + j][pos_x];
+    int p0 =  blk[0] + blk[2];
+    int p1 =  blk[0] - blk[2];
+    int p2 = (blk[1] >> 1) - blk[3];
+    int p3 =  blk[1] + (blk[3] >> 1);
+
+    tmp[j][0] = p0 + p3;
+    tmp[j][1] = p1 + p2;
+    tmp[j][2] = p1 - p2;
+    tmp[j][3] = p0 - p3;
+  }
+
+  //  Vertical
+  for (i = 0; i < BLOCK_SIZE; i++)
+  {
+    int p0 =  tmp[0][i] + tmp[2][i];
+    int p1 =  tmp[0][i] - tmp[2][i];
+    int p2 = (tmp[1][i] >> 1) - tmp[3][i];
+    int p3 =  tmp[1][i] + (tmp[3][i] >> 1);
+
+    res[0][i] = p0 + p3;
+    res[1][i] = p1 + p2;
+    res[2][i] = p1 - p2;
+    res[3][i] = p0 - p3;
+  }
+
+  // Reconstruction
+  for (j = 0; j < BLOCK_SIZE; j++)
+  {
+    imgpel *prd = &mpr[pos_y + j][pos_x];
+    imgpel *rec = &img[j][img_x];
+
+    for (i = 0; i < BLOCK_SIZE; i++)
+      rec[i] = (imgpel) iClip1(max_imgpel_value, rshift_rnd_sf(res[j][i], DQ_BITS) + prd[i]);
+  }
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Inverse 4x4 transformation of the block at (ioff, joff) of the
+ *    macroblock, reconstructed directly into the picture rows img at
+ *    column img_x
+ ***********************************************************************
+ */
+void itrans4x4_recon(Macroblock *currMB, //!< current macroblock
+                     ColorPlane pl,      //!< used color plane
+                     int ioff,           //!< index to 4x4 block
+                     int joff,           //!< index to 4x4 block
+                     imgpel **img,       //!< picture rows of the block
+                     int img_x)          //!< picture column of the block
+{
+  Slice *currSlice = currMB->p_Slice;
+
+  inverse4x4_recon(currSlice->cof[pl], currSlice->mb_pred[pl], img, joff, ioff, img_x, currMB->p_Vid->max_pel_value_comp[pl]);
+}
+
 /*!
  ****************************************************************************
  * \brief
@@ -626,10 +702,13 @@ void iMBtrans4x4(Macroblock *currMB, ColorPlane pl, int smb)
   if (currMB->is_lossless && currMB->mb_type == I16MB)
   {
     Inv_Residual_trans_16x16(currMB, pl) ;
+
+    // construct picture from 4x4 blocks
+    copy_image_data_16x16(&curr_img[currMB->pix_y], currSlice->mb_rec[pl], currMB->pix_x, 0);
   }
   else if (smb || currMB->is_lossless == TRUE)
   {
-    currMB->itrans_4x4 = (smb) ? itrans_sp : ((currMB->is_lossless == FALSE) ? itrans4x4 : Inv_Residual_trans_4x4);
+    currMB->p_Slice->itrans_4x4 = (smb) ? itrans_sp : ((currMB->is_lossless == FALSE) ? itrans4x4 : Inv_Residual_trans_4x4);
     for (block8x8=0; block8x8 < MB_BLOCK_SIZE; block8x8 += 4)
     { 
       for (k = block8x8; k < block8x8 + 4; ++k )
@@ -637,61 +716,38 @@ void iMBtrans4x4(Macroblock *currMB, ColorPlane pl, int smb)
         jj = ((decode_block_scan[k] >> 2) & 3) << BLOCK_SHIFT;
         ii = (decode_block_scan[k] & 3) << BLOCK_SHIFT;
 
-        currMB->itrans_4x4(currMB, pl, ii, jj);   // use integer transform and make 4x4 block mb_rres from prediction block mb_pred
+        currMB->p_Slice->itrans_4x4(currMB, pl, ii, jj);   // use integer transform and make 4x4 block mb_rres from prediction block mb_pred
       }
     }
+
+    // construct picture from 4x4 blocks
+    copy_image_data_16x16(&curr_img[currMB->pix_y], currSlice->mb_rec[pl], currMB->pix_x, 0);
   }
   else
   {
-    int **cof = currSlice->cof[pl];
-    int **mb_rres = currSlice->mb_rres[pl];
-
-    if (currMB->is_intra_block == FALSE)
+    // transform and reconstruct straight into the picture, 8x8 blocks
+    // of inter macroblocks without coefficients are the prediction.
+    // There is no 16x16 kernel, Intra 16x16 macroblocks are reconstructed
+    // by four 4x4 kernel calls per 8x8 block like the inter macroblocks.
+    imgpel **img = &curr_img[currMB->pix_y];
+    imgpel **mb_pred = currSlice->mb_pred[pl];
+
+    for (block8x8 = 0; block8x8 < 4; block8x8++)
     {
-      if (currMB->cbp & 0x01)
-      {
-        inverse4x4(cof, mb_rres, 0, 0);
-        inverse4x4(cof, mb_rres, 0, 4);
-        inverse4x4(cof, mb_rres, 4, 0);
-        inverse4x4(cof, mb_rres, 4, 4);
-      }
-      if (currMB->cbp & 0x02)
-      {
-        inverse4x4(cof, mb_rres, 0, 8);
-        inverse4x4(cof, mb_rres, 0, 12);
-        inverse4x4(cof, mb_rres, 4, 8);
-        inverse4x4(cof, mb_rres, 4, 12);
-      }
-      if (currMB->cbp & 0x04)
-      {
-        inverse4x4(cof, mb_rres, 8, 0);
-        inverse4x4(cof, mb_rres, 8, 4);
-        inverse4x4(cof, mb_rres, 12, 0);
-        inverse4x4(cof, mb_rres, 12, 4);
-      }
-      if (currMB->cbp & 0x08)
-      {
-        inverse4x4(cof, mb_rres, 8, 8);
-        inverse4x4(cof, mb_rres, 8, 12);
-        inverse4x4(cof, mb_rres, 12, 8);
-        inverse4x4(cof, mb_rres, 12, 12);
-      }
-    }
-    else
-    {
-      for (jj = 0; jj < MB_BLOCK_SIZE; jj += BLOCK_SIZE)
+      int ioff = (block8x8 & 0x01) << 3;
+      int joff = (block8x8 >> 1  ) << 3;
+
+      if (currMB->is_intra_block || (currMB->cbp & (1 << block8x8)))
       {
-        inverse4x4(cof, mb_rres, jj, 0);
-        inverse4x4(cof, mb_rres, jj, 4);
-        inverse4x4(cof, mb_rres, jj, 8);
-        inverse4x4(cof, mb_rres, jj, 12);
+        itrans4x4_recon(currMB, pl, ioff    , joff    , &img[joff    ], currMB->pix_x + ioff    );
+        itrans4x4_recon(currMB, pl, ioff + 4, joff    , &img[joff    ], currMB->pix_x + ioff + 4);
+        itrans4x4_recon(currMB, pl, ioff    , joff + 4, &img[joff + 4], currMB->pix_x + ioff    );
+        itrans4x4_recon(currMB, pl, ioff + 4, joff + 4, &img[joff + 4], currMB->pix_x + ioff + 4);
       }
+      else
+        copy_image_data_8x8(&img[joff], &mb_pred[joff], currMB->pix_x + ioff, ioff);
     }
-    sample_reconstruct (currSlice->mb_rec[pl], currSlice->mb_pred[pl], mb_rres, 0, 0, MB_BLOCK_SIZE, MB_BLOCK_SIZE, currMB->p_Vid->max_pel_value_comp[pl], DQ_BITS);
   }
-
-  // construct picture from 4x4 blocks
-  copy_image_data_16x16(&curr_img[currMB->pix_y], currSlice->mb_rec[pl], currMB->pix_x, 0);
 }
 
 void iMBtrans8x8(Macroblock *currMB, ColorPlane pl)
@@ -700,6 +756,25 @@ void iMBtrans8x8(Macroblock *currMB, ColorPlane pl)
   StorablePicture *dec_picture = currMB->p_Slice->dec_picture;
   imgpel **curr_img = pl ? dec_picture->imgUV[pl - 1]: dec_picture->imgY;
 
+  if (currMB->is_lossless == FALSE)
+  {
+    // transform and reconstruct straight into the picture
+    imgpel **img = &curr_img[currMB->pix_y];
+    int block8x8;
+
+    for (block8x8 = 0; block8x8 < 4; block8x8++)
+    {
+      int ioff = (block8x8 & 0x01) << 3;
+      int joff = (block8x8 >> 1  ) << 3;
+
+      if (currMB->cbp & (1 << block8x8))
+        itrans8x8_recon(currMB, pl, ioff, joff, &img[joff], currMB->pix_x + ioff);
+      else
+        copy_image_data_8x8(&img[joff], &currMB->p_Slice->mb_pred[pl][joff], currMB->pix_x + ioff, ioff);
+    }
+    return;
+  }
+
   // Perform 8x8 idct
   if (currMB->cbp & 0x01) 
     itrans8x8(currMB, pl, 0, 0);
@@ -732,6 +807,7 @@ void iTransform(Macroblock *currMB, ColorPlane pl, int smb)
   imgpel **curr_img;
   int uv = pl-1; 
 
+  DEC_PROFILE_START(p_Vid, PROF_ITRANS);
   if ((currMB->cbp & 15) != 0 || smb)
   {
     if(currMB->luma_transform_size_8x8_flag == 0) // 4x4 inverse transform
@@ -769,20 +845,16 @@ void iTransform(Macroblock *currMB, ColorPlane pl, int smb)
       {
         if (currMB->is_lossless == FALSE)
         {
-          const unsigned char *x_pos, *y_pos;
-
           for (b8 = 0; b8 < (p_Vid->num_uv_blocks); ++b8)
           {
-            x_pos = subblk_offset_x[1][b8];
-            y_pos = subblk_offset_y[1][b8];
-
-            itrans4x4(currMB, uv, *x_pos++, *y_pos++);
-            itrans4x4(currMB, uv, *x_pos++, *y_pos++);
-            itrans4x4(currMB, uv, *x_pos++, *y_pos++);
-            itrans4x4(currMB, uv, *x_pos  , *y_pos  );
+            int b4;
+            for (b4 = 0; b4 < 4; ++b4)
+            {
+              ioff = subblk_offset_x[1][b8][b4];
+              joff = subblk_offset_y[1][b8][b4];
+              itrans4x4_recon(currMB, uv, ioff, joff, &curUV[joff], currMB->pix_c_x + ioff);
+            }
           }
-          sample_reconstruct (mb_rec, currSlice->mb_pred[uv], currSlice->mb_rres[uv], 0, 0, 
-            p_Vid->mb_size[1][0], p_Vid->mb_size[1][1], currMB->p_Vid->max_pel_value_comp[uv], DQ_BITS);
         }
         else
         {
@@ -806,21 +878,21 @@ void iTransform(Macroblock *currMB, ColorPlane pl, int smb)
             itrans4x4_ls(currMB, uv, *x_pos++, *y_pos++);
             itrans4x4_ls(currMB, uv, *x_pos  , *y_pos  );
           }
+          copy_image_data(curUV, mb_rec, currMB->pix_c_x, 0, p_Vid->mb_size[1][0], p_Vid->mb_size[1][1]);
         }
-        copy_image_data(curUV, mb_rec, currMB->pix_c_x, 0, p_Vid->mb_size[1][0], p_Vid->mb_size[1][1]);
 
         currSlice->is_reset_coeff_cr = FALSE;
       }
       else if (smb)
       {
-        currMB->itrans_4x4 = (currMB->is_lossless == FALSE) ? itrans4x4 : itrans4x4_ls;
+        currMB->p_Slice->itrans_4x4 = (currMB->is_lossless == FALSE) ? itrans4x4 : itrans4x4_ls;
         itrans_sp_cr(currMB, uv - 1);
 
         for (joff = 0; joff < p_Vid->mb_cr_size_y; joff += BLOCK_SIZE)
         {
           for(ioff = 0; ioff < p_Vid->mb_cr_size_x ;ioff += BLOCK_SIZE)
           {
-            currMB->itrans_4x4(currMB, uv, ioff, joff);
+            currMB->p_Slice->itrans_4x4(currMB, uv, ioff, joff);
           }
         }
 
@@ -833,6 +905,7 @@ void iTransform(Macroblock *currMB, ColorPlane pl, int smb)
       }
     }
   }
+  DEC_PROFILE_STOP(p_Vid, PROF_ITRANS);
 }
 
 /*!
@@ -113,6 +113,7 @@ extern void Inv_Residual_trans_16x16 (Macroblock *currMB, ColorPlane pl);
 extern void Inv_Residual_trans_Chroma(Macroblock *currMB, int uv);
 
 extern void itrans4x4   (Macroblock *currMB, ColorPlane pl, int ioff, int joff);
+extern void itrans4x4_recon(Macroblock *currMB, ColorPlane pl, int ioff, int joff, imgpel **img, int img_x);
 extern void itrans4x4_ls(Macroblock *currMB, ColorPlane pl, int ioff, int joff);
 extern void itrans_sp   (Macroblock *currMB, ColorPlane pl, int ioff, int joff);
 extern void itrans_2    (Macroblock *currMB, ColorPlane pl);
@@ -358,11 +358,11 @@ void read_MVD_CABAC( Macroblock *currMB,
   get4x4NeighbourBase(currMB, i    , j - 1, mb_size, &block_b);
   if (block_a.available)
   {
-    a = iabs(currSlice->mb_data[block_a.mb_addr].mvd[list_idx][block_a.y][block_a.x][k]);
+    a = iabs(currSlice->mb_mvd[block_a.mb_addr][list_idx][block_a.y][block_a.x][k]);
   }
   if (block_b.available)
   {
-    a += iabs(currSlice->mb_data[block_b.mb_addr].mvd[list_idx][block_b.y][block_b.x][k]);
+    a += iabs(currSlice->mb_mvd[block_b.mb_addr][list_idx][block_b.y][block_b.x][k]);
   }
 
   //a += b;
@@ -422,7 +422,7 @@ void read_mvd_CABAC_mbaff( Macroblock *currMB,
   get4x4NeighbourBase(currMB, i - 1, j    , p_Vid->mb_size[IS_LUMA], &block_a);
   if (block_a.available)
   {
-    a = iabs(currSlice->mb_data[block_a.mb_addr].mvd[list_idx][block_a.y][block_a.x][k]);
+    a = iabs(currSlice->mb_mvd[block_a.mb_addr][list_idx][block_a.y][block_a.x][k]);
     if (currSlice->mb_aff_frame_flag && (k==1))
     {
       if ((currMB->mb_field==0) && (currSlice->mb_data[block_a.mb_addr].mb_field==1))
@@ -435,7 +435,7 @@ void read_mvd_CABAC_mbaff( Macroblock *currMB,
   get4x4NeighbourBase(currMB, i    , j - 1, p_Vid->mb_size[IS_LUMA], &block_b);
   if (block_b.available)
   {
-    b = iabs(currSlice->mb_data[block_b.mb_addr].mvd[list_idx][block_b.y][block_b.x][k]);
+    b = iabs(currSlice->mb_mvd[block_b.mb_addr][list_idx][block_b.y][block_b.x][k]);
     if (currSlice->mb_aff_frame_flag && (k==1))
     {
       if ((currMB->mb_field==0) && (currSlice->mb_data[block_b.mb_addr].mb_field==1))
@@ -1919,9 +1919,9 @@ static int read_and_store_CBP_block_bit_normal (Macroblock              *currMB,
 void set_read_and_store_CBP(Macroblock **currMB, int chroma_format_idc)
 {
   if (chroma_format_idc == YUV444)
-    (*currMB)->read_and_store_CBP_block_bit = read_and_store_CBP_block_bit_444;
+    (*currMB)->p_Slice->read_and_store_CBP_block_bit = read_and_store_CBP_block_bit_444;
   else
-    (*currMB)->read_and_store_CBP_block_bit = read_and_store_CBP_block_bit_normal; 
+    (*currMB)->p_Slice->read_and_store_CBP_block_bit = read_and_store_CBP_block_bit_normal; 
 }
 
 
@@ -2110,7 +2110,7 @@ void readRunLevel_CABAC (Macroblock *currMB,
   if (*coeff_ctr < 0)
   {
     //===== decode CBP-BIT =====
-    if ((*coeff_ctr = currMB->read_and_store_CBP_block_bit (currMB, dep_dp, se->context) ) != 0)
+    if ((*coeff_ctr = currMB->p_Slice->read_and_store_CBP_block_bit (currMB, dep_dp, se->context) ) != 0)
     {
       //===== decode significance map =====
       *coeff_ctr = read_significance_map (currMB, dep_dp, se->context, coeff);
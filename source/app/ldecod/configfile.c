@@ -313,5 +313,13 @@ static void PatchInp (InputParameters *p_Inp)
   TestParams(Map, NULL);
   if(p_Inp->export_views == 1)
     p_Inp->dpb_plus[1] = imax(1, p_Inp->dpb_plus[1]);
+#if (MVC_EXTENSION_ENABLE)
+  // the skipped base view pictures may be needed for inter-view prediction
+  if (p_Inp->skip_pictures && p_Inp->DecodeAllLayers)
+  {
+    printf("Warning: SkipPictures is not supported with DecodeAllLayers, all pictures are decoded\n");
+    p_Inp->skip_pictures = 0;
+  }
+#endif
 }
 
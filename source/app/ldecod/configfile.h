@@ -47,6 +47,16 @@ Mapping Map[] = {
     {"Silent",                   &cfgparams.silent,                       0,   0.0,                       1,  0.0,              1.0,                             },
     {"IntraProfileDeblocking",   &cfgparams.intra_profile_deblocking,     0,   1.0,                       1,  0.0,              1.0,                             },
     {"DecFrmNum",                &cfgparams.iDecFrmNum,                   0,   0.0,                       2,  0.0,              0.0,                             },
+    {"RowDeblocking",            &cfgparams.row_deblocking,               0,   1.0,                       1,  0.0,              1.0,                             },
+    {"ProfileFile",              &cfgparams.profile_file,                 1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
+    {"MemoryFile",               &cfgparams.memory_file,                  1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
+    {"FrameThreads",             &cfgparams.frame_threads,                0,   0.0,                       1,  0.0,              64.0,                            },
+    {"PlaneThreads",             &cfgparams.plane_threads,                0,   0.0,                       1,  0.0,              1.0,                             },
+    {"IndexFile",                &cfgparams.index_file,                   1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
+    {"BuildIndex",               &cfgparams.build_index,                  0,   0.0,                       1,  0.0,              2.0,                             },
+    {"SeekPicture",              &cfgparams.seek_picture,                 0,   0.0,                       2,  0.0,              0.0,                             },
+    {"SkipPictures",             &cfgparams.skip_pictures,                0,   0.0,                       1,  0.0,              2.0,                             },
+    {"OutputScale",              &cfgparams.output_scale,                 0,   0.0,                       1,  0.0,              3.0,                             },
 #if (MVC_EXTENSION_ENABLE)
     {"DecodeAllLayers",          &cfgparams.DecodeAllLayers,              0,   0.0,                       1,  0.0,              1.0,                             },
 #endif
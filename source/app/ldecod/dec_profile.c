@@ -0,0 +1,178 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    dec_profile.c
+ * \brief
+ *    Per stage decoder timing. The intervals are measured with
+ *    gettime_ns() and accumulated per slice type and per picture.
+ *    The report is written as JSON, or as one CSV line per picture if
+ *    the file name ends in ".csv".
+ ***********************************************************************
+ */
+
+#include "global.h"
+#include "dec_profile.h"
+#include "memalloc.h"
+
+static const char *stage_name[PROF_NUM_STAGES] = { "nal", "entropy", "recon", "mc", "itrans", "deblock", "conceal", "output" };
+static const char *slice_name[NUM_SLICE_TYPES] = { "P", "B", "I", "SP", "SI" };
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    allocates and initializes the decoder profile
+ ***********************************************************************
+ */
+DecProfile *init_dec_profile(void)
+{
+  DecProfile *prof;
+
+  if ((prof = (DecProfile *) calloc (1, sizeof (DecProfile)))== NULL)
+    no_mem_exit ("init_dec_profile: prof");
+  prof->slice_type = I_SLICE;
+
+  return prof;
+}
+
+void delete_dec_profile(DecProfile *prof)
+{
+  if (prof)
+  {
+    free (prof->pics);
+    free (prof);
+  }
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    closes the running interval of a stage
+ ***********************************************************************
+ */
+void dec_profile_stop(DecProfile *prof, DecProfStage stage)
+{
+  int64 elapsed = gettime_ns() - prof->start[stage];
+  int type = iClip3(0, NUM_SLICE_TYPES - 1, prof->slice_type);
+
+  prof->time [type][stage] += elapsed;
+  prof->count[type][stage] ++;
+  prof->curr.time [stage]  += elapsed;
+  prof->curr.count[stage]  ++;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    stores the stages accounted since the previous picture as one
+ *    picture record
+ ***********************************************************************
+ */
+void dec_profile_picture(DecProfile *prof, int frame_poc, int structure, int slice_type)
+{
+  if (prof->num_pics == prof->size_pics)
+  {
+    prof->size_pics = imax(64, 2 * prof->size_pics);
+    if ((prof->pics = (DecProfPicture *) realloc (prof->pics, prof->size_pics * sizeof (DecProfPicture)))== NULL)
+      no_mem_exit ("dec_profile_picture: prof->pics");
+  }
+
+  prof->curr.frame_poc  = frame_poc;
+  prof->curr.structure  = structure;
+  prof->curr.slice_type = iClip3(0, NUM_SLICE_TYPES - 1, slice_type);
+  prof->pics[prof->num_pics++] = prof->curr;
+  prof->pic_ctr[prof->curr.slice_type]++;
+
+  memset(&prof->curr, 0, sizeof (DecProfPicture));
+}
+
+static void write_dec_profile_csv(DecProfile *prof, FILE *f)
+{
+  int i, stage;
+
+  fprintf(f, "picture,frame_poc,structure,slice_type");
+  for (stage = 0; stage < PROF_NUM_STAGES; stage++)
+    fprintf(f, ",%s_ns,%s_count", stage_name[stage], stage_name[stage]);
+  fprintf(f, "\n");
+
+  for (i = 0; i < prof->num_pics; i++)
+  {
+    DecProfPicture *pic = &prof->pics[i];
+    fprintf(f, "%d,%d,%d,%s", i, pic->frame_poc, pic->structure, slice_name[pic->slice_type]);
+    for (stage = 0; stage < PROF_NUM_STAGES; stage++)
+      fprintf(f, ",%lld,%lld", (long long) pic->time[stage], (long long) pic->count[stage]);
+    fprintf(f, "\n");
+  }
+}
+
+static void write_dec_profile_stages(FILE *f, int64 *time, int64 *count)
+{
+  int stage;
+
+  fprintf(f, "{");
+  for (stage = 0; stage < PROF_NUM_STAGES; stage++)
+    fprintf(f, "%s\"%s\": {\"ns\": %lld, \"count\": %lld}", stage ? ", " : "", stage_name[stage], (long long) time[stage], (long long) count[stage]);
+  fprintf(f, "}");
+}
+
+static void write_dec_profile_json(DecProfile *prof, FILE *f)
+{
+  int i, type, stage;
+  int64 time[PROF_NUM_STAGES], count[PROF_NUM_STAGES];
+
+  memset(time,  0, sizeof (time));
+  memset(count, 0, sizeof (count));
+  for (type = 0; type < NUM_SLICE_TYPES; type++)
+  {
+    for (stage = 0; stage < PROF_NUM_STAGES; stage++)
+    {
+      time [stage] += prof->time [type][stage];
+      count[stage] += prof->count[type][stage];
+    }
+  }
+
+  fprintf(f, "{\n  \"pictures\": %d,\n  \"total\": ", prof->num_pics);
+  write_dec_profile_stages(f, time, count);
+
+  fprintf(f, ",\n  \"slice_types\": {");
+  for (type = 0; type < NUM_SLICE_TYPES; type++)
+  {
+    fprintf(f, "%s\n    \"%s\": {\"pictures\": %d, \"stages\": ", type ? "," : "", slice_name[type], prof->pic_ctr[type]);
+    write_dec_profile_stages(f, prof->time[type], prof->count[type]);
+    fprintf(f, "}");
+  }
+
+  fprintf(f, "\n  },\n  \"per_picture\": [");
+  for (i = 0; i < prof->num_pics; i++)
+  {
+    DecProfPicture *pic = &prof->pics[i];
+    fprintf(f, "%s\n    {\"frame_poc\": %d, \"structure\": %d, \"slice_type\": \"%s\", \"stages\": ", i ? "," : "", pic->frame_poc, pic->structure, slice_name[pic->slice_type]);
+    write_dec_profile_stages(f, pic->time, pic->count);
+    fprintf(f, "}");
+  }
+  fprintf(f, "\n  ]\n}\n");
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    writes the profile report
+ ***********************************************************************
+ */
+void write_dec_profile(DecProfile *prof, char *filename)
+{
+  FILE *f;
+  size_t len = strlen(filename);
+
+  if ((f = fopen(filename, "w")) == NULL)
+  {
+    fprintf(stderr, "Error open file %s for writing the decoder profile\n", filename);
+    return;
+  }
+
+  if (len > 4 && strcasecmp(filename + len - 4, ".csv") == 0)
+    write_dec_profile_csv(prof, f);
+  else
+    write_dec_profile_json(prof, f);
+
+  fclose(f);
+}
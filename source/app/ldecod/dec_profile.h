@@ -0,0 +1,63 @@
+/*!
+ **************************************************************************
+ *  \file dec_profile.h
+ *
+ *  \brief
+ *     Per stage decoder timing (enabled with the ProfileFile parameter)
+ *
+ **************************************************************************
+ */
+
+#ifndef _DEC_PROFILE_H_
+#define _DEC_PROFILE_H_
+#include "global.h"
+
+//! decoding stages; "recon" includes the nested "mc" and "itrans" stages
+typedef enum
+{
+  PROF_NAL,         //!< NAL unit reading and slice header parsing (read_new_slice)
+  PROF_ENTROPY,     //!< macroblock syntax parsing (read_one_macroblock)
+  PROF_RECON,       //!< macroblock reconstruction (decode_one_macroblock)
+  PROF_MC,          //!< motion compensated prediction (perform_mc)
+  PROF_ITRANS,      //!< inverse transform and reconstruction of inter macroblocks (iTransform)
+  PROF_DEBLOCK,     //!< deblocking filter
+  PROF_CONCEAL,     //!< error concealment
+  PROF_OUTPUT,      //!< output format conversion and writing
+  PROF_NUM_STAGES
+} DecProfStage;
+
+//! stage totals of one decoded picture
+typedef struct dec_prof_picture
+{
+  int    frame_poc;
+  int    structure;
+  int    slice_type;
+  int64  time [PROF_NUM_STAGES];   //!< nanoseconds
+  int64  count[PROF_NUM_STAGES];
+} DecProfPicture;
+
+typedef struct dec_profile
+{
+  int64  start[PROF_NUM_STAGES];                     //!< start of the running interval of each stage
+  int    slice_type;                                 //!< slice type the running intervals are accounted to
+  int64  time [NUM_SLICE_TYPES][PROF_NUM_STAGES];    //!< nanoseconds per slice type
+  int64  count[NUM_SLICE_TYPES][PROF_NUM_STAGES];    //!< calls per slice type
+  int    pic_ctr[NUM_SLICE_TYPES];                   //!< pictures per (picture) slice type
+
+  DecProfPicture  curr;                              //!< stages accounted since the last picture ended
+  DecProfPicture *pics;
+  int             num_pics;
+  int             size_pics;
+} DecProfile;
+
+#define DEC_PROFILE_START(p_Vid, stage)  do { if ((p_Vid)->dec_profile) (p_Vid)->dec_profile->start[stage] = gettime_ns(); } while (0)
+#define DEC_PROFILE_STOP(p_Vid, stage)   do { if ((p_Vid)->dec_profile) dec_profile_stop((p_Vid)->dec_profile, stage); } while (0)
+#define DEC_PROFILE_SLICE(p_Vid, type)   do { if ((p_Vid)->dec_profile) (p_Vid)->dec_profile->slice_type = (type); } while (0)
+
+extern DecProfile *init_dec_profile  (void);
+extern void        delete_dec_profile(DecProfile *prof);
+extern void        dec_profile_stop  (DecProfile *prof, DecProfStage stage);
+extern void        dec_profile_picture(DecProfile *prof, int frame_poc, int structure, int slice_type);
+extern void        write_dec_profile (DecProfile *prof, char *filename);
+
+#endif
@@ -239,7 +239,8 @@ int main(int argc, char **argv)
     return -1; //failed;
   }
 
-  //decoding;
+  //decoding; BuildIndex = 2 only writes the random access index
+  if (p_Dec->p_Inp->build_index != 2)
   do
   {
     iRet = DecodeOneFrame(&pDecPicList);
@@ -0,0 +1,453 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    frame_thread.c
+ * \brief
+ *    Frame threaded decoding. The calling thread parses the slice
+ *    headers, manages the DPB and writes the output, while the slice
+ *    data of every picture is decoded, deblocked and padded by one of
+ *    FrameThreads worker threads. Each worker owns a copy of the
+ *    VideoParameters with private macroblock buffers. A picture
+ *    publishes the number of its final MB rows in iDecodedRows, and
+ *    motion compensation from a picture still being reconstructed
+ *    waits for the rows it reads. With DecodeAllLayers the pictures of
+ *    both views are dispatched: the non-base view picture of an access
+ *    unit waits for its inter-view reference when it is set up, and is
+ *    then reconstructed while the next base view picture decodes.
+ ***********************************************************************
+ */
+
+#include "global.h"
+#include "frame_thread.h"
+#include "image.h"
+#include "mbuffer.h"
+#include "memalloc.h"
+#include "erc_api.h"
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    (re)allocates the per picture buffers of a job for the current
+ *    picture size
+ ***********************************************************************
+ */
+static void alloc_job_buffers(FrameJob *job, VideoParameters *p_Vid)
+{
+  VideoParameters *p_Job = job->p_Vid;
+  MemTag mem_tag;
+
+  if (job->FrameSizeInMbs == (int) p_Vid->FrameSizeInMbs && job->PicWidthInMbs == (int) p_Vid->PicWidthInMbs)
+    return;
+  mem_tag = mem_set_tag(MEM_MB);
+
+  if (job->mb_data)
+  {
+    mem_free(job->mb_data);
+    mem_free(job->mb_mvd);
+    mem_free(job->mb_strength);
+    mem_free(job->intra_block);
+    free_mem2D(job->ipredmode);
+    free_mem4D(job->nz_coeff);
+    free_mem2Dint(job->siblock);
+    free(job->iMbRowDecoded);
+    free(job->MbToSliceGroupMap);
+  }
+
+  if ((job->mb_data = (Macroblock *) mem_calloc(p_Vid->FrameSizeInMbs, sizeof(Macroblock))) == NULL)
+    no_mem_exit("alloc_job_buffers: job->mb_data");
+  if ((job->mb_mvd = (MbMvd *) mem_calloc(p_Vid->FrameSizeInMbs, sizeof(MbMvd))) == NULL)
+    no_mem_exit("alloc_job_buffers: job->mb_mvd");
+  if ((job->mb_strength = (MbStrength *) mem_calloc(p_Vid->FrameSizeInMbs, sizeof(MbStrength))) == NULL)
+    no_mem_exit("alloc_job_buffers: job->mb_strength");
+  if ((job->intra_block = (char *) mem_calloc(p_Vid->FrameSizeInMbs, sizeof(char))) == NULL)
+    no_mem_exit("alloc_job_buffers: job->intra_block");
+  get_mem2D(&job->ipredmode, 4 * p_Vid->FrameHeightInMbs, 4 * p_Vid->PicWidthInMbs);
+  get_mem4D(&job->nz_coeff, p_Vid->FrameSizeInMbs, 3, BLOCK_SIZE, BLOCK_SIZE);
+  get_mem2Dint(&job->siblock, p_Vid->FrameHeightInMbs, p_Vid->PicWidthInMbs);
+  if ((job->iMbRowDecoded = (int *) malloc(p_Vid->FrameHeightInMbs * sizeof(int))) == NULL)
+    no_mem_exit("alloc_job_buffers: job->iMbRowDecoded");
+  if ((job->MbToSliceGroupMap = (int *) malloc(p_Vid->FrameSizeInMbs * sizeof(int))) == NULL)
+    no_mem_exit("alloc_job_buffers: job->MbToSliceGroupMap");
+
+  // ercInit() releases the previous instance of the job
+  p_Job->erc_object_list = job->erc_object_list;
+  p_Job->erc_errorVar    = job->erc_errorVar;
+  ercInit(p_Job, p_Vid->width, p_Vid->height, 1);
+  job->erc_object_list = p_Job->erc_object_list;
+  job->erc_errorVar    = p_Job->erc_errorVar;
+
+  job->FrameSizeInMbs = p_Vid->FrameSizeInMbs;
+  job->PicWidthInMbs  = p_Vid->PicWidthInMbs;
+  mem_set_tag(mem_tag);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    frees the pictures released by the DPB that no running job can
+ *    reference any more. Called from the decoding thread only.
+ ***********************************************************************
+ */
+static void release_deferred(FrameThreads *ft)
+{
+  int i, n = 0, oldest = INT_MAX;
+
+  mutex_lock(&ft->lock);
+  for (i = 0; i < ft->num_jobs; i++)
+  {
+    if (ft->jobs[i].seq && ft->jobs[i].seq < oldest)
+      oldest = ft->jobs[i].seq;
+  }
+  mutex_unlock(&ft->lock);
+
+  for (i = 0; i < ft->num_deferred; i++)
+  {
+    FrameDeferred *d = &ft->deferred[i];
+    if (d->seq < oldest)
+    {
+      d->p->p_FrameThreads = NULL;
+      free_storable_picture(d->p);
+    }
+    else
+      ft->deferred[n++] = *d;
+  }
+  ft->num_deferred = n;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    worker thread: reconstructs the dispatched pictures of one job
+ ***********************************************************************
+ */
+static void frame_worker(void *arg)
+{
+  FrameJob *job = (FrameJob *) arg;
+  FrameThreads *ft = job->p_Threads;
+
+  mutex_lock(&ft->lock);
+  while (!ft->quit)
+  {
+    VideoParameters *p_Vid = job->p_Vid;
+    StorablePicture *p;
+
+    if (job->seq == 0)
+    {
+      cond_wait(&ft->cond, &ft->lock);
+      continue;
+    }
+    mutex_unlock(&ft->lock);
+
+    p = p_Vid->dec_picture;
+    decode_picture_slices(p_Vid, job->used_for_reference);
+    // rows not yet published by the row pipelined deblocking
+    pad_picture_rows(p_Vid, p, p->iDecodedRows * MB_BLOCK_SIZE, p->size_y);
+
+    mutex_lock(&ft->lock);
+    store_release(&p->iDecodedRows, INT_MAX);
+    job->seq = 0;
+    cond_broadcast(&ft->cond);
+  }
+  mutex_unlock(&ft->lock);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    starts the frame threads if enabled and possible with the
+ *    decoder configuration
+ ***********************************************************************
+ */
+void init_frame_threads(VideoParameters *p_Vid)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  FrameThreads *ft;
+  int i;
+
+  // concealment, profiling and tracing need the pictures in decoding order
+  if (p_Inp->frame_threads <= 0 || p_Inp->conceal_mode != 0 || p_Vid->dec_profile != NULL || TRACE)
+    return;
+
+  if ((ft = (FrameThreads *) calloc(1, sizeof(FrameThreads))) == NULL)
+    no_mem_exit("init_frame_threads: ft");
+  ft->num_jobs = p_Inp->frame_threads;
+  if ((ft->jobs = (FrameJob *) calloc(ft->num_jobs, sizeof(FrameJob))) == NULL)
+    no_mem_exit("init_frame_threads: ft->jobs");
+  mutex_init(&ft->lock);
+  cond_init(&ft->cond);
+
+  for (i = 0; i < ft->num_jobs; i++)
+  {
+    FrameJob *job = &ft->jobs[i];
+
+    job->p_Threads = ft;
+    if ((job->p_Vid = (VideoParameters *) calloc(1, sizeof(VideoParameters))) == NULL)
+      no_mem_exit("init_frame_threads: job->p_Vid");
+    job->iNumOfSlicesAllocated = MAX_NUM_DECSLICES;
+    if ((job->ppSliceList = (Slice **) calloc(MAX_NUM_DECSLICES, sizeof(Slice *))) == NULL)
+      no_mem_exit("init_frame_threads: job->ppSliceList");
+    // the first slice of the next picture is swapped into slot 0 of the list (decode_one_frame)
+    job->ppSliceList[0] = malloc_slice(p_Inp, p_Vid);
+    if (thread_create(&job->thread, frame_worker, job))
+      error("init_frame_threads: cannot create frame thread", 500);
+  }
+
+  p_Vid->p_FrameThreads = ft;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    stops the frame threads and frees their resources
+ ***********************************************************************
+ */
+void free_frame_threads(VideoParameters *p_Vid)
+{
+  FrameThreads *ft = p_Vid->p_FrameThreads;
+  int i, j;
+
+  if (ft == NULL)
+    return;
+
+  frame_threads_drain(p_Vid);
+  mutex_lock(&ft->lock);
+  ft->quit = 1;
+  cond_broadcast(&ft->cond);
+  mutex_unlock(&ft->lock);
+
+  for (i = 0; i < ft->num_jobs; i++)
+  {
+    FrameJob *job = &ft->jobs[i];
+
+    thread_join(job->thread);
+    for (j = 0; j < job->iNumOfSlicesAllocated; j++)
+    {
+      if (job->ppSliceList[j])
+        free_slice(job->ppSliceList[j]);
+    }
+    free(job->ppSliceList);
+    if (job->mb_data)
+    {
+      mem_free(job->mb_data);
+      mem_free(job->mb_mvd);
+      mem_free(job->mb_strength);
+      mem_free(job->intra_block);
+      free_mem2D(job->ipredmode);
+      free_mem4D(job->nz_coeff);
+      free_mem2Dint(job->siblock);
+      free(job->iMbRowDecoded);
+      free(job->MbToSliceGroupMap);
+      job->p_Vid->erc_object_list = job->erc_object_list;
+      ercClose(job->p_Vid, job->erc_errorVar);
+    }
+    free(job->p_Vid);
+  }
+  free(ft->jobs);
+  free(ft->deferred);
+  mutex_destroy(&ft->lock);
+  cond_destroy(&ft->cond);
+  free(ft);
+  p_Vid->p_FrameThreads = NULL;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    returns 1 if the slices of the current picture can be handed to a
+ *    frame thread: progressive 4:2:0 / 4:2:2 frames without slice
+ *    groups, without lost or redundant slices and without memory
+ *    management operations that modify the current picture
+ ***********************************************************************
+ */
+int frame_threads_eligible(VideoParameters *p_Vid)
+{
+  StorablePicture *dec_picture = p_Vid->dec_picture;
+  Slice *pSlice = p_Vid->ppSliceList[0];
+  int i, next_mb_nr = 0;
+
+  if (dec_picture == NULL || pSlice->structure != FRAME || !pSlice->active_sps->frame_mbs_only_flag
+    || p_Vid->separate_colour_plane_flag || p_Vid->yuv_format == YUV444 || pSlice->active_pps->num_slice_groups_minus1 > 0
+    || dec_picture->adaptive_ref_pic_buffering_flag || (dec_picture->idr_flag && dec_picture->long_term_reference_flag))
+    return 0;
+
+  // the slices must cover the picture, the DPB is updated before they are decoded
+  for (i = 0; i < p_Vid->iSliceNumOfCurrPic; i++)
+  {
+    Slice *currSlice = p_Vid->ppSliceList[i];
+    if (currSlice->ei_flag || currSlice->dpB_NotPresent || currSlice->dpC_NotPresent || currSlice->redundant_pic_cnt
+      || currSlice->start_mb_nr != next_mb_nr)
+      return 0;
+    next_mb_nr = currSlice->end_mb_nr_plus1;
+  }
+  return (next_mb_nr == (int) p_Vid->PicSizeInMbs);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    hands the current picture and its slices to an idle frame thread.
+ *    The slices have been initialized with init_slice(); the calling
+ *    thread gets the slice list of the job in exchange.
+ ***********************************************************************
+ */
+void frame_threads_dispatch(VideoParameters *p_Vid)
+{
+  FrameThreads *ft = p_Vid->p_FrameThreads;
+  FrameJob *job = NULL;
+  VideoParameters *p_Job;
+  Slice **ppSliceList;
+  int i, iNumOfSlicesAllocated;
+
+  mutex_lock(&ft->lock);
+  while (job == NULL)
+  {
+    for (i = 0; i < ft->num_jobs && job == NULL; i++)
+    {
+      if (ft->jobs[i].seq == 0)
+        job = &ft->jobs[i];
+    }
+    if (job == NULL)
+      cond_wait(&ft->cond, &ft->lock);
+  }
+  mutex_unlock(&ft->lock);
+  release_deferred(ft);
+
+  p_Job = job->p_Vid;
+  alloc_job_buffers(job, p_Vid);
+  memcpy(p_Job, p_Vid, sizeof(VideoParameters));
+  p_Job->p_FrameThreads     = NULL;
+  p_Job->dec_profile        = NULL;
+  p_Job->mb_data            = job->mb_data;
+  p_Job->mb_mvd             = job->mb_mvd;
+  p_Job->mb_strength        = job->mb_strength;
+  p_Job->intra_block        = job->intra_block;
+  p_Job->ipredmode          = job->ipredmode;
+  p_Job->nz_coeff           = job->nz_coeff;
+  p_Job->siblock            = job->siblock;
+  p_Job->iMbRowDecoded      = job->iMbRowDecoded;
+  p_Job->iMbRowDecodedSize  = p_Vid->FrameHeightInMbs;
+  p_Job->erc_object_list    = job->erc_object_list;
+  p_Job->erc_errorVar       = job->erc_errorVar;
+  p_Job->erc_img            = p_Job;
+  memcpy(job->MbToSliceGroupMap, p_Vid->MbToSliceGroupMap, p_Vid->PicSizeInMbs * sizeof(int));
+  p_Job->MbToSliceGroupMap      = job->MbToSliceGroupMap;
+  p_Job->MapUnitToSliceGroupMap = NULL;
+
+  // exchange the slice lists
+  ppSliceList           = job->ppSliceList;
+  iNumOfSlicesAllocated = job->iNumOfSlicesAllocated;
+  job->ppSliceList           = p_Job->ppSliceList = p_Vid->ppSliceList;
+  job->iNumOfSlicesAllocated = p_Job->iNumOfSlicesAllocated = p_Vid->iNumOfSlicesAllocated;
+  p_Vid->ppSliceList           = ppSliceList;
+  p_Vid->iNumOfSlicesAllocated = iNumOfSlicesAllocated;
+  for (i = 0; i < iNumOfSlicesAllocated; i++)
+  {
+    if (ppSliceList[i])
+      ppSliceList[i]->p_Vid = p_Vid;
+  }
+  for (i = 0; i < p_Job->iSliceNumOfCurrPic; i++)
+    p_Job->ppSliceList[i]->p_Vid = p_Job;
+
+  p_Vid->dec_picture->iDecodedRows = 0;
+  job->used_for_reference = p_Vid->dec_picture->used_for_reference;
+
+  mutex_lock(&ft->lock);
+  job->seq = ++ft->dispatched;
+  cond_broadcast(&ft->cond);
+  mutex_unlock(&ft->lock);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    waits until all dispatched pictures are reconstructed, e.g. before
+ *    parameter sets are replaced
+ ***********************************************************************
+ */
+void frame_threads_drain(VideoParameters *p_Vid)
+{
+  FrameThreads *ft = p_Vid->p_FrameThreads;
+  int i;
+
+  if (ft == NULL)
+    return;
+
+  mutex_lock(&ft->lock);
+  for (i = 0; i < ft->num_jobs; i++)
+  {
+    while (ft->jobs[i].seq)
+      cond_wait(&ft->cond, &ft->lock);
+  }
+  mutex_unlock(&ft->lock);
+  release_deferred(ft);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    keeps a picture released by the DPB until no running job can
+ *    reference it. Returns 1 if the picture is freed later.
+ ***********************************************************************
+ */
+int frame_threads_defer_free(StorablePicture *p)
+{
+  FrameThreads *ft = p->p_FrameThreads;
+  int i, busy = 0;
+
+  mutex_lock(&ft->lock);
+  for (i = 0; i < ft->num_jobs; i++)
+    busy |= ft->jobs[i].seq;
+  mutex_unlock(&ft->lock);
+
+  if (!busy)
+    return 0;
+
+  if (ft->num_deferred == ft->size_deferred)
+  {
+    FrameDeferred *deferred;
+    ft->size_deferred = imax(16, 2 * ft->size_deferred);
+    if ((deferred = (FrameDeferred *) realloc(ft->deferred, ft->size_deferred * sizeof(FrameDeferred))) == NULL)
+      no_mem_exit("frame_threads_defer_free: ft->deferred");
+    ft->deferred = deferred;
+  }
+  ft->deferred[ft->num_deferred].p   = p;
+  ft->deferred[ft->num_deferred].seq = ft->dispatched;
+  ft->num_deferred++;
+  return 1;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    pads and publishes the first "rows" MB rows of a picture that is
+ *    reconstructed by a frame thread
+ ***********************************************************************
+ */
+void frame_threads_progress(VideoParameters *p_Vid, StorablePicture *p, int rows)
+{
+  FrameThreads *ft = p->p_FrameThreads;
+
+  pad_picture_rows(p_Vid, p, p->iDecodedRows * MB_BLOCK_SIZE, rows * MB_BLOCK_SIZE);
+
+  mutex_lock(&ft->lock);
+  store_release(&p->iDecodedRows, rows);
+  cond_broadcast(&ft->cond);
+  mutex_unlock(&ft->lock);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    blocks until the first "rows" MB rows of a picture are final
+ *    (see wait_picture_rows())
+ ***********************************************************************
+ */
+void frame_threads_wait(StorablePicture *p, int rows)
+{
+  FrameThreads *ft = p->p_FrameThreads;
+
+  mutex_lock(&ft->lock);
+  while (p->iDecodedRows < rows)
+    cond_wait(&ft->cond, &ft->lock);
+  mutex_unlock(&ft->lock);
+}
@@ -0,0 +1,86 @@
+/*!
+ **************************************************************************
+ *  \file frame_thread.h
+ *
+ *  \brief
+ *     Frame threaded decoding (enabled with the FrameThreads parameter)
+ *
+ **************************************************************************
+ */
+
+#ifndef _FRAME_THREAD_H_
+#define _FRAME_THREAD_H_
+#include <limits.h>
+#include "global.h"
+#include "mbuffer.h"
+
+//! one picture reconstructed by a worker thread
+typedef struct frame_job
+{
+  struct frame_threads *p_Threads;
+  VideoParameters      *p_Vid;                //!< private copy of the decoder state the picture is reconstructed with
+  ThreadHandle          thread;
+  int                   seq;                  //!< dispatch number of the picture being reconstructed, 0: idle
+  int                   used_for_reference;   //!< reference marking of the picture when it was dispatched
+
+  // slices and per picture buffers owned by the job
+  Slice               **ppSliceList;
+  int                   iNumOfSlicesAllocated;
+  Macroblock           *mb_data;
+  MbMvd                *mb_mvd;
+  MbStrength           *mb_strength;
+  char                 *intra_block;
+  byte                **ipredmode;
+  byte              ****nz_coeff;
+  int                 **siblock;
+  int                  *iMbRowDecoded;
+  int                  *MbToSliceGroupMap;
+  struct object_buffer  *erc_object_list;
+  struct ercVariables_s *erc_errorVar;
+  int                   FrameSizeInMbs;       //!< size the buffers above are allocated for
+  int                   PicWidthInMbs;
+} FrameJob;
+
+//! picture freed by the DPB while it may still be referenced by a worker
+typedef struct frame_deferred
+{
+  StorablePicture *p;
+  int              seq;                       //!< last picture dispatched before the free
+} FrameDeferred;
+
+typedef struct frame_threads
+{
+  int            num_jobs;
+  FrameJob      *jobs;
+  ThreadMutex    lock;
+  ThreadCond     cond;                        //!< signalled on dispatch, row progress and completion
+  int            quit;
+  int            dispatched;                  //!< number of dispatched pictures
+  FrameDeferred *deferred;
+  int            num_deferred;
+  int            size_deferred;
+} FrameThreads;
+
+extern void init_frame_threads      (VideoParameters *p_Vid);
+extern void free_frame_threads      (VideoParameters *p_Vid);
+extern int  frame_threads_eligible  (VideoParameters *p_Vid);
+extern void frame_threads_dispatch  (VideoParameters *p_Vid);
+extern void frame_threads_drain     (VideoParameters *p_Vid);
+extern int  frame_threads_defer_free(StorablePicture *p);
+extern void frame_threads_progress  (VideoParameters *p_Vid, StorablePicture *p, int rows);
+extern void frame_threads_wait      (StorablePicture *p, int rows);
+
+/*!
+ ************************************************************************
+ * \brief
+ *    waits until the first "rows" MB rows of a picture are final,
+ *    INT_MAX waits for the complete picture
+ ************************************************************************
+ */
+static inline void wait_picture_rows(StorablePicture *p, int rows)
+{
+  if (load_acquire(&p->iDecodedRows) < rows)
+    frame_threads_wait(p, rows);
+}
+
+#endif
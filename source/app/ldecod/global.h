@@ -109,6 +109,14 @@ typedef struct
   short y;
 } BlockPos;
 
+//! neighbouring macroblocks (pairs in MBAFF) A (left), B (above), C (above right) and D (above left)
+//! of a macroblock (pair) address, independent of the slice structure
+typedef struct
+{
+  int  mbAddrA, mbAddrB, mbAddrC, mbAddrD;
+  byte inside;          //!< NB_A, NB_B, NB_C and NB_D bits of the neighbours inside the picture
+} MbNeighbours;
+
 //! struct for context management
 typedef struct
 {
@@ -197,15 +205,54 @@ typedef struct cbp_s
   int64         bits_8x8;
 } CBPStructure;
 
+//! CABAC motion vector differences of a macroblock, indices correspond to [forw,backw][block_y][block_x][x,y]
+typedef short MbMvd[2][BLOCK_MULTIPLE][BLOCK_MULTIPLE][2];
+
+//! deblocking strength indices of a macroblock
+typedef struct mb_strength
+{
+  byte ver[4][4];
+  byte hor[4][16];
+} MbStrength;
+
 //! Macroblock
+//! The fields read for the neighbours of a macroblock (availability, type, cbp, deblocking
+//! parameters) come first. The CABAC motion vector differences and the deblocking strengths
+//! are kept in the separate mb_mvd and mb_strength arrays, the function pointers of the
+//! macroblock being decoded in the Slice.
 typedef struct macroblock_dec
 {
   struct slice       *p_Slice;                    //!< pointer to the current slice
   struct video_par   *p_Vid;                      //!< pointer to VideoParameters
-  struct inp_par     *p_Inp;
   int                 mbAddrX;                    //!< current MB address
   int mbAddrA, mbAddrB, mbAddrC, mbAddrD;
   Boolean mbAvailA, mbAvailB, mbAvailC, mbAvailD;
+
+  // some storage of macroblock syntax elements for global access
+  short         mb_type;
+  short         slice_nr;
+  int           cbp;
+  Boolean       is_intra_block;
+  Boolean       mb_field;
+  Boolean       luma_transform_size_8x8_flag;
+  int           DeblockCall;
+  short         DFDisableIdc;
+  short         DFAlphaC0Offset;
+  short         DFBetaOffset;
+  //Flag for MBAFF deblocking;
+  byte          mixedModeEdgeFlag;
+  char          ei_flag;             //!< error indicator flag that enables concealment
+  int           qp;                    //!< QP luma
+  int           qpc[2];                //!< QP chroma
+
+  struct macroblock_dec   *mbup;   // neighbors for loopfilter
+  struct macroblock_dec   *mbleft; // neighbors for loopfilter
+
+  CBPStructure  s_cbp[3];
+
+  struct macroblock_dec   *mb_up;   //!< pointer to neighboring MB (CABAC)
+  struct macroblock_dec   *mb_left; //!< pointer to neighboring MB (CABAC)
+
   BlockPos mb;
   int block_x;
   int block_y;
@@ -218,69 +265,24 @@ typedef struct macroblock_dec
   int subblock_x;
   int subblock_y;
 
-  int           qp;                    //!< QP luma
-  int           qpc[2];                //!< QP chroma
   int           qp_scaled[MAX_PLANE];  //!< QP scaled for all comps.
   Boolean       is_lossless;
-  Boolean       is_intra_block;
   Boolean       is_v_block;
-  int           DeblockCall;
 
-  short         slice_nr;
-  char          ei_flag;             //!< error indicator flag that enables concealment
   char          dpl_flag;            //!< error indicator flag that signals a missing data partition
   short         delta_quant;          //!< for rate control
   short         list_offset;
 
-  struct macroblock_dec   *mb_up;   //!< pointer to neighboring MB (CABAC)
-  struct macroblock_dec   *mb_left; //!< pointer to neighboring MB (CABAC)
-
-  struct macroblock_dec   *mbup;   // neighbors for loopfilter
-  struct macroblock_dec   *mbleft; // neighbors for loopfilter
-
-  // some storage of macroblock syntax elements for global access
-  short         mb_type;
-  short         mvd[2][BLOCK_MULTIPLE][BLOCK_MULTIPLE][2];      //!< indices correspond to [forw,backw][block_y][block_x][x,y]
-  //short         ****mvd;      //!< indices correspond to [forw,backw][block_y][block_x][x,y]
-  int           cbp;
-  CBPStructure  s_cbp[3];
-
   int           i16mode;
   char          b8mode[4];
   char          b8pdir[4];
   char          ipmode_DPCM;
   char          c_ipred_mode;       //!< chroma intra prediction mode
   char          skip_flag;
-  short         DFDisableIdc;
-  short         DFAlphaC0Offset;
-  short         DFBetaOffset;
 
-  Boolean       mb_field;
-  //Flag for MBAFF deblocking;
-  byte          mixedModeEdgeFlag;
-
-  // deblocking strength indices
-  byte strength_ver[4][4];
-  byte strength_hor[4][16];
-
-
-  Boolean       luma_transform_size_8x8_flag;
   Boolean       NoMbPartLessThan8x8Flag;
 
-  void (*itrans_4x4)(struct macroblock_dec *currMB, ColorPlane pl, int ioff, int joff);
-  void (*itrans_8x8)(struct macroblock_dec *currMB, ColorPlane pl, int ioff, int joff);
-
-  void (*GetMVPredictor) (struct macroblock_dec *currMB, PixelPos *block, 
-    MotionVector *pmv, short ref_frame, struct pic_motion_params **mv_info, int list, int mb_x, int mb_y, int blockshape_x, int blockshape_y);
-
-  int  (*read_and_store_CBP_block_bit)  (struct macroblock_dec *currMB, DecodingEnvironmentPtr  dep_dp, int type);
-  char (*readRefPictureIdx)             (struct macroblock_dec *currMB, struct syntaxelement_dec *currSE, struct datapartition_dec *dP, char b8mode, int list);
-
-  void (*read_comp_coeff_4x4_CABAC)     (struct macroblock_dec *currMB, struct syntaxelement_dec *currSE, ColorPlane pl, int (*InvLevelScale4x4)[4], int qp_per, int cbp);
-  void (*read_comp_coeff_8x8_CABAC)     (struct macroblock_dec *currMB, struct syntaxelement_dec *currSE, ColorPlane pl);
-
-  void (*read_comp_coeff_4x4_CAVLC)     (struct macroblock_dec *currMB, ColorPlane pl, int (*InvLevelScale4x4)[4], int qp_per, int cbp, byte **nzcoeff);
-  void (*read_comp_coeff_8x8_CAVLC)     (struct macroblock_dec *currMB, ColorPlane pl, int (*InvLevelScale8x8)[8], int qp_per, int cbp, byte **nzcoeff);
+  struct inp_par     *p_Inp;
 } Macroblock;
 
 //! Syntaxelement
@@ -543,6 +545,7 @@ typedef struct slice
 
   int erc_mvperMB;
   Macroblock *mb_data;
+  MbMvd      *mb_mvd;
   struct storable_picture *dec_picture;
   int **siblock;
   byte **ipredmode;
@@ -567,6 +570,21 @@ typedef struct slice
   void (*update_direct_mv_info    )    (Macroblock *currMB);
   void (*read_coeff_4x4_CAVLC     )    (Macroblock *currMB, int block_type, int i, int j, int levarr[16], int runarr[16], int *number_coefficients);
 
+  // set up for the macroblock being decoded
+  void (*itrans_4x4)(Macroblock *currMB, ColorPlane pl, int ioff, int joff);
+  void (*itrans_8x8)(Macroblock *currMB, ColorPlane pl, int ioff, int joff);
+
+  void (*GetMVPredictor) (Macroblock *currMB, PixelPos *block, 
+    MotionVector *pmv, short ref_frame, struct pic_motion_params **mv_info, int list, int mb_x, int mb_y, int blockshape_x, int blockshape_y);
+
+  int  (*read_and_store_CBP_block_bit)  (Macroblock *currMB, DecodingEnvironmentPtr  dep_dp, int type);
+  char (*readRefPictureIdx)             (Macroblock *currMB, struct syntaxelement_dec *currSE, struct datapartition_dec *dP, char b8mode, int list);
+
+  void (*read_comp_coeff_4x4_CABAC)     (Macroblock *currMB, struct syntaxelement_dec *currSE, ColorPlane pl, int (*InvLevelScale4x4)[4], int qp_per, int cbp);
+  void (*read_comp_coeff_8x8_CABAC)     (Macroblock *currMB, struct syntaxelement_dec *currSE, ColorPlane pl);
+
+  void (*read_comp_coeff_4x4_CAVLC)     (Macroblock *currMB, ColorPlane pl, int (*InvLevelScale4x4)[4], int qp_per, int cbp, byte **nzcoeff);
+  void (*read_comp_coeff_8x8_CAVLC)     (Macroblock *currMB, ColorPlane pl, int (*InvLevelScale8x8)[8], int qp_per, int cbp, byte **nzcoeff);
 } Slice;
 
 typedef struct decodedpic_t
@@ -650,9 +668,14 @@ typedef struct coding_par
   imgpel ***imgUV_ref;
   Macroblock *mb_data;               //!< array containing all MBs of a whole frame
   Macroblock *mb_data_JV[MAX_PLANE]; //!< mb_data to be used for 4:4:4 independent mode
+  MbMvd      *mb_mvd;                //!< CABAC motion vector differences of all MBs
+  MbMvd      *mb_mvd_JV[MAX_PLANE];
+  MbStrength *mb_strength;           //!< deblocking strengths of all MBs
+  MbStrength *mb_strength_JV[MAX_PLANE];
   char  *intra_block;
   char  *intra_block_JV[MAX_PLANE];
   BlockPos *PicPos;  
+  MbNeighbours *PicNeighbours;       //!< neighbours of all MB addresses, see init_mb_neighbours()
   byte **ipredmode;                  //!< prediction type [90][74]
   byte **ipredmode_JV[MAX_PLANE];
   byte ****nz_coeff;
@@ -718,6 +741,7 @@ typedef struct video_par
   int **siblock;
   int **siblock_JV[MAX_PLANE];
   BlockPos *PicPos;
+  MbNeighbours *PicNeighbours;
 
   int newframe;
   int structure;                     //!< Identify picture structure type
@@ -726,6 +750,10 @@ typedef struct video_par
   Slice      *pNextSlice;             //!< pointer to first Slice of next picture;
   Macroblock *mb_data;               //!< array containing all MBs of a whole frame
   Macroblock *mb_data_JV[MAX_PLANE]; //!< mb_data to be used for 4:4:4 independent mode
+  MbMvd      *mb_mvd;                //!< CABAC motion vector differences of all MBs
+  MbMvd      *mb_mvd_JV[MAX_PLANE];
+  MbStrength *mb_strength;           //!< deblocking strengths of all MBs
+  MbStrength *mb_strength_JV[MAX_PLANE];
   //int colour_plane_id;               //!< colour_plane_id of the current coded slice
   int ChromaArrayType;
 
@@ -883,6 +911,11 @@ typedef struct video_par
   ImageData tempData3;
   DecodedPicList *pDecOuputPic;
   int iDeblockMode;  //0: deblock in picture, 1: deblock in slice;
+  int iDeblockRows;         //!< 1: deblock each MB row as soon as the row below it is reconstructed
+  int iDeblockRowNext;      //!< next MB row waiting to be deblocked
+  int *iMbRowDecoded;       //!< number of reconstructed macroblocks per MB row
+  int iMbRowDecodedSize;    //!< number of allocated entries in iMbRowDecoded
+  int iPlanesDeblocked;     //!< the colour planes of the picture have been deblocked by the plane threads
   struct nalu_t *nalu;
   int iLumaPadX;
   int iLumaPadY;
@@ -950,6 +983,9 @@ typedef struct video_par
 /******************* end deprecative variables; ***************************************/
 
   struct dec_stat_parameters *dec_stats;
+  struct dec_profile *dec_profile;           //!< per stage timing, NULL if not enabled
+  struct frame_threads *p_FrameThreads;      //!< frame threaded reconstruction, NULL if not enabled
+  struct plane_threads *p_PlaneThreads;      //!< concurrent colour plane decoding, NULL if not enabled
 } VideoParameters;
 
 
@@ -977,6 +1013,16 @@ typedef struct inp_par
   int write_uv;
   int silent;
   int intra_profile_deblocking;               //!< Loop filter usage determined by flags and parameters in bitstream 
+  int row_deblocking;                         //!< Deblock macroblock rows while the picture is being reconstructed
+  char profile_file[FILE_NAME_SIZE];          //!< per stage timing report (JSON, or CSV for *.csv), disabled if empty
+  char memory_file[FILE_NAME_SIZE];           //!< current and peak memory per subsystem (JSON), disabled if empty
+  int frame_threads;                          //!< number of pictures reconstructed concurrently, 0: decode in the calling thread
+  int plane_threads;                          //!< decode the colour planes of 4:4:4 independent mode pictures concurrently
+  char index_file[FILE_NAME_SIZE];            //!< random access index, InputFile.idx if empty
+  int build_index;                            //!< 1: write the random access index before decoding, 2: write it only
+  int seek_picture;                           //!< start decoding at the last random access point in front of this picture
+  int skip_pictures;                          //!< 1: decode reference pictures only, 2: decode I and SI slices only
+  int output_scale;                           //!< downscale the output pictures by 1 << output_scale
 
   // Input/output sequence format related variables
   FrameFormat source;                   //!< source related information
@@ -1082,6 +1128,7 @@ extern void FreeDecPicList ( DecodedPicList *pDecPicList );
 extern void ClearDecPicList( VideoParameters *p_Vid );
 extern DecodedPicList *get_one_avail_dec_pic_from_list(DecodedPicList *pDecPicList, int b3D, int view_id);
 extern Slice *malloc_slice( InputParameters *p_Inp, VideoParameters *p_Vid );
+extern void   free_slice  ( Slice *currSlice );
 extern void copy_slice_info ( Slice *currSlice, OldSliceParams *p_old_slice );
 extern void OpenOutputFiles(VideoParameters *p_Vid, int view0_id, int view1_id);
 extern void set_global_coding_par(VideoParameters *p_Vid, CodingParameters *cps);
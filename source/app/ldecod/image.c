@@ -60,8 +60,12 @@
 #include "fast_memory.h"
 
 #include "mc_prediction.h"
+#include "dec_profile.h"
+#include "frame_thread.h"
+#include "plane_thread.h"
 extern int testEndian(void);
 void reorder_lists(Slice *currSlice);
+static void store_decoded_picture(VideoParameters *p_Vid, StorablePicture **dec_picture);
 
 static inline void reset_mbs(Macroblock *currMB)
 {
@@ -84,11 +88,15 @@ static void setup_buffers(VideoParameters *p_Vid, int layer_id)
      for( i=0; i<MAX_PLANE; i++ )
      {
        p_Vid->mb_data_JV[i] = cps->mb_data_JV[i];
+       p_Vid->mb_mvd_JV[i] = cps->mb_mvd_JV[i];
+       p_Vid->mb_strength_JV[i] = cps->mb_strength_JV[i];
        p_Vid->intra_block_JV[i] = cps->intra_block_JV[i];
        p_Vid->ipredmode_JV[i] = cps->ipredmode_JV[i];
        p_Vid->siblock_JV[i] = cps->siblock_JV[i];
      }
      p_Vid->mb_data = NULL;
+     p_Vid->mb_mvd = NULL;
+     p_Vid->mb_strength = NULL;
      p_Vid->intra_block = NULL;
      p_Vid->ipredmode = NULL;
      p_Vid->siblock = NULL;
@@ -96,11 +104,14 @@ static void setup_buffers(VideoParameters *p_Vid, int layer_id)
     else
     {
       p_Vid->mb_data = cps->mb_data;
+      p_Vid->mb_mvd = cps->mb_mvd;
+      p_Vid->mb_strength = cps->mb_strength;
       p_Vid->intra_block = cps->intra_block;
       p_Vid->ipredmode = cps->ipredmode;
       p_Vid->siblock = cps->siblock;
     }
     p_Vid->PicPos = cps->PicPos;
+    p_Vid->PicNeighbours = cps->PicNeighbours;
     p_Vid->nz_coeff = cps->nz_coeff;
     p_Vid->qp_per_matrix = cps->qp_per_matrix;
     p_Vid->qp_rem_matrix = cps->qp_rem_matrix;
@@ -162,6 +173,8 @@ static void init_mvc_picture(Slice *currSlice)
   }
   else
   {
+    // the inter-view reference is copied, the base view picture may still be reconstructed by a frame thread
+    wait_picture_rows(p_pic, INT_MAX);
     process_picture_in_dpb_s(p_Vid, p_pic);
     store_proc_picture_in_dpb (currSlice->p_Dpb, clone_storable_picture(p_Vid, p_pic));
   }
@@ -171,13 +184,73 @@ static void init_mvc_picture(Slice *currSlice)
 /*!
  ************************************************************************
  * \brief
- *    Initializes the parameters for a new picture
+ *    Resets the macroblock buffers before the slices of a picture are
+ *    decoded
  ************************************************************************
  */
-static void init_picture(VideoParameters *p_Vid, Slice *currSlice, InputParameters *p_Inp)
+static void reset_mb_buffers(VideoParameters *p_Vid)
 {
   int i;
   int nplane;
+
+  // CAVLC init
+  if (p_Vid->active_pps->entropy_coding_mode_flag == (Boolean) CAVLC)
+  {
+    memset(p_Vid->nz_coeff[0][0][0], -1, p_Vid->PicSizeInMbs * 48 *sizeof(byte)); // 3 * 4 * 4
+  }
+
+  // Set the slice_nr member of each MB to -1, to ensure correct when packet loss occurs
+  // TO set Macroblock Map (mark all MBs as 'have to be concealed')
+  if( (p_Vid->separate_colour_plane_flag != 0) )
+  {
+    for( nplane=0; nplane<MAX_PLANE; ++nplane )
+    {      
+      Macroblock *currMB = p_Vid->mb_data_JV[nplane];
+      char *intra_block = p_Vid->intra_block_JV[nplane];
+      for(i=0; i<(int)p_Vid->PicSizeInMbs; ++i)
+      {
+        reset_mbs(currMB++);
+      }
+      fast_memset(p_Vid->ipredmode_JV[nplane][0], DC_PRED, 16 * p_Vid->FrameHeightInMbs * p_Vid->PicWidthInMbs * sizeof(char));
+      if(p_Vid->active_pps->constrained_intra_pred_flag)
+      {
+        for (i=0; i<(int)p_Vid->PicSizeInMbs; ++i)
+        {
+          intra_block[i] = 1;
+        }
+      }
+    }
+  }
+  else
+  {
+#if 0 //defined(OPENMP)
+#pragma omp parallel for
+    for(i=0; i<(int)p_Vid->PicSizeInMbs; ++i)
+      reset_mbs(&p_Vid->mb_data[i]);
+#else
+    Macroblock *currMB = p_Vid->mb_data;
+    for(i=0; i<(int)p_Vid->PicSizeInMbs; ++i)
+      reset_mbs(currMB++);
+#endif
+    if(p_Vid->active_pps->constrained_intra_pred_flag)
+    {
+      for (i=0; i<(int)p_Vid->PicSizeInMbs; ++i)
+      {
+        p_Vid->intra_block[i] = 1;
+      }
+    }
+    fast_memset(p_Vid->ipredmode[0], DC_PRED, 16 * p_Vid->FrameHeightInMbs * p_Vid->PicWidthInMbs * sizeof(char));
+  }
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Initializes the parameters for a new picture
+ ************************************************************************
+ */
+static void init_picture(VideoParameters *p_Vid, Slice *currSlice, InputParameters *p_Inp)
+{
   StorablePicture *dec_picture = NULL;
   seq_parameter_set_rbsp_t *active_sps = p_Vid->active_sps;
   DecodedPictureBuffer *p_Dpb = currSlice->p_Dpb;
@@ -323,55 +396,6 @@ static void init_picture(VideoParameters *p_Vid, Slice *currSlice, InputParamete
     p_Vid->type = P_SLICE;  // concealed element
   }
 
-  // CAVLC init
-  if (p_Vid->active_pps->entropy_coding_mode_flag == (Boolean) CAVLC)
-  {
-    memset(p_Vid->nz_coeff[0][0][0], -1, p_Vid->PicSizeInMbs * 48 *sizeof(byte)); // 3 * 4 * 4
-  }
-
-  // Set the slice_nr member of each MB to -1, to ensure correct when packet loss occurs
-  // TO set Macroblock Map (mark all MBs as 'have to be concealed')
-  if( (p_Vid->separate_colour_plane_flag != 0) )
-  {
-    for( nplane=0; nplane<MAX_PLANE; ++nplane )
-    {      
-      Macroblock *currMB = p_Vid->mb_data_JV[nplane];
-      char *intra_block = p_Vid->intra_block_JV[nplane];
-      for(i=0; i<(int)p_Vid->PicSizeInMbs; ++i)
-      {
-        reset_mbs(currMB++);
-      }
-      fast_memset(p_Vid->ipredmode_JV[nplane][0], DC_PRED, 16 * p_Vid->FrameHeightInMbs * p_Vid->PicWidthInMbs * sizeof(char));
-      if(p_Vid->active_pps->constrained_intra_pred_flag)
-      {
-        for (i=0; i<(int)p_Vid->PicSizeInMbs; ++i)
-        {
-          intra_block[i] = 1;
-        }
-      }
-    }
-  }
-  else
-  {
-#if 0 //defined(OPENMP)
-#pragma omp parallel for
-    for(i=0; i<(int)p_Vid->PicSizeInMbs; ++i)
-      reset_mbs(&p_Vid->mb_data[i]);
-#else
-    Macroblock *currMB = p_Vid->mb_data;
-    for(i=0; i<(int)p_Vid->PicSizeInMbs; ++i)
-      reset_mbs(currMB++);
-#endif
-    if(p_Vid->active_pps->constrained_intra_pred_flag)
-    {
-      for (i=0; i<(int)p_Vid->PicSizeInMbs; ++i)
-      {
-        p_Vid->intra_block[i] = 1;
-      }
-    }
-    fast_memset(p_Vid->ipredmode[0], DC_PRED, 16 * p_Vid->FrameHeightInMbs * p_Vid->PicWidthInMbs * sizeof(char));
-  }  
-
   dec_picture->slice_type = p_Vid->type;
   dec_picture->used_for_reference = (currSlice->nal_reference_idc != 0);
   dec_picture->idr_flag = currSlice->idr_flag;
@@ -615,10 +639,48 @@ static void fill_wp_params(Slice *currSlice)
 
 
 
+/*!
+ ************************************************************************
+ * \brief
+ *    Clears the per row macroblock counters of row pipelined deblocking
+ ************************************************************************
+ */
+static void reset_deblock_rows(VideoParameters *p_Vid)
+{
+  p_Vid->iDeblockRowNext = 0;
+  if (p_Vid->iMbRowDecodedSize < (int) p_Vid->PicHeightInMbs)
+  {
+    free(p_Vid->iMbRowDecoded);
+    p_Vid->iMbRowDecodedSize = p_Vid->FrameHeightInMbs;
+    if ((p_Vid->iMbRowDecoded = (int *) malloc(p_Vid->iMbRowDecodedSize * sizeof(int))) == NULL)
+      no_mem_exit("reset_deblock_rows: p_Vid->iMbRowDecoded");
+  }
+  memset(p_Vid->iMbRowDecoded, 0, p_Vid->PicHeightInMbs * sizeof(int));
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Set up row pipelined deblocking for the current picture.
+ *    MBAFF frames and separate colour planes are deblocked after the
+ *    whole picture has been reconstructed.
+ ************************************************************************
+ */
+static void init_deblock_rows(VideoParameters *p_Vid, Slice *pSlice, int iDeblockRows)
+{
+  p_Vid->iDeblockRowNext = 0;
+  p_Vid->iDeblockRows = iDeblockRows && p_Vid->p_Inp->row_deblocking && !p_Vid->iDeblockMode
+    && !pSlice->mb_aff_frame_flag && !p_Vid->separate_colour_plane_flag
+    && (p_Vid->bDeblockEnable & (1 << p_Vid->dec_picture->used_for_reference));
+
+  if (p_Vid->iDeblockRows)
+    reset_deblock_rows(p_Vid);
+}
+
 static void init_picture_decoding(VideoParameters *p_Vid)
 {
   Slice *pSlice = p_Vid->ppSliceList[0];
-  int j, iDeblockMode=1;
+  int j, iDeblockMode=1, iDeblockRows=1;
 
   if(p_Vid->iSliceNumOfCurrPic >= MAX_NUM_SLICES)
   {
@@ -663,11 +725,17 @@ static void init_picture_decoding(VideoParameters *p_Vid)
   {
     if(p_Vid->ppSliceList[j]->DFDisableIdc != 1)
       iDeblockMode=0;
+    // lost partitions and redundant slices are concealed or replaced at picture level
+    if(p_Vid->ppSliceList[j]->ei_flag || p_Vid->ppSliceList[j]->dpB_NotPresent || p_Vid->ppSliceList[j]->dpC_NotPresent || p_Vid->ppSliceList[j]->redundant_pic_cnt)
+      iDeblockRows = 0;
 #if (MVC_EXTENSION_ENABLE)
     assert(p_Vid->ppSliceList[j]->view_id == pSlice->view_id);
 #endif
   }
   p_Vid->iDeblockMode = iDeblockMode;
+  p_Vid->iPlanesDeblocked = 0;
+
+  init_deblock_rows(p_Vid, pSlice, iDeblockRows);
 }
 
 void init_slice(VideoParameters *p_Vid, Slice *currSlice)
@@ -812,6 +880,7 @@ int decode_one_frame(DecoderParams *pDecoder)
   Slice *currSlice; // = p_Vid->currentSlice;
   Slice **ppSliceList = p_Vid->ppSliceList;
   int iSliceNo;
+  int threaded;
   
   //read one picture first;
   p_Vid->iSliceNumOfCurrPic=0;
@@ -864,7 +933,10 @@ int decode_one_frame(DecoderParams *pDecoder)
     currSlice->is_reset_coeff = FALSE;
     currSlice->is_reset_coeff_cr = FALSE;
 
+    DEC_PROFILE_START(p_Vid, PROF_NAL);
     current_header = read_new_slice(currSlice);
+    DEC_PROFILE_SLICE(p_Vid, currSlice->slice_type);
+    DEC_PROFILE_STOP(p_Vid, PROF_NAL);
     //init;
     currSlice->current_header = current_header;
 
@@ -927,22 +999,40 @@ int decode_one_frame(DecoderParams *pDecoder)
   iRet = current_header;
   init_picture_decoding(p_Vid);
 
+  threaded = p_Vid->p_FrameThreads && frame_threads_eligible(p_Vid);
+  if (threaded)
   {
+    // reference lists are built here, the slice data is decoded by a frame thread
     for(iSliceNo=0; iSliceNo<p_Vid->iSliceNumOfCurrPic; iSliceNo++)
+      init_slice(p_Vid, ppSliceList[iSliceNo]);
+  }
+  else
+  {
+    frame_threads_drain(p_Vid);
+    reset_mb_buffers(p_Vid);
+
+    if (p_Vid->p_PlaneThreads && plane_threads_eligible(p_Vid))
+    {
+      decode_colour_planes(p_Vid);
+    }
+    else
     {
-      currSlice = ppSliceList[iSliceNo];
-      current_header = currSlice->current_header;
-      //p_Vid->currentSlice = currSlice;
+      for(iSliceNo=0; iSliceNo<p_Vid->iSliceNumOfCurrPic; iSliceNo++)
+      {
+        currSlice = ppSliceList[iSliceNo];
+        current_header = currSlice->current_header;
+        //p_Vid->currentSlice = currSlice;
 
-      assert(current_header != EOS);
-      assert(currSlice->current_slice_nr == iSliceNo);
+        assert(current_header != EOS);
+        assert(currSlice->current_slice_nr == iSliceNo);
 
-      init_slice(p_Vid, currSlice);
-      decode_slice(currSlice, current_header);
+        init_slice(p_Vid, currSlice);
+        decode_slice(currSlice, current_header);
 
-      p_Vid->iNumOfSlicesDecoded++;
-      p_Vid->num_dec_mb += currSlice->num_dec_mb;
-      p_Vid->erc_mvperMB += currSlice->erc_mvperMB;
+        p_Vid->iNumOfSlicesDecoded++;
+        p_Vid->num_dec_mb += currSlice->num_dec_mb;
+        p_Vid->erc_mvperMB += currSlice->erc_mvperMB;
+      }
     }
   }
 #if MVC_EXTENSION_ENABLE
@@ -954,6 +1044,13 @@ int decode_one_frame(DecoderParams *pDecoder)
     p_Vid->last_dec_poc = p_Vid->dec_picture->top_poc;
   else if(p_Vid->dec_picture->structure == BOTTOM_FIELD)
     p_Vid->last_dec_poc = p_Vid->dec_picture->bottom_poc;
+  if (threaded)
+  {
+    p_Vid->previous_frame_num = ppSliceList[0]->frame_num;
+    frame_threads_dispatch(p_Vid);
+    store_decoded_picture(p_Vid, &p_Vid->dec_picture);
+    return (iRet);
+  }
   exit_picture(p_Vid, &p_Vid->dec_picture);
   p_Vid->previous_frame_num = ppSliceList[0]->frame_num;
   return (iRet);
@@ -1151,6 +1248,8 @@ void find_snr(VideoParameters *p_Vid,
   // picture error concealment
   char yuv_types[4][6]= {"4:0:0","4:2:0","4:2:2","4:4:4"};
 
+  wait_picture_rows(p, INT_MAX);
+
   max_pix_value_sqd[0] = iabs2(p_Vid->max_pel_value_comp[0]);
   max_pix_value_sqd[1] = iabs2(p_Vid->max_pel_value_comp[1]);
   max_pix_value_sqd[2] = iabs2(p_Vid->max_pel_value_comp[2]);
@@ -1332,6 +1431,90 @@ void reorder_lists(Slice *currSlice)
 }
 
 
+/*!
+ ************************************************************************
+ * \brief
+ *    returns 1 if the slice in nalu is not decoded with SkipPictures:
+ *    the slices of non-reference pictures (1) or all slices but I and
+ *    SI slices (2). Only the start of the slice header is read; the
+ *    frame_num and POC state is updated as if the picture had been
+ *    decoded, so the next decoded picture finds no frame_num gap and
+ *    gets its POC MSB right. The memory management operations of
+ *    skipped pictures are not known, so the picture after one with
+ *    MMCO 5 is always decoded.
+ ************************************************************************
+ */
+static int skip_slice(VideoParameters *p_Vid, NALU_t *nalu)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  pic_parameter_set_rbsp_t *pps;
+  seq_parameter_set_rbsp_t *sps;
+  byte *buf = nalu->buf + 1;
+  int size = nalu->len - 1;
+  int bitoffset = 0;
+  int first_mb, slice_type, pps_id, frame_num, max_frame_num;
+
+  if (nalu->nal_unit_type == NALU_TYPE_IDR || p_Vid->last_has_mmco_5)
+    return 0;
+  if (p_Inp->skip_pictures == 1 && nalu->nal_reference_idc != NALU_PRIORITY_DISPOSABLE)
+    return 0;
+
+  first_mb = peek_ue_v(buf, &bitoffset, size);
+  slice_type = peek_ue_v(buf, &bitoffset, size) % 5;
+  if (p_Inp->skip_pictures == 2 && (slice_type == I_SLICE || slice_type == SI_SLICE))
+    return 0;
+
+  pps_id = peek_ue_v(buf, &bitoffset, size);
+  if (pps_id < 0 || pps_id >= MAXPPS || !p_Vid->PicParSet[pps_id].Valid)
+    return 0;
+  pps = &p_Vid->PicParSet[pps_id];
+  sps = &p_Vid->SeqParSet[pps->seq_parameter_set_id];
+  if (!sps->Valid)
+    return 0;
+
+  if (sps->separate_colour_plane_flag)
+    bitoffset += 2;                                 // colour_plane_id
+  frame_num = peek_u_v(sps->log2_max_frame_num_minus4 + 4, buf, &bitoffset, size);
+  max_frame_num = 1 << (sps->log2_max_frame_num_minus4 + 4);
+
+  if (nalu->nal_reference_idc)
+    p_Vid->pre_frame_num = frame_num;
+
+  if (sps->pic_order_cnt_type == 0)
+  {
+    int MaxPicOrderCntLsb = 1 << (sps->log2_max_pic_order_cnt_lsb_minus4 + 4);
+    int pic_order_cnt_lsb;
+
+    if (!sps->frame_mbs_only_flag && peek_u_v(1, buf, &bitoffset, size) == 1)
+      bitoffset++;                                  // field_pic_flag set, skip bottom_field_flag
+    pic_order_cnt_lsb = peek_u_v(sps->log2_max_pic_order_cnt_lsb_minus4 + 4, buf, &bitoffset, size);
+
+    if (nalu->nal_reference_idc)
+    {
+      if (pic_order_cnt_lsb < (int) p_Vid->PrevPicOrderCntLsb && ((int) p_Vid->PrevPicOrderCntLsb - pic_order_cnt_lsb) >= MaxPicOrderCntLsb / 2)
+        p_Vid->PrevPicOrderCntMsb += MaxPicOrderCntLsb;
+      else if (pic_order_cnt_lsb > (int) p_Vid->PrevPicOrderCntLsb && (pic_order_cnt_lsb - (int) p_Vid->PrevPicOrderCntLsb) > MaxPicOrderCntLsb / 2)
+        p_Vid->PrevPicOrderCntMsb -= MaxPicOrderCntLsb;
+      p_Vid->PrevPicOrderCntLsb = pic_order_cnt_lsb;
+    }
+  }
+  else
+  {
+    if (frame_num < (int) p_Vid->PreviousFrameNum)
+      p_Vid->FrameNumOffset = p_Vid->PreviousFrameNumOffset + max_frame_num;
+    else
+      p_Vid->FrameNumOffset = p_Vid->PreviousFrameNumOffset;
+    p_Vid->PreviousFrameNumOffset = p_Vid->FrameNumOffset;
+  }
+  p_Vid->PreviousFrameNum = frame_num;
+
+  // the next decoded slice starts a new picture, even if its header equals the last decoded one
+  if (first_mb == 0)
+    init_old_slice(p_Vid->old_slice);
+
+  return 1;
+}
+
 /*!
  ************************************************************************
  * \brief
@@ -1427,6 +1610,9 @@ process_nalu:
       if (p_Vid->recovery_point_found == 0)
         break;
 
+      if (p_Inp->skip_pictures && skip_slice(p_Vid, nalu))
+        break;
+
       currSlice->idr_flag = (nalu->nal_unit_type == NALU_TYPE_IDR);
       currSlice->nal_reference_idc = nalu->nal_reference_idc;
       currSlice->dp_mode = PAR_DP_1;
@@ -1787,47 +1973,52 @@ process_nalu:
   }
 }
 
-void pad_buf(imgpel *pImgBuf, int iWidth, int iHeight, int iStride, int iPadX, int iPadY)
+/*!
+ ************************************************************************
+ * \brief
+ *    Replicates the border samples of lines [iRowStart, iRowEnd) of a
+ *    plane into the padding area. The top padding is written together
+ *    with line 0, the bottom padding together with the last line.
+ ************************************************************************
+ */
+void pad_buf_rows(imgpel *pImgBuf, int iWidth, int iHeight, int iStride, int iPadX, int iPadY, int iRowStart, int iRowEnd)
 {
   int j;
   imgpel *pLine0 = pImgBuf - iPadX, *pLine;
 #if (IMGTYPE==0)
   int pad_width = iPadX + iWidth;
-  fast_memset(pImgBuf - iPadX, *pImgBuf, iPadX * sizeof(imgpel));
-  fast_memset(pImgBuf + iWidth, *(pImgBuf + iWidth - 1), iPadX * sizeof(imgpel));
 
-  pLine = pLine0 - iPadY * iStride;
-  
-  for(j = -iPadY; j < 0; j++)
+  pLine = pLine0 + iRowStart * iStride;
+  for(j = iRowStart; j < iRowEnd; j++)
   {
-    fast_memcpy(pLine, pLine0, iStride * sizeof(imgpel));
+    fast_memset(pLine, *(pLine + iPadX), iPadX * sizeof(imgpel));
+    fast_memset(pLine + pad_width, *(pLine + pad_width - 1), iPadX * sizeof(imgpel));
     pLine += iStride;
   }
 
-  for(j = 1; j < iHeight; j++)
+  if (iRowStart == 0 && iRowEnd > 0)
   {
-    pLine += iStride;
-    fast_memset(pLine, *(pLine + iPadX), iPadX * sizeof(imgpel));
-    fast_memset(pLine + pad_width, *(pLine + pad_width - 1), iPadX * sizeof(imgpel));
+    pLine = pLine0 - iPadY * iStride;
+    for(j = -iPadY; j < 0; j++)
+    {
+      fast_memcpy(pLine, pLine0, iStride * sizeof(imgpel));
+      pLine += iStride;
+    }
   }
 
-  pLine0 = pLine + iStride;
-    
-  for(j = iHeight; j < iHeight + iPadY; j++)
+  if (iRowEnd == iHeight)
   {
-    fast_memcpy(pLine0,  pLine, iStride * sizeof(imgpel));
-    pLine0 += iStride;
+    pLine = pLine0 + (iHeight - 1) * iStride;
+    pLine0 = pLine + iStride;
+    for(j = iHeight; j < iHeight + iPadY; j++)
+    {
+      fast_memcpy(pLine0,  pLine, iStride * sizeof(imgpel));
+      pLine0 += iStride;
+    }
   }
 #else
   int i;
-  for(i=-iPadX; i<0; i++)
-    pImgBuf[i] = *pImgBuf;
-  for(i=0; i<iPadX; i++)
-    pImgBuf[i+iWidth] = *(pImgBuf+iWidth-1);
-
-  for(j=-iPadY; j<0; j++)
-    memcpy(pLine0+j*iStride, pLine0, iStride*sizeof(imgpel));
-  for(j=1; j<iHeight; j++)
+  for(j=iRowStart; j<iRowEnd; j++)
   {
     pLine = pLine0 + j*iStride;
     for(i=0; i<iPadX; i++)
@@ -1836,13 +2027,33 @@ void pad_buf(imgpel *pImgBuf, int iWidth, int iHeight, int iStride, int iPadX, i
     for(i=1; i<iPadX+1; i++)
       pLine[i] = *pLine;
   }
-  pLine = pLine0 + (iHeight-1)*iStride;
-  for(j=iHeight; j<iHeight+iPadY; j++)
-    memcpy(pLine0+j*iStride,  pLine, iStride*sizeof(imgpel));
+  if (iRowStart == 0 && iRowEnd > 0)
+  {
+    for(j=-iPadY; j<0; j++)
+      memcpy(pLine0+j*iStride, pLine0, iStride*sizeof(imgpel));
+  }
+  if (iRowEnd == iHeight)
+  {
+    pLine = pLine0 + (iHeight-1)*iStride;
+    for(j=iHeight; j<iHeight+iPadY; j++)
+      memcpy(pLine0+j*iStride,  pLine, iStride*sizeof(imgpel));
+  }
 #endif
 }
 
-void pad_dec_picture(VideoParameters *p_Vid, StorablePicture *dec_picture)
+void pad_buf(imgpel *pImgBuf, int iWidth, int iHeight, int iStride, int iPadX, int iPadY)
+{
+  pad_buf_rows(pImgBuf, iWidth, iHeight, iStride, iPadX, iPadY, 0, iHeight);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Pads the luma lines [iRowStart, iRowEnd) of a picture and the
+ *    corresponding chroma lines
+ ************************************************************************
+ */
+void pad_picture_rows(VideoParameters *p_Vid, StorablePicture *dec_picture, int iRowStart, int iRowEnd)
 {
   int iPadX = p_Vid->iLumaPadX;
   int iPadY = p_Vid->iLumaPadY;
@@ -1850,56 +2061,48 @@ void pad_dec_picture(VideoParameters *p_Vid, StorablePicture *dec_picture)
   int iHeight = dec_picture->size_y;
   int iStride = dec_picture->iLumaStride;
 
-  pad_buf(*dec_picture->imgY, iWidth, iHeight, iStride, iPadX, iPadY);
+  pad_buf_rows(*dec_picture->imgY, iWidth, iHeight, iStride, iPadX, iPadY, iRowStart, iRowEnd);
 
   if(dec_picture->chroma_format_idc != YUV400) 
   {
     iPadX = p_Vid->iChromaPadX;
     iPadY = p_Vid->iChromaPadY;
     iWidth = dec_picture->size_x_cr;
-    iHeight = dec_picture->size_y_cr;
     iStride = dec_picture->iChromaStride;
-    pad_buf(*dec_picture->imgUV[0], iWidth, iHeight, iStride, iPadX, iPadY);
-    pad_buf(*dec_picture->imgUV[1], iWidth, iHeight, iStride, iPadX, iPadY);
+    iRowStart = iRowStart * dec_picture->size_y_cr / iHeight;
+    iRowEnd   = iRowEnd   * dec_picture->size_y_cr / iHeight;
+    iHeight = dec_picture->size_y_cr;
+    pad_buf_rows(*dec_picture->imgUV[0], iWidth, iHeight, iStride, iPadX, iPadY, iRowStart, iRowEnd);
+    pad_buf_rows(*dec_picture->imgUV[1], iWidth, iHeight, iStride, iPadX, iPadY, iRowStart, iRowEnd);
   }
 }
 
+void pad_dec_picture(VideoParameters *p_Vid, StorablePicture *dec_picture)
+{
+  pad_picture_rows(p_Vid, dec_picture, 0, dec_picture->size_y);
+}
+
 
 /*!
  ************************************************************************
  * \brief
- *    finish decoding of a picture, conceal errors and store it
- *    into the DPB
+ *    conceal errors and deblock a reconstructed picture
  ************************************************************************
  */
-void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
+static void finish_picture_reconstruction(VideoParameters *p_Vid, StorablePicture *dec_picture, int used_for_reference)
 {
-  InputParameters *p_Inp = p_Vid->p_Inp;
-  SNRParameters   *snr   = p_Vid->snr;
-  char yuv_types[4][6]= {"4:0:0","4:2:0","4:2:2","4:4:4"};
 #if (DISABLE_ERC == 0)
   //int ercStartMB;
   int ercSegment;
   frame recfr;
-#endif
-  int structure, frame_poc, slice_type, refpic, qp, pic_num, chroma_format_idc, is_idr;
-
-  int64 tmp_time;                   // time used by decoding the last frame
-  char   yuvFormat[10];
-
-  // return if the last picture has already been finished
-  if (*dec_picture==NULL || (p_Vid->num_dec_mb != p_Vid->PicSizeInMbs && (p_Vid->yuv_format != YUV444 || !p_Vid->separate_colour_plane_flag)))
-  {
-    return;
-  }
 
-#if (DISABLE_ERC == 0)
+  DEC_PROFILE_START(p_Vid, PROF_CONCEAL);
   recfr.p_Vid = p_Vid;
-  recfr.yptr = &(*dec_picture)->imgY[0][0];
-  if ((*dec_picture)->chroma_format_idc != YUV400)
+  recfr.yptr = &dec_picture->imgY[0][0];
+  if (dec_picture->chroma_format_idc != YUV400)
   {
-    recfr.uptr = &(*dec_picture)->imgUV[0][0][0];
-    recfr.vptr = &(*dec_picture)->imgUV[1][0][0];
+    recfr.uptr = &dec_picture->imgUV[0][0][0];
+    recfr.vptr = &dec_picture->imgUV[1][0][0];
   }
 
   //! this is always true at the beginning of a picture
@@ -1907,12 +2110,12 @@ void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
   ercSegment = 0;
 
   //! mark the start of the first segment
-  if (!(*dec_picture)->mb_aff_frame_flag)
+  if (!dec_picture->mb_aff_frame_flag)
   {
     int i;
     ercStartSegment(0, ercSegment, 0 , p_Vid->erc_errorVar);
     //! generate the segments according to the macroblock map
-    for(i = 1; i < (int) (*dec_picture)->PicSizeInMbs; ++i)
+    for(i = 1; i < (int) dec_picture->PicSizeInMbs; ++i)
     {
       if(p_Vid->mb_data[i].ei_flag != p_Vid->mb_data[i-1].ei_flag)
       {
@@ -1920,9 +2123,9 @@ void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
 
         //! mark current segment as lost or OK
         if(p_Vid->mb_data[i-1].ei_flag)
-          ercMarkCurrSegmentLost((*dec_picture)->size_x, p_Vid->erc_errorVar);
+          ercMarkCurrSegmentLost(dec_picture->size_x, p_Vid->erc_errorVar);
         else
-          ercMarkCurrSegmentOK((*dec_picture)->size_x, p_Vid->erc_errorVar);
+          ercMarkCurrSegmentOK(dec_picture->size_x, p_Vid->erc_errorVar);
 
         ++ercSegment;  //! next segment
         ercStartSegment(i, ercSegment, 0 , p_Vid->erc_errorVar); //! start new segment
@@ -1930,25 +2133,26 @@ void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
       }
     }
     //! mark end of the last segment
-    ercStopSegment((*dec_picture)->PicSizeInMbs-1, ercSegment, 0, p_Vid->erc_errorVar);
+    ercStopSegment(dec_picture->PicSizeInMbs-1, ercSegment, 0, p_Vid->erc_errorVar);
     if(p_Vid->mb_data[i-1].ei_flag)
-      ercMarkCurrSegmentLost((*dec_picture)->size_x, p_Vid->erc_errorVar);
+      ercMarkCurrSegmentLost(dec_picture->size_x, p_Vid->erc_errorVar);
     else
-      ercMarkCurrSegmentOK((*dec_picture)->size_x, p_Vid->erc_errorVar);
+      ercMarkCurrSegmentOK(dec_picture->size_x, p_Vid->erc_errorVar);
 
     //! call the right error concealment function depending on the frame type.
-    p_Vid->erc_mvperMB /= (*dec_picture)->PicSizeInMbs;
+    p_Vid->erc_mvperMB /= dec_picture->PicSizeInMbs;
 
     p_Vid->erc_img = p_Vid;
 
-    if((*dec_picture)->slice_type == I_SLICE || (*dec_picture)->slice_type == SI_SLICE) // I-frame
-      ercConcealIntraFrame(p_Vid, &recfr, (*dec_picture)->size_x, (*dec_picture)->size_y, p_Vid->erc_errorVar);
+    if(dec_picture->slice_type == I_SLICE || dec_picture->slice_type == SI_SLICE) // I-frame
+      ercConcealIntraFrame(p_Vid, &recfr, dec_picture->size_x, dec_picture->size_y, p_Vid->erc_errorVar);
     else
-      ercConcealInterFrame(&recfr, p_Vid->erc_object_list, (*dec_picture)->size_x, (*dec_picture)->size_y, p_Vid->erc_errorVar, (*dec_picture)->chroma_format_idc);
+      ercConcealInterFrame(&recfr, p_Vid->erc_object_list, dec_picture->size_x, dec_picture->size_y, p_Vid->erc_errorVar, dec_picture->chroma_format_idc);
   }
+  DEC_PROFILE_STOP(p_Vid, PROF_CONCEAL);
 #endif
 
-  if(!p_Vid->iDeblockMode && (p_Vid->bDeblockEnable & (1<<(*dec_picture)->used_for_reference)))
+  if(!p_Vid->iDeblockMode && !p_Vid->iPlanesDeblocked && (p_Vid->bDeblockEnable & (1<<used_for_reference)))
   {
     //deblocking for frame or field
     if( (p_Vid->separate_colour_plane_flag != 0) )
@@ -1959,14 +2163,23 @@ void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
       {
         p_Vid->ppSliceList[0]->colour_plane_id = nplane;
         change_plane_JV( p_Vid, nplane, NULL );
-        DeblockPicture( p_Vid, *dec_picture );
+        DEC_PROFILE_START(p_Vid, PROF_DEBLOCK);
+        DeblockPicture( p_Vid, p_Vid->dec_picture );
+        DEC_PROFILE_STOP(p_Vid, PROF_DEBLOCK);
       }
       p_Vid->ppSliceList[0]->colour_plane_id = colour_plane_id;
       make_frame_picture_JV(p_Vid);
     }
+    else if (p_Vid->iDeblockRowNext > 0)
+    {
+      // remaining rows of a row pipelined picture
+      DeblockMbRowsFinish( p_Vid, dec_picture );
+    }
     else
     {
-      DeblockPicture( p_Vid, *dec_picture );
+      DEC_PROFILE_START(p_Vid, PROF_DEBLOCK);
+      DeblockPicture( p_Vid, dec_picture );
+      DEC_PROFILE_STOP(p_Vid, PROF_DEBLOCK);
     }
   }
   else
@@ -1977,20 +2190,76 @@ void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
     }
   }
 
-  if ((*dec_picture)->mb_aff_frame_flag)
+  // make_frame_picture_JV() replaces the plane picture by the combined frame
+  if (p_Vid->dec_picture->mb_aff_frame_flag)
     MbAffPostProc(p_Vid);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    decodes the slices of the current picture and finishes its
+ *    reconstruction. Used by the frame threads on their private copy
+ *    of the decoder state, the reference lists have already been
+ *    set up by init_slice().
+ ************************************************************************
+ */
+void decode_picture_slices(VideoParameters *p_Vid, int used_for_reference)
+{
+  int iSliceNo;
+
+  p_Vid->active_sps = p_Vid->ppSliceList[0]->active_sps;
+  p_Vid->active_pps = p_Vid->ppSliceList[0]->active_pps;
+
+#if (DISABLE_ERC == 0)
+  ercReset(p_Vid->erc_errorVar, p_Vid->PicSizeInMbs, p_Vid->PicSizeInMbs, p_Vid->dec_picture->size_x);
+#endif
+  p_Vid->erc_mvperMB = 0;
+  reset_mb_buffers(p_Vid);
+
+  init_Deblock(p_Vid, 0);
+  if (p_Vid->iDeblockRows)
+    reset_deblock_rows(p_Vid);
+
+  p_Vid->iNumOfSlicesDecoded = 0;
+  p_Vid->num_dec_mb = 0;
+  for(iSliceNo=0; iSliceNo<p_Vid->iSliceNumOfCurrPic; iSliceNo++)
+  {
+    Slice *currSlice = p_Vid->ppSliceList[iSliceNo];
+
+    decode_slice(currSlice, currSlice->current_header);
+
+    p_Vid->iNumOfSlicesDecoded++;
+    p_Vid->num_dec_mb += currSlice->num_dec_mb;
+    p_Vid->erc_mvperMB += currSlice->erc_mvperMB;
+  }
+
+  finish_picture_reconstruction(p_Vid, p_Vid->dec_picture, used_for_reference);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    store a decoded picture into the DPB and print its statistics
+ ************************************************************************
+ */
+static void store_decoded_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  SNRParameters   *snr   = p_Vid->snr;
+  char yuv_types[4][6]= {"4:0:0","4:2:0","4:2:2","4:4:4"};
+  int structure, frame_poc, slice_type, refpic, qp, pic_num, chroma_format_idc, is_idr;
+#if (MVC_EXTENSION_ENABLE)
+  int view_id;
+#endif
+
+  int64 tmp_time;                   // time used by decoding the last frame
+  char   yuvFormat[10];
 
   if (p_Vid->structure == FRAME)         // buffer mgt. for frame mode
     frame_postprocessing(p_Vid);
   else
     field_postprocessing(p_Vid);   // reset all interlaced variables
-#if (MVC_EXTENSION_ENABLE)
-  if((*dec_picture)->used_for_reference || ((*dec_picture)->inter_view_flag == 1))
-    pad_dec_picture(p_Vid, *dec_picture);
-#else
-  if((*dec_picture)->used_for_reference)
-    pad_dec_picture(p_Vid, *dec_picture);
-#endif
   structure  = (*dec_picture)->structure;
   slice_type = (*dec_picture)->slice_type;
   frame_poc  = (*dec_picture)->frame_poc;  
@@ -1998,6 +2267,9 @@ void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
   qp         = (*dec_picture)->qp;
   pic_num    = (*dec_picture)->pic_num;
   is_idr     = (*dec_picture)->idr_flag;
+#if (MVC_EXTENSION_ENABLE)
+  view_id    = (*dec_picture)->view_id;
+#endif
 
   chroma_format_idc = (*dec_picture)->chroma_format_idc;
 #if MVC_EXTENSION_ENABLE
@@ -2008,6 +2280,9 @@ void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
 
   *dec_picture=NULL;
 
+  if (p_Vid->dec_profile)
+    dec_profile_picture(p_Vid->dec_profile, frame_poc, structure, slice_type);
+
   if (p_Vid->last_has_mmco_5)
   {
     p_Vid->pre_frame_num = 0;
@@ -2091,7 +2366,7 @@ void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
     if(slice_type == I_SLICE || slice_type == SI_SLICE || slice_type == P_SLICE || refpic)   // I or P pictures
     {
 #if (MVC_EXTENSION_ENABLE)
-      if((p_Vid->ppSliceList[0])->view_id!=0)
+      if(view_id!=0)
 #endif
         ++(p_Vid->number);
     }
@@ -2100,7 +2375,7 @@ void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
     ++(snr->frame_ctr);
 
 #if (MVC_EXTENSION_ENABLE)
-    if ((p_Vid->ppSliceList[0])->view_id != 0)
+    if (view_id != 0)
 #endif
       ++(p_Vid->g_nFrame);   
   }
@@ -2109,6 +2384,35 @@ void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
   //p_Vid->currentSlice->current_slice_nr = 0;
 }
 
+/*!
+ ************************************************************************
+ * \brief
+ *    finish decoding of a picture, conceal errors and store it
+ *    into the DPB
+ ************************************************************************
+ */
+void exit_picture(VideoParameters *p_Vid, StorablePicture **dec_picture)
+{
+  // return if the last picture has already been finished
+  if (*dec_picture==NULL || (p_Vid->num_dec_mb != p_Vid->PicSizeInMbs && (p_Vid->yuv_format != YUV444 || !p_Vid->separate_colour_plane_flag)))
+  {
+    return;
+  }
+
+  DEC_PROFILE_SLICE(p_Vid, (*dec_picture)->slice_type);
+  finish_picture_reconstruction(p_Vid, *dec_picture, (*dec_picture)->used_for_reference);
+
+#if (MVC_EXTENSION_ENABLE)
+  if((*dec_picture)->used_for_reference || ((*dec_picture)->inter_view_flag == 1))
+    pad_dec_picture(p_Vid, *dec_picture);
+#else
+  if((*dec_picture)->used_for_reference)
+    pad_dec_picture(p_Vid, *dec_picture);
+#endif
+
+  store_decoded_picture(p_Vid, dec_picture);
+}
+
 /*!
  ************************************************************************
  * \brief
@@ -2444,8 +2748,12 @@ static void init_cur_imgy(Slice *currSlice, VideoParameters *p_Vid)
           StorablePicture *curr_ref = currSlice->listX[j][i];
           if (curr_ref) 
           {
-            curr_ref->no_ref = noref && (curr_ref == vidref);
-            curr_ref->cur_imgY = curr_ref->imgY;
+            // only write on change, the reference is read by the other plane threads
+            int no_ref = noref && (curr_ref == vidref);
+            if (curr_ref->no_ref != no_ref)
+              curr_ref->no_ref = no_ref;
+            if (curr_ref->cur_imgY != curr_ref->imgY)
+              curr_ref->cur_imgY = curr_ref->imgY;
           }
         }
       }
@@ -2469,8 +2777,12 @@ static void init_cur_imgy(Slice *currSlice, VideoParameters *p_Vid)
         StorablePicture *curr_ref = currSlice->listX[j][i];
         if (curr_ref) 
         {
-          curr_ref->no_ref = noref && (curr_ref == vidref);
-          curr_ref->cur_imgY = curr_ref->imgY;
+          // only write on change, the reference may be read by other frame threads
+          int no_ref = noref && (curr_ref == vidref);
+          if (curr_ref->no_ref != no_ref)
+            curr_ref->no_ref = no_ref;
+          if (curr_ref->cur_imgY != curr_ref->imgY)
+            curr_ref->cur_imgY = curr_ref->imgY;
         }
       }
     }
@@ -2490,6 +2802,7 @@ void decode_one_slice(Slice *currSlice)
   VideoParameters *p_Vid = currSlice->p_Vid;
   Boolean end_of_slice = FALSE;
   Macroblock *currMB = NULL;
+  StorablePicture *colocated = NULL;
   currSlice->cod_counter=-1;
 
   if( (p_Vid->separate_colour_plane_flag != 0) )
@@ -2499,6 +2812,7 @@ void decode_one_slice(Slice *currSlice)
   else
   {
     currSlice->mb_data = p_Vid->mb_data;
+    currSlice->mb_mvd = p_Vid->mb_mvd;
     currSlice->dec_picture = p_Vid->dec_picture;
     currSlice->siblock = p_Vid->siblock;
     currSlice->ipredmode = p_Vid->ipredmode;
@@ -2508,12 +2822,16 @@ void decode_one_slice(Slice *currSlice)
   if (currSlice->slice_type == B_SLICE)
   {
     compute_colocated(currSlice, currSlice->listX);
+    // direct prediction reads the motion of a picture that may still be reconstructed
+    if (currSlice->listX[LIST_1][0] && load_acquire(&currSlice->listX[LIST_1][0]->iDecodedRows) != INT_MAX)
+      colocated = currSlice->listX[LIST_1][0];
   }
 
   if (currSlice->slice_type != I_SLICE && currSlice->slice_type != SI_SLICE)
     init_cur_imgy(currSlice,p_Vid); 
 
   //reset_ec_flags(p_Vid);
+  DEC_PROFILE_SLICE(p_Vid, currSlice->slice_type);
 
   while (end_of_slice == FALSE) // loop over macroblocks
   {
@@ -2524,9 +2842,18 @@ void decode_one_slice(Slice *currSlice)
 
     // Initializes the current macroblock
     start_macroblock(currSlice, &currMB);
+    if (colocated)
+      wait_picture_rows(colocated, currMB->mb.y + 1);
     // Get the syntax elements from the NAL
+    DEC_PROFILE_START(p_Vid, PROF_ENTROPY);
     currSlice->read_one_macroblock(currMB);
+    DEC_PROFILE_STOP(p_Vid, PROF_ENTROPY);
+    DEC_PROFILE_START(p_Vid, PROF_RECON);
     decode_one_macroblock(currMB, currSlice->dec_picture);
+    DEC_PROFILE_STOP(p_Vid, PROF_RECON);
+
+    if (p_Vid->iDeblockRows)
+      DeblockMbRowsUpdate(p_Vid, currSlice->dec_picture, currMB);
 
     if(currSlice->mb_aff_frame_flag && currMB->mb_field)
     {
@@ -21,6 +21,7 @@ extern int  picture_order     ( Slice *pSlice );
 extern void decode_one_slice  (Slice *currSlice);
 extern int  read_new_slice    (Slice *currSlice);
 extern void exit_picture      (VideoParameters *p_Vid, StorablePicture **dec_picture);
+extern void decode_picture_slices(VideoParameters *p_Vid, int used_for_reference);
 extern int  decode_one_frame  (DecoderParams *pDecoder);
 
 extern int  is_new_picture(StorablePicture *dec_picture, Slice *currSlice, OldSliceParams *p_old_slice);
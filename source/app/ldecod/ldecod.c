@@ -69,6 +69,11 @@
 #include "output.h"
 #include "h264decoder.h"
 #include "dec_statistics.h"
+#include "dec_profile.h"
+#include "frame_thread.h"
+#include "plane_thread.h"
+#include "rap_index.h"
+#include "mb_access.h"
 
 #define LOGFILE     "log.dec"
 #define DATADECFILE "dataDec.txt"
@@ -82,7 +87,6 @@ char errortext[ET_SIZE];
 // Prototypes of static functions
 static void Report      (VideoParameters *p_Vid);
 static void init        (VideoParameters *p_Vid);
-static void free_slice  (Slice *currSlice);
 
 void init_frext(VideoParameters *p_Vid);
 
@@ -296,6 +300,7 @@ static void free_img( VideoParameters *p_Vid)
     delete_dec_stats(p_Vid->dec_stats);
     free (p_Vid->dec_stats);
 #endif
+    delete_dec_profile(p_Vid->dec_profile);
 
     free (p_Vid);
     p_Vid = NULL;
@@ -309,7 +314,7 @@ void FreeDecPicList(DecodedPicList *pDecPicList)
     DecodedPicList *pPicNext = pDecPicList->pNext;
     if(pDecPicList->pY)
     {
-      free(pDecPicList->pY);
+      mem_free(pDecPicList->pY);
       pDecPicList->pY = NULL;
       pDecPicList->pU = NULL;
       pDecPicList->pV = NULL;
@@ -510,6 +515,7 @@ static void Report(VideoParameters *p_Vid)
     fprintf(stdout," SNR U(dB)           : %5.2f\n",snr->snra[1]);
     fprintf(stdout," SNR V(dB)           : %5.2f\n",snr->snra[2]);
     fprintf(stdout," Total decoding time : %.3f sec (%.3f fps)[%d frm/%" FORMAT_OFF_T " ms]\n",p_Vid->tot_time*0.001,(snr->frame_ctr ) * 1000.0 / p_Vid->tot_time, snr->frame_ctr, p_Vid->tot_time);
+    print_mem_usage(stdout, 20);
     fprintf(stdout,"--------------------------------------------------------------------------\n");
     fprintf(stdout," Exit JM %s decoder, ver %s ",JM, VERSION);
     fprintf(stdout,"\n");
@@ -518,6 +524,7 @@ static void Report(VideoParameters *p_Vid)
   {
     fprintf(stdout,"\n----------------------- Decoding Completed -------------------------------\n");
     fprintf(stdout," Total decoding time : %.3f sec (%.3f fps)[%d frm/%" FORMAT_OFF_T "  ms]\n",p_Vid->tot_time*0.001, (snr->frame_ctr) * 1000.0 / p_Vid->tot_time, snr->frame_ctr, p_Vid->tot_time);
+    print_mem_usage(stdout, 20);
     fprintf(stdout,"--------------------------------------------------------------------------\n");
     fprintf(stdout," Exit JM %s decoder, ver %s ",JM, VERSION);
     fprintf(stdout,"\n");
@@ -730,8 +737,9 @@ Slice *malloc_slice(InputParameters *p_Inp, VideoParameters *p_Vid)
 {
   int i, j, memory_size = 0;
   Slice *currSlice;
+  MemTag mem_tag = mem_set_tag(MEM_SLICE);
 
-  currSlice = (Slice *) calloc(1, sizeof(Slice));
+  currSlice = (Slice *) mem_calloc(1, sizeof(Slice));
   if ( currSlice  == NULL)
   {
     snprintf(errortext, ET_SIZE, "Memory allocation for Slice datastruct in NAL-mode %d failed", p_Inp->FileFormat);
@@ -769,7 +777,7 @@ Slice *malloc_slice(InputParameters *p_Inp, VideoParameters *p_Vid)
   }
   for (i = 0; i < 6; i++)
   {
-    currSlice->listX[i] = calloc(MAX_LIST_SIZE, sizeof (StorablePicture*)); // +1 for reordering
+    currSlice->listX[i] = mem_calloc(MAX_LIST_SIZE, sizeof (StorablePicture*)); // +1 for reordering
     if (NULL==currSlice->listX[i])
       no_mem_exit("malloc_slice: currSlice->listX[i]");
   }
@@ -781,6 +789,7 @@ Slice *malloc_slice(InputParameters *p_Inp, VideoParameters *p_Vid)
     }
     currSlice->listXsize[j]=0;
   }
+  mem_set_tag(mem_tag);
 
   return currSlice;
 }
@@ -796,7 +805,7 @@ Slice *malloc_slice(InputParameters *p_Inp, VideoParameters *p_Vid)
  *    Input Parameters Slice *currSlice
  ************************************************************************
  */
-static void free_slice(Slice *currSlice)
+void free_slice(Slice *currSlice)
 {
   int i;
 
@@ -826,7 +835,7 @@ static void free_slice(Slice *currSlice)
   {
     if (currSlice->listX[i])
     {
-      free (currSlice->listX[i]);
+      mem_free(currSlice->listX[i]);
       currSlice->listX[i] = NULL;
     }
   }
@@ -837,7 +846,7 @@ static void free_slice(Slice *currSlice)
     free (tmp_drpm);
   }
 
-  free(currSlice);
+  mem_free(currSlice);
   currSlice = NULL;
 }
 
@@ -861,11 +870,13 @@ int init_global_buffers(VideoParameters *p_Vid, int layer_id)
   int i;
   CodingParameters *cps = p_Vid->p_EncodePar[layer_id];
   BlockPos* PicPos;
+  MemTag mem_tag;
 
   if (p_Vid->global_init_done[layer_id])
   {
     free_layer_buffers(p_Vid, layer_id);
   }
+  mem_tag = mem_set_tag(MEM_MB);
 
   // allocate memory for reference frame in find_snr
   memory_size += get_mem2Dpel(&cps->imgY_ref, cps->height, cps->width);
@@ -881,34 +892,44 @@ int init_global_buffers(VideoParameters *p_Vid, int layer_id)
   {
     for( i=0; i<MAX_PLANE; ++i )
     {
-      if(((cps->mb_data_JV[i]) = (Macroblock *) calloc(cps->FrameSizeInMbs, sizeof(Macroblock))) == NULL)
+      if(((cps->mb_data_JV[i]) = (Macroblock *) mem_calloc(cps->FrameSizeInMbs, sizeof(Macroblock))) == NULL)
         no_mem_exit("init_global_buffers: cps->mb_data_JV");
+      if(((cps->mb_mvd_JV[i]) = (MbMvd *) mem_calloc(cps->FrameSizeInMbs, sizeof(MbMvd))) == NULL)
+        no_mem_exit("init_global_buffers: cps->mb_mvd_JV");
+      if(((cps->mb_strength_JV[i]) = (MbStrength *) mem_calloc(cps->FrameSizeInMbs, sizeof(MbStrength))) == NULL)
+        no_mem_exit("init_global_buffers: cps->mb_strength_JV");
     }
     cps->mb_data = NULL;
+    cps->mb_mvd = NULL;
+    cps->mb_strength = NULL;
   }
   else
   {
-    if(((cps->mb_data) = (Macroblock *) calloc(cps->FrameSizeInMbs, sizeof(Macroblock))) == NULL)
+    if(((cps->mb_data) = (Macroblock *) mem_calloc(cps->FrameSizeInMbs, sizeof(Macroblock))) == NULL)
       no_mem_exit("init_global_buffers: cps->mb_data");
+    if(((cps->mb_mvd) = (MbMvd *) mem_calloc(cps->FrameSizeInMbs, sizeof(MbMvd))) == NULL)
+      no_mem_exit("init_global_buffers: cps->mb_mvd");
+    if(((cps->mb_strength) = (MbStrength *) mem_calloc(cps->FrameSizeInMbs, sizeof(MbStrength))) == NULL)
+      no_mem_exit("init_global_buffers: cps->mb_strength");
   }
   if( (cps->separate_colour_plane_flag != 0) )
   {
     for( i=0; i<MAX_PLANE; ++i )
     {
-      if(((cps->intra_block_JV[i]) = (char*) calloc(cps->FrameSizeInMbs, sizeof(char))) == NULL)
+      if(((cps->intra_block_JV[i]) = (char*) mem_calloc(cps->FrameSizeInMbs, sizeof(char))) == NULL)
         no_mem_exit("init_global_buffers: cps->intra_block_JV");
     }
     cps->intra_block = NULL;
   }
   else
   {
-    if(((cps->intra_block) = (char*) calloc(cps->FrameSizeInMbs, sizeof(char))) == NULL)
+    if(((cps->intra_block) = (char*) mem_calloc(cps->FrameSizeInMbs, sizeof(char))) == NULL)
       no_mem_exit("init_global_buffers: cps->intra_block");
   }
 
 
   //memory_size += get_mem2Dint(&PicPos,p_Vid->FrameSizeInMbs + 1,2);  //! Helper array to access macroblock positions. We add 1 to also consider last MB.
-  if(((cps->PicPos) = (BlockPos*) calloc(cps->FrameSizeInMbs + 1, sizeof(BlockPos))) == NULL)
+  if(((cps->PicPos) = (BlockPos*) mem_calloc(cps->FrameSizeInMbs + 1, sizeof(BlockPos))) == NULL)
     no_mem_exit("init_global_buffers: PicPos");
 
   PicPos = cps->PicPos;
@@ -918,6 +939,10 @@ int init_global_buffers(VideoParameters *p_Vid, int layer_id)
     PicPos[i].y = (short) (i / cps->PicWidthInMbs);
   }
 
+  if(((cps->PicNeighbours) = (MbNeighbours*) mem_calloc(cps->FrameSizeInMbs, sizeof(MbNeighbours))) == NULL)
+    no_mem_exit("init_global_buffers: PicNeighbours");
+  init_mb_neighbours(cps->PicNeighbours, cps->PicWidthInMbs, cps->FrameSizeInMbs);
+
   if( (cps->separate_colour_plane_flag != 0) )
   {
     for( i=0; i<MAX_PLANE; ++i )
@@ -953,6 +978,7 @@ int init_global_buffers(VideoParameters *p_Vid, int layer_id)
   else
     cps->img2buf = p_Vid->p_EncodePar[0]->img2buf;
   p_Vid->global_init_done[layer_id] = 1;
+  mem_set_tag(mem_tag);
 
   return (memory_size);
 }
@@ -1002,13 +1028,17 @@ void free_layer_buffers(VideoParameters *p_Vid, int layer_id)
     int i;
     for(i=0; i<MAX_PLANE; i++)
     {
-      free(cps->mb_data_JV[i]);
+      mem_free(cps->mb_data_JV[i]);
       cps->mb_data_JV[i] = NULL;
+      mem_free(cps->mb_mvd_JV[i]);
+      cps->mb_mvd_JV[i] = NULL;
+      mem_free(cps->mb_strength_JV[i]);
+      cps->mb_strength_JV[i] = NULL;
       free_mem2Dint(cps->siblock_JV[i]);
       cps->siblock_JV[i] = NULL;
       free_mem2D(cps->ipredmode_JV[i]);
       cps->ipredmode_JV[i] = NULL;
-      free (cps->intra_block_JV[i]);
+      mem_free(cps->intra_block_JV[i]);
       cps->intra_block_JV[i] = NULL;
     }   
   }
@@ -1016,8 +1046,12 @@ void free_layer_buffers(VideoParameters *p_Vid, int layer_id)
   {
     if (cps->mb_data != NULL)
     {
-      free(cps->mb_data);
+      mem_free(cps->mb_data);
       cps->mb_data = NULL;
+      mem_free(cps->mb_mvd);
+      cps->mb_mvd = NULL;
+      mem_free(cps->mb_strength);
+      cps->mb_strength = NULL;
     }
     if(cps->siblock)
     {
@@ -1031,15 +1065,20 @@ void free_layer_buffers(VideoParameters *p_Vid, int layer_id)
     }
     if(cps->intra_block)
     {
-      free (cps->intra_block);
+      mem_free(cps->intra_block);
       cps->intra_block = NULL;
     }
   }
   if(cps->PicPos)
   {
-    free(cps->PicPos);
+    mem_free(cps->PicPos);
     cps->PicPos = NULL;
   }
+  if(cps->PicNeighbours)
+  {
+    mem_free(cps->PicNeighbours);
+    cps->PicNeighbours = NULL;
+  }
 
   free_qp_matrices(cps);
 
@@ -1054,6 +1093,12 @@ void free_global_buffers(VideoParameters *p_Vid)
     free_storable_picture(p_Vid->dec_picture);
     p_Vid->dec_picture = NULL;
   }
+  if (p_Vid->iMbRowDecoded)
+  {
+    free(p_Vid->iMbRowDecoded);
+    p_Vid->iMbRowDecoded = NULL;
+    p_Vid->iMbRowDecodedSize = 0;
+  }
 #if MVC_EXTENSION_ENABLE
   if(p_Vid->active_subset_sps && p_Vid->active_subset_sps->sps.Valid && (p_Vid->active_subset_sps->sps.profile_idc==MVC_HIGH||p_Vid->active_subset_sps->sps.profile_idc == STEREO_HIGH))
     free_img_data( p_Vid, &(p_Vid->tempData3) );
@@ -1141,6 +1186,8 @@ int OpenDecoder(InputParameters *p_Inp)
   pDecoder->p_Vid->conceal_mode = p_Inp->conceal_mode;
   pDecoder->p_Vid->ref_poc_gap = p_Inp->ref_poc_gap;
   pDecoder->p_Vid->poc_gap = p_Inp->poc_gap;
+  if ((strcasecmp(p_Inp->profile_file, "\"\"")!=0) && (strlen(p_Inp->profile_file)>0))
+    pDecoder->p_Vid->dec_profile = init_dec_profile();
 #if TRACE
   if ((pDecoder->p_trace = fopen(TRACEFILE,"w"))==0)             // append new statistic at the end
   {
@@ -1224,12 +1271,20 @@ int OpenDecoder(InputParameters *p_Inp)
  
   init_out_buffer(pDecoder->p_Vid);
 
+  init_frame_threads(pDecoder->p_Vid);
+  init_plane_threads(pDecoder->p_Vid);
+
 #if (MVC_EXTENSION_ENABLE)
   pDecoder->p_Vid->active_sps = NULL;
   pDecoder->p_Vid->active_subset_sps = NULL;
   init_subset_sps_list(pDecoder->p_Vid->SubsetSeqParSet, MAXSPS);
 #endif
 
+  if (pDecoder->p_Inp->build_index)
+    build_rap_index(pDecoder->p_Vid);
+  if (pDecoder->p_Inp->seek_picture > 0)
+    seek_rap_index(pDecoder->p_Vid);
+
 
 #if _FLTDBG_
   pDecoder->p_Vid->fpDbg = fopen("c:/fltdbg.txt", "a");
@@ -1275,6 +1330,7 @@ int FinitDecoder(DecodedPicList **ppDecPicList)
   if(!pDecoder)
     return DEC_GEN_NOERR;
   ClearDecPicList(pDecoder->p_Vid);
+  frame_threads_drain(pDecoder->p_Vid);
 #if (MVC_EXTENSION_ENABLE)
   flush_dpb(pDecoder->p_Vid->p_Dpb_layer[0]);
   flush_dpb(pDecoder->p_Vid->p_Dpb_layer[1]);
@@ -1302,7 +1358,12 @@ int CloseDecoder()
   if(!pDecoder)
     return DEC_CLOSE_NOERR;
   
+  frame_threads_drain(pDecoder->p_Vid);
   Report  (pDecoder->p_Vid);
+  if (pDecoder->p_Vid->dec_profile)
+    write_dec_profile(pDecoder->p_Vid->dec_profile, pDecoder->p_Inp->profile_file);
+  if ((strcasecmp(pDecoder->p_Inp->memory_file, "\"\"")!=0) && (strlen(pDecoder->p_Inp->memory_file)>0))
+    write_mem_usage(pDecoder->p_Inp->memory_file);
   FmoFinit(pDecoder->p_Vid);
   free_layer_buffers(pDecoder->p_Vid, 0);
   free_layer_buffers(pDecoder->p_Vid, 1);
@@ -1353,6 +1414,8 @@ int CloseDecoder()
 
 
   uninit_out_buffer(pDecoder->p_Vid);
+  free_frame_threads(pDecoder->p_Vid);
+  free_plane_threads(pDecoder->p_Vid);
 #if _FLTDBG_
   if(pDecoder->p_Vid->fpDbg)
   {
@@ -25,6 +25,8 @@
 #include "mb_access.h"
 #include "loopfilter.h"
 #include "loop_filter.h"
+#include "dec_profile.h"
+#include "frame_thread.h"
 
 static void DeblockMb      (VideoParameters *p_Vid, StorablePicture *p, int MbQAddr);
 static void perform_db     (VideoParameters *p_Vid, StorablePicture *p, int MbQAddr);
@@ -117,6 +119,101 @@ void DeblockPicture(VideoParameters *p_Vid, StorablePicture *p)
 }
 #endif
 
+/*!
+ *****************************************************************************************
+ * \brief
+ *    Filter one macroblock row of a non-MBAFF picture.
+ *****************************************************************************************
+ */
+static void DeblockMbRow(VideoParameters *p_Vid, StorablePicture *p, int row)
+{
+  int i;
+  int first = row * p->PicWidthInMbs;
+  int last  = first + p->PicWidthInMbs;
+
+  for (i = first; i < last; ++i)
+  {
+    get_db_strength( p_Vid, p, i ) ;
+  }
+  for (i = first; i < last; ++i)
+  {
+    perform_db( p_Vid, p, i ) ;
+  }
+}
+
+/*!
+ *****************************************************************************************
+ * \brief
+ *    returns 1 if the next macroblock row to filter and the row below it are reconstructed
+ *****************************************************************************************
+ */
+static inline int deblock_row_ready(VideoParameters *p_Vid, int width, int height)
+{
+  int row = p_Vid->iDeblockRowNext;
+
+  return row < height && p_Vid->iMbRowDecoded[row] == width
+    && (row + 1 == height || p_Vid->iMbRowDecoded[row + 1] == width);
+}
+
+/*!
+ *****************************************************************************************
+ * \brief
+ *    Row pipelined deblocking. Registers a reconstructed macroblock and filters every
+ *    macroblock row whose lower neighbour row is reconstructed as well. Intra prediction
+ *    of row N+1 only reads unfiltered samples of row N, while filtering row N only
+ *    modifies rows N-1 and N, so rows can be filtered in raster order as soon as
+ *    row N+1 is complete, while the samples are still in cache.
+ *****************************************************************************************
+ */
+void DeblockMbRowsUpdate(VideoParameters *p_Vid, StorablePicture *p, Macroblock *currMB)
+{
+  int row = currMB->mb.y;
+  int height = p_Vid->PicHeightInMbs;
+  int width  = p->PicWidthInMbs;
+
+  if (currMB->ei_flag)
+  {
+    // lost data must be concealed before filtering; leave the remaining rows to exit_picture()
+    p_Vid->iDeblockRows = 0;
+    return;
+  }
+
+  ++p_Vid->iMbRowDecoded[row];
+
+  if (deblock_row_ready(p_Vid, width, height))
+  {
+    DEC_PROFILE_START(p_Vid, PROF_DEBLOCK);
+    do
+    {
+      DeblockMbRow(p_Vid, p, p_Vid->iDeblockRowNext++);
+    } while (deblock_row_ready(p_Vid, width, height));
+    DEC_PROFILE_STOP(p_Vid, PROF_DEBLOCK);
+  }
+
+  // the rows above the last filtered one are final, publish them to the other frame threads
+  if (p->iDecodedRows < p_Vid->iDeblockRowNext - 1)
+    frame_threads_progress(p_Vid, p, p_Vid->iDeblockRowNext - 1);
+}
+
+/*!
+ *****************************************************************************************
+ * \brief
+ *    Filter all macroblock rows not yet handled by DeblockMbRowsUpdate().
+ *****************************************************************************************
+ */
+void DeblockMbRowsFinish(VideoParameters *p_Vid, StorablePicture *p)
+{
+  int height = p_Vid->PicHeightInMbs;
+
+  DEC_PROFILE_START(p_Vid, PROF_DEBLOCK);
+  while (p_Vid->iDeblockRowNext < height)
+  {
+    DeblockMbRow(p_Vid, p, p_Vid->iDeblockRowNext++);
+  }
+  DEC_PROFILE_STOP(p_Vid, PROF_DEBLOCK);
+  p_Vid->iDeblockRows = 0;
+}
+
 // likely already set - see testing via asserts
 static void init_neighbors(VideoParameters *p_Vid)
 {
@@ -163,15 +260,15 @@ void  init_Deblock(VideoParameters *p_Vid, int mb_aff_frame_flag)
   if(p_Vid->yuv_format == YUV444 && p_Vid->separate_colour_plane_flag)
   {
     change_plane_JV(p_Vid, PLANE_Y, NULL);
-    init_neighbors(p_Dec->p_Vid);
+    init_neighbors(p_Vid);
     change_plane_JV(p_Vid, PLANE_U, NULL);
-    init_neighbors(p_Dec->p_Vid);
+    init_neighbors(p_Vid);
     change_plane_JV(p_Vid, PLANE_V, NULL);
-    init_neighbors(p_Dec->p_Vid);
+    init_neighbors(p_Vid);
     change_plane_JV(p_Vid, PLANE_Y, NULL);
   }
   else 
-    init_neighbors(p_Dec->p_Vid);
+    init_neighbors(p_Vid);
   if (mb_aff_frame_flag == 1) 
   {
     set_loop_filter_functions_mbaff(p_Vid);
@@ -557,7 +654,7 @@ static void perform_db(VideoParameters *p_Vid, StorablePicture *p, int MbQAddr)
 
       if( edge || filterLeftMbEdgeFlag )
       {      
-        byte *Strength = MbQ->strength_ver[edge];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[edge];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the 4 first Strength bytes is != 0
         {
@@ -602,7 +699,7 @@ static void perform_db(VideoParameters *p_Vid, StorablePicture *p, int MbQAddr)
 
       if( edge || filterTopMbEdgeFlag )
       {
-        byte *Strength = MbQ->strength_hor[edge];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[edge];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] !=0 ||
         Strength[4] != 0 || Strength[5] != 0 || Strength[6] != 0 || Strength[7] !=0 ||
@@ -85,7 +85,7 @@ Macroblock* get_non_aff_neighbor_chroma(Macroblock *mb, int xN, int yN, int bloc
  */
 void get_strength_ver_MBAff(byte *Strength, Macroblock *MbQ, int edge, int mvlimit, StorablePicture *p)
 {
-  //byte *Strength = MbQ->strength_ver[edge];
+  //byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[edge];
   short  blkP, blkQ, idx;
   //short  blk_x, blk_x2, blk_y, blk_y2 ;
 
@@ -1044,7 +1044,7 @@ void perform_db_mbaff(VideoParameters *p_Vid, StorablePicture *p, int MbQAddr)
 
       if( edge || filterLeftMbEdgeFlag )
       {      
-        byte *Strength = MbQ->strength_ver[edge];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[edge];
 
         if ((*((int64 *) Strength)) || ((*(((int64 *) Strength) + 1)))) // only if one of the 16 Strength bytes is != 0
         {
@@ -1089,7 +1089,7 @@ void perform_db_mbaff(VideoParameters *p_Vid, StorablePicture *p, int MbQAddr)
 
       if( edge || filterTopMbEdgeFlag )
       {
-        byte *Strength = MbQ->strength_hor[edge];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[edge];
 
         if ((*((int64 *) Strength)) || ((*(((int64 *) Strength) + 1)))) // only if one of the 16 Strength bytes is != 0
         {
@@ -92,7 +92,7 @@ static Macroblock* get_non_aff_neighbor_chroma(Macroblock *mb, int xN, int yN, i
  */
 static void get_strength_ver(Macroblock *MbQ, int edge, int mvlimit, StorablePicture *p)
 {
-  byte *Strength = MbQ->strength_ver[edge];
+  byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[edge];
   Slice *currSlice = MbQ->p_Slice;
   int     StrValue, i;
   BlockPos *PicPos = MbQ->p_Vid->PicPos;
@@ -222,7 +222,7 @@ static void get_strength_ver(Macroblock *MbQ, int edge, int mvlimit, StorablePic
  */
 static void get_strength_hor(Macroblock *MbQ, int edge, int mvlimit, StorablePicture *p)
 {  
-  byte  *Strength = MbQ->strength_hor[edge];
+  byte  *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[edge];
   int    StrValue, i;
   Slice *currSlice = MbQ->p_Slice;
   BlockPos *PicPos = MbQ->p_Vid->PicPos;
@@ -981,7 +981,7 @@ static void perform_db_dep_normal(Macroblock   *MbQ, StorablePicture *p)
 
       if( edge || filterLeftMbEdgeFlag )
       {      
-        byte *Strength = MbQ->strength_ver[edge];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[edge];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
         {
@@ -1007,7 +1007,7 @@ static void perform_db_dep_normal(Macroblock   *MbQ, StorablePicture *p)
 
       if( edge || filterTopMbEdgeFlag )
       {
-        byte *Strength = MbQ->strength_hor[edge];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[edge];
 
         if (Strength[0]!=0 || Strength[1]!=0 || Strength[2]!=0 || Strength[3]!=0) // only if one of the 16 Strength bytes is != 0
         {
@@ -1037,7 +1037,7 @@ static void perform_db_dep_normal(Macroblock   *MbQ, StorablePicture *p)
 
       if( edge || filterLeftMbEdgeFlag )
       {      
-        byte *Strength = MbQ->strength_ver[edge];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[edge];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
         {              
@@ -1065,7 +1065,7 @@ static void perform_db_dep_normal(Macroblock   *MbQ, StorablePicture *p)
 
       if( edge || filterTopMbEdgeFlag )
       {
-        byte *Strength = MbQ->strength_hor[edge];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[edge];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
         {
@@ -1115,7 +1115,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
     {
       if( edge || filterLeftMbEdgeFlag )
       {      
-        byte *Strength = MbQ->strength_ver[edge];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[edge];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
         {
@@ -1139,7 +1139,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
     {
       if( edge || filterTopMbEdgeFlag )
       {
-        byte *Strength = MbQ->strength_hor[edge];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[edge];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
         {
@@ -1165,7 +1165,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
       // Vertical deblocking
       if( filterLeftMbEdgeFlag )
       {      
-        byte *Strength = MbQ->strength_ver[0];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[0];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
         {
@@ -1186,7 +1186,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
 
       if( filterTopMbEdgeFlag )
       {
-        byte *Strength = MbQ->strength_hor[0];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[0];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
         {
@@ -1209,7 +1209,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
       // Vertical deblocking
       if( filterLeftMbEdgeFlag )
       {      
-        byte *Strength = MbQ->strength_ver[0];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[0];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
         {
@@ -1231,7 +1231,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
       {
         if( edge || filterTopMbEdgeFlag )
         {
-          byte *Strength = MbQ->strength_hor[edge];
+          byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[edge];
 
           if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
           {
@@ -1258,7 +1258,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
       {
         if( edge || filterLeftMbEdgeFlag )
         {      
-          byte *Strength = MbQ->strength_ver[edge];
+          byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[edge];
 
           if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
           {
@@ -1280,7 +1280,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
       // horizontal deblocking  
       if( filterTopMbEdgeFlag )
       {
-        byte *Strength = MbQ->strength_hor[0];
+        byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[0];
 
         if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
         {
@@ -1305,7 +1305,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
       {
         if( edge || filterLeftMbEdgeFlag )
         {      
-          byte *Strength = MbQ->strength_ver[edge];
+          byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[edge];
 
           if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
           {
@@ -1329,7 +1329,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
       {
         if( edge || filterTopMbEdgeFlag )
         {
-          byte *Strength = MbQ->strength_hor[edge];
+          byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[edge];
 
           if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
           {
@@ -1356,7 +1356,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
       {
         if( edge || filterLeftMbEdgeFlag )
         {      
-          byte *Strength = MbQ->strength_ver[edge];
+          byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].ver[edge];
 
           if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
           {
@@ -1380,7 +1380,7 @@ static void perform_db_ind_normal(Macroblock *MbQ, StorablePicture *p)
       {
         if( edge || filterTopMbEdgeFlag )
         {
-          byte *Strength = MbQ->strength_hor[edge];
+          byte *Strength = MbQ->p_Vid->mb_strength[MbQ->mbAddrX].hor[edge];
 
           if ( Strength[0] != 0 || Strength[1] != 0 || Strength[2] != 0 || Strength[3] != 0 ) // only if one of the first 4 Strength bytes is != 0
           {
@@ -14,6 +14,8 @@
 #include "mbuffer.h"
 
 extern void DeblockPicture(VideoParameters *p_Vid, StorablePicture *p) ;
+extern void DeblockMbRowsUpdate(VideoParameters *p_Vid, StorablePicture *p, Macroblock *currMB);
+extern void DeblockMbRowsFinish(VideoParameters *p_Vid, StorablePicture *p);
 
 void  init_Deblock(VideoParameters *p_Vid, int mb_aff_frame_flag);
 #endif //_LOOPFILTER_H_
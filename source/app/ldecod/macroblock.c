@@ -153,18 +153,18 @@ static void prepareListforRefIdx ( Macroblock *currMB, SyntaxElement *currSE, Da
     {
       currSE->mapping = linfo_ue;
       if (refidx_present)
-        currMB->readRefPictureIdx = (num_ref_idx_active == 2) ? readRefPictureIdx_FLC : readRefPictureIdx_VLC;
+        currMB->p_Slice->readRefPictureIdx = (num_ref_idx_active == 2) ? readRefPictureIdx_FLC : readRefPictureIdx_VLC;
       else
-        currMB->readRefPictureIdx = readRefPictureIdx_Null;
+        currMB->p_Slice->readRefPictureIdx = readRefPictureIdx_Null;
     }
     else
     {
       currSE->reading = readRefFrame_CABAC;
-      currMB->readRefPictureIdx = (refidx_present) ? readRefPictureIdx_VLC : readRefPictureIdx_Null;
+      currMB->p_Slice->readRefPictureIdx = (refidx_present) ? readRefPictureIdx_VLC : readRefPictureIdx_Null;
     }
   }
   else
-    currMB->readRefPictureIdx = readRefPictureIdx_Null; 
+    currMB->p_Slice->readRefPictureIdx = readRefPictureIdx_Null; 
 }
 
 void set_chroma_qp(Macroblock* currMB)
@@ -248,7 +248,7 @@ static void readMBRefPictureIdx (SyntaxElement *currSE, DataPartition *dP, Macro
 
       currMB->subblock_x = 0;
       currMB->subblock_y = 0;
-      refframe = currMB->readRefPictureIdx(currMB, currSE, dP, 1, list);
+      refframe = currMB->p_Slice->readRefPictureIdx(currMB, currSE, dP, 1, list);
       for (j = 0; j <  step_v0; ++j)
       {
         char *ref_idx = &mv_info[j][currMB->block_x].ref_idx[list];
@@ -275,7 +275,7 @@ static void readMBRefPictureIdx (SyntaxElement *currSE, DataPartition *dP, Macro
       {
         currMB->subblock_y = j0 << 2;
         currMB->subblock_x = 0;
-        refframe = currMB->readRefPictureIdx(currMB, currSE, dP, currMB->b8mode[k], list);
+        refframe = currMB->p_Slice->readRefPictureIdx(currMB, currSE, dP, currMB->b8mode[k], list);
         for (j = j0; j < j0 + step_v0; ++j)
         {
           char *ref_idx = &mv_info[j][currMB->block_x].ref_idx[list];
@@ -303,7 +303,7 @@ static void readMBRefPictureIdx (SyntaxElement *currSE, DataPartition *dP, Macro
       if ((currMB->b8pdir[k] == list || currMB->b8pdir[k] == BI_PRED) && currMB->b8mode[k] != 0)
       {
         currMB->subblock_x = i0 << 2;
-        refframe = currMB->readRefPictureIdx(currMB, currSE, dP, currMB->b8mode[k], list);
+        refframe = currMB->p_Slice->readRefPictureIdx(currMB, currSE, dP, currMB->b8mode[k], list);
         for (j = 0; j < step_v0; ++j)
         {
           char *ref_idx = &mv_info[j][currMB->block_x + i0].ref_idx[list];
@@ -333,7 +333,7 @@ static void readMBRefPictureIdx (SyntaxElement *currSE, DataPartition *dP, Macro
         if ((currMB->b8pdir[k] == list || currMB->b8pdir[k] == BI_PRED) && currMB->b8mode[k] != 0)
         {
           currMB->subblock_x = i0 << 2;
-          refframe = currMB->readRefPictureIdx(currMB, currSE, dP, currMB->b8mode[k], list);
+          refframe = currMB->p_Slice->readRefPictureIdx(currMB, currSE, dP, currMB->b8mode[k], list);
           for (j = j0; j < j0 + step_v0; ++j)
           {
             char *ref_idx = &mv_info[j][currMB->block_x + i0].ref_idx[list];
@@ -375,12 +375,12 @@ static void readMBMotionVectors (SyntaxElement *currSE, DataPartition *dP, Macro
       currMB->subblock_y = 0; // position used for context determination
       i4  = currMB->block_x;
       j4  = currMB->block_y;
-      mvd = &currMB->mvd [list][0];
+      mvd = &currMB->p_Slice->mb_mvd[currMB->mbAddrX][list][0];
 
       get_neighbors(currMB, block, 0, 0, step_h0 << 2);
 
       // first get MV predictor
-      currMB->GetMVPredictor (currMB, block, &pred_mv, mv_info[j4][i4].ref_idx[list], mv_info, list, 0, 0, step_h0 << 2, step_v0 << 2);
+      currMB->p_Slice->GetMVPredictor (currMB, block, &pred_mv, mv_info[j4][i4].ref_idx[list], mv_info, list, 0, 0, step_h0 << 2, step_v0 << 2);
 
       // X component
 #if TRACE
@@ -455,7 +455,7 @@ static void readMBMotionVectors (SyntaxElement *currSE, DataPartition *dP, Macro
           {
             currMB->subblock_y = j << 2; // position used for context determination
             j4  = currMB->block_y + j;
-            mvd = &currMB->mvd [list][j];
+            mvd = &currMB->p_Slice->mb_mvd[currMB->mbAddrX][list][j];
 
             for (i = i0; i < i0 + step_h0; i += step_h)
             {
@@ -465,7 +465,7 @@ static void readMBMotionVectors (SyntaxElement *currSE, DataPartition *dP, Macro
               get_neighbors(currMB, block, BLOCK_SIZE * i, BLOCK_SIZE * j, step_h4);
 
               // first get MV predictor
-              currMB->GetMVPredictor (currMB, block, &pred_mv, cur_ref_idx, mv_info, list, BLOCK_SIZE * i, BLOCK_SIZE * j, step_h4, step_v4);
+              currMB->p_Slice->GetMVPredictor (currMB, block, &pred_mv, cur_ref_idx, mv_info, list, BLOCK_SIZE * i, BLOCK_SIZE * j, step_h4, step_v4);
 
               for (k=0; k < 2; ++k)
               {
@@ -588,7 +588,7 @@ void start_macroblock(Slice *currSlice, Macroblock **currMB)
   CheckAvailabilityOfNeighbors(*currMB);
 
   // Select appropriate MV predictor function
-  init_motion_vector_prediction(*currMB, currSlice->mb_aff_frame_flag);
+  currSlice->GetMVPredictor = currSlice->mb_aff_frame_flag ? GetMotionVectorPredictorMBAFF : GetMotionVectorPredictorNormal;
 
   set_read_and_store_CBP(currMB, currSlice->active_sps->chroma_format_idc);
 
@@ -597,9 +597,9 @@ void start_macroblock(Slice *currSlice, Macroblock **currMB)
   if (currSlice->slice_type != I_SLICE)
   {
     if (currSlice->slice_type != B_SLICE)
-      fast_memset((*currMB)->mvd[0][0][0], 0, MB_BLOCK_PARTITIONS * 2 * sizeof(short));
+      fast_memset(currSlice->mb_mvd[mb_nr][0][0][0], 0, MB_BLOCK_PARTITIONS * 2 * sizeof(short));
     else
-      fast_memset((*currMB)->mvd[0][0][0], 0, 2 * MB_BLOCK_PARTITIONS * 2 * sizeof(short));
+      fast_memset(currSlice->mb_mvd[mb_nr][0][0][0], 0, 2 * MB_BLOCK_PARTITIONS * 2 * sizeof(short));
   }
   
   fast_memset((*currMB)->s_cbp, 0, 3 * sizeof(CBPStructure));
@@ -1450,6 +1450,8 @@ void change_plane_JV( VideoParameters *p_Vid, int nplane, Slice *pSlice)
   p_Vid->siblock = p_Vid->siblock_JV[nplane];
   p_Vid->ipredmode = p_Vid->ipredmode_JV[nplane];
   p_Vid->intra_block = p_Vid->intra_block_JV[nplane];
+  p_Vid->mb_mvd = p_Vid->mb_mvd_JV[nplane];
+  p_Vid->mb_strength = p_Vid->mb_strength_JV[nplane];
   if(pSlice)
   {
     pSlice->mb_data = p_Vid->mb_data_JV[nplane];
@@ -1457,6 +1459,7 @@ void change_plane_JV( VideoParameters *p_Vid, int nplane, Slice *pSlice)
     pSlice->siblock = p_Vid->siblock_JV[nplane];
     pSlice->ipredmode = p_Vid->ipredmode_JV[nplane];
     pSlice->intra_block = p_Vid->intra_block_JV[nplane];
+    pSlice->mb_mvd = p_Vid->mb_mvd_JV[nplane];
   }
 }
 
@@ -42,43 +42,29 @@ Boolean mb_is_available(int mbAddr, Macroblock *currMB)
 /*!
  ************************************************************************
  * \brief
- *    Checks the availability of neighboring macroblocks of
- *    the current macroblock for prediction and context determination;
+ *    sets the neighbour availability of the current macroblock from the
+ *    picture neighbour table. Neighbours inside the picture are available
+ *    if they belong to the current slice (or when deblocking).
  ************************************************************************
  */
-void CheckAvailabilityOfNeighbors(Macroblock *currMB)
+static inline void set_neighbour_availability(Macroblock *currMB, Slice *currSlice, int inside)
 {
-  Slice *currSlice = currMB->p_Slice;
-  StorablePicture *dec_picture = currSlice->dec_picture; //p_Vid->dec_picture;
-  const int mb_nr = currMB->mbAddrX;
-  BlockPos *PicPos = currMB->p_Vid->PicPos;
-
-  if (dec_picture->mb_aff_frame_flag)
+  if (currMB->DeblockCall)
   {
-    int cur_mb_pair = mb_nr >> 1;
-    currMB->mbAddrA = 2 * (cur_mb_pair - 1);
-    currMB->mbAddrB = 2 * (cur_mb_pair - dec_picture->PicWidthInMbs);
-    currMB->mbAddrC = 2 * (cur_mb_pair - dec_picture->PicWidthInMbs + 1);
-    currMB->mbAddrD = 2 * (cur_mb_pair - dec_picture->PicWidthInMbs - 1);
-
-    currMB->mbAvailA = (Boolean) (mb_is_available(currMB->mbAddrA, currMB) && ((PicPos[cur_mb_pair    ].x)!=0));
-    currMB->mbAvailB = (Boolean) (mb_is_available(currMB->mbAddrB, currMB));
-    currMB->mbAvailC = (Boolean) (mb_is_available(currMB->mbAddrC, currMB) && ((PicPos[cur_mb_pair + 1].x)!=0));
-    currMB->mbAvailD = (Boolean) (mb_is_available(currMB->mbAddrD, currMB) && ((PicPos[cur_mb_pair    ].x)!=0));
+    currMB->mbAvailA = (Boolean) ((inside & NB_A) != 0);
+    currMB->mbAvailB = (Boolean) ((inside & NB_B) != 0);
+    currMB->mbAvailC = (Boolean) ((inside & NB_C) != 0);
+    currMB->mbAvailD = (Boolean) ((inside & NB_D) != 0);
   }
   else
   {
-    BlockPos *p_pic_pos = &PicPos[mb_nr    ];
-    currMB->mbAddrA = mb_nr - 1;
-    currMB->mbAddrD = currMB->mbAddrA - dec_picture->PicWidthInMbs;
-    currMB->mbAddrB = currMB->mbAddrD + 1;
-    currMB->mbAddrC = currMB->mbAddrB + 1;
-
+    Macroblock *mb_data = currSlice->mb_data;
+    short slice_nr = currMB->slice_nr;
 
-    currMB->mbAvailA = (Boolean) (mb_is_available(currMB->mbAddrA, currMB) && ((p_pic_pos->x)!=0));
-    currMB->mbAvailD = (Boolean) (mb_is_available(currMB->mbAddrD, currMB) && ((p_pic_pos->x)!=0));
-    currMB->mbAvailC = (Boolean) (mb_is_available(currMB->mbAddrC, currMB) && (((p_pic_pos + 1)->x)!=0));
-    currMB->mbAvailB = (Boolean) (mb_is_available(currMB->mbAddrB, currMB));        
+    currMB->mbAvailA = (Boolean) ((inside & NB_A) && mb_data[currMB->mbAddrA].slice_nr == slice_nr);
+    currMB->mbAvailB = (Boolean) ((inside & NB_B) && mb_data[currMB->mbAddrB].slice_nr == slice_nr);
+    currMB->mbAvailC = (Boolean) ((inside & NB_C) && mb_data[currMB->mbAddrC].slice_nr == slice_nr);
+    currMB->mbAvailD = (Boolean) ((inside & NB_D) && mb_data[currMB->mbAddrD].slice_nr == slice_nr);
   }
 
   currMB->mb_left = (currMB->mbAvailA) ? &(currSlice->mb_data[currMB->mbAddrA]) : NULL;
@@ -92,28 +78,31 @@ void CheckAvailabilityOfNeighbors(Macroblock *currMB)
  *    the current macroblock for prediction and context determination;
  ************************************************************************
  */
-void CheckAvailabilityOfNeighborsNormal(Macroblock *currMB)
+void CheckAvailabilityOfNeighbors(Macroblock *currMB)
 {
-  Slice *currSlice = currMB->p_Slice;
-  StorablePicture *dec_picture = currSlice->dec_picture; //p_Vid->dec_picture;
-  const int mb_nr = currMB->mbAddrX;
-  BlockPos *PicPos = currMB->p_Vid->PicPos;
-
-  BlockPos *p_pic_pos = &PicPos[mb_nr    ];
-  currMB->mbAddrA = mb_nr - 1;
-  currMB->mbAddrD = currMB->mbAddrA - dec_picture->PicWidthInMbs;
-  currMB->mbAddrB = currMB->mbAddrD + 1;
-  currMB->mbAddrC = currMB->mbAddrB + 1;
-
+  if (currMB->p_Slice->dec_picture->mb_aff_frame_flag)
+    CheckAvailabilityOfNeighborsMBAFF(currMB);
+  else
+    CheckAvailabilityOfNeighborsNormal(currMB);
+}
 
-  currMB->mbAvailA = (Boolean) (mb_is_available(currMB->mbAddrA, currMB) && ((p_pic_pos->x)!=0));
-  currMB->mbAvailD = (Boolean) (mb_is_available(currMB->mbAddrD, currMB) && ((p_pic_pos->x)!=0));
-  currMB->mbAvailC = (Boolean) (mb_is_available(currMB->mbAddrC, currMB) && (((p_pic_pos + 1)->x)!=0));
-  currMB->mbAvailB = (Boolean) (mb_is_available(currMB->mbAddrB, currMB));        
+/*!
+ ************************************************************************
+ * \brief
+ *    Checks the availability of neighboring macroblocks of
+ *    the current macroblock for prediction and context determination;
+ ************************************************************************
+ */
+void CheckAvailabilityOfNeighborsNormal(Macroblock *currMB)
+{
+  MbNeighbours *nb = &currMB->p_Vid->PicNeighbours[currMB->mbAddrX];
 
+  currMB->mbAddrA = nb->mbAddrA;
+  currMB->mbAddrB = nb->mbAddrB;
+  currMB->mbAddrC = nb->mbAddrC;
+  currMB->mbAddrD = nb->mbAddrD;
 
-  currMB->mb_left = (currMB->mbAvailA) ? &(currSlice->mb_data[currMB->mbAddrA]) : NULL;
-  currMB->mb_up   = (currMB->mbAvailB) ? &(currSlice->mb_data[currMB->mbAddrB]) : NULL;
+  set_neighbour_availability(currMB, currMB->p_Slice, nb->inside);
 }
 
 /*!
@@ -125,24 +114,14 @@ void CheckAvailabilityOfNeighborsNormal(Macroblock *currMB)
  */
 void CheckAvailabilityOfNeighborsMBAFF(Macroblock *currMB)
 {
-  Slice *currSlice = currMB->p_Slice;
-  StorablePicture *dec_picture = currSlice->dec_picture; //p_Vid->dec_picture;
-  const int mb_nr = currMB->mbAddrX;
-  BlockPos *PicPos = currMB->p_Vid->PicPos;
+  MbNeighbours *nb = &currMB->p_Vid->PicNeighbours[currMB->mbAddrX >> 1];
 
-  int cur_mb_pair = mb_nr >> 1;
-  currMB->mbAddrA = 2 * (cur_mb_pair - 1);
-  currMB->mbAddrB = 2 * (cur_mb_pair - dec_picture->PicWidthInMbs);
-  currMB->mbAddrC = 2 * (cur_mb_pair - dec_picture->PicWidthInMbs + 1);
-  currMB->mbAddrD = 2 * (cur_mb_pair - dec_picture->PicWidthInMbs - 1);
+  currMB->mbAddrA = 2 * nb->mbAddrA;
+  currMB->mbAddrB = 2 * nb->mbAddrB;
+  currMB->mbAddrC = 2 * nb->mbAddrC;
+  currMB->mbAddrD = 2 * nb->mbAddrD;
 
-  currMB->mbAvailA = (Boolean) (mb_is_available(currMB->mbAddrA, currMB) && ((PicPos[cur_mb_pair    ].x)!=0));
-  currMB->mbAvailB = (Boolean) (mb_is_available(currMB->mbAddrB, currMB));
-  currMB->mbAvailC = (Boolean) (mb_is_available(currMB->mbAddrC, currMB) && ((PicPos[cur_mb_pair + 1].x)!=0));
-  currMB->mbAvailD = (Boolean) (mb_is_available(currMB->mbAddrD, currMB) && ((PicPos[cur_mb_pair    ].x)!=0));
-
-  currMB->mb_left = (currMB->mbAvailA) ? &(currSlice->mb_data[currMB->mbAddrA]) : NULL;
-  currMB->mb_up   = (currMB->mbAvailB) ? &(currSlice->mb_data[currMB->mbAddrB]) : NULL;
+  set_neighbour_availability(currMB, currMB->p_Slice, nb->inside);
 }
 
 
@@ -47,7 +47,6 @@ int mb_pred_intra4x4(Macroblock *currMB, ColorPlane curr_plane, imgpel **currImg
   int j_pos, i_pos;
   int ioff,joff;
   int block8x8;   // needed for ABT
-  currMB->itrans_4x4 = (currMB->is_lossless == FALSE) ? itrans4x4 : Inv_Residual_trans_4x4;    
 
   for (block8x8 = 0; block8x8 < 4; block8x8++)
   {
@@ -69,9 +68,13 @@ int mb_pred_intra4x4(Macroblock *currMB, ColorPlane curr_plane, imgpel **currImg
         return SEARCH_SYNC;                   /* bit error */
       // =============== 4x4 itrans ================
       // -------------------------------------------
-      currMB->itrans_4x4  (currMB, curr_plane, ioff, joff);
-
-      copy_image_data_4x4(&currImg[j_pos], &currSlice->mb_rec[curr_plane][joff], i_pos, ioff);
+      if (currMB->is_lossless == FALSE)
+        itrans4x4_recon(currMB, curr_plane, ioff, joff, &currImg[j_pos], i_pos);
+      else
+      {
+        Inv_Residual_trans_4x4(currMB, curr_plane, ioff, joff);
+        copy_image_data_4x4(&currImg[j_pos], &currSlice->mb_rec[curr_plane][joff], i_pos, ioff);
+      }
     }
   }
 
@@ -113,7 +116,7 @@ int mb_pred_intra8x8(Macroblock *currMB, ColorPlane curr_plane, imgpel **currImg
   int yuv = dec_picture->chroma_format_idc - 1;
 
   int block8x8;   // needed for ABT
-  currMB->itrans_8x8 = (currMB->is_lossless == FALSE) ? itrans8x8 : Inv_Residual_trans_8x8;
+  currMB->p_Slice->itrans_8x8 = (currMB->is_lossless == FALSE) ? itrans8x8 : Inv_Residual_trans_8x8;
 
   for (block8x8 = 0; block8x8 < 4; block8x8++)
   {
@@ -123,12 +126,15 @@ int mb_pred_intra8x8(Macroblock *currMB, ColorPlane curr_plane, imgpel **currImg
 
     //PREDICTION
     currSlice->intra_pred_8x8(currMB, curr_plane, ioff, joff);
-    if (currMB->cbp & (1 << block8x8)) 
-      currMB->itrans_8x8    (currMB, curr_plane, ioff,joff);      // use inverse integer transform and make 8x8 block m7 from prediction block mpr
+    if (!(currMB->cbp & (1 << block8x8)))
+      copy_image_data_8x8(&currImg[currMB->pix_y + joff], &currSlice->mb_pred[curr_plane][joff], currMB->pix_x + ioff, ioff);
+    else if (currMB->is_lossless == FALSE)
+      itrans8x8_recon(currMB, curr_plane, ioff, joff, &currImg[currMB->pix_y + joff], currMB->pix_x + ioff);
     else
-      icopy8x8(currMB, curr_plane, ioff,joff);
-
-    copy_image_data_8x8(&currImg[currMB->pix_y + joff], &currSlice->mb_rec[curr_plane][joff], currMB->pix_x + ioff, ioff);
+    {
+      currMB->p_Slice->itrans_8x8    (currMB, curr_plane, ioff,joff);      // use inverse integer transform and make 8x8 block m7 from prediction block mpr
+      copy_image_data_8x8(&currImg[currMB->pix_y + joff], &currSlice->mb_rec[curr_plane][joff], currMB->pix_x + ioff, ioff);
+    }
   }
   // chroma decoding *******************************************************
   if ((dec_picture->chroma_format_idc != YUV400) && (dec_picture->chroma_format_idc != YUV444)) 
@@ -32,6 +32,7 @@
 #include "mbuffer_mvc.h"
 #include "fast_memory.h"
 #include "input.h"
+#include "frame_thread.h"
 
 static void insert_picture_in_dpb    (VideoParameters *p_Vid, FrameStore* fs, StorablePicture* p);
 static int output_one_frame_from_dpb (DecodedPictureBuffer *p_Dpb);
@@ -533,6 +534,7 @@ StorablePicture* alloc_storable_picture(VideoParameters *p_Vid, PictureStructure
 
   StorablePicture *s;
   int   nplane;
+  MemTag mem_tag;
 
   //printf ("Allocating (%s) picture (x=%d, y=%d, x_cr=%d, y_cr=%d)\n", (type == FRAME)?"FRAME":(type == TOP_FIELD)?"TOP_FIELD":"BOTTOM_FIELD", size_x, size_y, size_x_cr, size_y_cr);
 
@@ -549,6 +551,7 @@ StorablePicture* alloc_storable_picture(VideoParameters *p_Vid, PictureStructure
   s->PicSizeInMbs = (size_x*size_y)/256;
   s->imgUV = NULL;
 
+  mem_tag = mem_set_tag(MEM_DPB);
   get_mem2Dpel_pad (&(s->imgY), size_y, size_x, p_Vid->iLumaPadY, p_Vid->iLumaPadX);
   s->iLumaStride = size_x+2*p_Vid->iLumaPadX;
   s->iLumaExpandedHeight = size_y+2*p_Vid->iLumaPadY;
@@ -578,6 +581,7 @@ StorablePicture* alloc_storable_picture(VideoParameters *p_Vid, PictureStructure
       alloc_pic_motion(&s->JVmotion[nplane] , (size_y >> BLOCK_SHIFT), (size_x >> BLOCK_SHIFT));
     }
   }
+  mem_set_tag(mem_tag);
 
   s->pic_num   = 0;
   s->frame_num = 0;
@@ -615,6 +619,10 @@ StorablePicture* alloc_storable_picture(VideoParameters *p_Vid, PictureStructure
   s->top_poc = s->bottom_poc = s->poc = 0;
   s->seiHasTone_mapping = 0;
 
+  s->cur_imgY       = s->imgY;
+  s->iDecodedRows   = INT_MAX;
+  s->p_FrameThreads = p_Vid->p_FrameThreads;
+
   if(!p_Vid->active_sps->frame_mbs_only_flag && structure != FRAME)
   {
     int i, j;
@@ -692,6 +700,10 @@ void free_storable_picture(StorablePicture* p)
   int nplane;
   if (p)
   {
+    // a frame thread may still reference the picture
+    if (p->p_FrameThreads && frame_threads_defer_free(p))
+      return;
+
     if (p->mv_info)
     {
       free_mem2Dmp(p->mv_info);
@@ -1637,6 +1649,38 @@ static void sliding_window_memory_management(DecodedPictureBuffer *p_Dpb, Storab
 }
 
 
+/*!
+ ************************************************************************
+ * \brief
+ *    With SkipPictures = 2 the skipped pictures leave a gap in the
+ *    frame_num of the decoded pictures. As for a gap in frame_num
+ *    (fill_frame_num_gap), the sliding window would have removed the
+ *    short-term reference frames that are more than num_ref_frames
+ *    frame numbers in front of p; they are unmarked here, otherwise a
+ *    frame_num could appear twice in the DPB after it wraps.
+ ************************************************************************
+ */
+static void skipped_pictures_memory_management(DecodedPictureBuffer *p_Dpb, StorablePicture* p)
+{
+  VideoParameters *p_Vid = p_Dpb->p_Vid;
+  int oldest_frame_num_wrap = (int) p->frame_num - imax(1, p_Dpb->num_ref_frames);
+  int frame_num_wrap;
+  uint32 i;
+
+  for (i = 0; i < p_Dpb->ref_frames_in_buffer; i++)
+  {
+    FrameStore *fs = p_Dpb->fs_ref[i];
+
+    if (fs->is_reference && !fs->is_long_term)
+    {
+      frame_num_wrap = (fs->frame_num > p->frame_num) ? (int) fs->frame_num - p_Vid->max_frame_num : (int) fs->frame_num;
+      if (frame_num_wrap <= oldest_frame_num_wrap)
+        unmark_for_reference(fs);
+    }
+  }
+  update_ref_list(p_Dpb);
+}
+
 /*!
  ************************************************************************
  * \brief
@@ -1784,6 +1828,9 @@ void store_picture_in_dpb(DecodedPictureBuffer *p_Dpb, StorablePicture* p)
   }
   else
   {
+    if (p_Vid->p_Inp->skip_pictures == 2)
+      skipped_pictures_memory_management(p_Dpb, p);
+
     // adaptive memory management
     if (p->used_for_reference && (p->adaptive_ref_pic_buffering_flag))
       adaptive_memory_management(p_Dpb, p);
@@ -1815,8 +1862,9 @@ void store_picture_in_dpb(DecodedPictureBuffer *p_Dpb, StorablePicture* p)
 
   // this is a frame or a field which has no stored complementary field
 
-  // sliding window, if necessary
-  if ((!p->idr_flag)&&(p->used_for_reference && (!p->adaptive_ref_pic_buffering_flag)))
+  // sliding window, if necessary; with SkipPictures = 2 the memory management
+  // operations may refer to skipped pictures and leave no room for this one
+  if ((!p->idr_flag)&&(p->used_for_reference && (!p->adaptive_ref_pic_buffering_flag || p_Vid->p_Inp->skip_pictures == 2)))
   {
     sliding_window_memory_management(p_Dpb, p);
   }
@@ -131,6 +131,8 @@ typedef struct storable_picture
   char listXsize[MAX_NUM_SLICES][2];
   struct storable_picture **listX[MAX_NUM_SLICES][2];
   int         layer_id;
+  int         iDecodedRows;              //!< final (deblocked and padded) MB rows while a frame thread reconstructs the picture, INT_MAX once complete
+  struct frame_threads *p_FrameThreads;  //!< frame threads the picture may be referenced by, NULL if decoding single threaded
 } StorablePicture;
 
 typedef StorablePicture *StorablePicturePtr;
@@ -250,6 +252,8 @@ extern int init_img_data(VideoParameters *p_Vid, ImageData *p_ImgData, seq_param
 extern void free_img_data(VideoParameters *p_Vid, ImageData *p_ImgData);
 extern void pad_dec_picture(VideoParameters *p_Vid, StorablePicture *dec_picture);
 extern void pad_buf(imgpel *pImgBuf, int iWidth, int iHeight, int iStride, int iPadX, int iPadY);
+extern void pad_buf_rows(imgpel *pImgBuf, int iWidth, int iHeight, int iStride, int iPadX, int iPadY, int iRowStart, int iRowEnd);
+extern void pad_picture_rows(VideoParameters *p_Vid, StorablePicture *dec_picture, int iRowStart, int iRowEnd);
 extern void process_picture_in_dpb_s(VideoParameters *p_Vid, StorablePicture *p_pic);
 extern StorablePicture * clone_storable_picture( VideoParameters *p_Vid, StorablePicture *p_pic );
 extern void store_proc_picture_in_dpb(DecodedPictureBuffer *p_Dpb, StorablePicture* p);
@@ -22,6 +22,8 @@
 #include "macroblock.h"
 #include "memalloc.h"
 #include "dec_statistics.h"
+#include "dec_profile.h"
+#include "frame_thread.h"
 
 int allocate_pred_mem(Slice *currSlice)
 {
@@ -891,6 +893,18 @@ static void get_luma_31(imgpel **block, imgpel **cur_imgY, int block_size_y, int
   }      
 }
 
+/*!
+ ************************************************************************
+ * \brief
+ *    Waits until the reference is final down to luma line last_line.
+ *    Lines below the picture are the padding written with the last row.
+ ************************************************************************
+ */
+static void wait_ref_lines(StorablePicture *ref, int last_line)
+{
+  wait_picture_rows(ref, last_line >= ref->size_y ? INT_MAX : imax(1, (last_line >> 4) + 1));
+}
+
 /*!
  ************************************************************************
  * \brief
@@ -914,6 +928,10 @@ void get_block_luma(StorablePicture *curr_ref, int x_pos, int y_pos, int block_s
     x_pos = iClip3(-18, maxold_x+2, x_pos);
     y_pos = iClip3(-10, maxold_y+2, y_pos);
 
+    // a reference still reconstructed by a frame thread must be final down to the last filter tap
+    if (load_acquire(&curr_ref->iDecodedRows) != INT_MAX)
+      wait_ref_lines(curr_ref, y_pos + block_size_y + 3);
+
     if (dx == 0 && dy == 0)
       get_block_00(&block[0][0], &cur_imgY[y_pos][x_pos], curr_ref->iLumaStride, block_size_y);
     else
@@ -1147,7 +1165,7 @@ void intra_cr_decoding(Macroblock *currMB, int yuv)
 
   for(uv = 0; uv < 2; uv++)
   {
-    currMB->itrans_4x4 = (currMB->is_lossless == FALSE) ? itrans4x4 : itrans4x4_ls;
+    currMB->p_Slice->itrans_4x4 = (currMB->is_lossless == FALSE) ? itrans4x4 : itrans4x4_ls;
 
     curUV = dec_picture->imgUV[uv];
 
@@ -1172,9 +1190,13 @@ void intra_cr_decoding(Macroblock *currMB, int yuv)
           joff = subblk_offset_y[yuv][b8][b4];          
           ioff = subblk_offset_x[yuv][b8][b4];          
 
-          currMB->itrans_4x4(currMB, (ColorPlane) (uv + 1), ioff, joff);
-
-          copy_image_data_4x4(&curUV[currMB->pix_c_y + joff], &(currSlice->mb_rec[uv + 1][joff]), currMB->pix_c_x + ioff, ioff);
+          if (currMB->is_lossless == FALSE)
+            itrans4x4_recon(currMB, (ColorPlane) (uv + 1), ioff, joff, &curUV[currMB->pix_c_y + joff], currMB->pix_c_x + ioff);
+          else
+          {
+            itrans4x4_ls(currMB, (ColorPlane) (uv + 1), ioff, joff);
+            copy_image_data_4x4(&curUV[currMB->pix_c_y + joff], &(currSlice->mb_rec[uv + 1][joff]), currMB->pix_c_x + ioff, ioff);
+          }
         }
       }
       currSlice->is_reset_coeff_cr = FALSE;
@@ -1187,7 +1209,7 @@ void intra_cr_decoding(Macroblock *currMB, int yuv)
       {
         for(ioff = 0; ioff < 8;ioff+=4)
         {          
-          currMB->itrans_4x4(currMB, (ColorPlane) (uv + 1), ioff, joff);
+          currMB->p_Slice->itrans_4x4(currMB, (ColorPlane) (uv + 1), ioff, joff);
         
           copy_image_data_4x4(&curUV[currMB->pix_c_y + joff], &(currSlice->mb_rec[uv + 1][joff]), currMB->pix_c_x + ioff, ioff);
         }
@@ -1310,10 +1332,10 @@ void prepare_direct_params(Macroblock *currMB, StorablePicture *dec_picture, Mot
   *l1_rFrame = (char) imin(imin((unsigned char) l1_refA, (unsigned char) l1_refB), (unsigned char) l1_refC);
 
   if (*l0_rFrame >=0)
-    currMB->GetMVPredictor (currMB, mb, pmvl0, *l0_rFrame, mv_info, LIST_0, 0, 0, 16, 16);
+    currMB->p_Slice->GetMVPredictor (currMB, mb, pmvl0, *l0_rFrame, mv_info, LIST_0, 0, 0, 16, 16);
 
   if (*l1_rFrame >=0)
-    currMB->GetMVPredictor (currMB, mb, pmvl1, *l1_rFrame, mv_info, LIST_1, 0, 0, 16, 16);
+    currMB->p_Slice->GetMVPredictor (currMB, mb, pmvl1, *l1_rFrame, mv_info, LIST_1, 0, 0, 16, 16);
 }
 
 static void check_motion_vector_range(const MotionVector *mv, Slice *pSlice)
@@ -1775,6 +1797,7 @@ void perform_mc(Macroblock *currMB, ColorPlane pl, StorablePicture *dec_picture,
 {
   Slice *currSlice = currMB->p_Slice;
   assert (pred_dir<=2);
+  DEC_PROFILE_START(currMB->p_Vid, PROF_MC);
   if (pred_dir != 2)
   {
     if (currSlice->weighted_pred_flag)
@@ -1789,6 +1812,7 @@ void perform_mc(Macroblock *currMB, ColorPlane pl, StorablePicture *dec_picture,
     else
       perform_mc_bi(currMB, pl, dec_picture, i, j, block_size_x, block_size_y);
   }
+  DEC_PROFILE_STOP(currMB->p_Vid, PROF_MC);
 }
 
 
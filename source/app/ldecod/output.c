@@ -21,11 +21,14 @@
 #include "sei.h"
 #include "input.h"
 #include "fast_memory.h"
+#include "dec_profile.h"
+#include "frame_thread.h"
 
 static void write_out_picture(VideoParameters *p_Vid, StorablePicture *p, int p_out);
 static void img2buf_byte   (imgpel** imgX, unsigned char* buf, int size_x, int size_y, int symbol_size_in_bytes, int crop_left, int crop_right, int crop_top, int crop_bottom, int iOutStride);
 static void img2buf_normal (imgpel** imgX, unsigned char* buf, int size_x, int size_y, int symbol_size_in_bytes, int crop_left, int crop_right, int crop_top, int crop_bottom, int iOutStride);
 static void img2buf_endian (imgpel** imgX, unsigned char* buf, int size_x, int size_y, int symbol_size_in_bytes, int crop_left, int crop_right, int crop_top, int crop_bottom, int iOutStride);
+static void img2buf_scaled (imgpel** imgX, unsigned char* buf, int *acc, int size_x, int size_y, int symbol_size_in_bytes, int crop_left, int crop_right, int crop_top, int crop_bottom, int iOutStride, int shift);
 
 
 /*!
@@ -258,6 +261,72 @@ static void img2buf_endian (imgpel** imgX, unsigned char* buf, int size_x, int s
   }  
 }
 
+/*!
+ ************************************************************************
+ * \brief
+ *    Convert image plane to temporary buffer for file writing and
+ *    downscale it by 1 << shift in both directions. Each output sample
+ *    is the rounded mean of its (1 << shift) x (1 << shift) block of
+ *    the cropped plane, incomplete blocks at the right and bottom edge
+ *    are dropped. Samples are written in little endian order.
+ * \param acc
+ *    row accumulator of at least (size_x >> shift) entries
+ * \param shift
+ *    1, 2 or 3 for 1/2, 1/4 or 1/8 of the size
+ ************************************************************************
+ */
+static void img2buf_scaled (imgpel** imgX, unsigned char* buf, int *acc, int size_x, int size_y, int symbol_size_in_bytes, int crop_left, int crop_right, int crop_top, int crop_bottom, int iOutStride, int shift)
+{
+  int step    = 1 << shift;
+  int twidth  = (size_x - crop_left - crop_right) >> shift;
+  int theight = (size_y - crop_top - crop_bottom) >> shift;
+  int round   = 1 << (2 * shift - 1);
+  int i, j, k, l;
+
+  if (symbol_size_in_bytes > 2)
+    error ("write_out_picture: OutputScale supports 8 and 16 bit output only", 500);
+
+  for (i = 0; i < theight; i++)
+  {
+    memset(acc, 0, twidth * sizeof(int));
+
+    // sum the block rows first, the horizontal taps are contiguous
+    for (k = 0; k < step; k++)
+    {
+      imgpel *src = imgX[crop_top + i * step + k] + crop_left;
+      if (shift == 1)
+      {
+        for (j = 0; j < twidth; j++)
+          acc[j] += src[2 * j] + src[2 * j + 1];
+      }
+      else
+      {
+        for (j = 0; j < twidth; j++, src += step)
+        {
+          for (l = 0; l < step; l++)
+            acc[j] += src[l];
+        }
+      }
+    }
+
+    if (symbol_size_in_bytes == 1)
+    {
+      for (j = 0; j < twidth; j++)
+        buf[j] = (unsigned char) ((acc[j] + round) >> (2 * shift));
+    }
+    else
+    {
+      for (j = 0; j < twidth; j++)
+      {
+        int val = (acc[j] + round) >> (2 * shift);
+        buf[2 * j]     = (unsigned char) (val & 0xFF);
+        buf[2 * j + 1] = (unsigned char) (val >> 8);
+      }
+    }
+    buf += iOutStride;
+  }
+}
+
 
 #if (PAIR_FIELDS_IN_OUTPUT)
 
@@ -454,6 +523,106 @@ static void allocate_p_dec_pic(VideoParameters *p_Vid, DecodedPicList *pDecPic,
   pDecPic->iUVBufStride = iChromaSizeX*symbol_size_in_bytes; //p->size_x_cr*symbol_size_in_bytes;
 }
 
+/*!
+************************************************************************
+* \brief
+*    Writes out a storable picture downscaled by OutputScale. The plane
+*    order, cropping and chroma of monochrome streams follow
+*    write_out_picture(); the decoded picture list gets the downscaled
+*    planes.
+************************************************************************
+*/
+static void write_out_scaled_picture(VideoParameters *p_Vid, StorablePicture *p, int p_out, int crop_left, int crop_right, int crop_top, int crop_bottom)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  DecodedPicList *pDecPic;
+  int shift = p_Inp->output_scale;
+  int symbol_size_in_bytes = ((p_Vid->pic_unit_bitsize_on_disk+7) >> 3);
+  int rgb_output = p_Vid->p_EncodePar[p->layer_id]->rgb_output;
+  int crop_left_cr   = p->frame_crop_left_offset;
+  int crop_right_cr  = p->frame_crop_right_offset;
+  int crop_top_cr    = ( 2 - p->frame_mbs_only_flag ) * p->frame_crop_top_offset;
+  int crop_bottom_cr = ( 2 - p->frame_mbs_only_flag ) * p->frame_crop_bottom_offset;
+  int iLumaSizeX = (p->size_x - crop_left - crop_right) >> shift;
+  int iLumaSizeY = (p->size_y - crop_top - crop_bottom) >> shift;
+  int iChromaSizeX = 0, iChromaSizeY = 0;
+  int iLumaSize, iChromaSize, iFrameSize;
+  int *acc;
+
+  if (p->chroma_format_idc != YUV400)
+  {
+    iChromaSizeX = (p->size_x_cr - crop_left_cr - crop_right_cr) >> shift;
+    iChromaSizeY = (p->size_y_cr - crop_top_cr - crop_bottom_cr) >> shift;
+  }
+  iLumaSize   = iLumaSizeX * iLumaSizeY * symbol_size_in_bytes;
+  iChromaSize = iChromaSizeX * iChromaSizeY * symbol_size_in_bytes;
+  iFrameSize  = iLumaSize + 2 * iChromaSize;
+
+  pDecPic = get_one_avail_dec_pic_from_list(p_Vid->pDecOuputPic, 0, 0);
+  if( (pDecPic->pY == NULL) || (pDecPic->iBufSize < iFrameSize) )
+    allocate_p_dec_pic(p_Vid, pDecPic, p, iLumaSize, iFrameSize, iLumaSizeX, iLumaSizeY, iChromaSizeX, iChromaSizeY);
+  if (NULL==pDecPic->pY)
+    no_mem_exit("write_out_scaled_picture: buf");
+#if (MVC_EXTENSION_ENABLE)
+  pDecPic->iViewId = p->view_id >=0 ? p->view_id : -1;
+#endif
+  pDecPic->bValid = 1;
+  pDecPic->iPOC = p->frame_poc;
+
+  if ((acc = malloc(imax(iLumaSizeX, 1) * sizeof(int))) == NULL)
+    no_mem_exit("write_out_scaled_picture: acc");
+
+  img2buf_scaled(p->imgY, pDecPic->pY, acc, p->size_x, p->size_y, symbol_size_in_bytes, crop_left, crop_right, crop_top, crop_bottom, pDecPic->iYBufStride, shift);
+  if (p->chroma_format_idc != YUV400)
+  {
+    img2buf_scaled(p->imgUV[0], pDecPic->pU, acc, p->size_x_cr, p->size_y_cr, symbol_size_in_bytes, crop_left_cr, crop_right_cr, crop_top_cr, crop_bottom_cr, pDecPic->iUVBufStride, shift);
+    img2buf_scaled(p->imgUV[1], pDecPic->pV, acc, p->size_x_cr, p->size_y_cr, symbol_size_in_bytes, crop_left_cr, crop_right_cr, crop_top_cr, crop_bottom_cr, pDecPic->iUVBufStride, shift);
+  }
+  free(acc);
+
+  if (p_out >= 0)
+  {
+    // RGB output is written as G, B, R without the plane in pV
+    if (rgb_output && p->chroma_format_idc != YUV400)
+    {
+      if (write(p_out, pDecPic->pV, iChromaSize) != iChromaSize)
+        error ("write_out_picture: error writing to RGB file", 500);
+    }
+    if (write(p_out, pDecPic->pY, iLumaSize) != iLumaSize)
+      error ("write_out_picture: error writing to YUV file", 500);
+
+    if (p->chroma_format_idc != YUV400)
+    {
+      if (write(p_out, pDecPic->pU, iChromaSize) != iChromaSize)
+        error ("write_out_picture: error writing to YUV file", 500);
+      if (!rgb_output && write(p_out, pDecPic->pV, iChromaSize) != iChromaSize)
+        error ("write_out_picture: error writing to YUV file", 500);
+    }
+    else if (p_Inp->write_uv)
+    {
+      // fake out U=V=128 to make a YUV 4:2:0 stream
+      int cr_size = ((p->size_x - crop_left - crop_right) / 2 >> shift) * ((p->size_y - crop_top - crop_bottom) / 2 >> shift);
+      int cr_val  = 1 << (p_Vid->bitdepth_luma - 1);
+      unsigned char *buf = malloc(imax(cr_size, 1) * symbol_size_in_bytes);
+      int i;
+
+      if (buf == NULL)
+        no_mem_exit("write_out_scaled_picture: buf");
+      for (i = 0; i < cr_size; i++)
+      {
+        buf[i * symbol_size_in_bytes] = (unsigned char) (cr_val & 0xFF);
+        if (symbol_size_in_bytes == 2)
+          buf[i * 2 + 1] = (unsigned char) (cr_val >> 8);
+      }
+      cr_size *= symbol_size_in_bytes;
+      if (write(p_out, buf, cr_size) != cr_size || write(p_out, buf, cr_size) != cr_size)
+        error ("write_out_picture: error writing to YUV file", 500);
+      free(buf);
+    }
+    pDecPic->bValid = 0;
+  }
+}
+
 /*!
 ************************************************************************
 * \brief
@@ -489,6 +658,9 @@ static void write_out_picture(VideoParameters *p_Vid, StorablePicture *p, int p_
   if (p->non_existing)
     return;
 
+  // the picture may still be reconstructed by a frame thread
+  wait_picture_rows(p, INT_MAX);
+
 #if (ENABLE_OUTPUT_TONEMAPPING)
   // note: this tone-mapping is working for RGB format only. Sharp
   if (p->seiHasTone_mapping && rgb_output)
@@ -526,6 +698,14 @@ static void write_out_picture(VideoParameters *p_Vid, StorablePicture *p, int p_
   if (p_out == -1)
     return;
 
+  DEC_PROFILE_START(p_Vid, PROF_OUTPUT);
+
+  if (p_Inp->output_scale)
+  {
+    write_out_scaled_picture(p_Vid, p, p_out, crop_left, crop_right, crop_top, crop_bottom);
+    DEC_PROFILE_STOP(p_Vid, PROF_OUTPUT);
+    return;
+  }
 
 
   // KS: this buffer should actually be allocated only once, but this is still much faster than the previous version
@@ -669,6 +849,7 @@ static void write_out_picture(VideoParameters *p_Vid, StorablePicture *p, int p_
  if(p_out >=0)
    pDecPic->bValid = 0;
 
+  DEC_PROFILE_STOP(p_Vid, PROF_OUTPUT);
   //  fsync(p_out);
 }
 
@@ -23,6 +23,7 @@
 #include "vlc.h"
 #include "mbuffer.h"
 #include "erc_api.h"
+#include "frame_thread.h"
 
 #if TRACE
 #define SYMTRACESTRING(s) strncpy(sym->tracestring,s,TRACESTRING_SIZE)
@@ -527,6 +528,10 @@ void MakePPSavailable (VideoParameters *p_Vid, int id, pic_parameter_set_rbsp_t
 {
   assert (pps->Valid == TRUE);
 
+  // the slices of the pictures still being reconstructed may use the replaced parameter set
+  if (p_Vid->PicParSet[id].Valid == TRUE)
+    frame_threads_drain(p_Vid);
+
   if (p_Vid->PicParSet[id].Valid == TRUE && p_Vid->PicParSet[id].slice_group_id != NULL)
     free (p_Vid->PicParSet[id].slice_group_id);
 
@@ -555,6 +560,8 @@ void CleanUpPPS(VideoParameters *p_Vid)
 void MakeSPSavailable (VideoParameters *p_Vid, int id, seq_parameter_set_rbsp_t *sps)
 {
   assert (sps->Valid == TRUE);
+  if (p_Vid->SeqParSet[id].Valid == TRUE)
+    frame_threads_drain(p_Vid);
   memcpy (&p_Vid->SeqParSet[id], sps, sizeof (seq_parameter_set_rbsp_t));
 }
 
@@ -1036,6 +1043,8 @@ void activate_sps (VideoParameters *p_Vid, seq_parameter_set_rbsp_t *sps)
         || p_Vid->last_max_dec_frame_buffering != GetMaxDecFrameBuffering(p_Vid)
         || */(p_Vid->last_profile_idc != p_Vid->active_sps->profile_idc && is_BL_profile(p_Vid->active_sps->profile_idc) && !p_Vid->p_Dpb_layer[0]->init_done /*&& is_BL_profile(p_Vid->last_profile_idc)*/))
     {
+      // the frame threads use the buffers of the previous sequence
+      frame_threads_drain(p_Vid);
       //init_frext(p_Vid);
       init_global_buffers(p_Vid, 0);
 
@@ -1051,6 +1060,7 @@ void activate_sps (VideoParameters *p_Vid, seq_parameter_set_rbsp_t *sps)
             )&& (!p_Vid->p_Dpb_layer[1]->init_done))
     {
       assert(p_Vid->p_Dpb_layer[0]->init_done);
+      frame_threads_drain(p_Vid);
       //init_frext(p_Vid);
       if(p_Vid->p_Dpb_layer[0]->init_done)
       {
@@ -1074,6 +1084,8 @@ void activate_sps (VideoParameters *p_Vid, seq_parameter_set_rbsp_t *sps)
     p_Vid->last_profile_idc = p_Vid->active_sps->profile_idc;
 
 #else
+    // the frame threads use the buffers of the previous sequence
+    frame_threads_drain(p_Vid);
     //init_frext(p_Vid);
     init_global_buffers(p_Vid, 0);
 
@@ -0,0 +1,285 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    plane_thread.c
+ * \brief
+ *    Concurrent decoding of the colour planes of 4:4:4 independent
+ *    mode pictures. The slices of PLANE_U and PLANE_V are decoded and
+ *    deblocked by two worker threads on private copies of the
+ *    VideoParameters, while the calling thread decodes PLANE_Y. The
+ *    workers are started once and wait for the pictures. The
+ *    planes use separate macroblock buffers (mb_data_JV etc.); only
+ *    the CAVLC coefficient counts and the error concealment motion
+ *    buffer are shared by the planes and duplicated for the workers.
+ ***********************************************************************
+ */
+
+#include "global.h"
+#include "plane_thread.h"
+#include "image.h"
+#include "loopfilter.h"
+#include "memalloc.h"
+#include "erc_api.h"
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    (re)allocates the private buffers of a job for the current
+ *    picture size
+ ***********************************************************************
+ */
+static void alloc_job_buffers(PlaneJob *job, VideoParameters *p_Vid)
+{
+  if (job->FrameSizeInMbs == (int) p_Vid->FrameSizeInMbs)
+    return;
+
+  if (job->nz_coeff)
+  {
+    free_mem4D(job->nz_coeff);
+    free(job->erc_object_list);
+  }
+
+  get_mem4D(&job->nz_coeff, p_Vid->FrameSizeInMbs, 3, BLOCK_SIZE, BLOCK_SIZE);
+  if ((job->erc_object_list = (objectBuffer_t *) calloc((p_Vid->width * p_Vid->height) >> 6, sizeof(objectBuffer_t))) == NULL)
+    no_mem_exit("alloc_job_buffers: job->erc_object_list");
+
+  job->FrameSizeInMbs = p_Vid->FrameSizeInMbs;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    decodes the slices of one colour plane of the current picture
+ *    and deblocks the plane if requested
+ ***********************************************************************
+ */
+static void decode_plane_slices(VideoParameters *p_Vid, int colour_plane_id, int deblock)
+{
+  int iSliceNo;
+
+  for (iSliceNo = 0; iSliceNo < p_Vid->iSliceNumOfCurrPic; iSliceNo++)
+  {
+    Slice *currSlice = p_Vid->ppSliceList[iSliceNo];
+
+    if (currSlice->colour_plane_id != colour_plane_id)
+      continue;
+
+    decode_slice(currSlice, currSlice->current_header);
+
+    p_Vid->iNumOfSlicesDecoded++;
+    p_Vid->num_dec_mb += currSlice->num_dec_mb;
+    p_Vid->erc_mvperMB += currSlice->erc_mvperMB;
+  }
+
+  if (deblock)
+  {
+    change_plane_JV(p_Vid, colour_plane_id, NULL);
+    DeblockPicture(p_Vid, p_Vid->dec_picture);
+  }
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    worker thread: decodes one colour plane of each dispatched
+ *    picture
+ ***********************************************************************
+ */
+static void plane_worker(void *arg)
+{
+  PlaneJob *job = (PlaneJob *) arg;
+  PlaneThreads *pt = job->p_Threads;
+
+  mutex_lock(&pt->lock);
+  while (!pt->quit)
+  {
+    if (!job->busy)
+    {
+      cond_wait(&pt->cond, &pt->lock);
+      continue;
+    }
+    mutex_unlock(&pt->lock);
+
+    decode_plane_slices(job->p_Vid, job->colour_plane_id, job->deblock);
+
+    mutex_lock(&pt->lock);
+    job->busy = 0;
+    cond_broadcast(&pt->cond);
+  }
+  mutex_unlock(&pt->lock);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    enables concurrent colour plane decoding if requested and
+ *    possible with the decoder configuration
+ ***********************************************************************
+ */
+void init_plane_threads(VideoParameters *p_Vid)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  PlaneThreads *pt;
+  int i;
+
+  // profiling and tracing need the macroblocks in decoding order
+  if (p_Inp->plane_threads <= 0 || p_Vid->dec_profile != NULL || TRACE)
+    return;
+
+  if ((pt = (PlaneThreads *) calloc(1, sizeof(PlaneThreads))) == NULL)
+    no_mem_exit("init_plane_threads: pt");
+  mutex_init(&pt->lock);
+  cond_init(&pt->cond);
+
+  for (i = 0; i < MAX_PLANE - 1; i++)
+  {
+    PlaneJob *job = &pt->jobs[i];
+
+    job->p_Threads = pt;
+    job->colour_plane_id = PLANE_U + i;
+    if ((job->p_Vid = (VideoParameters *) calloc(1, sizeof(VideoParameters))) == NULL)
+      no_mem_exit("init_plane_threads: job->p_Vid");
+    if (thread_create(&job->thread, plane_worker, job))
+      error("init_plane_threads: cannot create plane thread", 500);
+  }
+
+  p_Vid->p_PlaneThreads = pt;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    stops the plane threads and frees their resources
+ ***********************************************************************
+ */
+void free_plane_threads(VideoParameters *p_Vid)
+{
+  PlaneThreads *pt = p_Vid->p_PlaneThreads;
+  int i;
+
+  if (pt == NULL)
+    return;
+
+  mutex_lock(&pt->lock);
+  pt->quit = 1;
+  cond_broadcast(&pt->cond);
+  mutex_unlock(&pt->lock);
+
+  for (i = 0; i < MAX_PLANE - 1; i++)
+  {
+    PlaneJob *job = &pt->jobs[i];
+
+    thread_join(job->thread);
+    if (job->nz_coeff)
+    {
+      free_mem4D(job->nz_coeff);
+      free(job->erc_object_list);
+    }
+    free(job->p_Vid);
+  }
+  mutex_destroy(&pt->lock);
+  cond_destroy(&pt->cond);
+  free(pt);
+  p_Vid->p_PlaneThreads = NULL;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    returns 1 if the colour planes of the current picture can be
+ *    decoded concurrently: 4:4:4 independent mode pictures without
+ *    lost or redundant slices. The concealment of lost slices needs
+ *    the planes before they are deblocked.
+ ***********************************************************************
+ */
+int plane_threads_eligible(VideoParameters *p_Vid)
+{
+  int i;
+
+  if (p_Vid->dec_picture == NULL || !p_Vid->separate_colour_plane_flag)
+    return 0;
+
+  for (i = 0; i < p_Vid->iSliceNumOfCurrPic; i++)
+  {
+    Slice *currSlice = p_Vid->ppSliceList[i];
+    if (currSlice->ei_flag || currSlice->dpB_NotPresent || currSlice->dpC_NotPresent || currSlice->redundant_pic_cnt)
+      return 0;
+  }
+  return 1;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    decodes and deblocks the three colour planes of the current
+ *    picture concurrently. Returns when all planes are done; the
+ *    planes are combined by exit_picture().
+ ***********************************************************************
+ */
+void decode_colour_planes(VideoParameters *p_Vid)
+{
+  PlaneThreads *pt = p_Vid->p_PlaneThreads;
+  int deblock = !p_Vid->iDeblockMode && (p_Vid->bDeblockEnable & (1 << p_Vid->dec_picture->used_for_reference));
+  int i, j;
+
+  // the reference lists are set up before any plane is decoded
+  for (i = 0; i < p_Vid->iSliceNumOfCurrPic; i++)
+    init_slice(p_Vid, p_Vid->ppSliceList[i]);
+
+  for (i = 0; i < MAX_PLANE - 1; i++)
+  {
+    PlaneJob *job = &pt->jobs[i];
+    VideoParameters *p_Job = job->p_Vid;
+
+    alloc_job_buffers(job, p_Vid);
+    memcpy(p_Job, p_Vid, sizeof(VideoParameters));
+    p_Job->nz_coeff            = job->nz_coeff;
+    p_Job->erc_object_list     = job->erc_object_list;
+    p_Job->erc_img             = p_Job;
+    p_Job->p_FrameThreads      = NULL;
+    p_Job->p_PlaneThreads      = NULL;
+    p_Job->iNumOfSlicesDecoded = 0;
+    p_Job->num_dec_mb          = 0;
+    p_Job->erc_mvperMB         = 0;
+    change_plane_JV(p_Job, job->colour_plane_id, NULL);
+
+    if (p_Vid->active_pps->entropy_coding_mode_flag == (Boolean) CAVLC)
+      memset(job->nz_coeff[0][0][0], -1, p_Vid->PicSizeInMbs * 48 * sizeof(byte)); // 3 * 4 * 4
+
+    for (j = 0; j < p_Vid->iSliceNumOfCurrPic; j++)
+    {
+      if (p_Vid->ppSliceList[j]->colour_plane_id == job->colour_plane_id)
+        p_Vid->ppSliceList[j]->p_Vid = p_Job;
+    }
+
+    job->deblock = deblock;
+  }
+
+  mutex_lock(&pt->lock);
+  for (i = 0; i < MAX_PLANE - 1; i++)
+    pt->jobs[i].busy = 1;
+  cond_broadcast(&pt->cond);
+  mutex_unlock(&pt->lock);
+
+  decode_plane_slices(p_Vid, PLANE_Y, deblock);
+
+  mutex_lock(&pt->lock);
+  while (pt->jobs[0].busy || pt->jobs[1].busy)
+    cond_wait(&pt->cond, &pt->lock);
+  mutex_unlock(&pt->lock);
+
+  for (i = 0; i < MAX_PLANE - 1; i++)
+  {
+    VideoParameters *p_Job = pt->jobs[i].p_Vid;
+
+    p_Vid->iNumOfSlicesDecoded += p_Job->iNumOfSlicesDecoded;
+    p_Vid->num_dec_mb          += p_Job->num_dec_mb;
+    p_Vid->erc_mvperMB         += p_Job->erc_mvperMB;
+  }
+
+  for (j = 0; j < p_Vid->iSliceNumOfCurrPic; j++)
+    p_Vid->ppSliceList[j]->p_Vid = p_Vid;
+
+  // the planes have been deblocked, exit_picture() only combines them
+  p_Vid->iPlanesDeblocked = deblock;
+}
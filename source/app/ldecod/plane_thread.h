@@ -0,0 +1,45 @@
+/*!
+ **************************************************************************
+ *  \file plane_thread.h
+ *
+ *  \brief
+ *     Concurrent decoding of the colour planes of 4:4:4 independent
+ *     mode pictures (enabled with the PlaneThreads parameter)
+ *
+ **************************************************************************
+ */
+
+#ifndef _PLANE_THREAD_H_
+#define _PLANE_THREAD_H_
+#include "global.h"
+
+//! one colour plane decoded by a worker thread
+typedef struct plane_job
+{
+  VideoParameters      *p_Vid;                //!< private copy of the decoder state the plane is decoded with
+  ThreadHandle          thread;
+  struct plane_threads *p_Threads;
+  int                   busy;                 //!< plane dispatched and not yet decoded
+  int                   colour_plane_id;
+  int                   deblock;              //!< deblock the plane after its slices are decoded
+
+  // buffers shared by the planes in the calling thread, private to the job
+  byte              ****nz_coeff;
+  struct object_buffer *erc_object_list;
+  int                   FrameSizeInMbs;       //!< size the buffers above are allocated for
+} PlaneJob;
+
+typedef struct plane_threads
+{
+  PlaneJob    jobs[MAX_PLANE - 1];            //!< PLANE_U and PLANE_V, PLANE_Y is decoded by the calling thread
+  ThreadMutex lock;                           //!< protects busy and quit
+  ThreadCond  cond;                           //!< signals a dispatched plane to the workers and a decoded one to the caller
+  int         quit;
+} PlaneThreads;
+
+extern void init_plane_threads    (VideoParameters *p_Vid);
+extern void free_plane_threads    (VideoParameters *p_Vid);
+extern int  plane_threads_eligible(VideoParameters *p_Vid);
+extern void decode_colour_planes  (VideoParameters *p_Vid);
+
+#endif
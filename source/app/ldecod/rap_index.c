@@ -0,0 +1,309 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    rap_index.c
+ * \brief
+ *    Random access index of Annex B bit streams. build_rap_index()
+ *    scans the NAL units of the bit stream without decoding them and
+ *    writes the random access points (IDR pictures and pictures with a
+ *    recovery point SEI message) to a text file, one line per access
+ *    unit:
+ *
+ *      picture offset type n offset_1 .. offset_n
+ *
+ *    picture is the number of the access unit in decoding order (the
+ *    pictures of the non-base view are not counted), offset the byte
+ *    position of the first NAL unit of the access unit and type IDR or
+ *    RP. The n offsets are the byte positions of the
+ *    parameter sets that are active in front of the access unit.
+ *    seek_rap_index() decodes these parameter sets and continues
+ *    reading the bit stream at the last random access point before
+ *    the SeekPicture.
+ ***********************************************************************
+ */
+
+#include "global.h"
+#include "rap_index.h"
+#include "annexb.h"
+#include "nalu.h"
+#include "parset.h"
+#include "sei.h"
+#include "vlc.h"
+
+#define RAP_INDEX_HEADER "# JM random access index: picture offset type n parameter set offsets"
+
+// parameter sets are tracked by NAL unit type and id
+#define PS_SPS        0
+#define PS_SUBSET_SPS MAXSPS
+#define PS_PPS        (2 * MAXSPS)
+#define PS_NUM        (2 * MAXSPS + MAXPPS)
+
+#define INDEX_NAME_SIZE (FILE_NAME_SIZE + 4)
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    name of the index file: IndexFile or the bit stream name with
+ *    .idx appended
+ ***********************************************************************
+ */
+static void get_index_name(InputParameters *p_Inp, char *name)
+{
+  if (strlen(p_Inp->index_file) > 0 && strcmp(p_Inp->index_file, "\"\""))
+    snprintf(name, INDEX_NAME_SIZE, "%s", p_Inp->index_file);
+  else
+    snprintf(name, INDEX_NAME_SIZE, "%s.idx", p_Inp->infile);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    returns 1 if the SEI NAL unit (RBSP) contains a recovery point
+ *    message
+ ***********************************************************************
+ */
+static int has_recovery_point(NALU_t *nalu)
+{
+  int offset = 1;
+
+  while (offset + 1 < nalu->len && nalu->buf[offset] != 0x80)
+  {
+    int payload_type = 0;
+    int payload_size = 0;
+
+    while (offset < nalu->len && nalu->buf[offset] == 0xFF)
+    {
+      payload_type += 255;
+      offset++;
+    }
+    payload_type += nalu->buf[offset++];
+
+    while (offset < nalu->len && nalu->buf[offset] == 0xFF)
+    {
+      payload_size += 255;
+      offset++;
+    }
+    payload_size += nalu->buf[offset++];
+
+    if (payload_type == SEI_RECOVERY_POINT)
+      return 1;
+    offset += payload_size;
+  }
+  return 0;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    writes one random access point to the index file
+ ***********************************************************************
+ */
+static void write_rap(FILE *f, int picture, int64 offset, int idr, int64 *ps_offset)
+{
+  int64 ps[PS_NUM];
+  int n = 0, i, j;
+
+  // in the order of the bit stream, the parameter sets of the access unit itself are decoded with it
+  for (i = 0; i < PS_NUM; i++)
+  {
+    if (ps_offset[i] < 0 || ps_offset[i] >= offset)
+      continue;
+    for (j = n++; j > 0 && ps[j - 1] > ps_offset[i]; j--)
+      ps[j] = ps[j - 1];
+    ps[j] = ps_offset[i];
+  }
+
+  fprintf(f, "%d %lld %s %d", picture, (long long) offset, idr ? "IDR" : "RP", n);
+  for (i = 0; i < n; i++)
+    fprintf(f, " %lld", (long long) ps[i]);
+  fprintf(f, "\n");
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    scans the bit stream and writes the random access index. The NAL
+ *    units are read by read_next_nalu, so the headers are parsed with
+ *    the emulation prevention bytes removed. With BuildIndex = 1 the
+ *    bit stream is decoded afterwards, with BuildIndex = 2 decoding
+ *    ends with the scan.
+ ***********************************************************************
+ */
+void build_rap_index(VideoParameters *p_Vid)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  ANNEXB_t *annex_b = p_Vid->annex_b;
+  NALU_t *nalu = p_Vid->nalu;
+  char name[INDEX_NAME_SIZE];
+  int64 ps_offset[PS_NUM];
+  int64 au_offset = 0;
+  int prev_vcl = 1;
+  int recovery_point = 0;
+  int picture = 0, num_rap = 0;
+  int i;
+  FILE *f;
+
+  if (p_Inp->FileFormat != PAR_OF_ANNEXB)
+    error("build_rap_index: the random access index needs an Annex B bit stream", 500);
+
+  get_index_name(p_Inp, name);
+  if ((f = fopen(name, "w")) == NULL)
+  {
+    snprintf(errortext, ET_SIZE, "Error open file %s", name);
+    error(errortext, 500);
+  }
+  fprintf(f, "%s\n", RAP_INDEX_HEADER);
+
+  for (i = 0; i < PS_NUM; i++)
+    ps_offset[i] = -1;
+
+  while (read_next_nalu(p_Vid, nalu) > 0)
+  {
+    int64 offset = annex_b->nalu_offset;
+    int bitoffset = 0;
+    int id;
+
+    switch (nalu->nal_unit_type)
+    {
+    case NALU_TYPE_SLICE:
+    case NALU_TYPE_DPA:
+    case NALU_TYPE_IDR:
+      if (peek_ue_v(nalu->buf + 1, &bitoffset, nalu->len - 1) == 0)  // first_mb_in_slice
+      {
+        if (prev_vcl)
+          au_offset = offset;
+        if (nalu->nal_unit_type == NALU_TYPE_IDR || recovery_point)
+        {
+          write_rap(f, picture, au_offset, nalu->nal_unit_type == NALU_TYPE_IDR, ps_offset);
+          num_rap++;
+        }
+        recovery_point = 0;
+        picture++;
+      }
+      prev_vcl = 1;
+      break;
+    case NALU_TYPE_SLC_EXT:
+      // non-base view pictures belong to the access unit of the base view
+    case NALU_TYPE_DPB:
+    case NALU_TYPE_DPC:
+      prev_vcl = 1;
+      break;
+    default:
+      if (prev_vcl)
+        au_offset = offset;
+      prev_vcl = 0;
+
+      if (nalu->nal_unit_type == NALU_TYPE_SEI)
+        recovery_point |= has_recovery_point(nalu);
+      else if (nalu->nal_unit_type == NALU_TYPE_SPS || nalu->nal_unit_type == NALU_TYPE_SUB_SPS)
+      {
+        bitoffset = 24;   // profile_idc, constraint flags, level_idc
+        id = peek_ue_v(nalu->buf + 1, &bitoffset, nalu->len - 1);
+        if (id >= 0 && id < MAXSPS)
+          ps_offset[(nalu->nal_unit_type == NALU_TYPE_SPS ? PS_SPS : PS_SUBSET_SPS) + id] = offset;
+      }
+      else if (nalu->nal_unit_type == NALU_TYPE_PPS)
+      {
+        id = peek_ue_v(nalu->buf + 1, &bitoffset, nalu->len - 1);
+        if (id >= 0 && id < MAXPPS)
+          ps_offset[PS_PPS + id] = offset;
+      }
+      break;
+    }
+  }
+  fclose(f);
+
+  if (p_Inp->silent == FALSE)
+    printf("Random access index %s: %d random access points in %d access units\n", name, num_rap, picture);
+
+  if (p_Inp->build_index == 1)
+  {
+    p_Vid->NALUCount = 0;
+    p_Vid->LastAccessUnitExists = 0;
+    seek_annex_b(annex_b, 0);
+  }
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    continues decoding at the last random access point of the index
+ *    file in front of the SeekPicture
+ ***********************************************************************
+ */
+void seek_rap_index(VideoParameters *p_Vid)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  ANNEXB_t *annex_b = p_Vid->annex_b;
+  NALU_t *nalu = p_Vid->nalu;
+  char name[INDEX_NAME_SIZE];
+  char line[256];
+  char type[16];
+  int64 ps[PS_NUM], rap_ps[PS_NUM];
+  long long offset, rap_offset = -1;
+  int picture, n, rap_picture = 0, rap_n = 0, rap_idr = 0;
+  int i;
+  FILE *f;
+
+  if (p_Inp->FileFormat != PAR_OF_ANNEXB)
+    error("seek_rap_index: seeking needs an Annex B bit stream", 500);
+
+  get_index_name(p_Inp, name);
+  if ((f = fopen(name, "r")) == NULL)
+  {
+    snprintf(errortext, ET_SIZE, "Cannot open random access index %s", name);
+    error(errortext, 500);
+  }
+  if (fgets(line, sizeof(line), f) == NULL || strncmp(line, RAP_INDEX_HEADER, strlen(RAP_INDEX_HEADER)))
+  {
+    snprintf(errortext, ET_SIZE, "%s is not a random access index", name);
+    error(errortext, 500);
+  }
+
+  while (fscanf(f, "%d %lld %15s %d", &picture, &offset, type, &n) == 4 && picture <= p_Inp->seek_picture)
+  {
+    if (n < 0 || n > PS_NUM)
+      break;
+    for (i = 0; i < n; i++)
+    {
+      long long ps_offset;
+      if (fscanf(f, "%lld", &ps_offset) != 1)
+        error("seek_rap_index: broken random access index", 500);
+      ps[i] = ps_offset;
+    }
+    rap_picture = picture;
+    rap_offset  = offset;
+    rap_idr     = !strcmp(type, "IDR");
+    rap_n       = n;
+    memcpy(rap_ps, ps, n * sizeof(int64));
+  }
+  fclose(f);
+
+  if (rap_offset < 0)
+  {
+    printf("Warning: no random access point in front of picture %d, decoding starts with the first picture\n", p_Inp->seek_picture);
+    return;
+  }
+
+  for (i = 0; i < rap_n; i++)
+  {
+    seek_annex_b(annex_b, rap_ps[i]);
+    if (read_next_nalu(p_Vid, nalu) == 0)
+      continue;
+
+    if (nalu->nal_unit_type == NALU_TYPE_SPS)
+      ProcessSPS(p_Vid, nalu);
+    else if (nalu->nal_unit_type == NALU_TYPE_PPS)
+      ProcessPPS(p_Vid, nalu);
+#if (MVC_EXTENSION_ENABLE)
+    else if (nalu->nal_unit_type == NALU_TYPE_SUB_SPS && p_Inp->DecodeAllLayers == 1)
+      ProcessSubsetSPS(p_Vid, nalu);
+#endif
+  }
+  p_Vid->NALUCount = 0;
+
+  seek_annex_b(annex_b, rap_offset);
+
+  if (p_Inp->silent == FALSE)
+    printf("Decoding starts with %s picture %d at byte %lld\n", rap_idr ? "IDR" : "recovery point", rap_picture, rap_offset);
+}
@@ -0,0 +1,19 @@
+/*!
+ **************************************************************************
+ *  \file rap_index.h
+ *
+ *  \brief
+ *     Random access index of Annex B bit streams (BuildIndex, IndexFile
+ *     and SeekPicture parameters)
+ *
+ **************************************************************************
+ */
+
+#ifndef _RAP_INDEX_H_
+#define _RAP_INDEX_H_
+#include "global.h"
+
+extern void build_rap_index(VideoParameters *p_Vid);
+extern void seek_rap_index (VideoParameters *p_Vid);
+
+#endif
@@ -711,12 +711,12 @@ static void read_CBP_and_coeffs_from_NAL_CABAC_420(Macroblock *currMB)
     if(currMB->luma_transform_size_8x8_flag) 
     {
       //======= 8x8 transform size & CABAC ========
-      currMB->read_comp_coeff_8x8_CABAC (currMB, &currSE, PLANE_Y); 
+      currMB->p_Slice->read_comp_coeff_8x8_CABAC (currMB, &currSE, PLANE_Y); 
     }
     else
     {
       InvLevelScale4x4 = intra? currSlice->InvLevelScale4x4_Intra[currSlice->colour_plane_id][qp_rem] : currSlice->InvLevelScale4x4_Inter[currSlice->colour_plane_id][qp_rem];
-      currMB->read_comp_coeff_4x4_CABAC (currMB, &currSE, PLANE_Y, InvLevelScale4x4, qp_per, cbp);        
+      currMB->p_Slice->read_comp_coeff_4x4_CABAC (currMB, &currSE, PLANE_Y, InvLevelScale4x4, qp_per, cbp);        
     }
   }
 
@@ -1119,12 +1119,12 @@ static void read_CBP_and_coeffs_from_NAL_CABAC_400(Macroblock *currMB)
     if(currMB->luma_transform_size_8x8_flag) 
     {
       //======= 8x8 transform size & CABAC ========
-      currMB->read_comp_coeff_8x8_CABAC (currMB, &currSE, PLANE_Y); 
+      currMB->p_Slice->read_comp_coeff_8x8_CABAC (currMB, &currSE, PLANE_Y); 
     }
     else
     {
       InvLevelScale4x4 = intra? currSlice->InvLevelScale4x4_Intra[currSlice->colour_plane_id][qp_rem] : currSlice->InvLevelScale4x4_Inter[currSlice->colour_plane_id][qp_rem];
-      currMB->read_comp_coeff_4x4_CABAC (currMB, &currSE, PLANE_Y, InvLevelScale4x4, qp_per, cbp);        
+      currMB->p_Slice->read_comp_coeff_4x4_CABAC (currMB, &currSE, PLANE_Y, InvLevelScale4x4, qp_per, cbp);        
     }
   }  
 }
@@ -1349,11 +1349,11 @@ static void read_CBP_and_coeffs_from_NAL_CABAC_444(Macroblock *currMB)
       if(currMB->luma_transform_size_8x8_flag) 
       {
         //======= 8x8 transform size & CABAC ========
-        currMB->read_comp_coeff_8x8_CABAC (currMB, &currSE, PLANE_Y); 
+        currMB->p_Slice->read_comp_coeff_8x8_CABAC (currMB, &currSE, PLANE_Y); 
       }
       else
       {
-        currMB->read_comp_coeff_4x4_CABAC (currMB, &currSE, PLANE_Y, InvLevelScale4x4, qp_per, cbp);        
+        currMB->p_Slice->read_comp_coeff_4x4_CABAC (currMB, &currSE, PLANE_Y, InvLevelScale4x4, qp_per, cbp);        
       }
     }
   }
@@ -1431,11 +1431,11 @@ static void read_CBP_and_coeffs_from_NAL_CABAC_444(Macroblock *currMB)
         if(currMB->luma_transform_size_8x8_flag) 
         {
           //======= 8x8 transform size & CABAC ========
-          currMB->read_comp_coeff_8x8_CABAC (currMB, &currSE, (ColorPlane) (PLANE_U + uv)); 
+          currMB->p_Slice->read_comp_coeff_8x8_CABAC (currMB, &currSE, (ColorPlane) (PLANE_U + uv)); 
         }
         else //4x4
         {        
-          currMB->read_comp_coeff_4x4_CABAC (currMB, &currSE, (ColorPlane) (PLANE_U + uv), InvLevelScale4x4,  qp_per_uv[uv], cbp);
+          currMB->p_Slice->read_comp_coeff_4x4_CABAC (currMB, &currSE, (ColorPlane) (PLANE_U + uv), InvLevelScale4x4,  qp_per_uv[uv], cbp);
         }
       }
     }
@@ -1665,11 +1665,11 @@ static void read_CBP_and_coeffs_from_NAL_CABAC_422(Macroblock *currMB)
       if(currMB->luma_transform_size_8x8_flag) 
       {
         //======= 8x8 transform size & CABAC ========
-        currMB->read_comp_coeff_8x8_CABAC (currMB, &currSE, PLANE_Y); 
+        currMB->p_Slice->read_comp_coeff_8x8_CABAC (currMB, &currSE, PLANE_Y); 
       }
       else
       {
-        currMB->read_comp_coeff_4x4_CABAC (currMB, &currSE, PLANE_Y, InvLevelScale4x4, qp_per, cbp);        
+        currMB->p_Slice->read_comp_coeff_4x4_CABAC (currMB, &currSE, PLANE_Y, InvLevelScale4x4, qp_per, cbp);        
       }
     }
   }
@@ -1932,13 +1932,13 @@ void set_read_comp_coeff_cabac(Macroblock *currMB)
 {
   if (currMB->is_lossless == FALSE)
   {
-    currMB->read_comp_coeff_4x4_CABAC = read_comp_coeff_4x4_CABAC;
-    currMB->read_comp_coeff_8x8_CABAC = read_comp_coeff_8x8_MB_CABAC;
+    currMB->p_Slice->read_comp_coeff_4x4_CABAC = read_comp_coeff_4x4_CABAC;
+    currMB->p_Slice->read_comp_coeff_8x8_CABAC = read_comp_coeff_8x8_MB_CABAC;
   }
   else
   {
-    currMB->read_comp_coeff_4x4_CABAC = read_comp_coeff_4x4_CABAC_ls;
-    currMB->read_comp_coeff_8x8_CABAC = read_comp_coeff_8x8_MB_CABAC_ls;
+    currMB->p_Slice->read_comp_coeff_4x4_CABAC = read_comp_coeff_4x4_CABAC_ls;
+    currMB->p_Slice->read_comp_coeff_8x8_CABAC = read_comp_coeff_8x8_MB_CABAC_ls;
   }
 }
 
@@ -98,6 +98,124 @@ void itrans8x8(Macroblock *currMB,   //!< current macroblock
   }
 }
 
+/*!
+ ***********************************************************************
+ * \brief
+ *    Inverse 8x8 transformation of the coefficients m7[0..7][ioff..] fused
+ *    with the reconstruction. The residual is added to the prediction
+ *    mpr[0..7][ioff..], clipped and stored to img[0..7][img_x..].
+ ***********************************************************************
+ */
+static inline void inverse8x8_recon(int **m7, imgpel **mpr, imgpel **img, int ioff, int img_x, int max_imgpel_value)
+{
+  int tmp[BLOCK_SIZE_8x8][BLOCK_SIZE_8x8];
+  int res[BLOCK_SIZE_8x8][BLOCK_SIZE_8x8];
+  int i, j;
+
+  // Horizontal
+  for (j = 0; j < BLOCK_SIZE_8x8; j++)
+  {
+    int *p = &m7[j][ioff];
+    int a0, a1, a2, a3;
+    int b0, b1, b2, b3, b4, b5, b6, b7;
+
+    a0 = p[0] + p[4];
+    a1 = p[0] - p[4];
+    a2 = p[6] - (p[2] >> 1);
+    a3 = p[2] + (p[6] >> 1);
+
+    b0 = a0 + a3;
+    b2 = a1 - a2;
+    b4 = a1 + a2;
+    b6 = a0 - a3;
+
+    a0 = -p[3] + p[5] - p[7] - (p[7] >> 1);
+    a1 =  p[1] + p[7] - p[3] - (p[3] >> 1);
+    a2 = -p[1] + p[7] + p[5] + (p[5] >> 1);
+    a3 =  p[3] + p[5] + p[1] + (p[1] >> 1);
+
+    b1 = a0 + (a3 >> 2);
+    b3 = a1 + (a2 >> 2);
+    b5 = a2 - (a1 >> 2);
+    b7 = a3 - (a0 >> 2);
+
+    tmp[j][0] = b0 + b7;
+    tmp[j][1] = b2 - b5;
+    tmp[j][2] = b4 + b3;
+    tmp[j][3] = b6 + b1;
+    tmp[j][4] = b6 - b1;
+    tmp[j][5] = b4 - b3;
+    tmp[j][6] = b2 + b5;
+    tmp[j][7] = b0 - b7;
+  }
+
+  //  Vertical
+  for (i = 0; i < BLOCK_SIZE_8x8; i++)
+  {
+    int a0, a1, a2, a3;
+    int b0, b1, b2, b3, b4, b5, b6, b7;
+
+    a0 = tmp[0][i] + tmp[4][i];
+    a1 = tmp[0][i] - tmp[4][i];
+    a2 = tmp[6][i] - (tmp[2][i] >> 1);
+    a3 = tmp[2][i] + (tmp[6][i] >> 1);
+
+    b0 = a0 + a3;
+    b2 = a1 - a2;
+    b4 = a1 + a2;
+    b6 = a0 - a3;
+
+    a0 = -tmp[3][i] + tmp[5][i] - tmp[7][i] - (tmp[7][i] >> 1);
+    a1 =  tmp[1][i] + tmp[7][i] - tmp[3][i] - (tmp[3][i] >> 1);
+    a2 = -tmp[1][i] + tmp[7][i] + tmp[5][i] + (tmp[5][i] >> 1);
+    a3 =  tmp[3][i] + tmp[5][i] + tmp[1][i] + (tmp[1][i] >> 1);
+
+    b1 = a0 + (a3 >> 2);
+    b7 = a3 - (a0 >> 2);
+    b3 = a1 + (a2 >> 2);
+    b5 = a2 - (a1 >> 2);
+
+    res[0][i] = b0 + b7;
+    res[1][i] = b2 - b5;
+    res[2][i] = b4 + b3;
+    res[3][i] = b6 + b1;
+    res[4][i] = b6 - b1;
+    res[5][i] = b4 - b3;
+    res[6][i] = b2 + b5;
+    res[7][i] = b0 - b7;
+  }
+
+  // Reconstruction
+  for (j = 0; j < BLOCK_SIZE_8x8; j++)
+  {
+    imgpel *prd = &mpr[j][ioff];
+    imgpel *rec = &img[j][img_x];
+
+    for (i = 0; i < BLOCK_SIZE_8x8; i++)
+      rec[i] = (imgpel) iClip1(max_imgpel_value, prd[i] + rshift_rnd_sf(res[j][i], DQ_BITS_8));
+  }
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Inverse 8x8 transformation of the block at (ioff, joff) of the
+ *    macroblock, reconstructed directly into the picture rows img at
+ *    column img_x
+ ***********************************************************************
+ */
+void itrans8x8_recon(Macroblock *currMB,   //!< current macroblock
+                     ColorPlane pl,        //!< used color plane
+                     int ioff,             //!< index to 8x8 block
+                     int joff,             //!< index to 8x8 block
+                     imgpel **img,         //!< picture rows of the block
+                     int img_x)            //!< picture column of the block
+{
+  Slice *currSlice = currMB->p_Slice;
+
+  inverse8x8_recon(&currSlice->mb_rres[pl][joff], &currSlice->mb_pred[pl][joff], img, ioff, img_x, currMB->p_Vid->max_pel_value_comp[pl]);
+}
+
 /*!
  ***********************************************************************
  * \brief
@@ -19,5 +19,6 @@
 
 extern void itrans8x8   (Macroblock *currMB, ColorPlane pl, int ioff, int joff);
 extern void icopy8x8    (Macroblock *currMB, ColorPlane pl, int ioff, int joff);
+extern void itrans8x8_recon(Macroblock *currMB, ColorPlane pl, int ioff, int joff, imgpel **img, int img_x);
 
 #endif
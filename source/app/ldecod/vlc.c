@@ -59,6 +59,45 @@ int read_ue_v (char *tracestring, Bitstream *bitstream, int *used_bits)
 }
 
 
+/*!
+ *************************************************************************************
+ * \brief
+ *    reads an ue(v) syntax element at bit position *bitoffset of buffer without
+ *    tracing it, used to look at headers before they are decoded
+ *
+ * \return
+ *    the value of the syntax element, -1 at the end of the buffer
+ *************************************************************************************
+ */
+int peek_ue_v(byte buffer[], int *bitoffset, int bytecount)
+{
+  int info, value, dummy;
+  int len = GetVLCSymbol(buffer, *bitoffset, &info, bytecount);
+
+  if (len < 0)
+    return -1;
+  *bitoffset += len;
+  linfo_ue(len, info, &value, &dummy);
+  return value;
+}
+
+/*!
+ *************************************************************************************
+ * \brief
+ *    reads an u(v) syntax element like peek_ue_v()
+ *************************************************************************************
+ */
+int peek_u_v(int LenInBits, byte buffer[], int *bitoffset, int bytecount)
+{
+  int value;
+
+  if (GetBits(buffer, *bitoffset, &value, bytecount << 3, LenInBits) < 0)
+    return -1;
+  *bitoffset += LenInBits;
+  return value;
+}
+
+
 /*!
  *************************************************************************************
  * \brief
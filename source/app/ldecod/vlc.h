@@ -92,6 +92,8 @@ extern int  readSyntaxElement_UVLC(Macroblock *currMB, SyntaxElement *sym, struc
 extern int  readSyntaxElement_Intra4x4PredictionMode(SyntaxElement *sym, Bitstream   *currStream);
 
 extern int  GetVLCSymbol (byte buffer[],int totbitoffset,int *info, int bytecount);
+extern int  peek_ue_v    (byte buffer[], int *bitoffset, int bytecount);
+extern int  peek_u_v     (int LenInBits, byte buffer[], int *bitoffset, int bytecount);
 extern int  GetVLCSymbol_IntraMode (byte buffer[],int totbitoffset,int *info, int bytecount);
 
 extern int readSyntaxElement_FLC                         (SyntaxElement *sym, Bitstream *currStream);
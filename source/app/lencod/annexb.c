@@ -14,6 +14,7 @@
 
 #include "global.h"
 #include "nalucommon.h"
+#include "enc_profile.h"
 
 /*!
  ********************************************************************************************
@@ -33,6 +34,7 @@ int WriteAnnexbNALU (VideoParameters *p_Vid, NALU_t *n, FILE **f_annexb)
   static const byte startcode[] = {0,0,0,1};
   byte first_byte;
 
+  ENC_PROFILE_START(p_Vid, EPROF_OUTPUT);
   assert (n != NULL);
   assert (n->forbidden_bit == 0);
   assert ((*f_annexb) != NULL);
@@ -127,10 +129,70 @@ int WriteAnnexbNALU (VideoParameters *p_Vid, NALU_t *n, FILE **f_annexb)
   fprintf (p_Enc->p_trace, "\n----------------------------------------------------------------------------\n\n\n");
   fflush (p_Enc->p_trace);
 #endif
+  ENC_PROFILE_STOP(p_Vid, EPROF_OUTPUT);
   return BitsWritten;
 }
 
 
+/*!
+ ********************************************************************************************
+ * \brief
+ *    Hands a NALU in Annex B Byte Stream format to the application
+ *    (encoder library, see h264encoder.h)
+ *
+ * \return
+ *    number of bits written
+ *
+ ********************************************************************************************
+*/
+int WriteAnnexbNALUCallback (VideoParameters *p_Vid, NALU_t *n, FILE **f_annexb)
+{
+  int length = (n->startcodeprefix_len < 4) ? 3 : 4;
+  int size   = length + 1 + n->len;
+  byte *buf;
+
+  ENC_PROFILE_START(p_Vid, EPROF_OUTPUT);
+  assert (n->forbidden_bit == 0);
+  assert (n->startcodeprefix_len == 3 || n->startcodeprefix_len == 4);
+
+#if (MVC_EXTENSION_ENABLE)
+  if(n->nal_unit_type==NALU_TYPE_PREFIX || n->nal_unit_type==NALU_TYPE_SLC_EXT)
+    size += 3;
+#endif
+
+  if (size > p_Vid->nalu_buf_size)
+  {
+    free (p_Vid->nalu_buf);
+    if ((p_Vid->nalu_buf = (byte *) malloc(size)) == NULL)
+      no_mem_exit ("WriteAnnexbNALUCallback: p_Vid->nalu_buf");
+    p_Vid->nalu_buf_size = size;
+  }
+
+  buf = p_Vid->nalu_buf;
+  memset (buf, 0, length - 1);
+  buf[length - 1] = 1;
+  buf += length;
+  *buf++ = (byte) ((n->forbidden_bit << 7) | (n->nal_reference_idc << 5) | n->nal_unit_type);
+
+#if (MVC_EXTENSION_ENABLE)
+  if(n->nal_unit_type==NALU_TYPE_PREFIX || n->nal_unit_type==NALU_TYPE_SLC_EXT)
+  {
+    int view_id = p_Vid->p_Inp->MVCFlipViews ? !(n->view_id) : n->view_id;
+
+    *buf++ = (byte) ((n->svc_extension_flag << 7) | (n->non_idr_flag << 6) | n->priority_id);
+    *buf++ = (byte) (view_id >> 2);
+    *buf++ = (byte) (((view_id&3) << 6) | (n->temporal_id << 3) | (n->anchor_pic_flag << 2) | (n->inter_view_flag << 1) | n->reserved_one_bit);
+  }
+#endif
+
+  memcpy (buf, n->buf, n->len);
+  p_Vid->nalu_callback (p_Vid->nalu_opaque, p_Vid->nalu_buf, size, p_Vid->nalu_pts);
+
+  ENC_PROFILE_STOP(p_Vid, EPROF_OUTPUT);
+  return size << 3;
+}
+
+
 /*!
  ********************************************************************************************
  * \brief
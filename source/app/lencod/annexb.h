@@ -18,6 +18,7 @@
 #include "nalucommon.h"
 
 extern int WriteAnnexbNALU (VideoParameters *p_Vid, NALU_t *n, FILE **f_annexb);
+extern int WriteAnnexbNALUCallback (VideoParameters *p_Vid, NALU_t *n, FILE **f_annexb);
 extern void OpenAnnexbFile (char *fn, FILE **f_annexb);
 extern void CloseAnnexbFile(FILE *f_annexb);
 
@@ -0,0 +1,117 @@
+/*!
+ *************************************************************************************
+ * \file complexity.c
+ *
+ * \brief
+ *    Adaptive complexity control (ComplexityControl parameter).
+ *
+ *    The encoding time of every frame is smoothed and compared with the
+ *    time per frame of the target frame rate. If the encoder is too slow
+ *    the complexity level is raised, if it is well within the budget the
+ *    level is lowered again. Each level switches off the tools with the
+ *    best ratio of saved time to quality loss first: sub 8x8 partitions
+ *    and bi-predictive motion estimation, then references (and the range
+ *    of the full search), and finally the rate-distortion optimized mode
+ *    decision. The level only changes between frames.
+ *
+ *************************************************************************************
+ */
+
+#include "global.h"
+#include "complexity.h"
+
+#define CPLX_SMOOTHING   0.25   //!< weight of the latest frame in the average encoding time
+#define CPLX_LOW_LOAD    0.70   //!< fraction of the budget below which the level is lowered
+#define CPLX_HOLD        3      //!< frames between level changes
+
+static const ComplexityTools level_tools[CPLX_LEVELS] =
+{
+  // search_shift, max_refs, no_sub8x8, no_bipred_me, low_rdo
+  { 0, 0, 0, 0, 0 },
+  { 0, 0, 1, 1, 0 },
+  { 1, 2, 1, 1, 0 },
+  { 2, 1, 1, 1, 0 },
+  { 2, 1, 1, 1, 1 },
+};
+
+/*!
+ ************************************************************************
+ * \brief
+ *    allocates and initializes the complexity control
+ ************************************************************************
+ */
+ComplexityCtrl *init_complexity_control(InputParameters *p_Inp)
+{
+  ComplexityCtrl *p_Cplx;
+  double fps = (p_Inp->ComplexityTargetFps > 0.0) ? p_Inp->ComplexityTargetFps : p_Inp->source.frame_rate;
+  int md_metric = p_Inp->MEErrorMetric[(p_Inp->DisableSubpelME[0] || p_Inp->DisableSubpelME[1]) ? F_PEL : Q_PEL];
+
+  if ((p_Cplx = (ComplexityCtrl *) calloc (1, sizeof (ComplexityCtrl)))== NULL)
+    no_mem_exit ("init_complexity_control: p_Cplx");
+
+  p_Cplx->tools  = &level_tools[0];
+  p_Cplx->rdopt  = p_Inp->rdopt;
+  p_Cplx->budget = 1000.0 / fps;
+
+  // the low complexity mode decision has the restrictions checked in PatchInp for RDOptimization = 0
+  // and does not support field macroblock pairs
+  if ((p_Inp->rdopt == 1 || p_Inp->rdopt == 4) && !p_Inp->UseRDOQuant && !p_Inp->MbInterlace && md_metric == p_Inp->ModeDecisionMetric)
+    p_Cplx->max_level = CPLX_LEVELS - 1;
+  else
+    p_Cplx->max_level = CPLX_LEVELS - 2;
+
+  return p_Cplx;
+}
+
+void delete_complexity_control(ComplexityCtrl *p_Cplx)
+{
+  free (p_Cplx);
+}
+
+static void set_complexity_level(ComplexityCtrl *p_Cplx, InputParameters *p_Inp, int level)
+{
+  p_Cplx->level = level;
+  p_Cplx->tools = &level_tools[level];
+  p_Cplx->hold  = CPLX_HOLD;
+  p_Cplx->peak_level = imax(p_Cplx->peak_level, level);
+
+  p_Inp->rdopt = p_Cplx->tools->low_rdo ? 0 : p_Cplx->rdopt;
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    updates the complexity level with the encoding time of the last
+ *    frame (ms)
+ ************************************************************************
+ */
+void update_complexity_control(ComplexityCtrl *p_Cplx, InputParameters *p_Inp, int64 frame_time)
+{
+  double time = (double) frame_time;
+
+  p_Cplx->avg_time = (p_Cplx->frames == 0) ? time : p_Cplx->avg_time + CPLX_SMOOTHING * (time - p_Cplx->avg_time);
+  p_Cplx->level_sum += p_Cplx->level;
+  p_Cplx->frames++;
+
+  if (p_Cplx->hold > 0)
+  {
+    p_Cplx->hold--;
+    return;
+  }
+
+  if (p_Cplx->avg_time > p_Cplx->budget && p_Cplx->level < p_Cplx->max_level)
+    set_complexity_level(p_Cplx, p_Inp, p_Cplx->level + 1);
+  else if (p_Cplx->avg_time < CPLX_LOW_LOAD * p_Cplx->budget && p_Cplx->level > 0)
+    set_complexity_level(p_Cplx, p_Inp, p_Cplx->level - 1);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    restores the configured parameters at the end of the sequence
+ ************************************************************************
+ */
+void close_complexity_control(ComplexityCtrl *p_Cplx, InputParameters *p_Inp)
+{
+  p_Inp->rdopt = p_Cplx->rdopt;
+}
@@ -0,0 +1,47 @@
+/*!
+ **************************************************************************
+ *  \file complexity.h
+ *
+ *  \brief
+ *     Adaptive complexity control holding a target encoding frame rate
+ *     (ComplexityControl and ComplexityTargetFps parameters)
+ *
+ **************************************************************************
+ */
+
+#ifndef _COMPLEXITY_H_
+#define _COMPLEXITY_H_
+#include "global.h"
+
+#define CPLX_LEVELS  5   //!< complexity levels, 0 = configured parameters
+
+//! coding tools of a complexity level
+typedef struct complexity_tools
+{
+  int search_shift;     //!< full search range reduction (right shift of SearchRange)
+  int max_refs;         //!< active references per list (0: as configured)
+  int no_sub8x8;        //!< 8x4, 4x8 and 4x4 partitions disabled
+  int no_bipred_me;     //!< bi-predictive motion estimation disabled
+  int low_rdo;          //!< low complexity mode decision (RDOptimization = 0)
+} ComplexityTools;
+
+typedef struct complexity_ctrl
+{
+  const ComplexityTools *tools;  //!< tools of the current level
+  int    level;                  //!< current complexity level
+  int    max_level;              //!< highest level usable with the configuration
+  int    peak_level;             //!< highest level used
+  int    hold;                   //!< frames before the level may change again
+  int    rdopt;                  //!< configured RDOptimization
+  double budget;                 //!< encoding time per frame at the target frame rate (ms)
+  double avg_time;               //!< smoothed encoding time per frame (ms)
+  int64  frames;                 //!< controlled frames
+  int64  level_sum;              //!< sum of the levels of the controlled frames
+} ComplexityCtrl;
+
+extern ComplexityCtrl *init_complexity_control   (InputParameters *p_Inp);
+extern void            delete_complexity_control (ComplexityCtrl *p_Cplx);
+extern void            update_complexity_control (ComplexityCtrl *p_Cplx, InputParameters *p_Inp, int64 frame_time);
+extern void            close_complexity_control  (ComplexityCtrl *p_Cplx, InputParameters *p_Inp);
+
+#endif
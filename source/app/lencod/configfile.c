@@ -644,8 +644,11 @@ void read_slice_group_info(VideoParameters *p_Vid, InputParameters *p_Inp)
         snprintf(errortext, ET_SIZE, "Error while reading slice group config file (line %d)", i+1);
         error (errortext, 500);
       }
-      // scan remaining line
-      ret = fscanf(sgfile,"%*[^\n]");
+      else
+      {
+        // scan remaining line
+        ret = fscanf(sgfile,"%*[^\n]");
+      }
     }
     break;
 
@@ -730,14 +733,17 @@ void read_slice_group_info(VideoParameters *p_Vid, InputParameters *p_Inp)
           snprintf(errortext, ET_SIZE, "Error while reading slice group config file (line %d)", i + 1);
           error (errortext, 500);
         }
-        if ( *(p_Inp->slice_group_id+i) > p_Inp->num_slice_groups_minus1 )
+        else if ( *(p_Inp->slice_group_id+i) > p_Inp->num_slice_groups_minus1 )
         {
           fclose(sgfile);
           snprintf(errortext, ET_SIZE, "Error while reading slice group config file: slice_group_id not allowed (line %d)", i + 1);
           error (errortext, 500);
         }
-        // scan remaining line
-        ret = fscanf(sgfile,"%*[^\n]");
+        else
+        {
+          // scan remaining line
+          ret = fscanf(sgfile,"%*[^\n]");
+        }
       }
     }
     break;
@@ -1081,6 +1087,26 @@ static void PatchInp (VideoParameters *p_Vid, InputParameters *p_Inp)
     error (errortext, 500);
   }
 
+  if (p_Inp->FieldAnalysis && p_Inp->PicInterlace == ADAPTIVE_CODING && (p_Inp->RCEnable || p_Inp->RDPictureDecision
+    || p_Inp->redundant_pic_flag || p_Inp->sp_periodicity || p_Inp->si_frame_indicator))
+  {
+    printf("FieldAnalysis with PicInterlace = 2 is not supported with rate control, RDPictureDecision, redundant pictures or SP/SI pictures and therefore disabled.\n");
+    p_Inp->FieldAnalysis = 0;
+  }
+
+  // the analysis keeps the previous source picture of a single view
+  if (p_Inp->FieldAnalysis && p_Inp->num_of_views > 1)
+  {
+    printf("FieldAnalysis is not supported with MVC and therefore disabled.\n");
+    p_Inp->FieldAnalysis = 0;
+  }
+
+  if (p_Inp->ComplexityControl && p_Inp->num_of_views > 1)
+  {
+    printf("ComplexityControl is not supported with MVC and therefore disabled.\n");
+    p_Inp->ComplexityControl = 0;
+  }
+
   // Tian Dong: May 31, 2002
   // The number of frames in one sub-seq in enhanced layer should not exceed
   // the number of reference frame number.
@@ -67,6 +67,7 @@ Mapping Map[] = {
     {"NumberOfViews",            &cfgparams.num_of_views,                 0,   1.0,                       1,  1.0,              2.0,                             },
 #if (MVC_EXTENSION_ENABLE)
     {"View1ConfigFile",          &cfgparams.View1ConfigName,              1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
+    {"ViewThreads",              &cfgparams.ViewThreads,                  0,   0.0,                       1,  0.0,              1.0,                             },
 #endif
     {"Log2MaxFNumMinus4",        &cfgparams.Log2MaxFNumMinus4,            0,   0.0,                       1, -1.0,             12.0,                             },
     {"Log2MaxPOCLsbMinus4",      &cfgparams.Log2MaxPOCLsbMinus4,          0,   2.0,                       1, -1.0,             12.0,                             },
@@ -89,6 +90,8 @@ Mapping Map[] = {
     {"ReconFile",                &cfgparams.ReconFile,                    1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
     {"TraceFile",                &cfgparams.TraceFile,                    1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
     {"StatsFile",                &cfgparams.StatsFile,                    1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
+    {"ProfileFile",              &cfgparams.ProfileFile,                  1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
+    {"MemoryFile",               &cfgparams.MemoryFile,                   1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
     {"DisposableP",              &cfgparams.DisposableP,                  0,   0.0,                       1,  0.0,              1.0,                             },
     {"SetFirstAsLongTerm",       &cfgparams.SetFirstAsLongTerm,           0,   0.0,                       1,  0.0,              1.0,                             },
     {"MultiSourceData",          &cfgparams.MultiSourceData,              0,   0.0,                       0,  0.0,              2.0,                             },
@@ -152,6 +155,8 @@ Mapping Map[] = {
     {"EnableIPCM",               &cfgparams.EnableIPCM,                   0,   0.0,                       1,  0.0,              2.0,                             },
     {"ChromaIntraDisable",       &cfgparams.ChromaIntraDisable,           0,   0.0,                       1,  0.0,              1.0,                             },
     {"RDOptimization",           &cfgparams.rdopt,                        0,   0.0,                       1,  0.0,              4.0,                             },
+    {"ComplexityControl",        &cfgparams.ComplexityControl,            0,   0.0,                       1,  0.0,              1.0,                             },
+    {"ComplexityTargetFps",      &cfgparams.ComplexityTargetFps,          2,   0.0,                       1,  0.0,              480.0,                           },
 
     {"DistortionEstimation",     &cfgparams.de,                           0,   1.0,                       2,  0.0,              8.0,                             },
     {"SubMBCodingState",         &cfgparams.subMBCodingState,             0,   2.0,                       1,  0.0,              2.0,                             },
@@ -173,15 +178,20 @@ Mapping Map[] = {
     {"LossRateC",                &cfgparams.LossRateC,                    2,   0.0,                       2,  0.0,              0.0,                             },
     {"FirstFrameCorrect",        &cfgparams.FirstFrameCorrect,            0,   0.0,                       2,  0.0,              0.0,                             },
     {"NumberOfDecoders",         &cfgparams.NoOfDecoders,                 0,   0.0,                       2,  0.0,              0.0,                             },
+    {"DecoderThreads",           &cfgparams.DecoderThreads,               0,   0.0,                       1,  0.0,              64.0,                            },
     {"ErrorConcealment",         &cfgparams.ErrorConcealment,             0,   0.0,                       2,  0.0,              0.0,                             },
     {"RestrictRefFrames",        &cfgparams.RestrictRef ,                 0,   0.0,                       1,  0.0,              1.0,                             },
 #ifdef _LEAKYBUCKET_
     {"NumberofLeakyBuckets",     &cfgparams.NumberLeakyBuckets,           0,   2.0,                       1,  2.0,              255.0,                           },
     {"LeakyBucketRateFile",      &cfgparams.LeakyBucketRateFile,          1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
     {"LeakyBucketParamFile",     &cfgparams.LeakyBucketParamFile,         1,   0.0,                       0,  0.0,              0.0,             FILE_NAME_SIZE, },
+    {"LeakyBucketOnlineRates",   &cfgparams.LeakyBucketOnlineRates,       0,   0.0,                       1,  0.0,              1.0,                             },
 #endif
     {"PicInterlace",             &cfgparams.PicInterlace,                 0,   0.0,                       1,  0.0,              3.0,                             },
     {"MbInterlace",              &cfgparams.MbInterlace,                  0,   0.0,                       1,  0.0,              3.0,                             },
+    {"PAFFThreads",              &cfgparams.PAFFThreads,                  0,   0.0,                       1,  0.0,              1.0,                             },
+    {"FieldAnalysis",            &cfgparams.FieldAnalysis,                0,   0.0,                       1,  0.0,              1.0,                             },
+    {"FieldAnalysisMargin",      &cfgparams.FieldAnalysisMargin,          0,   20.0,                      1,  0.0,              1000.0,                          },
 
     {"IntraBottom",              &cfgparams.IntraBottom,                  0,   0.0,                       1,  0.0,              1.0,                             },
 
@@ -22,10 +22,10 @@
 #include "ctx_tables.h"
 #include "biariencode.h"
 #include "memalloc.h"
+#include "context_ini.h"
 
 #define DEFAULT_CTX_MODEL   0
 #define RELIABLE_COUNT      32.0
-#define FRAME_TYPES         4
 #define FIXED               0
 
 // These essentially are constants
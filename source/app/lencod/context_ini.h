@@ -16,6 +16,8 @@
 #ifndef _CONTEXT_INI_
 #define _CONTEXT_INI_
 
+#define FRAME_TYPES         4   //!< slice types the adaptive context initialization is kept for
+
 extern void  create_context_memory       (VideoParameters *p_Vid, InputParameters *p_Inp);
 extern void  free_context_memory         (VideoParameters *p_Vid);
 extern void  update_field_frame_contexts (VideoParameters *p_Vid, int);
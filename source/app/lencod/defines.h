@@ -151,6 +151,7 @@ typedef enum {
 #define BLOCK_MULTIPLE         4 // (MB_BLOCK_SIZE/BLOCK_SIZE)
 #define MB_BLOCK_PARTITIONS   16 // (BLOCK_MULTIPLE * BLOCK_MULTIPLE)
 #define BLOCK_CONTEXT         64 // (4 * MB_BLOCK_PARTITIONS)
+#define MV_BLOCK_TYPES         9 // block types with motion vectors in the mode decision
 // These variables relate to the subpel accuracy supported by the software (1/4)
 #define BLOCK_SIZE_SP      16  // BLOCK_SIZE << 2
 #define BLOCK_SIZE_8x8_SP  32  // BLOCK_SIZE8x8 << 2
@@ -0,0 +1,210 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    enc_profile.c
+ * \brief
+ *    Per module encoder timing and motion search statistics. The
+ *    module intervals are measured with gettime_ns() and accumulated
+ *    per slice type. Motion search candidates are counted by wrapping
+ *    the distortion functions of the MEBlock, and a histogram of the
+ *    candidates evaluated per block motion search is kept for each
+ *    block type. The report is written as JSON.
+ ***********************************************************************
+ */
+
+#include "global.h"
+#include "mbuffer.h"
+#include "enc_statistics.h"
+#include "enc_profile.h"
+
+static const char *module_name[EPROF_NUM_MODULES] = { "mode_decision", "me", "trellis", "interpolation", "entropy", "deblock", "distortion", "input", "output" };
+static const char *slice_name [NUM_SLICE_TYPES]   = { "P", "B", "I", "SP", "SI" };
+static const char *mode_name  [EPROF_ME_MODES]    = { "", "16x16", "16x8", "8x16", "8x8", "8x4", "4x8", "4x4" };
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    allocates and initializes the encoder profile
+ ***********************************************************************
+ */
+EncProfile *init_enc_profile(void)
+{
+  EncProfile *prof;
+
+  if ((prof = (EncProfile *) calloc (1, sizeof (EncProfile)))== NULL)
+    no_mem_exit ("init_enc_profile: prof");
+
+  return prof;
+}
+
+void delete_enc_profile(EncProfile *prof)
+{
+  free (prof);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    closes the running interval of a module
+ ***********************************************************************
+ */
+void enc_profile_stop(EncProfile *prof, EncProfModule module, int slice_type)
+{
+  int type = iClip3(0, NUM_SLICE_TYPES - 1, slice_type);
+
+  prof->time [type][module] += gettime_ns() - prof->start[module];
+  prof->count[type][module] ++;
+}
+
+static distblk count_pred_fpel(StorablePicture *ref, MEBlock *mv_block, distblk min_mcost, MotionVector *cand)
+{
+  mv_block->cand_count[F_PEL]++;
+  return mv_block->countedPred[F_PEL](ref, mv_block, min_mcost, cand);
+}
+
+static distblk count_pred_hpel(StorablePicture *ref, MEBlock *mv_block, distblk min_mcost, MotionVector *cand)
+{
+  mv_block->cand_count[H_PEL]++;
+  return mv_block->countedPred[H_PEL](ref, mv_block, min_mcost, cand);
+}
+
+static distblk count_pred_qpel(StorablePicture *ref, MEBlock *mv_block, distblk min_mcost, MotionVector *cand)
+{
+  mv_block->cand_count[Q_PEL]++;
+  return mv_block->countedPred[Q_PEL](ref, mv_block, min_mcost, cand);
+}
+
+static distblk count_bipred_fpel(StorablePicture *ref1, StorablePicture *ref2, MEBlock *mv_block, distblk min_mcost, MotionVector *cand1, MotionVector *cand2)
+{
+  mv_block->cand_count[F_PEL]++;
+  return mv_block->countedBiPred[F_PEL](ref1, ref2, mv_block, min_mcost, cand1, cand2);
+}
+
+static distblk count_bipred_hpel(StorablePicture *ref1, StorablePicture *ref2, MEBlock *mv_block, distblk min_mcost, MotionVector *cand1, MotionVector *cand2)
+{
+  mv_block->cand_count[H_PEL]++;
+  return mv_block->countedBiPred[H_PEL](ref1, ref2, mv_block, min_mcost, cand1, cand2);
+}
+
+static distblk count_bipred_qpel(StorablePicture *ref1, StorablePicture *ref2, MEBlock *mv_block, distblk min_mcost, MotionVector *cand1, MotionVector *cand2)
+{
+  mv_block->cand_count[Q_PEL]++;
+  return mv_block->countedBiPred[Q_PEL](ref1, ref2, mv_block, min_mcost, cand1, cand2);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    replaces the distortion functions of a motion estimation block
+ *    by wrappers counting the evaluated candidates
+ ***********************************************************************
+ */
+void enc_profile_count_candidates(MEBlock *mv_block)
+{
+  memset(mv_block->cand_count, 0, sizeof (mv_block->cand_count));
+
+  if (mv_block->computePredFPel != count_pred_fpel)
+  {
+    mv_block->countedPred[F_PEL]   = mv_block->computePredFPel;
+    mv_block->countedPred[H_PEL]   = mv_block->computePredHPel;
+    mv_block->countedPred[Q_PEL]   = mv_block->computePredQPel;
+    mv_block->countedBiPred[F_PEL] = mv_block->computeBiPredFPel;
+    mv_block->countedBiPred[H_PEL] = mv_block->computeBiPredHPel;
+    mv_block->countedBiPred[Q_PEL] = mv_block->computeBiPredQPel;
+
+    mv_block->computePredFPel   = count_pred_fpel;
+    mv_block->computePredHPel   = count_pred_hpel;
+    mv_block->computePredQPel   = count_pred_qpel;
+    mv_block->computeBiPredFPel = count_bipred_fpel;
+    mv_block->computeBiPredHPel = count_bipred_hpel;
+    mv_block->computeBiPredQPel = count_bipred_qpel;
+  }
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    accounts the candidates counted during one block motion search
+ *    (including its bi-predictive refinement)
+ ***********************************************************************
+ */
+void enc_profile_me(EncProfile *prof, MEBlock *mv_block)
+{
+  int mode = iClip3(0, EPROF_ME_MODES - 1, mv_block->blocktype);
+  int total = mv_block->cand_count[F_PEL] + mv_block->cand_count[H_PEL] + mv_block->cand_count[Q_PEL];
+  int bin = 0;
+  int pel;
+
+  while (total >> bin)
+    ++bin;
+
+  prof->me_searches[mode]++;
+  prof->me_hist[mode][imin(bin, EPROF_HIST_BINS - 1)]++;
+  for (pel = F_PEL; pel <= Q_PEL; pel++)
+    prof->me_cand[mode][pel] += mv_block->cand_count[pel];
+
+  memset(mv_block->cand_count, 0, sizeof (mv_block->cand_count));
+}
+
+static void write_enc_profile_modules(FILE *f, int64 *time, int64 *count)
+{
+  int module;
+
+  fprintf(f, "{");
+  for (module = 0; module < EPROF_NUM_MODULES; module++)
+    fprintf(f, "%s\"%s\": {\"ns\": %" FORMAT_OFF_T ", \"count\": %" FORMAT_OFF_T "}", module ? ", " : "", module_name[module], time[module], count[module]);
+  fprintf(f, "}");
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    writes the profile report
+ ***********************************************************************
+ */
+void write_enc_profile(VideoParameters *p_Vid, EncProfile *prof, char *filename)
+{
+  FILE *f;
+  int type, module, mode, bin;
+  int64 time[EPROF_NUM_MODULES], count[EPROF_NUM_MODULES];
+
+  if ((f = fopen(filename, "w")) == NULL)
+  {
+    fprintf(stderr, "Error open file %s for writing the encoder profile\n", filename);
+    return;
+  }
+
+  memset(time,  0, sizeof (time));
+  memset(count, 0, sizeof (count));
+  for (type = 0; type < NUM_SLICE_TYPES; type++)
+  {
+    for (module = 0; module < EPROF_NUM_MODULES; module++)
+    {
+      time [module] += prof->time [type][module];
+      count[module] += prof->count[type][module];
+    }
+  }
+
+  fprintf(f, "{\n  \"frames\": %d,\n  \"total_ns\": %" FORMAT_OFF_T ",\n  \"total\": ", p_Vid->p_Stats->frame_counter, (int64) p_Vid->tot_time * 1000000);
+  write_enc_profile_modules(f, time, count);
+
+  fprintf(f, ",\n  \"slice_types\": {");
+  for (type = 0; type < NUM_SLICE_TYPES; type++)
+  {
+    fprintf(f, "%s\n    \"%s\": ", type ? "," : "", slice_name[type]);
+    write_enc_profile_modules(f, prof->time[type], prof->count[type]);
+  }
+
+  fprintf(f, "\n  },\n  \"motion_search\": {");
+  for (mode = 1; mode < EPROF_ME_MODES; mode++)
+  {
+    fprintf(f, "%s\n    \"%s\": {\"searches\": %" FORMAT_OFF_T ", \"candidates\": {\"full_pel\": %" FORMAT_OFF_T ", \"half_pel\": %" FORMAT_OFF_T ", \"quarter_pel\": %" FORMAT_OFF_T "}, \"histogram\": [",
+      mode > 1 ? "," : "", mode_name[mode], prof->me_searches[mode], prof->me_cand[mode][F_PEL], prof->me_cand[mode][H_PEL], prof->me_cand[mode][Q_PEL]);
+    for (bin = 0; bin < EPROF_HIST_BINS; bin++)
+      fprintf(f, "%s%" FORMAT_OFF_T, bin ? ", " : "", prof->me_hist[mode][bin]);
+    fprintf(f, "]}");
+  }
+  fprintf(f, "\n  },\n  \"histogram_bins\": \"candidates per block search: 0, 1, 2-3, 4-7, ..., >= %d\"\n}\n", 1 << (EPROF_HIST_BINS - 2));
+
+  fclose(f);
+}
@@ -0,0 +1,55 @@
+/*!
+ **************************************************************************
+ *  \file enc_profile.h
+ *
+ *  \brief
+ *     Per module encoder timing and motion search statistics
+ *     (enabled with the ProfileFile parameter)
+ *
+ **************************************************************************
+ */
+
+#ifndef _ENC_PROFILE_H_
+#define _ENC_PROFILE_H_
+#include "global.h"
+
+//! encoder modules; "mode_decision" includes the nested "me" and "trellis" modules
+typedef enum
+{
+  EPROF_MODE_DECISION,  //!< macroblock mode decision (encode_one_macroblock_*)
+  EPROF_ME,             //!< motion search (PartitionMotionSearch, SubPartitionMotionSearch)
+  EPROF_TRELLIS,        //!< trellis / RDOQ quantization (quant_*_trellis)
+  EPROF_INTERPOLATION,  //!< reference picture sub-pel interpolation and padding (UnifiedOneForthPix)
+  EPROF_ENTROPY,        //!< macroblock entropy coding (write_macroblock)
+  EPROF_DEBLOCK,        //!< deblocking filter
+  EPROF_DISTORTION,     //!< picture distortion metrics (find_distortion, compute_distortion)
+  EPROF_INPUT,          //!< source picture reading
+  EPROF_OUTPUT,         //!< NAL unit and reconstructed picture writing
+  EPROF_NUM_MODULES
+} EncProfModule;
+
+#define EPROF_ME_MODES    8   //!< motion search block types 1..7 (16x16 .. 4x4)
+#define EPROF_HIST_BINS  16   //!< candidate histogram bins: 0, 1, 2-3, 4-7, ..., >= 16384
+
+typedef struct enc_profile
+{
+  int64  start[EPROF_NUM_MODULES];                     //!< start of the running interval of each module
+  int64  time [NUM_SLICE_TYPES][EPROF_NUM_MODULES];    //!< nanoseconds per slice type
+  int64  count[NUM_SLICE_TYPES][EPROF_NUM_MODULES];    //!< calls per slice type
+
+  int64  me_searches [EPROF_ME_MODES];                 //!< block motion searches per block type
+  int64  me_cand     [EPROF_ME_MODES][3];              //!< evaluated candidates per block type and F/H/Q pel
+  int64  me_hist     [EPROF_ME_MODES][EPROF_HIST_BINS];//!< histogram of candidates per block motion search
+} EncProfile;
+
+#define ENC_PROFILE_START(p_Vid, module)  do { if ((p_Vid)->enc_profile) (p_Vid)->enc_profile->start[module] = gettime_ns(); } while (0)
+#define ENC_PROFILE_STOP(p_Vid, module)   do { if ((p_Vid)->enc_profile) enc_profile_stop((p_Vid)->enc_profile, module, (p_Vid)->type); } while (0)
+
+extern EncProfile *init_enc_profile   (void);
+extern void        delete_enc_profile (EncProfile *prof);
+extern void        enc_profile_stop   (EncProfile *prof, EncProfModule module, int slice_type);
+extern void        enc_profile_count_candidates(MEBlock *mv_block);
+extern void        enc_profile_me     (EncProfile *prof, MEBlock *mv_block);
+extern void        write_enc_profile  (VideoParameters *p_Vid, EncProfile *prof, char *filename);
+
+#endif
@@ -72,6 +72,9 @@ int allocate_errdo_mem(VideoParameters *p_Vid, InputParameters *p_Inp)
   p_Vid->p_decs->second_moment_bestY_b8x8      = NULL;
   p_Vid->p_decs->second_moment_pred_bestY_b8x8      = NULL;
   p_Vid->p_decs->second_moment_pred      = NULL;
+  p_Vid->p_decs->loss_seed    = NULL;
+  p_Vid->p_decs->sim_jobs     = NULL;
+  p_Vid->p_decs->num_sim_jobs = 0;
 
   //Zhifeng 090630
   switch (p_Inp->de)
@@ -82,6 +85,7 @@ int allocate_errdo_mem(VideoParameters *p_Vid, InputParameters *p_Inp)
     memory_size += get_mem3Dpel(&p_Vid->p_decs->dec_mbY_best, p_Inp->NoOfDecoders, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
     memory_size += get_mem4Dpel(&p_Vid->p_decs->dec_mbY_best8x8, 2, p_Inp->NoOfDecoders, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
     memory_size += get_mem4Dpel(&p_Vid->p_decs->dec_mb_pred_best8x8, 2, p_Inp->NoOfDecoders, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+    memory_size += init_decoder_simulation(p_Vid, p_Inp);
     break;  
   default:
     ;
@@ -255,6 +259,8 @@ void free_errdo_mem(VideoParameters *p_Vid)
     p_Vid->p_decs->second_moment_pred      = NULL;
   }
 
+  free_decoder_simulation(p_Vid);
+
   free_pointer( p_Vid->p_decs );
 }
 
@@ -98,6 +98,11 @@ struct decoders
   uint16 ***second_moment_bestY_b8x8;
   uint16 ***second_moment_pred_bestY_b8x8;
   uint16 **second_moment_pred;
+
+  //for the simulation of the decoders after each reference picture (UpdateDecoders)
+  uint32 *loss_seed;                 //!< state of the packet loss generator of each decoder
+  struct decoder_sim_job *sim_jobs;  //!< worker threads simulating the decoders, NULL if single threaded
+  int num_sim_jobs;
 };
 
 typedef struct decoders Decoders;
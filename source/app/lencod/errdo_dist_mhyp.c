@@ -27,13 +27,30 @@
 #include "md_distortion.h"
 #include "md_common.h"
 #include "lln_mc_prediction.h"
+#include "memalloc.h"
+
+//! decoders simulated by a worker thread
+typedef struct decoder_sim_job
+{
+  VideoParameters *p_Vid;              //!< private copy of the encoder state the decoders are simulated with
+  Macroblock      *mb_data;            //!< private copy of the macroblocks, updated by concealment and deblocking
+  ThreadHandle     thread;
+  ThreadMutex      lock;               //!< protects busy and quit
+  ThreadCond       cond;               //!< signals a new picture to the worker and its completion to the encoder
+  int              busy;               //!< picture dispatched and not yet simulated
+  int              quit;
+  StorablePicture *enc_pic;
+  int              first_decoder;
+  int              decoder_step;
+} DecoderSimJob;
 
 static void add_residue     (Macroblock *currMB, StorablePicture *enc_pic, int decoder, int pl, int block8x8, int x_size, int y_size);
-static void Build_Status_Map(VideoParameters *p_Vid, InputParameters *p_Inp, byte **s_map);
+static void Build_Status_Map(VideoParameters *p_Vid, InputParameters *p_Inp, byte **s_map, uint32 *loss_seed);
 static void get_predicted_mb(Macroblock *currMB, StorablePicture *enc_pic, int decoder);
 static void copy_conceal_mb (Macroblock *currMB, StorablePicture *enc_pic, int decoder, int mb_error, StorablePicture* refPic);
 static void decode_one_b8block      (Macroblock* currMB, StorablePicture *enc_pic, int decoder, int block8x8, short mv_mode, int pred_dir);
 static void decode_one_mb           (Macroblock* currMB, StorablePicture *enc, int decoder);
+static void decoder_sim_worker      (void *arg);
 
 extern void UpdateDecoders          (VideoParameters *p_Vid, InputParameters *p_Inp, StorablePicture *enc_pic);
 extern void DeblockFrame(VideoParameters *p_Vid, imgpel **, imgpel ***);
@@ -169,22 +186,209 @@ distblk errdo_distortion_estimation_multihyp(Macroblock *currMB, int block, int
 /*!
  *************************************************************************************
  * \brief
- *    Performs the simulation of the packet losses, calls the error concealment funcs
- *    and deblocks the error concealed pictures
+ *    Allocates the packet loss generators of the decoders and the worker threads
+ *    simulating them (DecoderThreads)
  *
  *************************************************************************************
  */
-void UpdateDecoders(VideoParameters *p_Vid, InputParameters *p_Inp, StorablePicture *enc_pic)
+int init_decoder_simulation(VideoParameters *p_Vid, InputParameters *p_Inp)
 {
+  Decoders *p_decs = p_Vid->p_decs;
+  int memory_size = p_Inp->NoOfDecoders * sizeof(uint32);
   int k;
+
+  if ((p_decs->loss_seed = (uint32 *) malloc(p_Inp->NoOfDecoders * sizeof(uint32))) == NULL)
+    no_mem_exit("init_decoder_simulation: p_decs->loss_seed");
+
+  // one generator per decoder, the loss patterns do not depend on the number of threads
   for (k = 0; k < p_Inp->NoOfDecoders; k++)
+    p_decs->loss_seed[k] = (uint32) (k + 1) * 0x9E3779B9u;
+
+  p_decs->num_sim_jobs = imin(p_Inp->DecoderThreads, p_Inp->NoOfDecoders) - 1;
+  if (p_decs->num_sim_jobs <= 0)
+  {
+    p_decs->num_sim_jobs = 0;
+    return memory_size;
+  }
+
+  if ((p_decs->sim_jobs = (DecoderSimJob *) calloc(p_decs->num_sim_jobs, sizeof(DecoderSimJob))) == NULL)
+    no_mem_exit("init_decoder_simulation: p_decs->sim_jobs");
+
+  for (k = 0; k < p_decs->num_sim_jobs; k++)
+  {
+    DecoderSimJob *job = &p_decs->sim_jobs[k];
+
+    if ((job->p_Vid = (VideoParameters *) malloc(sizeof(VideoParameters))) == NULL)
+      no_mem_exit("init_decoder_simulation: job->p_Vid");
+    if ((job->mb_data = (Macroblock *) calloc(p_Vid->FrameSizeInMbs, sizeof(Macroblock))) == NULL)
+      no_mem_exit("init_decoder_simulation: job->mb_data");
+    memory_size += sizeof(VideoParameters) + p_Vid->FrameSizeInMbs * sizeof(Macroblock);
+
+    // the workers live for the whole sequence and wait for the reference pictures
+    mutex_init(&job->lock);
+    cond_init(&job->cond);
+    if (thread_create(&job->thread, decoder_sim_worker, job))
+      error("init_decoder_simulation: cannot create decoder simulation thread", 500);
+  }
+
+  return memory_size;
+}
+
+/*!
+ *************************************************************************************
+ * \brief
+ *    Frees the packet loss generators and the worker threads
+ *
+ *************************************************************************************
+ */
+void free_decoder_simulation(VideoParameters *p_Vid)
+{
+  Decoders *p_decs = p_Vid->p_decs;
+  int k;
+
+  for (k = 0; k < p_decs->num_sim_jobs; k++)
   {
-    Build_Status_Map(p_Vid, p_Inp, enc_pic->de_mem->mb_error_map[k]); // simulates the packet losses
+    DecoderSimJob *job = &p_decs->sim_jobs[k];
+
+    mutex_lock(&job->lock);
+    job->quit = 1;
+    cond_broadcast(&job->cond);
+    mutex_unlock(&job->lock);
+    thread_join(job->thread);
+
+    mutex_destroy(&job->lock);
+    cond_destroy(&job->cond);
+    free(job->mb_data);
+    free(job->p_Vid);
+  }
+  free_pointer(p_decs->sim_jobs);
+  free_pointer(p_decs->loss_seed);
+  p_decs->sim_jobs     = NULL;
+  p_decs->loss_seed    = NULL;
+  p_decs->num_sim_jobs = 0;
+}
+
+/*!
+ *************************************************************************************
+ * \brief
+ *    Simulates the decoders first_decoder, first_decoder + decoder_step, ...
+ *
+ *************************************************************************************
+ */
+static void simulate_decoders(VideoParameters *p_Vid, StorablePicture *enc_pic, int first_decoder, int decoder_step)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  int k;
+
+  for (k = first_decoder; k < p_Inp->NoOfDecoders; k += decoder_step)
+  {
+    Build_Status_Map(p_Vid, p_Inp, enc_pic->de_mem->mb_error_map[k], &p_Vid->p_decs->loss_seed[k]); // simulates the packet losses
     p_Vid->error_conceal_picture(p_Vid, enc_pic, k); 
     DeblockFrame (p_Vid, enc_pic->de_mem->p_dec_img[0][k], NULL);
   }
 }
 
+/*!
+ *************************************************************************************
+ * \brief
+ *    worker thread: simulates the decoders of a job for each dispatched picture
+ *
+ *************************************************************************************
+ */
+static void decoder_sim_worker(void *arg)
+{
+  DecoderSimJob *job = (DecoderSimJob *) arg;
+
+  mutex_lock(&job->lock);
+  while (!job->quit)
+  {
+    if (!job->busy)
+    {
+      cond_wait(&job->cond, &job->lock);
+      continue;
+    }
+    mutex_unlock(&job->lock);
+
+    simulate_decoders(job->p_Vid, job->enc_pic, job->first_decoder, job->decoder_step);
+
+    mutex_lock(&job->lock);
+    job->busy = 0;
+    cond_broadcast(&job->cond);
+  }
+  mutex_unlock(&job->lock);
+}
+
+/*!
+ *************************************************************************************
+ * \brief
+ *    Performs the simulation of the packet losses, calls the error concealment funcs
+ *    and deblocks the error concealed pictures. The decoders are independent; with
+ *    DecoderThreads they are distributed over the worker threads started by
+ *    init_decoder_simulation, which conceal and deblock on private copies of the
+ *    macroblock data.
+ *
+ *************************************************************************************
+ */
+void UpdateDecoders(VideoParameters *p_Vid, InputParameters *p_Inp, StorablePicture *enc_pic)
+{
+  Decoders *p_decs = p_Vid->p_decs;
+  int num_jobs = p_decs->num_sim_jobs;
+  int i, mb;
+
+  for (i = 0; i < num_jobs; i++)
+  {
+    DecoderSimJob *job = &p_decs->sim_jobs[i];
+    VideoParameters *p_Job = job->p_Vid;
+
+    memcpy(p_Job, p_Vid, sizeof(VideoParameters));
+    memcpy(job->mb_data, p_Vid->mb_data, p_Vid->PicSizeInMbs * sizeof(Macroblock));
+    for (mb = 0; mb < (int) p_Vid->PicSizeInMbs; mb++)
+      job->mb_data[mb].p_Vid = p_Job;
+    p_Job->mb_data = job->mb_data;
+
+    job->enc_pic       = enc_pic;
+    job->first_decoder = i + 1;
+    job->decoder_step  = num_jobs + 1;
+
+    mutex_lock(&job->lock);
+    job->busy = 1;
+    cond_broadcast(&job->cond);
+    mutex_unlock(&job->lock);
+  }
+
+  simulate_decoders(p_Vid, enc_pic, 0, num_jobs + 1);
+
+  for (i = 0; i < num_jobs; i++)
+  {
+    DecoderSimJob *job = &p_decs->sim_jobs[i];
+
+    mutex_lock(&job->lock);
+    while (job->busy)
+      cond_wait(&job->cond, &job->lock);
+    mutex_unlock(&job->lock);
+  }
+}
+
+/*!
+ *************************************************************************************
+ * \brief
+ *    Returns a uniformly distributed value in [0, 100) from the packet loss
+ *    generator (xorshift) of a decoder
+ *
+ *************************************************************************************
+ */
+static inline double loss_percent(uint32 *loss_seed)
+{
+  uint32 x = *loss_seed;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *loss_seed = x;
+
+  return (double) x * (100.0 / 4294967296.0);
+}
+
 
 
 /*!
@@ -195,9 +399,11 @@ void UpdateDecoders(VideoParameters *p_Vid, InputParameters *p_Inp, StorablePict
  *
  * \param s_map
  *    The status map to be filled
+ * \param loss_seed
+ *    The packet loss generator of the decoder
  *************************************************************************************
  */
-static void Build_Status_Map(VideoParameters *p_Vid, InputParameters *p_Inp, byte **s_map)
+static void Build_Status_Map(VideoParameters *p_Vid, InputParameters *p_Inp, byte **s_map, uint32 *loss_seed)
 {
   int i,j,slice=-1,mb=0,jj,ii;
   byte packet_lost=0;
@@ -212,9 +418,9 @@ static void Build_Status_Map(VideoParameters *p_Vid, InputParameters *p_Inp, byt
       if (!p_Inp->slice_mode || p_Vid->mb_data[mb].slice_nr != slice) /* new slice */
       {
         packet_lost=0;
-        if ((double)rand()/(double)RAND_MAX*100 < p_Inp->LossRateC)   packet_lost += 3;
-        if ((double)rand()/(double)RAND_MAX*100 < p_Inp->LossRateB)   packet_lost += 2;
-        if ((double)rand()/(double)RAND_MAX*100 < p_Inp->LossRateA)   packet_lost  = 1;
+        if (loss_percent(loss_seed) < p_Inp->LossRateC)   packet_lost += 3;
+        if (loss_percent(loss_seed) < p_Inp->LossRateB)   packet_lost += 2;
+        if (loss_percent(loss_seed) < p_Inp->LossRateA)   packet_lost  = 1;
         slice++;
       }
       if (!packet_lost)
@@ -18,4 +18,6 @@ extern void errdo_store_best_block_multihyp  (InputParameters *p_Inp, imgpel***
 extern void errdo_get_best_block_multihyp    (Macroblock *currMB, imgpel*** dec_img, imgpel*** mbY, int block, int block_size);
 extern distblk errdo_distortion_estimation_multihyp(Macroblock *currMB, int block, int block_size, short mode, short pdir, distblk min_rdcost);
 extern void copy_conceal_picture    (VideoParameters *p_Vid, StorablePicture *enc_pic, int decoder);
+extern int  init_decoder_simulation (VideoParameters *p_Vid, InputParameters *p_Inp);
+extern void free_decoder_simulation (VideoParameters *p_Vid);
 #endif
@@ -0,0 +1,221 @@
+/*!
+ *************************************************************************************
+ * \file field_analysis.c
+ *
+ * \brief
+ *    Frame/field decision of adaptive frame/field coding by analysis of the
+ *    source picture (FieldAnalysis parameter).
+ *
+ *    The analysis runs on a copy of the luma halved horizontally, which
+ *    keeps all lines of both fields. The vertical activity of a macroblock
+ *    pair is measured between neighbouring lines (frame) and between
+ *    neighbouring lines of the same field. Motion between the fields shows
+ *    as combing, which raises the frame activity above the field activity.
+ *    The field motion energy, the difference to the co-located lines of the
+ *    previous picture, tells static areas, where the fields cannot differ
+ *    by motion, from moving ones.
+ *
+ *    Pictures and pairs that are static or flat are coded as frames. The
+ *    others whose activities differ by more than FieldAnalysisMargin percent
+ *    are coded with the winning structure only, the rest are coded both
+ *    ways and decided by their rate-distortion cost as before.
+ *
+ *************************************************************************************
+ */
+
+#include "global.h"
+#include "memalloc.h"
+#include "field_analysis.h"
+
+#define PAIR_HEIGHT (2 * MB_BLOCK_SIZE)
+#define PAIR_WIDTH  (MB_BLOCK_SIZE >> 1)   //!< width of a macroblock pair in the analysis planes
+
+/*!
+ ************************************************************************
+ * \brief
+ *    allocates the field analysis, the planes are allocated with the
+ *    first picture
+ ************************************************************************
+ */
+FieldAnalysis *init_field_analysis(void)
+{
+  FieldAnalysis *p_FA;
+
+  if ((p_FA = (FieldAnalysis *) calloc (1, sizeof (FieldAnalysis)))== NULL)
+    no_mem_exit ("init_field_analysis: p_FA");
+
+  return p_FA;
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    frees the field analysis
+ ************************************************************************
+ */
+void delete_field_analysis(FieldAnalysis *p_FA)
+{
+  if (p_FA != NULL)
+  {
+    if (p_FA->plane[0] != NULL)
+    {
+      free_mem2Dpel(p_FA->plane[0]);
+      free_mem2Dpel(p_FA->plane[1]);
+    }
+    free (p_FA);
+  }
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    takes the luma of the current source picture into the analysis:
+ *    the previous plane is kept for the field motion energy and the
+ *    current one is filled with the average of each pair of columns
+ ************************************************************************
+ */
+void field_analysis_source(VideoParameters *p_Vid)
+{
+  FieldAnalysis *p_FA = p_Vid->p_FA;
+  imgpel **img = p_Vid->imgData.frm_data[0];
+  imgpel **tmp;
+  int x, y;
+
+  // redundant pictures code the same source again
+  if (p_FA->pictures > 0 && p_FA->frame_no == p_Vid->frame_no)
+    return;
+
+  if (p_FA->plane[0] == NULL)
+  {
+    p_FA->width  = p_Vid->PicWidthInMbs * PAIR_WIDTH;
+    p_FA->height = p_Vid->FrameHeightInMbs * MB_BLOCK_SIZE;
+    get_mem2Dpel(&p_FA->plane[0], p_FA->height, p_FA->width);
+    get_mem2Dpel(&p_FA->plane[1], p_FA->height, p_FA->width);
+  }
+
+  tmp = p_FA->plane[1];
+  p_FA->plane[1] = p_FA->plane[0];
+  p_FA->plane[0] = tmp;
+
+  for (y = 0; y < p_FA->height; y++)
+  {
+    imgpel *src = img[y];
+    imgpel *dst = tmp[y];
+
+    for (x = 0; x < p_FA->width; x++)
+      dst[x] = (imgpel) ((src[2 * x] + src[2 * x + 1] + 1) >> 1);
+  }
+
+  p_FA->frame_no = p_Vid->frame_no;
+  p_FA->pictures++;
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    accumulates the frame and the field activity of the macroblock pair
+ *    at (pos_x, pos_y) of the analysis planes. Both sum the differences
+ *    of the same 30 rows, to the next line and to the next line of the
+ *    same field. The field motion energy sums the differences of all 32
+ *    rows to the previous picture, if there is one.
+ ************************************************************************
+ */
+static void pair_activity(FieldAnalysis *p_FA, int pos_x, int pos_y, int64 *frm_act, int64 *fld_act, int64 *motion)
+{
+  imgpel **img = p_FA->plane[0];
+  int frm = 0, fld = 0, mot = 0;
+  int x, y;
+
+  for (y = pos_y; y < pos_y + PAIR_HEIGHT - 2; y++)
+  {
+    imgpel *cur = &img[y    ][pos_x];
+    imgpel *frm_nb = &img[y + 1][pos_x];
+    imgpel *fld_nb = &img[y + 2][pos_x];
+
+    for (x = 0; x < PAIR_WIDTH; x++)
+    {
+      frm += iabs(cur[x] - frm_nb[x]);
+      fld += iabs(cur[x] - fld_nb[x]);
+    }
+  }
+
+  if (p_FA->pictures > 1)
+  {
+    for (y = pos_y; y < pos_y + PAIR_HEIGHT; y++)
+    {
+      imgpel *cur  = &img[y][pos_x];
+      imgpel *prev = &p_FA->plane[1][y][pos_x];
+
+      for (x = 0; x < PAIR_WIDTH; x++)
+        mot += iabs(cur[x] - prev[x]);
+    }
+  }
+
+  *frm_act += frm;
+  *fld_act += fld;
+  *motion  += mot;
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    structure with the lower activity if the difference exceeds the
+ *    margin, ADAPTIVE_CODING otherwise. Flat and static areas (less
+ *    than one per sample) are coded as frame.
+ ************************************************************************
+ */
+static int structure_decision(FieldAnalysis *p_FA, int64 frm_act, int64 fld_act, int64 motion, int64 samples, int margin)
+{
+  if (frm_act < samples)
+    return FRAME_CODING;
+  if (p_FA->pictures > 1 && motion < samples)
+    return FRAME_CODING;
+  if (frm_act * 100 > fld_act * (100 + margin))
+    return FIELD_CODING;
+  if (frm_act * (100 + margin) < fld_act * 100)
+    return FRAME_CODING;
+  return ADAPTIVE_CODING;
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    structure of the current picture for PicInterlace = 2: FRAME_CODING,
+ *    FIELD_CODING or ADAPTIVE_CODING if both have to be coded
+ ************************************************************************
+ */
+int field_analysis_picture(VideoParameters *p_Vid)
+{
+  FieldAnalysis *p_FA = p_Vid->p_FA;
+  int64 frm_act = 0, fld_act = 0, motion = 0;
+  int pos_x, pos_y;
+
+  for (pos_y = 0; pos_y + PAIR_HEIGHT <= p_FA->height; pos_y += PAIR_HEIGHT)
+  {
+    for (pos_x = 0; pos_x < p_FA->width; pos_x += PAIR_WIDTH)
+      pair_activity(p_FA, pos_x, pos_y, &frm_act, &fld_act, &motion);
+  }
+
+  return structure_decision(p_FA, frm_act, fld_act, motion, (int64) p_Vid->FrameSizeInMbs * MB_PIXELS / 2, p_Vid->p_Inp->FieldAnalysisMargin);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    MbInterlace mode the macroblock pair of mb_addr is coded with:
+ *    FRAME_MB_PAIR_CODING, FIELD_CODING or ADAPTIVE_CODING if both have
+ *    to be coded
+ ************************************************************************
+ */
+int field_analysis_mb_pair(VideoParameters *p_Vid, int mb_addr)
+{
+  FieldAnalysis *p_FA = p_Vid->p_FA;
+  int pair = mb_addr >> 1;
+  int64 frm_act = 0, fld_act = 0, motion = 0;
+  int structure;
+
+  pair_activity(p_FA, (pair % p_Vid->PicWidthInMbs) * PAIR_WIDTH, (pair / p_Vid->PicWidthInMbs) * PAIR_HEIGHT, &frm_act, &fld_act, &motion);
+
+  structure = structure_decision(p_FA, frm_act, fld_act, motion, MB_PIXELS, p_Vid->p_Inp->FieldAnalysisMargin);
+  return (structure == FRAME_CODING) ? FRAME_MB_PAIR_CODING : structure;
+}
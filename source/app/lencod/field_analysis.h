@@ -0,0 +1,32 @@
+/*!
+ **************************************************************************
+ *  \file field_analysis.h
+ *
+ *  \brief
+ *     Frame/field decision of adaptive frame/field coding by analysis of
+ *     the source picture (FieldAnalysis and FieldAnalysisMargin parameters)
+ *
+ **************************************************************************
+ */
+
+#ifndef _FIELD_ANALYSIS_H_
+#define _FIELD_ANALYSIS_H_
+#include "global.h"
+
+//! analysis planes: luma of the source pictures, halved horizontally
+typedef struct field_analysis
+{
+  imgpel **plane[2];   //!< current and previous picture
+  int      width;      //!< width of the planes
+  int      height;     //!< height of the planes
+  int      frame_no;   //!< frame_no of the current picture
+  int      pictures;   //!< pictures analysed so far
+} FieldAnalysis;
+
+extern FieldAnalysis *init_field_analysis   (void);
+extern void           delete_field_analysis (FieldAnalysis *p_FA);
+extern void           field_analysis_source (VideoParameters *p_Vid);
+extern int            field_analysis_picture(VideoParameters *p_Vid);
+extern int            field_analysis_mb_pair(VideoParameters *p_Vid, int mb_addr);
+
+#endif
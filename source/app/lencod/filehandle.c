@@ -75,8 +75,14 @@ int start_sequence(VideoParameters *p_Vid, InputParameters *p_Inp)
   switch(p_Inp->of_mode)
   {
   case PAR_OF_ANNEXB:      
-    p_Vid->WriteNALU = WriteAnnexbNALU;
     p_Vid->f_out = &p_Vid->f_annexb;
+    // the encoder library hands the NAL units to the application
+    if (p_Vid->nalu_callback)
+    {
+      p_Vid->WriteNALU = WriteAnnexbNALUCallback;
+      break;
+    }
+    p_Vid->WriteNALU = WriteAnnexbNALU;
     OpenAnnexbFile (p_Inp->outfile, p_Vid->f_out);
     break;
   case PAR_OF_RTP:      
@@ -246,7 +252,8 @@ int terminate_sequence(VideoParameters *p_Vid, InputParameters *p_Inp)
   switch(p_Inp->of_mode)
   {
   case PAR_OF_ANNEXB:
-    CloseAnnexbFile(*p_Vid->f_out);
+    if (p_Vid->nalu_callback == NULL)
+      CloseAnnexbFile(*p_Vid->f_out);
     break;
   case PAR_OF_RTP:
     CloseRTPFile(*p_Vid->f_out);
@@ -32,6 +32,7 @@
 typedef struct bit_stream_enc Bitstream;
 
 #include "pred_struct_types.h"
+#include "h264encoder.h"
 
 
 /***********************************************************************
@@ -50,6 +51,7 @@ typedef struct image_structure ImageStructure;
 typedef struct info_8x8 Info8x8;
 typedef struct search_window SearchWindow;
 typedef struct block_pos BlockPos;
+typedef struct mb_neighbours MbNeighbours;
 typedef struct bit_counter BitCounter;
 typedef struct encoding_environment EncodingEnvironment;
 typedef EncodingEnvironment *EncodingEnvironmentPtr;
@@ -84,6 +86,14 @@ struct block_pos
   short y;
 };
 
+//! neighbouring macroblocks (pairs in MBAFF) A (left), B (above), C (above right) and D (above left)
+//! of a macroblock (pair) address, independent of the slice structure
+struct mb_neighbours
+{
+  int  mbAddrA, mbAddrB, mbAddrC, mbAddrD;
+  byte inside;          //!< NB_A, NB_B, NB_C and NB_D bits of the neighbours inside the picture
+};
+
 //! bit counter for a macroblock. Note that it seems safe to change all to unsigned short for 16x16 MBs. May be an issue if MB > 32x32
 struct bit_counter
 {
@@ -188,6 +198,12 @@ typedef struct
 
 static const MotionVector zero_mv = {0, 0};
 
+//! Motion vectors of the 4x4 blocks of a macroblock for all block types [blocktype][y][x]
+typedef MotionVector MBMotionVectors[MV_BLOCK_TYPES][BLOCK_MULTIPLE][BLOCK_MULTIPLE];
+
+//! Motion costs of the 8x8 blocks of a macroblock for all block types [blocktype][block8x8]
+typedef distblk MBMotionCosts[MV_BLOCK_TYPES][BLOCK_MULTIPLE];
+
 typedef struct rd_8x8_data
 {
   distblk  mb_p8x8_cost;  
@@ -319,6 +335,11 @@ typedef struct me_block
   distblk (*computeBiPredFPel)  (struct storable_picture *, struct storable_picture *, struct me_block *, distblk , MotionVector *, MotionVector *);
   distblk (*computeBiPredHPel)  (struct storable_picture *, struct storable_picture *, struct me_block *, distblk , MotionVector *, MotionVector *);
   distblk (*computeBiPredQPel)  (struct storable_picture *, struct storable_picture *, struct me_block *, distblk , MotionVector *, MotionVector *);
+
+  // candidate counting (encoder profile)
+  int              cand_count[3]; //!< evaluated F/H/Q pel candidates of the current block search
+  distblk (*countedPred[3])     (struct storable_picture *, struct me_block *, distblk , MotionVector * );
+  distblk (*countedBiPred[3])   (struct storable_picture *, struct storable_picture *, struct me_block *, distblk , MotionVector *, MotionVector *);
 } MEBlock;
 
 //! Syntax Element
@@ -537,8 +558,8 @@ typedef struct rd_data
   Info8x8 block;
   Info8x8 b8x8[4];
   
-  MotionVector   *****all_mv;         //!< all modes motion vectors
-  MotionVector ******bipred_mv;       //!< Bipredictive motion vectors
+  MBMotionVectors *all_mv[2];        //!< all modes motion vectors [list][ref][blocktype][y][x]
+  MBMotionVectors *bipred_mv[2][2];  //!< Bipredictive motion vectors
 
   char    intra_pred_modes[16];
   char    intra_pred_modes8x8[16];
@@ -638,8 +659,8 @@ typedef struct slice
   short  max_num_references;      //!< maximum number of reference pictures that may occur
   // Motion vectors for a macroblock
   // These need to be changed to MotionVector parameters
-  MotionVector *****all_mv;         //!< replaces local all_mv
-  MotionVector ******bipred_mv;     //!< Biprediction MVs  
+  MBMotionVectors *all_mv[2];       //!< replaces local all_mv [list][ref][blocktype][y][x]
+  MBMotionVectors *bipred_mv[2][2]; //!< Biprediction MVs [bipred_me][list][ref][blocktype][y][x]
   //Weighted prediction
   short ***wp_weight;         //!< weight in [list][index][component] order
   short ***wp_offset;         //!< offset in [list][index][component] order
@@ -1050,8 +1071,7 @@ typedef struct video_par
   byte *ibuf;
 
 #ifdef _LEAKYBUCKET_
-  long *Bit_Buffer;
-  unsigned long total_frame_buffer;
+  struct leaky_buckets *p_LeakyBuckets;   //!< online leaky bucket model of the coded pictures
 #endif
 
   unsigned int log2_max_frame_num_minus4;
@@ -1155,6 +1175,7 @@ typedef struct video_par
   int frame_no;
   int fld_type;                        //!< top or bottom field
   byte fld_flag;
+  int  pic_structure;                  //!< FRAME_CODING or FIELD_CODING if FieldAnalysis decided the picture structure, ADAPTIVE_CODING if both are coded
   unsigned int rd_pass;
 
   int  redundant_coding;
@@ -1232,6 +1253,7 @@ typedef struct video_par
   // rate control variables
   int NumberofCodedMacroBlocks;
   int BasicUnitQP;
+  Macroblock *last_coded_mb;           //!< used to find whether a MB is recoded
   int NumberofMBTextureBits;
   int NumberofMBHeaderBits;
   unsigned int BasicUnit;
@@ -1327,7 +1349,10 @@ typedef struct video_par
   PrevCodingStats prev_cs;
   int MVCInterViewReorder;
   struct storable_picture *proc_picture;
+  struct view_threads     *p_ViewThreads;   //!< pipelined encoding of the non-base view (ViewThreads)
 #endif
+  struct paff_thread      *p_PaffThread;    //!< frame candidate of adaptive frame/field coding encoded by a worker (PAFFThreads)
+  struct slice_pool       *p_SlicePool;     //!< slices of the previous pictures kept for reuse
 
   double *mb16x16_cost_frame;
   double mb16x16_cost;
@@ -1350,7 +1375,7 @@ typedef struct video_par
   //int Intra_Selected; 
 
   int CbCr_predmode_8x8[4]; 
-  distblk ****motion_cost;
+  MBMotionCosts *motion_cost[2];     //!< motion costs of all modes [list][ref][blocktype][block8x8]
   int*** initialized;
   int*** modelNumber;
   int    bipred_enabled[MAXMODE];
@@ -1387,6 +1412,14 @@ typedef struct video_par
   //! incremented with all P and I frames
   uint16 CurrentRTPSequenceNumber;     //!< The RTP sequence number of the current packet
   //!< incremented by one for each sent packet
+  int LastRTPTr;                       //!< TR of the last RTP timestamp update, -1 before the first one
+
+  // NAL unit output of the encoder library, replaces the output file
+  NaluCallback nalu_callback;
+  void        *nalu_opaque;
+  byte        *nalu_buf;                //!< Annex B NAL unit handed to nalu_callback
+  int          nalu_buf_size;
+  int64        nalu_pts;                //!< pts of the picture being coded
 
   // This should be the right location for this
   //struct storable_picture **listX[6];
@@ -1394,6 +1427,9 @@ typedef struct video_par
 
   DistortionParams *p_Dist;
   struct stat_parameters  *p_Stats;
+  struct enc_profile      *enc_profile;   //!< per module timing (ProfileFile)
+  struct complexity_ctrl  *p_Cplx;        //!< adaptive complexity control (ComplexityControl)
+  struct field_analysis   *p_FA;          //!< frame/field source analysis (FieldAnalysis)
   pic_parameter_set_rbsp_t *PicParSet[MAXPPS];
   //struct decoded_picture_buffer *p_Dpb;
   struct decoded_picture_buffer *p_Dpb_layer[MAX_NUM_DPB_LAYERS];
@@ -1452,7 +1488,7 @@ typedef struct video_par
   void (*error_conceal_picture)(struct video_par *p_Vid, struct storable_picture *enc_pic, int decoder);
   distblk (*estimate_distortion)(Macroblock *currMB, int block, int block_size, short mode, short pdir, distblk min_rdcost);
   // function pointer for different ways of obtaining chroma interpolation
-  void (*OneComponentChromaPrediction4x4)   (Macroblock *currMB, imgpel* , int , int , MotionVector ** , struct storable_picture *listX, int );
+  void (*OneComponentChromaPrediction4x4)   (Macroblock *currMB, imgpel* , int , int , MotionVector (*)[BLOCK_MULTIPLE], struct storable_picture *listX, int );
   
   // deblocking
   void (*GetStrengthVer)    (byte Strength[16], Macroblock *MbQ, int edge, int mvlimit);
@@ -1481,6 +1517,7 @@ typedef struct video_par
   int dpb_layer_id;
 
   BlockPos *PicPos;
+  MbNeighbours *PicNeighbours;   //!< neighbours of all MB addresses, see init_mb_neighbours()
 
   //deprecative varialbes, they will be removed in future, so donot add varaibles here;
   ColorFormat yuv_format;
@@ -1536,13 +1573,20 @@ typedef struct video_par
 typedef struct scaling_list      ScaleParameters;
 typedef struct rdo_structure     RDOPTStructure;
 
-typedef struct encoder_params
+struct encoder_params
 {
   InputParameters   *p_Inp;          //!< Input Parameters
   VideoParameters   *p_Vid;          //!< Image Parameters
   FILE              *p_trace;        //!< Trace file
   int64              bufferSize;     //!< buffer size for tiff reads (not currently supported)
-} EncoderParams;
+
+  // encoder library state (h264encoder.h)
+  int                frames_pushed;      //!< frames handed over to EncodeFrame()
+  int                frames_done;        //!< frames of the sequence coded so far
+  int                curr_frame_to_code; //!< next coding step of the sequence
+  int                frame_selected;     //!< the frame of curr_frame_to_code has been selected
+  int                flushed;            //!< FlushEncoder() has fixed the length of the sequence
+};
 
 extern EncoderParams  *p_Enc;
 
@@ -1570,6 +1614,10 @@ extern int  get_mem_DCcoeff      (int****);
 extern void free_mem_ACcoeff     (int****);
 extern void free_mem_ACcoeff_new (int***** cofAC);
 extern void free_mem_DCcoeff     (int***);
+extern int  get_mem_MBmv         (MBMotionVectors **mv, int dim0, int num_ref);
+extern void free_mem_MBmv        (MBMotionVectors **mv);
+extern int  get_mem_MBcost       (MBMotionCosts **cost, int dim0, int num_ref);
+extern void free_mem_MBcost      (MBMotionCosts **cost);
 
 #if TRACE
 extern void  trace2out(SyntaxElement *se);
@@ -1608,11 +1656,12 @@ extern void make_frame_picture_JV( VideoParameters *p_Vid );
 
 extern char errortext[ET_SIZE]; //!< buffer for error message for exit with error()
 extern void setup_coding_layer(VideoParameters *p_Vid);
+extern void encode_current_frame(VideoParameters *p_Vid, InputParameters *p_Inp, int curr_frame_to_code);
 
 static inline int is_FREXT_profile(unsigned int profile_idc) 
 {
   // we allow all FRExt tools, when no profile is active
-  return ( profile_idc==NO_PROFILE || profile_idc==FREXT_HP || profile_idc==FREXT_Hi10P || profile_idc==FREXT_Hi422 || profile_idc==FREXT_Hi444 || profile_idc == FREXT_CAVLC444 );
+  return ( profile_idc==NO_PROFILE || profile_idc==FREXT_HP || profile_idc==FREXT_Hi10P || profile_idc==FREXT_Hi422 || profile_idc==FREXT_Hi444 || profile_idc == FREXT_CAVLC444 || profile_idc == MULTIVIEW_HIGH || profile_idc == STEREO_HIGH );
 }
 
 
@@ -0,0 +1,60 @@
+
+/*!
+ ************************************************************************
+ *  \file
+ *     h264encoder.h
+ *  \brief
+ *     interface for H.264 encoder.
+ *
+ *     The encoder is configured like the lencod application (config
+ *     file and -p parameters), except that the pictures are passed in
+ *     with EncodeFrame() and the Annex B NAL units are handed back
+ *     through the NaluCallback instead of being written to OutputFile.
+ *     FramesToBeEncoded is the maximum length of the sequence,
+ *     FlushEncoder() ends it after the frames passed so far.
+ *
+ *     Several encoders may be opened in one process; their calls must
+ *     not run concurrently. Only single view sequences without 3:2
+ *     pulldown are supported.
+ *
+ *     The encoder is an opaque handle. Errors inside the encoder (invalid
+ *     configuration, out of memory, file errors) still go through
+ *     error() / no_mem_exit() and terminate the process with exit(), as
+ *     in lencod; only the checks of the arguments of these functions are
+ *     returned as ENC_ERRMASK codes.
+ ************************************************************************
+ */
+#ifndef _H264ENCODER_H_
+#define _H264ENCODER_H_
+
+//! encoder instance
+typedef struct encoder_params EncoderParams;
+
+//! receives the NAL units of the encoder (with start code) in coding order and the pts of their picture
+typedef void (*NaluCallback)(void *opaque, const unsigned char *buf, int len, long long pts);
+
+typedef enum
+{
+  ENC_GEN_NOERR = 0,
+  ENC_OPEN_NOERR = 0,
+  ENC_CLOSE_NOERR = 0,
+  ENC_SUCCEED = 0,
+  ENC_EOS = 1,
+  ENC_INVALID_PARAM = 3,
+  ENC_ERRMASK = 0x8000
+} EncErrCode;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! argc/argv as for lencod; planes are in the layout of the input file, 2 bytes per sample (little endian) above 8 bits
+int OpenEncoder(EncoderParams **ppEncoder, int argc, char **argv, NaluCallback callback, void *opaque);
+int EncodeFrame(EncoderParams *pEncoder, const unsigned char *planes[3], const int strides[3], long long pts);
+int FlushEncoder(EncoderParams *pEncoder);
+int CloseEncoder(EncoderParams *pEncoder);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
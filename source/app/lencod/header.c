@@ -31,12 +31,13 @@
 #define SYMTRACESTRING(s) // do nothing
 #endif
 
-const int * assignSE2partition[2] ;
 const int assignSE2partition_NoDP[SE_MAX_ELEMENTS] =
   {  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 const int assignSE2partition_DP[SE_MAX_ELEMENTS] =
   // 0  1  2  3  4  5  6  7  8  9 10 11 12 13 14 15 16 17
   {  0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0 } ;
+// only the data partitioning entry is changed per slice
+const int * assignSE2partition[2] = { assignSE2partition_NoDP, assignSE2partition_NoDP };
 
 #if (MVC_EXTENSION_ENABLE)
 static int mvc_ref_pic_list_reordering(Slice *currSlice, Bitstream *bitstream);
@@ -68,6 +68,12 @@
 #include "md_common.h"
 #include "me_epzs_common.h"
 #include "me_hme.h"
+#include "enc_profile.h"
+#include "complexity.h"
+#include "view_thread.h"
+#include "paff_thread.h"
+#include "field_analysis.h"
+#include "leaky_bucket.h"
 
 extern void UpdateDecoders            (VideoParameters *p_Vid, InputParameters *p_Inp, StorablePicture *enc_pic);
 
@@ -233,7 +239,9 @@ static void code_a_plane(VideoParameters *p_Vid, InputParameters *p_Inp)
     else
       distortion.value[0] = distortion.value[1] = distortion.value[2] = 0;
 
+    ENC_PROFILE_START(p_Vid, EPROF_DEBLOCK);
     DeblockFrame (p_Vid, p_Vid->enc_picture->imgY, p_Vid->enc_picture->imgUV); //comment out to disable deblocking filter
+    ENC_PROFILE_STOP(p_Vid, EPROF_DEBLOCK);
 
     if(p_Inp->RDPictureDeblocking && !p_Vid->TurnDBOff)
     {
@@ -775,6 +783,20 @@ void perform_encode_frame(VideoParameters *p_Vid)
 
   int frame_type;
 
+  p_Vid->pic_structure = ADAPTIVE_CODING;
+  if (p_Vid->p_FA)
+    field_analysis_source(p_Vid);
+  if (p_Inp->PicInterlace == ADAPTIVE_CODING && p_Inp->FieldAnalysis)
+    p_Vid->pic_structure = field_analysis_picture(p_Vid);
+
+  if (p_Vid->pic_structure == FIELD_CODING)
+  {
+    // the frame candidate is not coded
+    perform_encode_field(p_Vid);
+    update_field_frame_contexts (p_Vid, TRUE);
+    return;
+  }
+
   //Rate control
   if ( p_Inp->RCEnable && p_Inp->RCUpdateMode <= MAX_RC_MODE )
     p_Vid->p_rc_gen->FieldControl = 0;
@@ -806,7 +828,10 @@ void perform_encode_frame(VideoParameters *p_Vid)
     }
     else
     {
-      frame_picture (p_Vid, p_Vid->frame_pic[0], &p_Vid->imgData, 0);
+      if (p_Vid->p_PaffThread && p_Vid->pic_structure == ADAPTIVE_CODING)
+        paff_thread_dispatch(p_Vid);   // the frame is encoded concurrently with the top field
+      else
+        frame_picture (p_Vid, p_Vid->frame_pic[0], &p_Vid->imgData, 0);
       p_Vid->p_frame_pic = p_Vid->frame_pic[0]; 
     }
 
@@ -830,6 +855,13 @@ void perform_encode_frame(VideoParameters *p_Vid)
   }
 #endif
 
+  if (p_Vid->pic_structure == FRAME_CODING)
+  {
+    // the field candidate is not coded
+    p_Vid->fld_flag = FALSE;
+    update_field_frame_contexts (p_Vid, FALSE);
+  }
+  else
 #if (MVC_EXTENSION_ENABLE)
   if ((p_Inp->PicInterlace == ADAPTIVE_CODING) && (!is_MVC_profile(p_Vid->active_sps->profile_idc) || 
      (/*(p_Vid->active_sps->profile_idc == SBSPLUS_HIGH) &&*/ ((p_Vid->view_id == 0) || (p_Vid->view_id == 1 && p_Vid->sec_view_force_fld)))))
@@ -858,7 +890,20 @@ void perform_encode_frame(VideoParameters *p_Vid)
 
 #if (MVC_EXTENSION_ENABLE)
     field_picture (p_Vid, p_Vid->field_pic_ptr[0], p_Vid->field_pic_ptr[1]);
+#else
+    field_picture (p_Vid, p_Vid->field_pic[0], p_Vid->field_pic[1]);
+#endif
+
+    if (p_Vid->p_PaffThread)
+    {
+      VideoParameters *p_Frm = p_Vid->p_PaffThread->p_Vid;
 
+      tmpFrameQP = p_Frm->SumFrameQP;
+      num_ref_idx_l0 = p_Frm->num_ref_idx_l0_active;
+      num_ref_idx_l1 = p_Frm->num_ref_idx_l1_active;
+    }
+
+#if (MVC_EXTENSION_ENABLE)
     if(p_Inp->num_of_views==1 || p_Vid->view_id==0)  // first view will make the decision
     {
       if(p_Vid->rd_pass == 0)
@@ -875,8 +920,6 @@ void perform_encode_frame(VideoParameters *p_Vid)
       p_Vid->fld_flag = (byte) p_Vid->sec_view_force_fld;
     }
 #else
-    field_picture (p_Vid, p_Vid->field_pic[0], p_Vid->field_pic[1]);
-
     if(p_Vid->rd_pass == 0)
       p_Vid->fld_flag = picture_structure_decision (p_Vid, p_Vid->frame_pic[0], p_Vid->field_pic[0], p_Vid->field_pic[1]);
     else if(p_Vid->rd_pass == 1)
@@ -898,6 +941,8 @@ void perform_encode_frame(VideoParameters *p_Vid)
     }
 
     update_field_frame_contexts (p_Vid, p_Vid->fld_flag);
+    if (p_Vid->p_PaffThread)
+      paff_thread_merge(p_Vid);
 
     //Rate control
     if ( p_Inp->RCEnable && p_Inp->RCUpdateMode <= MAX_RC_MODE )
@@ -961,9 +1006,9 @@ void store_coded_picture(DecodedPictureBuffer *p_Dpb)
   unsigned int profile_idc = p_Vid->active_sps->profile_idc;
 
 #if (MVC_EXTENSION_ENABLE)
-  if ( (p_Inp->PicInterlace == ADAPTIVE_CODING) && ((p_Dpb->layer_id == 0 ) || !is_MVC_profile(profile_idc)))
+  if ( (p_Inp->PicInterlace == ADAPTIVE_CODING) && (p_Vid->pic_structure == ADAPTIVE_CODING) && ((p_Dpb->layer_id == 0 ) || !is_MVC_profile(profile_idc)))
 #else
-  if ( p_Inp->PicInterlace == ADAPTIVE_CODING )
+  if ( (p_Inp->PicInterlace == ADAPTIVE_CODING) && (p_Vid->pic_structure == ADAPTIVE_CODING) )
 #endif
   {
     if (p_Vid->fld_flag)
@@ -1184,6 +1229,7 @@ int encode_one_frame (VideoParameters *p_Vid, InputParameters *p_Inp)
 {
   int i;
   int nplane;
+  int file_read;
 
   //Rate control
   int bits = 0;
@@ -1225,19 +1271,16 @@ int encode_one_frame (VideoParameters *p_Vid, InputParameters *p_Inp)
                                // (and not to one of the field structures)
   init_frame (p_Vid, p_Inp);
 
+  ENC_PROFILE_START(p_Vid, EPROF_INPUT);
   if (p_Inp->enable_32_pulldown)
-  {
-    if ( !read_input_data_32pulldown (p_Vid) )
-    {
-      return 0;
-    }
-  }
+    file_read = read_input_data_32pulldown (p_Vid);
   else
+    file_read = read_input_data (p_Vid);
+  ENC_PROFILE_STOP(p_Vid, EPROF_INPUT);
+
+  if ( !file_read )
   {
-    if ( !read_input_data (p_Vid) )
-    {
-      return 0;
-    }
+    return 0;
   }
 
   process_image(p_Vid, p_Inp);
@@ -1290,6 +1333,11 @@ int encode_one_frame (VideoParameters *p_Vid, InputParameters *p_Inp)
   else
     perform_encode_frame(p_Vid);
 
+#if (MVC_EXTENSION_ENABLE)
+  // the pending view 1 picture is written before this one
+  view_threads_drain(p_Vid);
+#endif
+
   p_Vid->p_Stats->frame_counter++;
   p_Vid->p_Stats->frame_ctr[p_Vid->type]++;
 
@@ -1376,8 +1424,8 @@ int encode_one_frame (VideoParameters *p_Vid, InputParameters *p_Inp)
   // Store bits used for this frame and increment counter of no. of coded frames
   if (!p_Vid->redundant_coding)
   {
-    p_Vid->Bit_Buffer[p_Vid->total_frame_buffer++] = (long) (p_Vid->p_Stats->bit_ctr - p_Vid->p_Stats->bit_ctr_n)
-      + (long)( p_Vid->p_Stats->bit_ctr_filler_data - p_Vid->p_Stats->bit_ctr_filler_data_n );
+    update_leaky_buckets(p_Vid, (long) (p_Vid->p_Stats->bit_ctr - p_Vid->p_Stats->bit_ctr_n)
+      + (long)( p_Vid->p_Stats->bit_ctr_filler_data - p_Vid->p_Stats->bit_ctr_filler_data_n ));
   }
 #endif
 
@@ -1400,6 +1448,8 @@ int encode_one_frame (VideoParameters *p_Vid, InputParameters *p_Inp)
   p_Vid->tot_time += tmp_time;
   tmp_time  = timenorm(tmp_time);
   p_Vid->me_time   = timenorm(p_Vid->me_time);
+  if (p_Vid->p_Cplx)
+    update_complexity_control(p_Vid->p_Cplx, p_Inp, tmp_time);
   if (p_Vid->p_Stats->bit_ctr_parametersets_n!=0 && p_Inp->Verbose != 3)
     ReportNALNonVLCBits(p_Vid, tmp_time);
 
@@ -1722,6 +1772,8 @@ static void field_picture (VideoParameters *p_Vid, Picture *top, Picture *bottom
 
   code_a_picture(p_Vid, top);
   p_Vid->enc_picture->structure = TOP_FIELD;
+  // the frame candidate references the DPB until it is finished
+  paff_thread_join(p_Vid);
   store_picture_in_dpb(p_Vid->p_Dpb_layer[p_Vid->view_id], p_Vid->enc_field_picture[0], &p_Inp->output);
 
 #if (MVC_EXTENSION_ENABLE)
@@ -2190,6 +2242,7 @@ void UnifiedOneForthPix ( VideoParameters *p_Vid, StorablePicture *s)
   if(s->bInterpolated)
     return;
   s->bInterpolated = 1;
+  ENC_PROFILE_START(p_Vid, EPROF_INTERPOLATION);
   // Y component
   s->p_img_sub[0] = s->imgY_sub;
   s->p_curr_img_sub = s->imgY_sub;
@@ -2236,6 +2289,7 @@ void UnifiedOneForthPix ( VideoParameters *p_Vid, StorablePicture *s)
     OtfCompatibility_copyWithPadding( s->imgUV[0], s->imgUV[0], s->size_x_cr, s->size_y_cr, p_Vid->pad_size_uv_x,p_Vid->pad_size_uv_y ) ;
     OtfCompatibility_copyWithPadding( s->imgUV[1], s->imgUV[1], s->size_x_cr, s->size_y_cr, p_Vid->pad_size_uv_x, p_Vid->pad_size_uv_y ) ;
   }
+  ENC_PROFILE_STOP(p_Vid, EPROF_INTERPOLATION);
 }
 
 /*!
@@ -2269,6 +2323,7 @@ void UnifiedOneForthPix_JV (VideoParameters *p_Vid, int nplane, StorablePicture
     }
   }
 
+  ENC_PROFILE_START(p_Vid, EPROF_INTERPOLATION);
   // derive the subpixel images for first component
   s->colour_plane_id = nplane;
   s->p_curr_img = s->p_img[nplane];
@@ -2283,6 +2338,7 @@ void UnifiedOneForthPix_JV (VideoParameters *p_Vid, int nplane, StorablePicture
     // perform  padding ( copying borders) that is implicitly done above if p_Inp->OnTheFlyFractMCP=0
      OtfCompatibility_copyWithPadding( s->p_img[nplane], s->p_img[nplane], s->size_x, s->size_y, IMG_PAD_SIZE_X, IMG_PAD_SIZE_Y ) ;
   }
+  ENC_PROFILE_STOP(p_Vid, EPROF_INTERPOLATION);
 }
 
   /*!
@@ -337,7 +337,7 @@ static void generateChromaXX( VideoParameters *p_Vid, int size_x_minus1, int siz
  */
 void getSubImagesChroma( VideoParameters *p_Vid, StorablePicture *s )
 {
-  int uv, k, l, m;
+  int uv, k, l, m, n;
   int weight00, weight01, weight10, weight11;
   int subimages_y, subimages_x, subx, suby;
   int size_x_minus1, size_y_minus1;
@@ -396,42 +396,48 @@ void getSubImagesChroma( VideoParameters *p_Vid, StorablePicture *s )
     }
   }
 
-  // U or V
-  for ( uv = 0; uv < 2; uv++ )
+  // The sub-images of both components only read the integer samples and are
+  // independent of each other
+#if defined(OPENMP)
+#pragma omp parallel for private(uv, suby, subx, k, l, m, mm, kk, weight00, weight01, weight10, weight11, curr_img, curr_img_sub)
+#endif
+  for ( n = 0; n < 2 * subimages_y * subimages_x; n++ )
   {
+    // U or V
+    uv   = n / (subimages_y * subimages_x);
+    suby = (n / subimages_x) % subimages_y;
+    subx = n % subimages_x;
+
     curr_img     = s->imgUV[uv];
     curr_img_sub = s->p_img_sub[uv + 1];
 
-    for ( suby = 0, k = 0; suby < subimages_y; suby++, k += mul_y )
+    k = suby * mul_y;
+    l = subx * mul_x;
+    m = (8 - k);
+    mm = m << 3;
+    kk = k << 3;
+
+    weight01 = m * l;
+    weight00 = mm - weight01;
+    weight11 = k * l;
+    weight10 = kk - weight11;         
+
+    // Lets break things into cases
+    if (weight01 == 0 && weight10 == 0 && weight11 == 0) // integer
+    {
+      generateChroma00( p_Vid, size_x_minus1, size_y_minus1, curr_img_sub[suby][subx], curr_img);
+    }
+    else if (weight10 == 0 && weight11 == 0) // horizontal
+    {
+      generateChroma01( p_Vid, size_x_minus1, size_y_minus1, weight00, weight01, curr_img_sub[suby][subx], curr_img);
+    }
+    else if (weight01 == 0 && weight11 == 0) // vertical
     {
-      m = (8 - k);
-      mm = m << 3;
-      kk = k << 3;
-      for ( subx = 0, l = 0; subx < subimages_x; subx++, l += mul_x )
-      {
-        weight01 = m * l;
-        weight00 = mm - weight01;
-        weight11 = k * l;
-        weight10 = kk - weight11;         
-
-        // Lets break things into cases
-        if (weight01 == 0 && weight10 == 0 && weight11 == 0) // integer
-        {
-          generateChroma00( p_Vid, size_x_minus1, size_y_minus1, curr_img_sub[suby][subx], curr_img);
-        }
-        else if (weight10 == 0 && weight11 == 0) // horizontal
-        {
-           generateChroma01( p_Vid, size_x_minus1, size_y_minus1, weight00, weight01, curr_img_sub[suby][subx], curr_img);
-        }
-        else if (weight01 == 0 && weight11 == 0) // vertical
-        {
-          generateChroma10( p_Vid, size_x_minus1, size_y_minus1, weight00, weight10, curr_img_sub[suby][subx], curr_img);
-        }
-        else //diagonal
-        {
-          generateChromaXX( p_Vid, size_x_minus1, size_y_minus1, weight00, weight01, weight10, weight11, curr_img_sub[suby][subx], curr_img);
-        }          
-      }
+      generateChroma10( p_Vid, size_x_minus1, size_y_minus1, weight00, weight10, curr_img_sub[suby][subx], curr_img);
     }
+    else //diagonal
+    {
+      generateChromaXX( p_Vid, size_x_minus1, size_y_minus1, weight00, weight01, weight10, weight11, curr_img_sub[suby][subx], curr_img);
+    }          
   }
 }
@@ -47,6 +47,7 @@
 #include "img_dist_ssim.h"
 #include "img_dist_ms_ssim.h"
 #include "cconv_yuv2rgb.h"
+#include "enc_profile.h"
 
 
 /*!
@@ -98,6 +99,7 @@ void find_distortion (VideoParameters *p_Vid, ImageData *imgData)
   DistortionParams *p_Dist = p_Vid->p_Dist;
   int64 diff_cmp[3] = {0};
 
+  ENC_PROFILE_START(p_Vid, EPROF_DISTORTION);
   //  Calculate SSE for Y, U and V.
   if (p_Vid->structure!=FRAME)
   {
@@ -138,6 +140,7 @@ void find_distortion (VideoParameters *p_Vid, ImageData *imgData)
   p_Dist->metric[SSE].value[0] = (float) diff_cmp[0];
   p_Dist->metric[SSE].value[1] = (float) diff_cmp[1];
   p_Dist->metric[SSE].value[2] = (float) diff_cmp[2];
+  ENC_PROFILE_STOP(p_Vid, EPROF_DISTORTION);
 }
 
 void select_img(VideoParameters *p_Vid, ImageStructure *imgSRC, ImageStructure *imgREF, ImageData *imgData)
@@ -189,6 +192,7 @@ void compute_distortion(VideoParameters *p_Vid, ImageData *imgData)
   DistortionParams *p_Dist = p_Vid->p_Dist;
   if (p_Inp->Verbose != 0)
   {
+    ENC_PROFILE_START(p_Vid, EPROF_DISTORTION);
     select_img(p_Vid, &p_Vid->imgSRC, &p_Vid->imgREF, imgData);
 
     find_snr (p_Vid, &p_Vid->imgREF, &p_Vid->imgSRC, &p_Dist->metric[SSE], &p_Dist->metric[PSNR]);
@@ -207,5 +211,6 @@ void compute_distortion(VideoParameters *p_Vid, ImageData *imgData)
       if (p_Inp->Distortion[MS_SSIM] == 1)
         find_ms_ssim(p_Vid, p_Inp, &p_Vid->imgRGB_ref, &p_Vid->imgRGB_src, &p_Dist->metric[MS_SSIM_RGB]);
     }
+    ENC_PROFILE_STOP(p_Vid, EPROF_DISTORTION);
   }
 }
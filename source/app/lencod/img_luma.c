@@ -24,10 +24,15 @@
 #include "memalloc.h"
 
 
+//! height of the row bands the sub-pel images are generated in
+#define SUBPEL_BAND_SIZE  16
+
 /*!
  ************************************************************************
  * \brief
- *    Copy Integer Samples to image [0][0]
+ *    Copy Integer Samples to image [0][0] and pad them, rows jstart to jend - 1
+ *    of the padded image. If dstImg shares its samples with srcImg, only the
+ *    padded area is written.
  *
  * \param s
  *    pointer to StorablePicture structure
@@ -35,102 +40,35 @@
  *    destination image
  * \param srcImg
  *    source image
+ * \param jstart
+ *    first padded row
+ * \param jend
+ *    last padded row + 1
  ************************************************************************
  */
-static void getSubImageInteger( StorablePicture *s, imgpel **dstImg, imgpel **srcImg)
+static void getSubImageInteger( StorablePicture *s, imgpel **dstImg, imgpel **srcImg, int jstart, int jend)
 {
   int i, j;
   int size_x_minus1 = s->size_x - 1;
+  int size_y_minus1 = s->size_y - 1;
 
   imgpel *wBufSrc, *wBufDst;
 
-  // Copy top line
-  wBufDst = &( dstImg[-IMG_PAD_SIZE_Y][-IMG_PAD_SIZE_X] ); 
-  wBufSrc = srcImg[0];
-  // left IMG_PAD_SIZE
-  for (i = 0; i < IMG_PAD_SIZE_X; i++)
-    *(wBufDst++) = wBufSrc[0];
-  // center 0-(s->size_x)
-  memcpy(wBufDst, wBufSrc, s->size_x * sizeof(imgpel));
-  wBufDst += s->size_x;
-  // right IMG_PAD_SIZE
-  for (i = 0; i < IMG_PAD_SIZE_X; i++)
-    *(wBufDst++) = wBufSrc[size_x_minus1];
-
-  // Now copy remaining pad lines
-  for (j = -IMG_PAD_SIZE_Y+1; j < 1; ++j)
-  {
-    memcpy(dstImg[j]-IMG_PAD_SIZE_X, dstImg[j - 1]-IMG_PAD_SIZE_X, s->size_x_padded * sizeof(imgpel));
-  }
-
-  for (j = 1; j < s->size_y; j++)
+  for (j = jstart; j < jend; j++)
   {    
     wBufDst = &( dstImg[j][-IMG_PAD_SIZE_X] ); 
-    wBufSrc = srcImg[j];
+    wBufSrc = srcImg[iClip3(0, size_y_minus1, j)];
     // left IMG_PAD_SIZE
     for (i = 0; i < IMG_PAD_SIZE_X; i++)
       *(wBufDst++) = wBufSrc[0];
     // center 0-(s->size_x)
-    memcpy(wBufDst, wBufSrc, s->size_x * sizeof(imgpel));
+    if (wBufDst != wBufSrc)
+      memcpy(wBufDst, wBufSrc, s->size_x * sizeof(imgpel));
     wBufDst += s->size_x;
     // right IMG_PAD_SIZE
     for (i = 0; i < IMG_PAD_SIZE_X; i++)
       *(wBufDst++) = wBufSrc[size_x_minus1];
   }
-
-  // Replicate bottom pad lines
-  for (j = s->size_y; j < s->size_y+IMG_PAD_SIZE_Y; j++)
-  {    
-    memcpy(dstImg[j]-IMG_PAD_SIZE_X, dstImg[j - 1]-IMG_PAD_SIZE_X, s->size_x_padded * sizeof(imgpel));
-  }
-}
-
-static void getSubImageInteger_s( StorablePicture *s, imgpel **dstImg, imgpel **srcImg)
-{
-  int i, j;
-  int size_x_minus1 = s->size_x - 1;
-
-  imgpel *wBufSrc, *wBufDst;
-
-  // Copy top line
-  wBufDst = &( dstImg[-IMG_PAD_SIZE_Y][-IMG_PAD_SIZE_X] ); 
-  wBufSrc = srcImg[0];
-  // left IMG_PAD_SIZE
-  for (i = 0; i < IMG_PAD_SIZE_X; ++i)
-    *(wBufDst++) = wBufSrc[0];
-  // center 0-(s->size_x)
-  memcpy(wBufDst, wBufSrc, s->size_x * sizeof(imgpel));
-  wBufDst += s->size_x;
-  // right IMG_PAD_SIZE
-  for (i = 0; i < IMG_PAD_SIZE_X; ++i)
-    *(wBufDst++) = wBufSrc[size_x_minus1];
-
-  // Now copy remaining pad lines
-  for (j = -IMG_PAD_SIZE_Y+1; j < 1; ++j)
-  {
-    memcpy(dstImg[j]-IMG_PAD_SIZE_X, dstImg[j - 1]-IMG_PAD_SIZE_X, s->size_x_padded * sizeof(imgpel));
-  }
-
-  for (j = 1; j < s->size_y; ++j)
-  {    
-    wBufDst = &( dstImg[j][-IMG_PAD_SIZE_X] ); 
-    wBufSrc = srcImg[j];
-    // left IMG_PAD_SIZE
-    for (i = 0; i < IMG_PAD_SIZE_X; ++i)
-      *(wBufDst++) = wBufSrc[0];
-    // center 0-(s->size_x)
-    //memcpy(wBufDst, wBufSrc, s->size_x * sizeof(imgpel));
-    wBufDst += s->size_x;
-    // right IMG_PAD_SIZE
-    for (i = 0; i < IMG_PAD_SIZE_X; ++i)
-      *(wBufDst++) = wBufSrc[size_x_minus1];
-  }
-
-  // Replicate bottom pad lines
-  for (j = s->size_y; j < s->size_y+IMG_PAD_SIZE_Y; ++j)
-  {    
-    memcpy(dstImg[j]-IMG_PAD_SIZE_X, dstImg[j - 1]-IMG_PAD_SIZE_X, s->size_x_padded * sizeof(imgpel));
-  }
 }
 
 /*!
@@ -146,103 +84,73 @@ static void getSubImageInteger_s( StorablePicture *s, imgpel **dstImg, imgpel **
  *    destination image
  * \param srcImg
  *    source image
+ * \param jstart
+ *    first padded row
+ * \param jend
+ *    last padded row + 1
  ************************************************************************
  */
-static void getHorSubImageSixTap( VideoParameters *p_Vid, StorablePicture *s, imgpel **dstImg, imgpel **srcImg)
+static void getHorSubImageSixTap( VideoParameters *p_Vid, StorablePicture *s, imgpel **dstImg, imgpel **srcImg, int jstart, int jend)
 {
   int is, jpad, ipad;
-  int ypadded_size = s->size_y_padded;
   int xpadded_size = s->size_x_padded;
+  int max_imgpel_value = p_Vid->max_imgpel_value;
 
   imgpel *wBufSrc, *wBufDst;
-  imgpel *srcImgA, *srcImgB, *srcImgC, *srcImgD, *srcImgE, *srcImgF;
   int *iBufDst;
   const int tap0 = ONE_FOURTH_TAP[0][0];
   const int tap1 = ONE_FOURTH_TAP[0][1];
   const int tap2 = ONE_FOURTH_TAP[0][2];
 
-  for (jpad = -IMG_PAD_SIZE_Y; jpad < ypadded_size-IMG_PAD_SIZE_Y; jpad++)
+  for (jpad = jstart; jpad < jend; jpad++)
   {
     wBufSrc = srcImg[jpad]-IMG_PAD_SIZE_X; 
     wBufDst = dstImg[jpad]-IMG_PAD_SIZE_X; 
     iBufDst = p_Vid->imgY_sub_tmp[jpad]-IMG_PAD_SIZE_X;
 
-    srcImgA = &wBufSrc[0];
-    srcImgB = &wBufSrc[0];      
-    srcImgC = &wBufSrc[0];
-    srcImgD = &wBufSrc[1];
-    srcImgE = &wBufSrc[2];
-    srcImgF = &wBufSrc[3];
-
     // left padded area
-    is =
-      (tap0 * (*srcImgA++ + *srcImgD++) +
-      tap1 *  (*srcImgB   + *srcImgE++) +
-      tap2 *  (*srcImgC   + *srcImgF++));
-
-    *iBufDst++ =  is;
-    *wBufDst++ = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 5 ) );      
-
-    is =
-      (tap0 * (*srcImgA++ + *srcImgD++) +
-      tap1 *  (*srcImgB++ + *srcImgE++) +
-      tap2 *  (*srcImgC   + *srcImgF++));
-
-    *iBufDst++ =  is;
-    *wBufDst++ = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 5 ) );      
-
-    // center
-    for (ipad = 2; ipad < xpadded_size - 4; ipad++)
+    for (ipad = 0; ipad < 2; ipad++)
     {
       is =
-        (tap0 * (*srcImgA++ + *srcImgD++) +
-        tap1 *  (*srcImgB++ + *srcImgE++) +
-        tap2 *  (*srcImgC++ + *srcImgF++));
+        (tap0 * (wBufSrc[ipad             ] + wBufSrc[ipad + 1]) +
+        tap1 *  (wBufSrc[imax(ipad - 1, 0)] + wBufSrc[ipad + 2]) +
+        tap2 *  (wBufSrc[imax(ipad - 2, 0)] + wBufSrc[ipad + 3]));
 
-      *iBufDst++ =  is;
-      *wBufDst++ = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 5 ) );      
+      iBufDst[ipad] = is;
+      wBufDst[ipad] = (imgpel) iClip1 ( max_imgpel_value, rshift_rnd_sf( is, 5 ) );
     }
 
-    is = (
-      tap0 * (*srcImgA++ + *srcImgD++) +
-      tap1 * (*srcImgB++ + *srcImgE++) +
-      tap2 * (*srcImgC++ + *srcImgF  ));
+    // center; indexed so that the compiler can vectorize it
+    for (ipad = 2; ipad < xpadded_size - 3; ipad++)
+    {
+      is =
+        (tap0 * (wBufSrc[ipad    ] + wBufSrc[ipad + 1]) +
+        tap1 *  (wBufSrc[ipad - 1] + wBufSrc[ipad + 2]) +
+        tap2 *  (wBufSrc[ipad - 2] + wBufSrc[ipad + 3]));
 
-    *iBufDst++ =  is;
-    *wBufDst++ = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 5 ) );      
+      iBufDst[ipad] = is;
+      wBufDst[ipad] = (imgpel) iClip1 ( max_imgpel_value, rshift_rnd_sf( is, 5 ) );
+    }
 
     // right padded area
-    is = (
-      tap0 * (*srcImgA++ + *srcImgD++) +
-      tap1 * (*srcImgB++ + *srcImgE) +
-      tap2 * (*srcImgC++ + *srcImgF));
-
-    *iBufDst++ =  is;
-    *wBufDst++ = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 5 ) );      
-
-    is = (
-      tap0 * (*srcImgA++ + *srcImgD) +
-      tap1 * (*srcImgB++ + *srcImgE) +
-      tap2 * (*srcImgC++ + *srcImgF));
-
-    *iBufDst++ =  is;
-    *wBufDst++ = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 5 ) );      
-
-    is = (
-      tap0 * (*srcImgA + *srcImgD) +
-      tap1 * (*srcImgB + *srcImgE) +
-      tap2 * (*srcImgC + *srcImgF));
-
-    *iBufDst =  is;
-    *wBufDst = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 5 ) );      
+    for (ipad = xpadded_size - 3; ipad < xpadded_size; ipad++)
+    {
+      is =
+        (tap0 * (wBufSrc[ipad    ] + wBufSrc[imin(ipad + 1, xpadded_size - 1)]) +
+        tap1 *  (wBufSrc[ipad - 1] + wBufSrc[imin(ipad + 2, xpadded_size - 1)]) +
+        tap2 *  (wBufSrc[ipad - 2] + wBufSrc[xpadded_size - 1]));
 
+      iBufDst[ipad] = is;
+      wBufDst[ipad] = (imgpel) iClip1 ( max_imgpel_value, rshift_rnd_sf( is, 5 ) );
+    }
   }
 }
 
 /*!
  ************************************************************************
  * \brief
- *    Does _vertical_ interpolation using the SIX TAP filters
+ *    Does _vertical_ interpolation using the SIX TAP filters.
+ *    Rows outside the padded image are clamped to its first/last row.
  *
  * \param p_Vid
  *    pointer to VideoParameters structure
@@ -252,14 +160,18 @@ static void getHorSubImageSixTap( VideoParameters *p_Vid, StorablePicture *s, im
  *    pointer to target image
  * \param srcImg
  *    pointer to source image
+ * \param jstart
+ *    first padded row
+ * \param jend
+ *    last padded row + 1
  ************************************************************************
  */
-static void getVerSubImageSixTap( VideoParameters *p_Vid, StorablePicture *s, imgpel **dstImg, imgpel **srcImg)
+static void getVerSubImageSixTap( VideoParameters *p_Vid, StorablePicture *s, imgpel **dstImg, imgpel **srcImg, int jstart, int jend)
 {
   int is, jpad, ipad;
-  int ypadded_size = s->size_y_padded;
   int xpadded_size = s->size_x_padded;
-  int maxy = ypadded_size - 1-IMG_PAD_SIZE_Y;
+  int maxy = s->size_y_padded - 1-IMG_PAD_SIZE_Y;
+  int max_imgpel_value = p_Vid->max_imgpel_value;
 
   imgpel *wxLineDst;
   imgpel *srcImgA, *srcImgB, *srcImgC, *srcImgD, *srcImgE, *srcImgF;
@@ -267,66 +179,23 @@ static void getVerSubImageSixTap( VideoParameters *p_Vid, StorablePicture *s, im
   const int tap1 = ONE_FOURTH_TAP[0][1];
   const int tap2 = ONE_FOURTH_TAP[0][2];
 
-  // branches within the j loop
-  // top
-  for (jpad = -IMG_PAD_SIZE_Y; jpad < 2-IMG_PAD_SIZE_Y; jpad++)
-  {
-    wxLineDst = dstImg[jpad]-IMG_PAD_SIZE_X;
-    srcImgA = srcImg[jpad ]-IMG_PAD_SIZE_X;
-    srcImgB = srcImg[0-IMG_PAD_SIZE_Y]-IMG_PAD_SIZE_X;      
-    srcImgC = srcImg[0-IMG_PAD_SIZE_Y]-IMG_PAD_SIZE_X;
-    srcImgD = srcImg[jpad + 1]-IMG_PAD_SIZE_X;
-    srcImgE = srcImg[jpad + 2]-IMG_PAD_SIZE_X;
-    srcImgF = srcImg[jpad + 3]-IMG_PAD_SIZE_X;
-    for (ipad = 0; ipad < xpadded_size; ipad++)
-    {
-      is =
-        (tap0 * (*srcImgA++ + *srcImgD++) +
-        tap1 *  (*srcImgB++ + *srcImgE++) +
-        tap2 *  (*srcImgC++ + *srcImgF++));
-
-      wxLineDst[ipad] = (imgpel) iClip1 (p_Vid->max_imgpel_value, rshift_rnd_sf( is, 5 ) );
-    }
-  }
-  // center
-  for (jpad = 2-IMG_PAD_SIZE_Y; jpad < ypadded_size - 3-IMG_PAD_SIZE_Y; jpad++)
-  {
-    wxLineDst = dstImg[jpad]-IMG_PAD_SIZE_X;
-    srcImgA = srcImg[jpad ]-IMG_PAD_SIZE_X;
-    srcImgB = srcImg[jpad - 1]-IMG_PAD_SIZE_X;      
-    srcImgC = srcImg[jpad - 2]-IMG_PAD_SIZE_X;
-    srcImgD = srcImg[jpad + 1]-IMG_PAD_SIZE_X;
-    srcImgE = srcImg[jpad + 2]-IMG_PAD_SIZE_X;
-    srcImgF = srcImg[jpad + 3]-IMG_PAD_SIZE_X;
-    for (ipad = 0; ipad < xpadded_size; ipad++)
-    {
-      is =
-        (tap0 * (*srcImgA++ + *srcImgD++) +
-        tap1 *  (*srcImgB++ + *srcImgE++) +
-        tap2 *  (*srcImgC++ + *srcImgF++));
-
-      wxLineDst[ipad] = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 5 ) );
-    }
-  }
-
-  // bottom
-  for (jpad = ypadded_size - 3-IMG_PAD_SIZE_Y; jpad < ypadded_size-IMG_PAD_SIZE_Y; jpad++)
+  for (jpad = jstart; jpad < jend; jpad++)
   {
     wxLineDst = dstImg[jpad]-IMG_PAD_SIZE_X;
     srcImgA = srcImg[jpad ]-IMG_PAD_SIZE_X;
-    srcImgB = srcImg[jpad - 1]-IMG_PAD_SIZE_X;      
-    srcImgC = srcImg[jpad - 2]-IMG_PAD_SIZE_X;
-    srcImgD = srcImg[imin (maxy, jpad + 1)]-IMG_PAD_SIZE_X;
-    srcImgE = srcImg[maxy]-IMG_PAD_SIZE_X;
-    srcImgF = srcImg[maxy]-IMG_PAD_SIZE_X;
+    srcImgB = srcImg[imax(-IMG_PAD_SIZE_Y, jpad - 1)]-IMG_PAD_SIZE_X;      
+    srcImgC = srcImg[imax(-IMG_PAD_SIZE_Y, jpad - 2)]-IMG_PAD_SIZE_X;
+    srcImgD = srcImg[imin(maxy, jpad + 1)]-IMG_PAD_SIZE_X;
+    srcImgE = srcImg[imin(maxy, jpad + 2)]-IMG_PAD_SIZE_X;
+    srcImgF = srcImg[imin(maxy, jpad + 3)]-IMG_PAD_SIZE_X;
     for (ipad = 0; ipad < xpadded_size; ipad++)
     {
       is =
-        (tap0 * (*srcImgA++ + *srcImgD++) +
-        tap1 *  (*srcImgB++ + *srcImgE++) +
-        tap2 *  (*srcImgC++ + *srcImgF++));
+        (tap0 * (srcImgA[ipad] + srcImgD[ipad]) +
+        tap1 *  (srcImgB[ipad] + srcImgE[ipad]) +
+        tap2 *  (srcImgC[ipad] + srcImgF[ipad]));
 
-      wxLineDst[ipad] = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 5 ) );
+      wxLineDst[ipad] = (imgpel) iClip1 ( max_imgpel_value, rshift_rnd_sf( is, 5 ) );
     }
   }
 }
@@ -334,7 +203,8 @@ static void getVerSubImageSixTap( VideoParameters *p_Vid, StorablePicture *s, im
 /*!
  ************************************************************************
  * \brief
- *    Does _vertical_ interpolation using the SIX TAP filters
+ *    Does _vertical_ interpolation using the SIX TAP filters on the
+ *    unscaled output of the horizontal filter
  *
  * \param p_Vid
  *    pointer to VideoParameters structure
@@ -342,14 +212,19 @@ static void getVerSubImageSixTap( VideoParameters *p_Vid, StorablePicture *s, im
  *    pointer to StorablePicture structure
  * \param dstImg
  *    pointer to source image
+ * \param jstart
+ *    first padded row
+ * \param jend
+ *    last padded row + 1
  ************************************************************************
  */
-static void getVerSubImageSixTapTmp( VideoParameters *p_Vid, StorablePicture *s, imgpel **dstImg)
+static void getVerSubImageSixTapTmp( VideoParameters *p_Vid, StorablePicture *s, imgpel **dstImg, int jstart, int jend)
 {
   int is, jpad, ipad;
-  int ypadded_size = s->size_y_padded;
   int xpadded_size = s->size_x_padded;
-  int maxy = ypadded_size - 1-IMG_PAD_SIZE_Y;
+  int maxy = s->size_y_padded - 1-IMG_PAD_SIZE_Y;
+  int max_imgpel_value = p_Vid->max_imgpel_value;
+  int **srcImg = p_Vid->imgY_sub_tmp;
 
   imgpel *wxLineDst;
   int *srcImgA, *srcImgB, *srcImgC, *srcImgD, *srcImgE, *srcImgF;
@@ -357,67 +232,23 @@ static void getVerSubImageSixTapTmp( VideoParameters *p_Vid, StorablePicture *s,
   const int tap1 = ONE_FOURTH_TAP[0][1];
   const int tap2 = ONE_FOURTH_TAP[0][2];
 
-  // top
-  for (jpad = -IMG_PAD_SIZE_Y; jpad < 2-IMG_PAD_SIZE_Y; jpad++)
-  {
-    wxLineDst = dstImg[jpad]-IMG_PAD_SIZE_X;
-    srcImgA = p_Vid->imgY_sub_tmp[jpad ]-IMG_PAD_SIZE_X;
-    srcImgB = p_Vid->imgY_sub_tmp[0-IMG_PAD_SIZE_Y]-IMG_PAD_SIZE_X;     
-    srcImgC = p_Vid->imgY_sub_tmp[0-IMG_PAD_SIZE_Y]-IMG_PAD_SIZE_X;
-    srcImgD = p_Vid->imgY_sub_tmp[jpad + 1]-IMG_PAD_SIZE_X;
-    srcImgE = p_Vid->imgY_sub_tmp[jpad + 2]-IMG_PAD_SIZE_X;
-    srcImgF = p_Vid->imgY_sub_tmp[jpad + 3]-IMG_PAD_SIZE_X;
-
-    for (ipad = 0; ipad < xpadded_size; ipad++)
-    {
-      is =
-        (tap0 * (*srcImgA++ + *srcImgD++) +
-        tap1 *  (*srcImgB++ + *srcImgE++) +
-        tap2 *  (*srcImgC++ + *srcImgF++));
-
-      wxLineDst[ipad] = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 10 ) );
-    }
-  }
-
-  // center
-  for (jpad = 2-IMG_PAD_SIZE_Y; jpad < ypadded_size - 3-IMG_PAD_SIZE_Y; jpad++)
-  {
-    wxLineDst = dstImg[jpad]-IMG_PAD_SIZE_X;
-    srcImgA = p_Vid->imgY_sub_tmp[jpad ]-IMG_PAD_SIZE_X;
-    srcImgB = p_Vid->imgY_sub_tmp[jpad - 1]-IMG_PAD_SIZE_X;     
-    srcImgC = p_Vid->imgY_sub_tmp[jpad - 2]-IMG_PAD_SIZE_X;
-    srcImgD = p_Vid->imgY_sub_tmp[jpad + 1]-IMG_PAD_SIZE_X;
-    srcImgE = p_Vid->imgY_sub_tmp[jpad + 2]-IMG_PAD_SIZE_X;
-    srcImgF = p_Vid->imgY_sub_tmp[jpad + 3]-IMG_PAD_SIZE_X;
-    for (ipad = 0; ipad < xpadded_size; ipad++)
-    {
-      is =
-        (tap0 * (*srcImgA++ + *srcImgD++) +
-        tap1 *  (*srcImgB++ + *srcImgE++) +
-        tap2 *  (*srcImgC++ + *srcImgF++));
-
-      wxLineDst[ipad] = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 10 ) );
-    }
-  }
-
-  // bottom
-  for (jpad = ypadded_size - 3-IMG_PAD_SIZE_Y; jpad < ypadded_size-IMG_PAD_SIZE_Y; jpad++)
+  for (jpad = jstart; jpad < jend; jpad++)
   {
     wxLineDst = dstImg[jpad]-IMG_PAD_SIZE_X;
-    srcImgA = p_Vid->imgY_sub_tmp[jpad ]-IMG_PAD_SIZE_X;
-    srcImgB = p_Vid->imgY_sub_tmp[jpad - 1]-IMG_PAD_SIZE_X;      
-    srcImgC = p_Vid->imgY_sub_tmp[jpad - 2]-IMG_PAD_SIZE_X;
-    srcImgD = p_Vid->imgY_sub_tmp[imin (maxy, jpad + 1)]-IMG_PAD_SIZE_X;
-    srcImgE = p_Vid->imgY_sub_tmp[maxy]-IMG_PAD_SIZE_X;
-    srcImgF = p_Vid->imgY_sub_tmp[maxy]-IMG_PAD_SIZE_X;
+    srcImgA = srcImg[jpad ]-IMG_PAD_SIZE_X;
+    srcImgB = srcImg[imax(-IMG_PAD_SIZE_Y, jpad - 1)]-IMG_PAD_SIZE_X;      
+    srcImgC = srcImg[imax(-IMG_PAD_SIZE_Y, jpad - 2)]-IMG_PAD_SIZE_X;
+    srcImgD = srcImg[imin(maxy, jpad + 1)]-IMG_PAD_SIZE_X;
+    srcImgE = srcImg[imin(maxy, jpad + 2)]-IMG_PAD_SIZE_X;
+    srcImgF = srcImg[imin(maxy, jpad + 3)]-IMG_PAD_SIZE_X;
     for (ipad = 0; ipad < xpadded_size; ipad++)
     {
       is =
-        (tap0 * (*srcImgA++ + *srcImgD++) +
-        tap1 *  (*srcImgB++ + *srcImgE++) +
-        tap2 *  (*srcImgC++ + *srcImgF++));
+        (tap0 * (srcImgA[ipad] + srcImgD[ipad]) +
+        tap1 *  (srcImgB[ipad] + srcImgE[ipad]) +
+        tap2 *  (srcImgC[ipad] + srcImgF[ipad]));
 
-      wxLineDst[ipad] = (imgpel) iClip1 ( p_Vid->max_imgpel_value, rshift_rnd_sf( is, 10 ) );
+      wxLineDst[ipad] = (imgpel) iClip1 ( max_imgpel_value, rshift_rnd_sf( is, 10 ) );
     }
   }
 }
@@ -435,17 +266,20 @@ static void getVerSubImageSixTapTmp( VideoParameters *p_Vid, StorablePicture *s,
  *    source left image
  * \param srcImgR
  *    source right image 
+ * \param jstart
+ *    first padded row
+ * \param jend
+ *    last padded row + 1
  ************************************************************************
  */
-static void getSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel **srcImgL, imgpel **srcImgR)
+static void getSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel **srcImgL, imgpel **srcImgR, int jstart, int jend)
 {
   int jpad, ipad;
-  int ypadded_size = s->size_y_padded;
   int xpadded_size = s->size_x_padded;
 
   imgpel *wBufSrcL, *wBufSrcR, *wBufDst;
 
-  for (jpad = -IMG_PAD_SIZE_Y; jpad < ypadded_size-IMG_PAD_SIZE_Y; jpad++)
+  for (jpad = jstart; jpad < jend; jpad++)
   {
     wBufSrcL = srcImgL[jpad]-IMG_PAD_SIZE_X; 
     wBufSrcR = srcImgR[jpad]-IMG_PAD_SIZE_X; 
@@ -453,7 +287,7 @@ static void getSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel **s
 
     for (ipad = 0; ipad < xpadded_size; ipad++)
     {
-      *wBufDst++ = (imgpel) rshift_rnd_sf( *wBufSrcL++ + *wBufSrcR++, 1 );
+      wBufDst[ipad] = (imgpel) rshift_rnd_sf( wBufSrcL[ipad] + wBufSrcR[ipad], 1 );
     }
   }
 }
@@ -472,17 +306,20 @@ static void getSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel **s
  *    source left image
  * \param srcImgR
  *    source right image 
+ * \param jstart
+ *    first padded row
+ * \param jend
+ *    last padded row + 1
  ************************************************************************
  */
-static void getHorSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel **srcImgL, imgpel **srcImgR)
+static void getHorSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel **srcImgL, imgpel **srcImgR, int jstart, int jend)
 {
   int jpad, ipad;
-  int ypadded_size = s->size_y_padded;
   int xpadded_size = s->size_x_padded - 1;
 
   imgpel *wBufSrcL, *wBufSrcR, *wBufDst;
 
-  for (jpad = -IMG_PAD_SIZE_Y; jpad < ypadded_size-IMG_PAD_SIZE_Y; jpad++)
+  for (jpad = jstart; jpad < jend; jpad++)
   {
     wBufSrcL = srcImgL[jpad]-IMG_PAD_SIZE_X; 
     wBufSrcR = &srcImgR[jpad][1-IMG_PAD_SIZE_X]; 
@@ -491,10 +328,10 @@ static void getHorSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel
     // left padded area + center
     for (ipad = 0; ipad < xpadded_size; ipad++)
     {
-      *wBufDst++ = (imgpel) rshift_rnd_sf( *wBufSrcL++ + *wBufSrcR++, 1 );
+      wBufDst[ipad] = (imgpel) rshift_rnd_sf( wBufSrcL[ipad] + wBufSrcR[ipad], 1 );
     }
     // right padded area
-      *wBufDst++ = (imgpel) rshift_rnd_sf( *wBufSrcL++ + wBufSrcR[-1], 1 );
+    wBufDst[xpadded_size] = (imgpel) rshift_rnd_sf( wBufSrcL[xpadded_size] + wBufSrcR[xpadded_size - 1], 1 );
   }
 }
 
@@ -512,37 +349,32 @@ static void getHorSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel
  *    source top image
  * \param srcImgB
  *    source bottom image 
+ * \param jstart
+ *    first padded row
+ * \param jend
+ *    last padded row + 1
  ************************************************************************
  */
-static void getVerSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel **srcImgT, imgpel **srcImgB)
+static void getVerSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel **srcImgT, imgpel **srcImgB, int jstart, int jend)
 {
   int jpad, ipad;
-  int ypadded_size = s->size_y_padded - 1;
+  int maxy = s->size_y_padded - 1-IMG_PAD_SIZE_Y;
   int xpadded_size = s->size_x_padded;  
 
   imgpel *wBufSrcT, *wBufSrcB, *wBufDst;
 
-  // top
-  for (jpad = -IMG_PAD_SIZE_Y; jpad < ypadded_size-IMG_PAD_SIZE_Y; jpad++)
+  for (jpad = jstart; jpad < jend; jpad++)
   {
     wBufSrcT = srcImgT[jpad]-IMG_PAD_SIZE_X;           
     wBufDst  = dstImg[jpad]-IMG_PAD_SIZE_X;            
-    wBufSrcB = srcImgB[jpad + 1]-IMG_PAD_SIZE_X;  
+    // the bottom row is averaged with itself
+    wBufSrcB = srcImgB[imin(maxy, jpad + 1)]-IMG_PAD_SIZE_X;  
 
     for (ipad = 0; ipad < xpadded_size; ipad++)
     {
-      *wBufDst++ = (imgpel) rshift_rnd_sf(*wBufSrcT++ + *wBufSrcB++, 1);
+      wBufDst[ipad] = (imgpel) rshift_rnd_sf(wBufSrcT[ipad] + wBufSrcB[ipad], 1);
     }
   }
-  // bottom
-  wBufSrcT = srcImgT[ypadded_size-IMG_PAD_SIZE_Y]-IMG_PAD_SIZE_X;           
-  wBufDst  = dstImg[ypadded_size-IMG_PAD_SIZE_Y]-IMG_PAD_SIZE_X;            
-  wBufSrcB = srcImgB[ypadded_size-IMG_PAD_SIZE_Y]-IMG_PAD_SIZE_X;           
-
-  for (ipad = 0; ipad < xpadded_size; ipad++)
-  {
-    *wBufDst++ = (imgpel) rshift_rnd_sf(*wBufSrcT++ + *wBufSrcB++, 1);
-  }
 }
 
 
@@ -559,40 +391,34 @@ static void getVerSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel
  *    source top/left image
  * \param srcImgB
  *    source bottom/right image 
+ * \param jstart
+ *    first padded row
+ * \param jend
+ *    last padded row + 1
  ************************************************************************
  */
-static void getDiagSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel **srcImgT, imgpel **srcImgB )
+static void getDiagSubImageBiLinear( StorablePicture *s, imgpel **dstImg, imgpel **srcImgT, imgpel **srcImgB, int jstart, int jend)
 {
   int jpad, ipad;
-  int maxx = s->size_x_padded - 1-IMG_PAD_SIZE_X;
+  int maxx = s->size_x_padded - 1;
   int maxy = s->size_y_padded - 1-IMG_PAD_SIZE_Y;
 
   imgpel *wBufSrcL, *wBufSrcR, *wBufDst;
 
-  for (jpad = -IMG_PAD_SIZE_Y; jpad < maxy; jpad++)
+  for (jpad = jstart; jpad < jend; jpad++)
   {
-    wBufSrcL = srcImgT[jpad + 1]-IMG_PAD_SIZE_X; 
+    // the bottom row is averaged with itself
+    wBufSrcL = srcImgT[imin(maxy, jpad + 1)]-IMG_PAD_SIZE_X; 
     wBufSrcR = &srcImgB[jpad][1-IMG_PAD_SIZE_X]; 
     wBufDst  = dstImg[jpad]-IMG_PAD_SIZE_X;      
 
-    for (ipad = -IMG_PAD_SIZE_X; ipad < maxx; ipad++)
+    for (ipad = 0; ipad < maxx; ipad++)
     {
-      *wBufDst++ = (imgpel) rshift_rnd_sf(*wBufSrcL++ + *wBufSrcR++, 1);
+      wBufDst[ipad] = (imgpel) rshift_rnd_sf(wBufSrcL[ipad] + wBufSrcR[ipad], 1);
     }
 
-    *wBufDst++ = (imgpel) rshift_rnd_sf(*wBufSrcL++ +  wBufSrcR[-1], 1);
+    wBufDst[maxx] = (imgpel) rshift_rnd_sf(wBufSrcL[maxx] + wBufSrcR[maxx - 1], 1);
   }
-
-  wBufSrcL = srcImgT[maxy]-IMG_PAD_SIZE_X;     
-  wBufSrcR = &srcImgB[maxy][1-IMG_PAD_SIZE_X]; 
-  wBufDst = dstImg[maxy]-IMG_PAD_SIZE_X;       
-
-  for (ipad = -IMG_PAD_SIZE_X; ipad < maxx; ipad++)
-  {
-    *wBufDst++ = (imgpel) rshift_rnd_sf(*wBufSrcL++ + *wBufSrcR++, 1);
-  }
-
-    *wBufDst++ = (imgpel) rshift_rnd_sf(*wBufSrcL++ + wBufSrcR[-1], 1);
 }
 
 /*!
@@ -612,69 +438,99 @@ void getSubImagesLuma( VideoParameters *p_Vid, StorablePicture *s )
 {
   imgpel ****cImgSub   = s->p_curr_img_sub;
   int        otf_shift = ( p_Vid->p_Inp->OnTheFlyFractMCP == OTF_L1 ) ? (1) : (0) ;
+  int        jlast     = s->size_y_padded - IMG_PAD_SIZE_Y;
+  int        num_bands = (s->size_y_padded + SUBPEL_BAND_SIZE - 1) / SUBPEL_BAND_SIZE;
+  int        band;
 
   //  0  1  2  3
   //  4  5  6  7
   //  8  9 10 11
   // 12 13 14 15
 
-  //// INTEGER PEL POSITIONS ////
+  // The picture is processed in bands of SUBPEL_BAND_SIZE padded rows. The
+  // vertical filters read up to three rows of the neighbouring bands, so every
+  // stage has to be finished for all bands before the next one starts.
 
-  // sub-image 0 [0][0]
-  // simply copy the integer pels
-  if (cImgSub[0][0][0] != s->p_curr_img[0])
-  {
-    getSubImageInteger( s, cImgSub[0][0], s->p_curr_img);
-  }
-  else
+  // Stage 1: integer samples and horizontal half-pel positions, row local
+#if defined(OPENMP)
+#pragma omp parallel for
+#endif
+  for (band = 0; band < num_bands; band++)
   {
-    getSubImageInteger_s( s, cImgSub[0][0], s->p_curr_img);
-  }
+    int jstart = band * SUBPEL_BAND_SIZE - IMG_PAD_SIZE_Y;
+    int jend   = imin(jstart + SUBPEL_BAND_SIZE, jlast);
 
-  //// HALF-PEL POSITIONS: SIX-TAP FILTER ////
+    //// INTEGER PEL POSITIONS ////
 
-  // sub-image 2 [0][2]
-  // HOR interpolate (six-tap) sub-image [0][0]
-  getHorSubImageSixTap( p_Vid, s, cImgSub[0][2>>otf_shift], cImgSub[0][0] );
+    // sub-image 0 [0][0]
+    // simply copy the integer pels
+    getSubImageInteger( s, cImgSub[0][0], s->p_curr_img, jstart, jend);
 
-  // sub-image 8 [2][0]
-  // VER interpolate (six-tap) sub-image [0][0]
-  getVerSubImageSixTap( p_Vid, s, cImgSub[2>>otf_shift][0], cImgSub[0][0]);
+    //// HALF-PEL POSITIONS: SIX-TAP FILTER ////
 
-  // sub-image 10 [2][2]
-  // VER interpolate (six-tap) sub-image [0][2]
-  getVerSubImageSixTapTmp( p_Vid, s, cImgSub[2>>otf_shift][2>>otf_shift]);
+    // sub-image 2 [0][2]
+    // HOR interpolate (six-tap) sub-image [0][0]
+    getHorSubImageSixTap( p_Vid, s, cImgSub[0][2>>otf_shift], cImgSub[0][0], jstart, jend);
+  }
+
+  // Stage 2: vertical half-pel positions
+#if defined(OPENMP)
+#pragma omp parallel for
+#endif
+  for (band = 0; band < num_bands; band++)
+  {
+    int jstart = band * SUBPEL_BAND_SIZE - IMG_PAD_SIZE_Y;
+    int jend   = imin(jstart + SUBPEL_BAND_SIZE, jlast);
+
+    // sub-image 8 [2][0]
+    // VER interpolate (six-tap) sub-image [0][0]
+    getVerSubImageSixTap( p_Vid, s, cImgSub[2>>otf_shift][0], cImgSub[0][0], jstart, jend);
+
+    // sub-image 10 [2][2]
+    // VER interpolate (six-tap) sub-image [0][2]
+    getVerSubImageSixTapTmp( p_Vid, s, cImgSub[2>>otf_shift][2>>otf_shift], jstart, jend);
+  }
 
   if( !p_Vid->p_Inp->OnTheFlyFractMCP )
   {
-    //// QUARTER-PEL POSITIONS: BI-LINEAR INTERPOLATION ////
-
-    // sub-image 1 [0][1]
-    getSubImageBiLinear    ( s, cImgSub[0][1], cImgSub[0][0], cImgSub[0][2]);
-    // sub-image 4 [1][0]
-    getSubImageBiLinear    ( s, cImgSub[1][0], cImgSub[0][0], cImgSub[2][0]);
-    // sub-image 5 [1][1]
-    getSubImageBiLinear    ( s, cImgSub[1][1], cImgSub[0][2], cImgSub[2][0]);
-    // sub-image 6 [1][2]
-    getSubImageBiLinear    ( s, cImgSub[1][2], cImgSub[0][2], cImgSub[2][2]);
-    // sub-image 9 [2][1]
-    getSubImageBiLinear    ( s, cImgSub[2][1], cImgSub[2][0], cImgSub[2][2]);
-
-    // sub-image 3  [0][3]
-    getHorSubImageBiLinear ( s, cImgSub[0][3], cImgSub[0][2], cImgSub[0][0]);
-    // sub-image 7  [1][3]
-    getHorSubImageBiLinear ( s, cImgSub[1][3], cImgSub[0][2], cImgSub[2][0]);
-    // sub-image 11 [2][3]
-    getHorSubImageBiLinear ( s, cImgSub[2][3], cImgSub[2][2], cImgSub[2][0]);
-
-    // sub-image 12 [3][0]
-    getVerSubImageBiLinear ( s, cImgSub[3][0], cImgSub[2][0], cImgSub[0][0]);
-    // sub-image 13 [3][1]
-    getVerSubImageBiLinear ( s, cImgSub[3][1], cImgSub[2][0], cImgSub[0][2]);
-    // sub-image 14 [3][2]
-    getVerSubImageBiLinear ( s, cImgSub[3][2], cImgSub[2][2], cImgSub[0][2]);
-
-    // sub-image 15 [3][3]
-    getDiagSubImageBiLinear( s, cImgSub[3][3], cImgSub[0][2], cImgSub[2][0]);
+    // Stage 3: quarter-pel positions
+#if defined(OPENMP)
+#pragma omp parallel for
+#endif
+    for (band = 0; band < num_bands; band++)
+    {
+      int jstart = band * SUBPEL_BAND_SIZE - IMG_PAD_SIZE_Y;
+      int jend   = imin(jstart + SUBPEL_BAND_SIZE, jlast);
+
+      //// QUARTER-PEL POSITIONS: BI-LINEAR INTERPOLATION ////
+
+      // sub-image 1 [0][1]
+      getSubImageBiLinear    ( s, cImgSub[0][1], cImgSub[0][0], cImgSub[0][2], jstart, jend);
+      // sub-image 4 [1][0]
+      getSubImageBiLinear    ( s, cImgSub[1][0], cImgSub[0][0], cImgSub[2][0], jstart, jend);
+      // sub-image 5 [1][1]
+      getSubImageBiLinear    ( s, cImgSub[1][1], cImgSub[0][2], cImgSub[2][0], jstart, jend);
+      // sub-image 6 [1][2]
+      getSubImageBiLinear    ( s, cImgSub[1][2], cImgSub[0][2], cImgSub[2][2], jstart, jend);
+      // sub-image 9 [2][1]
+      getSubImageBiLinear    ( s, cImgSub[2][1], cImgSub[2][0], cImgSub[2][2], jstart, jend);
+
+      // sub-image 3  [0][3]
+      getHorSubImageBiLinear ( s, cImgSub[0][3], cImgSub[0][2], cImgSub[0][0], jstart, jend);
+      // sub-image 7  [1][3]
+      getHorSubImageBiLinear ( s, cImgSub[1][3], cImgSub[0][2], cImgSub[2][0], jstart, jend);
+      // sub-image 11 [2][3]
+      getHorSubImageBiLinear ( s, cImgSub[2][3], cImgSub[2][2], cImgSub[2][0], jstart, jend);
+
+      // sub-image 12 [3][0]
+      getVerSubImageBiLinear ( s, cImgSub[3][0], cImgSub[2][0], cImgSub[0][0], jstart, jend);
+      // sub-image 13 [3][1]
+      getVerSubImageBiLinear ( s, cImgSub[3][1], cImgSub[2][0], cImgSub[0][2], jstart, jend);
+      // sub-image 14 [3][2]
+      getVerSubImageBiLinear ( s, cImgSub[3][2], cImgSub[2][2], cImgSub[0][2], jstart, jend);
+
+      // sub-image 15 [3][3]
+      getDiagSubImageBiLinear( s, cImgSub[3][3], cImgSub[0][2], cImgSub[2][0], jstart, jend);
+    }
   }
 }
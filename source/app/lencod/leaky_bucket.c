@@ -14,6 +14,7 @@
 
 #include "contributors.h"
 #include "global.h"
+#include "leaky_bucket.h"
 
 #ifdef _LEAKYBUCKET_
 
@@ -180,6 +181,245 @@ void Sort(unsigned long NumberLeakyBuckets, unsigned long *Rmin)
   }
 }
 
+/*!
+ ***********************************************************************
+ * \brief
+ *    Sets the bucket rates in bits/picture and empties the buckets.
+ ***********************************************************************
+ */
+static void start_buckets(LeakyBuckets *p_Lb, double framerate)
+{
+  unsigned long iBucket;
+
+  for(iBucket = 0; iBucket < p_Lb->NumberLeakyBuckets; iBucket++)
+  {
+    p_Lb->channel_rate[iBucket] = (long) (p_Lb->Rmin[iBucket] / framerate); /* converts bits/second to bits/frame */
+    p_Lb->Bmin[iBucket]      = 0;
+    p_Lb->Fmin[iBucket]      = 0;
+    p_Lb->deficit[iBucket]   = 0;
+    p_Lb->drain[iBucket]     = 0;
+    p_Lb->underflow[iBucket] = 0;
+    p_Lb->overflow[iBucket]  = 0;
+  }
+  p_Lb->total_bits   = 0;
+  p_Lb->total_frames = 0;
+  p_Lb->rates_known  = 1;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Adds one coded picture to all buckets.
+ * \para Notes
+ *    A bucket of size Bmin that starts full loses the bits of each
+ *    picture and is refilled with the channel rate up to Bmin, so Bmin
+ *    is the largest deficit of the bucket. With the initial fullness
+ *    Fmin the bucket must hold the bits of each picture on top of the
+ *    bits drained before it; once the refill is limited by the bucket
+ *    size the deficit condition covers the later pictures. Both are
+ *    running maxima, no picture sizes are kept.
+ ***********************************************************************
+ */
+static void add_picture(LeakyBuckets *p_Lb, long bits)
+{
+  unsigned long iBucket;
+
+  for(iBucket = 0; iBucket < p_Lb->NumberLeakyBuckets; iBucket++)
+  {
+    int64 deficit  = p_Lb->deficit[iBucket] + bits;
+    int64 fullness = p_Lb->drain[iBucket] + bits;
+    int underflow  = 0;
+
+    if (deficit > p_Lb->Bmin[iBucket])
+    {
+      p_Lb->Bmin[iBucket] = deficit;
+      underflow = 1;
+    }
+    if (fullness > p_Lb->Fmin[iBucket])
+    {
+      p_Lb->Fmin[iBucket] = fullness;
+      underflow = 1;
+    }
+    if (underflow && p_Lb->total_frames > 0)
+      p_Lb->underflow[iBucket]++;
+
+    deficit -= p_Lb->channel_rate[iBucket];
+    if (deficit < 0)
+    {
+      // a constant rate channel would overflow the bucket
+      deficit = 0;
+      p_Lb->overflow[iBucket]++;
+    }
+    p_Lb->deficit[iBucket] = deficit;
+    p_Lb->drain[iBucket]  += bits - p_Lb->channel_rate[iBucket];
+  }
+  p_Lb->total_bits += bits;
+  p_Lb->total_frames++;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Derives the default bucket rates from the average rate of the
+ *    buffered pictures and adds these pictures to the buckets.
+ ***********************************************************************
+ */
+static void set_default_rates(VideoParameters *p_Vid, LeakyBuckets *p_Lb)
+{
+  unsigned long AvgRate = 0, TotalRate = 0, iBucket;
+  int i;
+
+  for(i = 0; i < p_Lb->num_first_bits; i++)
+  {
+    TotalRate += (unsigned long) p_Lb->first_bits[i];
+  }
+  if (p_Lb->num_first_bits > 0)
+    AvgRate = (unsigned long) ((float) TotalRate / p_Lb->num_first_bits);
+
+  for(iBucket=0; iBucket < p_Lb->NumberLeakyBuckets; iBucket++)
+  {
+    if(iBucket == 0)
+      p_Lb->Rmin[iBucket] = (unsigned long)((float) AvgRate * p_Vid->framerate); /* convert bits/frame to bits/second */
+    else
+      p_Lb->Rmin[iBucket] = (unsigned long) ((float) p_Lb->Rmin[iBucket-1] + (AvgRate/4) * (p_Vid->framerate));
+  }
+  Sort(p_Lb->NumberLeakyBuckets, p_Lb->Rmin);
+  start_buckets(p_Lb, p_Vid->framerate);
+
+  for(i = 0; i < p_Lb->num_first_bits; i++)
+  {
+    add_picture(p_Lb, p_Lb->first_bits[i]);
+  }
+  free_pointer(p_Lb->first_bits);
+  p_Lb->first_bits = NULL;
+  p_Lb->num_first_bits = 0;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Allocates the leaky bucket model. The rates are read from the
+ *    LeakyBucketRateFile; without it they are derived from the average
+ *    rate of the sequence, or of the first second with
+ *    LeakyBucketOnlineRates. The pictures are buffered until then.
+ ***********************************************************************
+ */
+void init_leaky_buckets(VideoParameters *p_Vid, InputParameters *p_Inp)
+{
+  LeakyBuckets *p_Lb;
+  unsigned long NumberLeakyBuckets = (unsigned long) p_Inp->NumberLeakyBuckets;
+
+  if ((p_Lb = (LeakyBuckets *) calloc(1, sizeof(LeakyBuckets))) == NULL)
+    no_mem_exit("init_leaky_buckets: p_Lb");
+  p_Lb->NumberLeakyBuckets = NumberLeakyBuckets;
+
+  if ((p_Lb->Rmin = calloc(NumberLeakyBuckets, sizeof(unsigned long))) == NULL)
+    no_mem_exit("init_leaky_buckets: Rmin");
+  if ((p_Lb->channel_rate = calloc(NumberLeakyBuckets, sizeof(long))) == NULL)
+    no_mem_exit("init_leaky_buckets: channel_rate");
+  if ((p_Lb->Bmin = calloc(NumberLeakyBuckets, sizeof(int64))) == NULL)
+    no_mem_exit("init_leaky_buckets: Bmin");
+  if ((p_Lb->Fmin = calloc(NumberLeakyBuckets, sizeof(int64))) == NULL)
+    no_mem_exit("init_leaky_buckets: Fmin");
+  if ((p_Lb->deficit = calloc(NumberLeakyBuckets, sizeof(int64))) == NULL)
+    no_mem_exit("init_leaky_buckets: deficit");
+  if ((p_Lb->drain = calloc(NumberLeakyBuckets, sizeof(int64))) == NULL)
+    no_mem_exit("init_leaky_buckets: drain");
+  if ((p_Lb->underflow = calloc(NumberLeakyBuckets, sizeof(unsigned long))) == NULL)
+    no_mem_exit("init_leaky_buckets: underflow");
+  if ((p_Lb->overflow = calloc(NumberLeakyBuckets, sizeof(unsigned long))) == NULL)
+    no_mem_exit("init_leaky_buckets: overflow");
+
+  if(1 == get_LeakyBucketRate(p_Inp, NumberLeakyBuckets, p_Lb->Rmin))
+  {
+    Sort(NumberLeakyBuckets, p_Lb->Rmin);
+    start_buckets(p_Lb, p_Vid->framerate);
+  }
+  else
+  { /* if rate file is not present, use default calculated from avg.rate */
+    p_Lb->online_rates = p_Inp->LeakyBucketOnlineRates;
+    if (p_Lb->online_rates)
+      p_Lb->size_first_bits = imax(1, (int) (p_Vid->framerate + 0.5));
+    else
+      p_Lb->size_first_bits = (p_Inp->no_frames + 1) * p_Vid->num_of_layers;
+    if ((p_Lb->first_bits = calloc(p_Lb->size_first_bits, sizeof(long))) == NULL)
+      no_mem_exit("init_leaky_buckets: first_bits");
+  }
+  p_Vid->p_LeakyBuckets = p_Lb;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Updates the buckets with the bits of the picture just coded.
+ ***********************************************************************
+ */
+void update_leaky_buckets(VideoParameters *p_Vid, long bits)
+{
+  LeakyBuckets *p_Lb = p_Vid->p_LeakyBuckets;
+
+  if (!p_Lb->rates_known)
+  {
+    if (p_Lb->num_first_bits == p_Lb->size_first_bits)
+    {
+      p_Lb->size_first_bits <<= 1;
+      if ((p_Lb->first_bits = realloc(p_Lb->first_bits, p_Lb->size_first_bits * sizeof(long))) == NULL)
+        no_mem_exit("update_leaky_buckets: first_bits");
+    }
+    p_Lb->first_bits[p_Lb->num_first_bits++] = bits;
+    if (p_Lb->online_rates && p_Lb->num_first_bits == p_Lb->size_first_bits)
+      set_default_rates(p_Vid, p_Lb);
+    return;
+  }
+  add_picture(p_Lb, bits);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Returns the parameters of one bucket for the pictures coded so
+ *    far. Before the default rates are known all values are zero.
+ ***********************************************************************
+ */
+void get_leaky_bucket(VideoParameters *p_Vid, unsigned long iBucket, unsigned long *R, unsigned long *B, unsigned long *F)
+{
+  LeakyBuckets *p_Lb = p_Vid->p_LeakyBuckets;
+
+  if (!p_Lb->rates_known || iBucket >= p_Lb->NumberLeakyBuckets)
+  {
+    *R = *B = *F = 0;
+    return;
+  }
+  *R = p_Lb->Rmin[iBucket];
+  *B = (unsigned long) p_Lb->Bmin[iBucket];
+  *F = (unsigned long) p_Lb->Fmin[iBucket];
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Frees the leaky bucket model.
+ ***********************************************************************
+ */
+void free_leaky_buckets(VideoParameters *p_Vid)
+{
+  LeakyBuckets *p_Lb = p_Vid->p_LeakyBuckets;
+
+  if (p_Lb == NULL)
+    return;
+  free_pointer(p_Lb->Rmin);
+  free_pointer(p_Lb->channel_rate);
+  free_pointer(p_Lb->Bmin);
+  free_pointer(p_Lb->Fmin);
+  free_pointer(p_Lb->deficit);
+  free_pointer(p_Lb->drain);
+  free_pointer(p_Lb->underflow);
+  free_pointer(p_Lb->overflow);
+  free_pointer(p_Lb->first_bits);
+  free_pointer(p_Lb);
+  p_Vid->p_LeakyBuckets = NULL;
+}
+
 /*!
  ***********************************************************************
  * \brief
@@ -197,11 +437,10 @@ void Sort(unsigned long NumberLeakyBuckets, unsigned long *Rmin)
 
 void calc_buffer(VideoParameters *p_Vid, InputParameters *p_Inp)
 {
-  unsigned long AvgRate, TotalRate, NumberLeakyBuckets;
-  long *buffer_frame, minB;
-  unsigned long iBucket, iFrame,  FrameIndex = 0;
-  long maxBuffer, actualBuffer, InitFullness, iChannelRate;
-  unsigned long *Rmin, *Bmin, *Fmin;
+  LeakyBuckets *p_Lb = p_Vid->p_LeakyBuckets;
+  unsigned long NumberLeakyBuckets = p_Lb->NumberLeakyBuckets;
+  unsigned long iBucket;
+  unsigned long *Bmin, *Fmin;
 
   switch (p_Inp->Verbose)
   {
@@ -219,14 +458,11 @@ void calc_buffer(VideoParameters *p_Vid, InputParameters *p_Inp)
       fprintf(stdout,"\n-------------------------------------------------------------------------------\n");
       break;
   }
-  printf(" Total Frames:  %ld \n", p_Vid->total_frame_buffer);
-  NumberLeakyBuckets = (unsigned long) p_Inp->NumberLeakyBuckets;
-  buffer_frame = calloc(p_Vid->total_frame_buffer + 1, sizeof(long));
-  if(!buffer_frame)
-    no_mem_exit("init_buffer: buffer_frame");
-  Rmin = calloc(NumberLeakyBuckets, sizeof(unsigned long));
-  if(!Rmin)
-    no_mem_exit("init_buffer: Rmin");
+  // default rates of the whole sequence, or of sequences shorter than a second
+  if (!p_Lb->rates_known)
+    set_default_rates(p_Vid, p_Lb);
+
+  printf(" Total Frames:  %ld \n", p_Lb->total_frames);
   Bmin = calloc(NumberLeakyBuckets, sizeof(unsigned long));
   if(!Bmin)
     no_mem_exit("init_buffer: Bmin");
@@ -234,81 +470,23 @@ void calc_buffer(VideoParameters *p_Vid, InputParameters *p_Inp)
   if(!Fmin)
     no_mem_exit("init_buffer: Fmin");
 
-  TotalRate = 0;
-  for(iFrame=0; iFrame < p_Vid->total_frame_buffer; iFrame++)
+  for(iBucket=0; iBucket< NumberLeakyBuckets; iBucket++)
   {
-    TotalRate += (unsigned long) p_Vid->Bit_Buffer[iFrame];
+    Bmin[iBucket] = (unsigned long) p_Lb->Bmin[iBucket];
+    Fmin[iBucket] = (unsigned long) p_Lb->Fmin[iBucket];
   }
-  AvgRate = (unsigned long) ((float) TotalRate/ p_Vid->total_frame_buffer);
 
-  if(1 != get_LeakyBucketRate(p_Inp, NumberLeakyBuckets, Rmin))
-  { /* if rate file is not present, use default calculated from avg.rate */
-    for(iBucket=0; iBucket < NumberLeakyBuckets; iBucket++)
-    {
-      if(iBucket == 0)
-        Rmin[iBucket] = (unsigned long)((float) AvgRate * p_Vid->framerate); /* convert bits/frame to bits/second */
-      else
-        Rmin[iBucket] = (unsigned long) ((float) Rmin[iBucket-1] + (AvgRate/4) * (p_Vid->framerate));
-    }
-  }
-  Sort(NumberLeakyBuckets, Rmin);
+  write_buffer(p_Inp, NumberLeakyBuckets, p_Lb->Rmin, Bmin, Fmin);
 
-  maxBuffer = AvgRate * 20; /* any initialization is good. */
-  for(iBucket=0; iBucket< NumberLeakyBuckets; iBucket++)
+  if (p_Inp->Verbose > 1)
   {
-    iChannelRate = (long) (Rmin[iBucket] / (p_Vid->framerate)); /* converts bits/second to bits/frame */
-    /* To calculate initial buffer size */
-    InitFullness = maxBuffer; /* set Initial Fullness to be buffer size */
-    buffer_frame[0] = InitFullness;
-    minB = maxBuffer;
-
-    for(iFrame=0; iFrame < p_Vid->total_frame_buffer ; iFrame++)
-    {
-      buffer_frame[iFrame] = buffer_frame[iFrame] - p_Vid->Bit_Buffer[iFrame];
-      if(buffer_frame[iFrame] < minB)
-      {
-        minB = buffer_frame[iFrame];
-        FrameIndex = iFrame;
-      }
-
-      if ( iFrame < p_Vid->total_frame_buffer )
-      {
-        buffer_frame[iFrame+1] = buffer_frame[iFrame] + iChannelRate;
-        if(buffer_frame[iFrame+1] > maxBuffer)
-          buffer_frame[iFrame+1] = maxBuffer;
-      }
-    }
-    actualBuffer = (maxBuffer - minB);
-
-    /* To calculate initial buffer Fullness */
-    InitFullness = p_Vid->Bit_Buffer[0];
-    buffer_frame[0] = InitFullness;
-    for(iFrame=0; iFrame < FrameIndex+1; iFrame++)
-    {
-      buffer_frame[iFrame] = buffer_frame[iFrame] - p_Vid->Bit_Buffer[iFrame];
-      if(buffer_frame[iFrame] < 0) 
-      {
-        InitFullness -= buffer_frame[iFrame];
-        buffer_frame[iFrame] = 0;
-      }
-      if ( iFrame < p_Vid->total_frame_buffer )
-      {
-        buffer_frame[iFrame+1] = buffer_frame[iFrame] + iChannelRate;
-        if(buffer_frame[iFrame+1] > actualBuffer)
-          break;
-      }
-    }
-    Bmin[iBucket] = (unsigned long) actualBuffer;
-    Fmin[iBucket] = (unsigned long) InitFullness;
+    printf("     Rmin underflow overflow \n");
+    for(iBucket=0; iBucket< NumberLeakyBuckets; iBucket++)
+      printf(" %8ld %8ld %8ld \n", p_Lb->Rmin[iBucket], p_Lb->underflow[iBucket], p_Lb->overflow[iBucket]);
   }
 
-  write_buffer(p_Inp, NumberLeakyBuckets, Rmin, Bmin, Fmin);
-
-  free_pointer(buffer_frame);
-  free_pointer(Rmin);
   free_pointer(Bmin);
   free_pointer(Fmin);
   return;
 }
 #endif
-
@@ -18,11 +18,36 @@
 
 /* Leaky Bucket Parameter Optimization */
 #ifdef _LEAKYBUCKET_
+//! online model of the leaky buckets, updated after each coded picture
+typedef struct leaky_buckets
+{
+  unsigned long  NumberLeakyBuckets;
+  unsigned long *Rmin;             //!< bucket rates in bits/second
+  long          *channel_rate;     //!< bucket rates in bits/picture
+  int64         *Bmin;             //!< minimum bucket size for the pictures coded so far
+  int64         *Fmin;             //!< minimum initial fullness for the pictures coded so far
+  int64         *deficit;          //!< bits missing in a bucket of size Bmin that started full
+  int64         *drain;            //!< bits removed minus bits delivered since the first picture
+  unsigned long *underflow;        //!< pictures that underflowed the Bmin/Fmin of the pictures before
+  unsigned long *overflow;         //!< pictures after which a constant rate channel overflowed Bmin
+  int            rates_known;      //!< Rmin is set, otherwise the pictures are buffered in first_bits
+  int            online_rates;     //!< the default rates are derived from the first second
+  long          *first_bits;       //!< bits of the pictures buffered for the default rates
+  int            num_first_bits;
+  int            size_first_bits;
+  int64          total_bits;
+  unsigned long  total_frames;
+} LeakyBuckets;
+
 extern int get_LeakyBucketRate(InputParameters *p_Inp, unsigned long NumberLeakyBuckets, unsigned long *Rmin);
 extern void PutBigDoubleWord  (unsigned long dw, FILE *fp);
 extern void write_buffer      (InputParameters *p_Inp, unsigned long NumberLeakyBuckets, unsigned long Rmin[], unsigned long Bmin[], unsigned long Fmin[]);
 extern void Sort              (unsigned long NumberLeakyBuckets, unsigned long *Rmin);
-extern void calc_buffer       (VideoParameters *p_Vid, InputParameters *p_Inp);
+extern void init_leaky_buckets  (VideoParameters *p_Vid, InputParameters *p_Inp);
+extern void update_leaky_buckets(VideoParameters *p_Vid, long bits);
+extern void get_leaky_bucket    (VideoParameters *p_Vid, unsigned long iBucket, unsigned long *R, unsigned long *B, unsigned long *F);
+extern void free_leaky_buckets  (VideoParameters *p_Vid);
+extern void calc_buffer         (VideoParameters *p_Vid, InputParameters *p_Inp);
 #endif
 
 #endif
@@ -100,7 +100,14 @@
 //#include "resize.h"
 #include "md_common.h"
 #include "macroblock.h"
+#include "mb_access.h"
 #include "get_block_otf.h"
+#include "enc_profile.h"
+#include "complexity.h"
+#include "field_analysis.h"
+#include "view_thread.h"
+#include "paff_thread.h"
+#include "h264encoder.h"
 
 #include "wp.h"
 
@@ -124,7 +131,11 @@ static void free_global_buffers (VideoParameters *p_Vid, InputParameters *p_Inp)
 static void free_img            (VideoParameters *p_Vid, InputParameters *p_Inp);
 static void free_params         (InputParameters *p_Inp);
 
+#ifndef H264ENCODER_LIB
 static void encode_sequence     (VideoParameters *p_Vid, InputParameters *p_Inp);
+#endif
+static void select_frame_to_code(VideoParameters *p_Vid, InputParameters *p_Inp, int curr_frame_to_code, int rate_control_enable);
+static void finish_sequence     (VideoParameters *p_Vid);
 
 
 static void generate_encode_parameters(VideoParameters *p_Vid);
@@ -188,6 +199,7 @@ static void alloc_video_params( VideoParameters **p_Vid)
   (*p_Vid)->f_rtp = NULL;
   (*p_Vid)->CurrentRTPTimestamp = 0;         
   (*p_Vid)->CurrentRTPSequenceNumber = 0;
+  (*p_Vid)->LastRTPTr = -1;
 }
 
 /*!
@@ -210,6 +222,24 @@ static void alloc_params( InputParameters **p_Inp )
 }
 
 
+/*!
+ ***********************************************************************
+ * \brief
+ *    Free the Video Parameters structure before the encoder has been
+ *    initialized
+ ***********************************************************************
+ */
+static void free_video_params(VideoParameters *p_Vid)
+{
+  free_pointer (p_Vid->p_SEI);
+  free_pointer (p_Vid->p_QScale);
+  free_pointer (p_Vid->p_Quant);
+  free_pointer (p_Vid->p_Dpb_layer[0]);
+  free_pointer (p_Vid->p_Stats);
+  free_pointer (p_Vid->p_Dist);
+  free_pointer (p_Vid);
+}
+
   /*!
  ***********************************************************************
  * \brief
@@ -240,6 +270,7 @@ static void free_encoder (EncoderParams *p_Enc)
   free_pointer( p_Enc );
 }
 
+#ifndef H264ENCODER_LIB   // the encoder library (h264encoder.h) has no main()
 /*!
  ***********************************************************************
  * \brief
@@ -277,6 +308,268 @@ int main(int argc, char **argv)
 
   return 0;
 }
+#endif
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Find the frame FrameNoInFile in the frames passed to the encoder
+ *    library (-1 finds an unused entry)
+ ***********************************************************************
+ */
+static MemoryFrame *get_memory_frame(VideoDataFile *input_file, int FrameNoInFile)
+{
+  int i;
+
+  for (i = 0; i < input_file->num_mem_frames; i++)
+  {
+    if (input_file->mem_frames[i].frame_no == FrameNoInFile)
+      return &input_file->mem_frames[i];
+  }
+  return NULL;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Copy a frame passed to the encoder library into the frame store
+ *    in the layout of a raw input file
+ ***********************************************************************
+ */
+static void store_memory_frame(InputParameters *p_Inp, const byte *planes[3], const int strides[3], int64 pts, int FrameNoInFile)
+{
+  VideoDataFile *input_file = &p_Inp->input_file1;
+  FrameFormat *source = &p_Inp->source;
+  int symbol_size_in_bytes = source->pic_unit_size_shift3;
+  MemoryFrame *frm = get_memory_frame(input_file, -1);
+  unsigned char *buf;
+  int pl, j;
+
+  if (frm == NULL)
+  {
+    int framesize_in_bytes = (source->size_cmp[0] + 2 * source->size_cmp[1]) * symbol_size_in_bytes;
+
+    if ((input_file->mem_frames = (MemoryFrame *) realloc(input_file->mem_frames, (input_file->num_mem_frames + 1) * sizeof(MemoryFrame))) == NULL)
+      no_mem_exit("store_memory_frame: input_file->mem_frames");
+    frm = &input_file->mem_frames[input_file->num_mem_frames++];
+    if ((frm->buf = (unsigned char *) malloc(framesize_in_bytes)) == NULL)
+      no_mem_exit("store_memory_frame: frm->buf");
+  }
+
+  frm->frame_no = FrameNoInFile;
+  frm->pts      = pts;
+
+  buf = frm->buf;
+  for (pl = 0; pl < 3; pl++)
+  {
+    int comp = (pl == 0) ? 0 : 1;
+    int width_in_bytes = source->width[comp] * symbol_size_in_bytes;
+
+    for (j = 0; j < source->height[comp]; j++)
+    {
+      memcpy(buf, planes[pl] + j * strides[pl], width_in_bytes);
+      buf += width_in_bytes;
+    }
+  }
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Encode the frames of the sequence that have been passed to the
+ *    encoder library. Stops at the first frame in coding order that
+ *    has not been passed yet.
+ ***********************************************************************
+ */
+static void encode_memory_frames(EncoderParams *p_Enc)
+{
+  VideoParameters *p_Vid = p_Enc->p_Vid;
+  InputParameters *p_Inp = p_Enc->p_Inp;
+  VideoDataFile *input_file = &p_Inp->input_file1;
+
+  // each frame of the sequence is selected once, FlushEncoder() may shorten the sequence
+  while (p_Enc->frames_done < p_Inp->no_frames)
+  {
+    if (!p_Enc->frame_selected)
+    {
+      select_frame_to_code(p_Vid, p_Inp, p_Enc->curr_frame_to_code, p_Inp->RCEnable);
+      p_Enc->frame_selected = 1;
+    }
+
+    if ( p_Vid->p_curr_frm_struct->frame_no < p_Inp->no_frames )
+    {
+      MemoryFrame *frm = get_memory_frame(input_file, (1 + p_Inp->frame_skip) * p_Vid->p_curr_frm_struct->frame_no);
+
+      if (frm == NULL)
+        return;
+
+      p_Vid->nalu_pts = frm->pts;
+      encode_current_frame(p_Vid, p_Inp, p_Enc->curr_frame_to_code);
+      frm->frame_no = -1;
+      p_Enc->frames_done++;
+    }
+
+    p_Enc->frame_selected = 0;
+    p_Enc->curr_frame_to_code++;
+  }
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Open an encoder
+ * \param ppEncoder
+ *    returns the encoder
+ * \param argc
+ *    number of command line arguments (as for lencod)
+ * \param argv
+ *    command line arguments (as for lencod)
+ * \param callback
+ *    receives the Annex B NAL units of the sequence
+ * \param opaque
+ *    passed to callback
+ * \return
+ *    ENC_OPEN_NOERR or ENC_INVALID_PARAM | ENC_ERRMASK
+ ***********************************************************************
+ */
+int OpenEncoder(EncoderParams **ppEncoder, int argc, char **argv, NaluCallback callback, void *opaque)
+{
+  InputParameters *p_Inp;
+  VideoParameters *p_Vid;
+
+  *ppEncoder = NULL;
+  if (callback == NULL)
+    return (ENC_INVALID_PARAM | ENC_ERRMASK);
+
+  init_time();
+  alloc_encoder(&p_Enc);
+  p_Inp = p_Enc->p_Inp;
+  p_Vid = p_Enc->p_Vid;
+
+  Configure (p_Vid, p_Inp, argc, argv);
+
+  if (p_Inp->num_of_views != 1 || p_Inp->enable_32_pulldown || p_Inp->input_file1.is_interleaved
+    || p_Inp->start_frame != 0 || p_Inp->of_mode != PAR_OF_ANNEXB)
+  {
+    printf("OpenEncoder: only single view Annex B encoding without 3:2 pulldown from frame 0 is supported\n");
+    free_video_params(p_Vid);
+    free_params (p_Inp);
+    free_encoder(p_Enc);
+    p_Enc = NULL;
+    return (ENC_INVALID_PARAM | ENC_ERRMASK);
+  }
+
+  // the frames are read from the frames passed with EncodeFrame()
+  p_Inp->input_file1.vdtype          = VIDEO_MEMORY;
+  p_Inp->input_file1.is_concatenated = 0;
+  p_Inp->input_file1.f_num           = -1;
+  p_Vid->nalu_callback = callback;
+  p_Vid->nalu_opaque   = opaque;
+
+  init_encoder(p_Vid, p_Inp);
+
+  *ppEncoder = p_Enc;
+  return ENC_OPEN_NOERR;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Pass the next frame of the sequence to the encoder. The NAL units
+ *    of the pictures that can be coded with it are handed to the
+ *    callback before the function returns.
+ * \return
+ *    ENC_SUCCEED, or ENC_EOS if the sequence is complete and the frame
+ *    is not coded
+ ***********************************************************************
+ */
+int EncodeFrame(EncoderParams *pEncoder, const byte *planes[3], const int strides[3], int64 pts)
+{
+  InputParameters *p_Inp;
+  int frm_no_in_file;
+
+  if (pEncoder == NULL || planes == NULL || strides == NULL)
+    return (ENC_INVALID_PARAM | ENC_ERRMASK);
+
+  p_Enc = pEncoder;
+  p_Inp = p_Enc->p_Inp;
+  frm_no_in_file = p_Enc->frames_pushed;
+
+  if (p_Enc->flushed || frm_no_in_file > (1 + p_Inp->frame_skip) * (p_Inp->no_frames - 1))
+    return ENC_EOS;
+
+  p_Enc->frames_pushed++;
+  // skipped frames (FrameSkip) are not coded
+  if (frm_no_in_file % (1 + p_Inp->frame_skip) == 0)
+  {
+    store_memory_frame(p_Inp, planes, strides, pts, frm_no_in_file);
+    encode_memory_frames(p_Enc);
+  }
+
+  return ENC_SUCCEED;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    End the sequence after the frames passed so far and code the
+ *    pictures still waiting for frames that follow in display order
+ ***********************************************************************
+ */
+int FlushEncoder(EncoderParams *pEncoder)
+{
+  InputParameters *p_Inp;
+
+  if (pEncoder == NULL)
+    return (ENC_INVALID_PARAM | ENC_ERRMASK);
+
+  p_Enc = pEncoder;
+  p_Inp = p_Enc->p_Inp;
+
+  if (p_Enc->flushed)
+    return ENC_GEN_NOERR;
+
+  p_Inp->no_frames = (p_Enc->frames_pushed + p_Inp->frame_skip) / (1 + p_Inp->frame_skip);
+  encode_memory_frames(p_Enc);
+  finish_sequence(p_Enc->p_Vid);
+  p_Enc->flushed = 1;
+
+  return ENC_GEN_NOERR;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Flush and close an encoder
+ ***********************************************************************
+ */
+int CloseEncoder(EncoderParams *pEncoder)
+{
+  VideoDataFile *input_file;
+  byte *nalu_buf;
+  int i;
+
+  if (pEncoder == NULL)
+    return ENC_CLOSE_NOERR;
+
+  FlushEncoder(pEncoder);
+
+  input_file = &p_Enc->p_Inp->input_file1;
+  nalu_buf = p_Enc->p_Vid->nalu_buf;
+  free_encoder_memory(p_Enc->p_Vid, p_Enc->p_Inp);
+  free_pointer(nalu_buf);
+
+  for (i = 0; i < input_file->num_mem_frames; i++)
+    free(input_file->mem_frames[i].buf);
+  free_pointer(input_file->mem_frames);
+  input_file->num_mem_frames = 0;
+
+  free_params (p_Enc->p_Inp);
+  free_encoder(p_Enc);
+  p_Enc = NULL;
+
+  return ENC_CLOSE_NOERR;
+}
 
 
 /*!
@@ -406,6 +699,15 @@ static void init_encoder(VideoParameters *p_Vid, InputParameters *p_Inp)
   p_Vid->cabac_encoding = 0;
   p_Vid->frame_statistic_start = 1;
 
+  if ((strcasecmp(p_Inp->ProfileFile, "\"\"")!=0) && (strlen(p_Inp->ProfileFile)>0))
+    p_Vid->enc_profile = init_enc_profile();
+
+  if (p_Inp->ComplexityControl)
+    p_Vid->p_Cplx = init_complexity_control(p_Inp);
+
+  if (p_Inp->FieldAnalysis && (p_Inp->PicInterlace == ADAPTIVE_CODING || p_Inp->MbInterlace == ADAPTIVE_CODING))
+    p_Vid->p_FA = init_field_analysis();
+
   if (p_Inp->Log2MaxFNumMinus4 == -1)
   {    
     p_Vid->log2_max_frame_num_minus4 = iClip3(0,12, (int) (CeilLog2(p_Inp->no_frames) - 4)); // hack for now...
@@ -555,15 +857,7 @@ static void init_encoder(VideoParameters *p_Vid, InputParameters *p_Inp)
 
 #ifdef _LEAKYBUCKET_
   p_Vid->initial_Bframes = 0;
-#if (MVC_EXTENSION_ENABLE)
-  if(p_Vid->num_of_layers == 2)
-    p_Vid->Bit_Buffer = (long *)malloc(((p_Inp->no_frames << 1) + 1) * sizeof(long));
-  else
-    p_Vid->Bit_Buffer = (long *)malloc((p_Inp->no_frames + 1) * sizeof(long));
-#else
-  p_Vid->Bit_Buffer = (long *)malloc((p_Inp->no_frames + 1) * sizeof(long));
-#endif
-  p_Vid->total_frame_buffer = 0;
+  init_leaky_buckets(p_Vid, p_Inp);
 #endif
 
   // Prepare hierarchical coding structures. 
@@ -654,7 +948,11 @@ static void init_encoder(VideoParameters *p_Vid, InputParameters *p_Inp)
 
   
   if(p_Inp->HMEEnable)
+  {
+    MemTag mem_tag = mem_set_tag(MEM_HME);
     InitHMEInfo(p_Vid, p_Inp); 
+    mem_set_tag(mem_tag);
+  }
   else
     p_Vid->pHMEInfo = NULL;
 
@@ -664,6 +962,12 @@ static void init_encoder(VideoParameters *p_Vid, InputParameters *p_Inp)
   {
     setup_dpb_layer(p_Vid->p_Dpb_layer[i], p_Vid, p_Inp);
   }
+
+#if (MVC_EXTENSION_ENABLE)
+  init_view_threads(p_Vid);
+#endif
+  init_paff_thread(p_Vid);
+  p_Vid->p_SlicePool = alloc_slice_pool();
 }
 
 void setup_coding_layer(VideoParameters *p_Vid)
@@ -880,150 +1184,203 @@ static void prepare_frame_params(VideoParameters *p_Vid, InputParameters *p_Inp,
 /*!
  ***********************************************************************
  * \brief
- *    Encode a sequence
+ *    Encode the frame selected by select_frame_to_code() (p_curr_frm_struct)
  ***********************************************************************
  */
-static void encode_sequence(VideoParameters *p_Vid, InputParameters *p_Inp)
+void encode_current_frame(VideoParameters *p_Vid, InputParameters *p_Inp, int curr_frame_to_code)
 {
-  int curr_frame_to_code;
-  int frames_to_code;
-  int frame_num_bak = 0, frame_coded;
-  int frm_struct_buffer;
-  SeqStructure *p_seq_struct = p_Vid->p_pred;
-  FrameUnitStruct *p_frm;
+  int frame_num_bak, frame_coded;
 
-#if (MVC_EXTENSION_ENABLE)
-  int tmp_rate_control_enable = p_Inp->RCEnable;
+  // Update frame_num counter
+  frame_num_bak = p_Vid->p_EncodePar[p_Vid->dpb_layer_id]->frame_num;
 
-  if ( p_Inp->num_of_views == 2 )
+  prepare_frame_params(p_Vid, p_Inp, curr_frame_to_code);
+
+  // redundant frame initialization and allocation
+  if (p_Inp->redundant_pic_flag)
   {
-    frames_to_code = p_Inp->no_frames << 1;
-    p_frm = p_seq_struct->p_frm_mvc;
-    frm_struct_buffer = p_seq_struct->num_frames_mvc;
+    init_redundant_frame(p_Vid, p_Inp);
+    set_redundant_frame(p_Vid, p_Inp);
   }
-  else
-#endif
+
+  frame_coded = encode_one_frame(p_Vid, p_Inp); // encode one frame;
+  if ( !frame_coded )
   {
-    frames_to_code = p_Inp->no_frames;
-    p_frm = p_seq_struct->p_frm;
-    frm_struct_buffer = p_Vid->frm_struct_buffer;
+    p_Vid->frame_num = p_Vid->p_CurrEncodePar->frame_num = frame_num_bak;
+    return;
   }
-  
-  for (curr_frame_to_code = 0; curr_frame_to_code < frames_to_code; curr_frame_to_code++)
-  {
-#if (MVC_EXTENSION_ENABLE)
-    if ( p_Inp->num_of_views == 2 )
-    {
-      if ( (curr_frame_to_code & 1) == 0 ) // call only for view_id 0
-      {
-        // determine whether to populate additional frames in the prediction structure
-        if ( (curr_frame_to_code >> 1) >= p_Vid->p_pred->pop_start_frame )
-        {
-          int start = p_seq_struct->pop_start_frame, end;
 
-          populate_frm_struct( p_Vid, p_Inp, p_seq_struct, p_Inp->FrmStructBufferLength, frames_to_code >> 1 );
-          end = p_seq_struct->pop_start_frame;
-          populate_frm_struct_mvc( p_Vid, p_Inp, p_seq_struct, start, end );
-        }
-      }
+  p_Vid->p_CurrEncodePar->last_ref_idc = p_Vid->nal_reference_idc ? 1 : 0;
 
-      p_Vid->curr_frm_idx = curr_frame_to_code;
-      p_Vid->p_curr_frm_struct = p_frm + ( p_Vid->curr_frm_idx % frm_struct_buffer ); // pointer to current frame structure
-      p_Vid->number = curr_frame_to_code;
+  // if key frame is encoded, encode one redundant frame
+  if (p_Inp->redundant_pic_flag && p_Vid->key_frame)
+  {
+    encode_one_redundant_frame(p_Vid, p_Inp);
+  }
 
-      p_Vid->view_id = p_Vid->p_curr_frm_struct->view_id;
-      set_dpb_layer_id(p_Vid, p_Vid->view_id);
-      if ( p_Vid->view_id == 1 )
-      {
-        p_Vid->curr_frm_idx = p_Vid->number = (curr_frame_to_code - 1) >> 1;
-        p_Vid->p_curr_frm_struct->qp = p_Vid->qp = iClip3( -p_Vid->bitdepth_luma_qp_scale, MAX_QP, p_Vid->AverageFrameQP + p_Inp->View1QPOffset );
-      }
-      else
-      {
-        p_Vid->curr_frm_idx = p_Vid->number = curr_frame_to_code >> 1;
-      }
-      if ( p_Vid->view_id == 1 && tmp_rate_control_enable )
-      {
-        p_Inp->RCEnable = 0;        
-      }
-      else
+  if (p_Inp->EnableOpenGOP && p_Vid->p_curr_frm_struct->random_access)
+  {
+    if (p_Inp->PicInterlace)
+    {
+      if (p_Vid->p_curr_frm_struct->p_top_fld_pic->p_Slice[0].type == I_SLICE && p_Vid->p_curr_frm_struct->random_access) //Currently encoder always codes top field as I
       {
-        p_Inp->RCEnable = tmp_rate_control_enable;
+        p_Vid->last_valid_reference = p_Vid->ThisPOC & (~( (signed int)1 ));
+        //printf("last valid ref: %d", p_Vid->last_valid_reference);
       }
     }
-    else
-#endif
+    else if (p_Vid->type == I_SLICE)
+    {
+      p_Vid->last_valid_reference = p_Vid->ThisPOC;
+      //printf("last valid ref: %d", p_Vid->last_valid_reference);
+    }
+  }
+
+  if (p_Inp->ReportFrameStats)
+  {
+    report_frame_statistic(p_Vid, p_Inp);
+  }
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Select the frame coded by step curr_frame_to_code of the sequence
+ *    (p_curr_frm_struct), populating the prediction structure as needed
+ ***********************************************************************
+ */
+static void select_frame_to_code(VideoParameters *p_Vid, InputParameters *p_Inp, int curr_frame_to_code, int rate_control_enable)
+{
+  int frames_to_code;
+  int frm_struct_buffer;
+  SeqStructure *p_seq_struct = p_Vid->p_pred;
+  FrameUnitStruct *p_frm;
+
+#if (MVC_EXTENSION_ENABLE)
+  if ( p_Inp->num_of_views == 2 )
+  {
+    frames_to_code = p_Inp->no_frames << 1;
+    p_frm = p_seq_struct->p_frm_mvc;
+    frm_struct_buffer = p_seq_struct->num_frames_mvc;
+
+    if ( (curr_frame_to_code & 1) == 0 ) // call only for view_id 0
     {
       // determine whether to populate additional frames in the prediction structure
-      if ( curr_frame_to_code >= p_Vid->p_pred->pop_start_frame )
+      if ( (curr_frame_to_code >> 1) >= p_Vid->p_pred->pop_start_frame )
       {
-        populate_frm_struct( p_Vid, p_Inp, p_seq_struct, p_Inp->FrmStructBufferLength, frames_to_code );
+        int start = p_seq_struct->pop_start_frame, end;
+
+        // the frame structures are reused, the pending view 1 picture may still use its own
+        view_threads_drain(p_Vid);
+        populate_frm_struct( p_Vid, p_Inp, p_seq_struct, p_Inp->FrmStructBufferLength, frames_to_code >> 1 );
+        end = p_seq_struct->pop_start_frame;
+        populate_frm_struct_mvc( p_Vid, p_Inp, p_seq_struct, start, end );
       }
+    }
+
     p_Vid->curr_frm_idx = curr_frame_to_code;
     p_Vid->p_curr_frm_struct = p_frm + ( p_Vid->curr_frm_idx % frm_struct_buffer ); // pointer to current frame structure
     p_Vid->number = curr_frame_to_code;
 
+    p_Vid->view_id = p_Vid->p_curr_frm_struct->view_id;
+    set_dpb_layer_id(p_Vid, p_Vid->view_id);
+    if ( p_Vid->view_id == 1 )
+    {
+      p_Vid->curr_frm_idx = p_Vid->number = (curr_frame_to_code - 1) >> 1;
+      p_Vid->p_curr_frm_struct->qp = p_Vid->qp = iClip3( -p_Vid->bitdepth_luma_qp_scale, MAX_QP, p_Vid->AverageFrameQP + p_Inp->View1QPOffset );
     }
-
-    if ( p_Vid->p_curr_frm_struct->frame_no >= p_Inp->no_frames )
+    else
     {
-      continue;
+      p_Vid->curr_frm_idx = p_Vid->number = curr_frame_to_code >> 1;
     }
-
-    // Update frame_num counter
-    frame_num_bak = p_Vid->p_EncodePar[p_Vid->dpb_layer_id]->frame_num;
-
-    prepare_frame_params(p_Vid, p_Inp, curr_frame_to_code);
-
-    // redundant frame initialization and allocation
-    if (p_Inp->redundant_pic_flag)
+    if ( p_Vid->view_id == 1 && rate_control_enable )
     {
-      init_redundant_frame(p_Vid, p_Inp);
-      set_redundant_frame(p_Vid, p_Inp);
+      p_Inp->RCEnable = 0;        
     }
-
-    frame_coded = encode_one_frame(p_Vid, p_Inp); // encode one frame;
-    if ( !frame_coded )
+    else if ( rate_control_enable )
     {
-      p_Vid->frame_num = p_Vid->p_CurrEncodePar->frame_num = frame_num_bak;
-      continue;
+      p_Inp->RCEnable = rate_control_enable;
     }
 
-    p_Vid->p_CurrEncodePar->last_ref_idc = p_Vid->nal_reference_idc ? 1 : 0;
+    // an IDR picture resets the frame_num of all layers
+    if ( p_Vid->view_id == 0 && p_Vid->p_curr_frm_struct->idr_flag )
+      view_threads_drain(p_Vid);
+  }
+  else
+#endif
+  {
+    frames_to_code = p_Inp->no_frames;
+    p_frm = p_seq_struct->p_frm;
+    frm_struct_buffer = p_Vid->frm_struct_buffer;
 
-    // if key frame is encoded, encode one redundant frame
-    if (p_Inp->redundant_pic_flag && p_Vid->key_frame)
+    // determine whether to populate additional frames in the prediction structure
+    if ( curr_frame_to_code >= p_Vid->p_pred->pop_start_frame )
     {
-      encode_one_redundant_frame(p_Vid, p_Inp);
+      populate_frm_struct( p_Vid, p_Inp, p_seq_struct, p_Inp->FrmStructBufferLength, frames_to_code );
     }
+    p_Vid->curr_frm_idx = curr_frame_to_code;
+    p_Vid->p_curr_frm_struct = p_frm + ( p_Vid->curr_frm_idx % frm_struct_buffer ); // pointer to current frame structure
+    p_Vid->number = curr_frame_to_code;
+  }
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    Complete the coding of the sequence
+ ***********************************************************************
+ */
+static void finish_sequence(VideoParameters *p_Vid)
+{
+#if (MVC_EXTENSION_ENABLE)
+  view_threads_drain(p_Vid);
+#endif
+
+#if EOS_OUTPUT
+  end_of_stream(p_Vid);
+#endif
+}
+
+#ifndef H264ENCODER_LIB
+/*!
+ ***********************************************************************
+ * \brief
+ *    Encode a sequence
+ ***********************************************************************
+ */
+static void encode_sequence(VideoParameters *p_Vid, InputParameters *p_Inp)
+{
+  int curr_frame_to_code;
+  int frames_to_code = p_Inp->no_frames;
+  int tmp_rate_control_enable = p_Inp->RCEnable;
 
-    if (p_Inp->EnableOpenGOP && p_Vid->p_curr_frm_struct->random_access)
+#if (MVC_EXTENSION_ENABLE)
+  if ( p_Inp->num_of_views == 2 )
+  {
+    frames_to_code <<= 1;
+  }
+#endif
+  
+  for (curr_frame_to_code = 0; curr_frame_to_code < frames_to_code; curr_frame_to_code++)
+  {
+    select_frame_to_code(p_Vid, p_Inp, curr_frame_to_code, tmp_rate_control_enable);
+
+    if ( p_Vid->p_curr_frm_struct->frame_no >= p_Inp->no_frames )
     {
-      if (p_Inp->PicInterlace)
-      {
-        if (p_Vid->p_curr_frm_struct->p_top_fld_pic->p_Slice[0].type == I_SLICE && p_Vid->p_curr_frm_struct->random_access) //Currently encoder always codes top field as I
-        {
-          p_Vid->last_valid_reference = p_Vid->ThisPOC & (~( (signed int)1 ));
-          //printf("last valid ref: %d", p_Vid->last_valid_reference);
-        }
-      }
-      else if (p_Vid->type == I_SLICE)
-      {
-        p_Vid->last_valid_reference = p_Vid->ThisPOC;
-        //printf("last valid ref: %d", p_Vid->last_valid_reference);
-      }
+      continue;
     }
 
-    if (p_Inp->ReportFrameStats)
+#if (MVC_EXTENSION_ENABLE)
+    if ( p_Vid->view_id == 1 && p_Vid->p_ViewThreads )
     {
-      report_frame_statistic(p_Vid, p_Inp);
+      view_threads_dispatch(p_Vid, curr_frame_to_code);
+      continue;
     }
+#endif
 
+    encode_current_frame(p_Vid, p_Inp, curr_frame_to_code);
   }
 
-#if EOS_OUTPUT
-  end_of_stream(p_Vid);
-#endif
+  finish_sequence(p_Vid);
 
 #if (MVC_EXTENSION_ENABLE)
   if(p_Inp->num_of_views == 2) //? it should use num_of_layers;
@@ -1032,6 +1389,7 @@ static void encode_sequence(VideoParameters *p_Vid, InputParameters *p_Inp)
   }
 #endif
 }
+#endif
 
 
 /*!
@@ -1043,6 +1401,10 @@ static void encode_sequence(VideoParameters *p_Vid, InputParameters *p_Inp)
 
 void free_encoder_memory(VideoParameters *p_Vid, InputParameters *p_Inp)
 {
+#if (MVC_EXTENSION_ENABLE)
+  free_view_threads(p_Vid);
+#endif
+  free_paff_thread(p_Vid);
   terminate_sequence(p_Vid, p_Inp);
   flush_dpb(p_Vid->p_Dpb_layer[0], &p_Inp->output);
   flush_dpb(p_Vid->p_Dpb_layer[1], &p_Inp->output);
@@ -1075,17 +1437,26 @@ void free_encoder_memory(VideoParameters *p_Vid, InputParameters *p_Inp)
   calc_buffer(p_Vid, p_Inp);
 #endif
 
+  if (p_Vid->p_Cplx)
+    close_complexity_control(p_Vid->p_Cplx, p_Inp);
+
   // report everything
   report(p_Vid, p_Inp, p_Vid->p_Stats);
+  if (p_Vid->enc_profile)
+    write_enc_profile(p_Vid, p_Vid->enc_profile, p_Inp->ProfileFile);
+  if ((strcasecmp(p_Inp->MemoryFile, "\"\"")!=0) && (strlen(p_Inp->MemoryFile)>0))
+    write_mem_usage(p_Inp->MemoryFile);
 
 #ifdef _LEAKYBUCKET_
-  free_pointer(p_Vid->Bit_Buffer);
+  free_leaky_buckets(p_Vid);
 #endif
   free_dpb(p_Vid->p_Dpb_layer[0]);
   free_dpb(p_Vid->p_Dpb_layer[1]);
   uninit_out_buffer(p_Vid);
 
   free_global_buffers(p_Vid, p_Inp);
+  free_slice_pool(p_Vid->p_SlicePool);
+  p_Vid->p_SlicePool = NULL;
 
   FreeParameterSets(p_Vid);
 
@@ -1482,6 +1853,9 @@ static void free_img (VideoParameters *p_Vid, InputParameters *p_Inp)
   p_Vid->p_Dpb_layer[0] = p_Vid->p_Dpb_layer[1] = NULL;
   free_pointer (p_Vid->p_Stats);
   free_pointer (p_Vid->p_Dist);
+  delete_enc_profile(p_Vid->enc_profile);
+  delete_complexity_control(p_Vid->p_Cplx);
+  delete_field_analysis(p_Vid->p_FA);
   //
   free_encode_parameters(p_Vid);
   free_pointer (p_Vid);
@@ -1731,6 +2105,9 @@ static int init_global_buffers(VideoParameters *p_Vid, InputParameters *p_Inp)
     p_Vid->PicPos[j].y = (short) (j / p_Vid->PicWidthInMbs);
   }
 
+  p_Vid->PicNeighbours = calloc(p_Vid->FrameSizeInMbs, sizeof(MbNeighbours));
+  init_mb_neighbours(p_Vid->PicNeighbours, p_Vid->PicWidthInMbs, p_Vid->FrameSizeInMbs);
+
 
   if (p_Inp->rdopt == 3)
   {
@@ -1764,6 +2141,8 @@ static int init_global_buffers(VideoParameters *p_Vid, InputParameters *p_Inp)
   // allocate and set memory relating to motion estimation
   if (!p_Inp->IntraProfile)
   {  
+    MemTag mem_tag = mem_set_tag(MEM_ME);
+
     if (p_Inp->SearchMode[0] == UM_HEX || p_Inp->SearchMode[1] == UM_HEX)
     {
       if ((p_Vid->p_UMHex = (UMHexStruct*)calloc(1, sizeof(UMHexStruct))) == NULL)
@@ -1780,8 +2159,10 @@ static int init_global_buffers(VideoParameters *p_Vid, InputParameters *p_Inp)
     }
     if (p_Inp->SearchMode[0] == EPZS || p_Inp->SearchMode[1] == EPZS)
     {
+      mem_set_tag(MEM_EPZS);
       memory_size += EPZSInit(p_Vid);
     }
+    mem_set_tag(mem_tag);
   }
 
   if (p_Inp->RCEnable)
@@ -1803,7 +2184,9 @@ static int init_global_buffers(VideoParameters *p_Vid, InputParameters *p_Inp)
 
   if( !(p_Inp->OnTheFlyFractMCP) || (p_Inp->OnTheFlyFractMCP==OTF_L1) ) // JLT : on-the-fly compatibility
   {
+    MemTag mem_tag = mem_set_tag(MEM_SUBPEL);
     memory_size += get_mem2Dint_pad (&p_Vid->imgY_sub_tmp, p_Vid->height, p_Vid->width, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
+    mem_set_tag(mem_tag);
   }
 
   //if ( p_Inp->ChromaMCBuffer )
@@ -1974,6 +2357,7 @@ static void free_global_buffers(VideoParameters *p_Vid, InputParameters *p_Inp)
   // free lookup memory which helps avoid divides with PicWidthInMbs
   //free_mem2Dshort(PicPos);
   free_pointer(p_Vid->PicPos);
+  free_pointer(p_Vid->PicNeighbours);
   // Free Qmatrices and offsets
   free_QMatrix(p_Vid->p_Quant);
   free_QOffsets(p_Vid->p_Quant, p_Inp);
@@ -2205,6 +2589,72 @@ void free_mem_DCcoeff (int*** cofDC)
   free_mem3Dint(cofDC);
 }
 
+/*!
+ ************************************************************************
+ * \brief
+ *    Allocate memory for the motion vectors of all block types of
+ *    dim0 lists and num_ref references -> mv[dim0][num_ref]. The
+ *    vectors of all lists are stored in one contiguous block.
+ ************************************************************************
+ */
+int get_mem_MBmv (MBMotionVectors **mv, int dim0, int num_ref)
+{
+  int i;
+
+  if ((mv[0] = (MBMotionVectors *) mem_calloc(dim0 * num_ref, sizeof(MBMotionVectors))) == NULL)
+    no_mem_exit("get_mem_MBmv: mv");
+
+  for (i = 1; i < dim0; i++)
+    mv[i] = mv[i - 1] + num_ref;
+
+  return dim0 * num_ref * sizeof(MBMotionVectors);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Free memory of motion vectors allocated with get_mem_MBmv()
+ ************************************************************************
+ */
+void free_mem_MBmv (MBMotionVectors **mv)
+{
+  mem_free(mv[0]);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Allocate memory for the motion costs of all block types of
+ *    dim0 lists and num_ref references -> cost[dim0][num_ref]. As
+ *    with get_mem_MBmv() the block type stays a direct index, so the
+ *    row of a reference covers every partition and not only the
+ *    enabled ones; the few unused entries keep the stride fixed.
+ ************************************************************************
+ */
+int get_mem_MBcost (MBMotionCosts **cost, int dim0, int num_ref)
+{
+  int i;
+
+  if ((cost[0] = (MBMotionCosts *) mem_calloc(dim0 * num_ref, sizeof(MBMotionCosts))) == NULL)
+    no_mem_exit("get_mem_MBcost: cost");
+
+  for (i = 1; i < dim0; i++)
+    cost[i] = cost[i - 1] + num_ref;
+
+  return dim0 * num_ref * sizeof(MBMotionCosts);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Free memory of motion costs allocated with get_mem_MBcost()
+ ************************************************************************
+ */
+void free_mem_MBcost (MBMotionCosts **cost)
+{
+  mem_free(cost[0]);
+}
+
 /*!
  ************************************************************************
  * \brief
@@ -1086,7 +1086,7 @@ void perform_mc(Macroblock* currMB, int decoder, ColorPlane pl, StorablePicture
     //===== Single List Prediction =====
     short ref_idx = mv_info[j4][i4].ref_idx[pred_dir];
     short ref_idx_wp = ref_idx;
-    MotionVector  **mv_array = currSlice->all_mv[pred_dir][ref_idx][l0_mode];
+    MotionVector  (*mv_array)[BLOCK_MULTIPLE] = currSlice->all_mv[pred_dir][ref_idx][l0_mode];
     StorablePicture **list = currSlice->listX[currMB->list_offset + pred_dir];
 
     vec1_x = i4 * mv_mul + mv_array[j][i].mv_x;
@@ -1147,8 +1147,8 @@ void perform_mc(Macroblock* currMB, int decoder, ColorPlane pl, StorablePicture
     short l0_ref = mv_info[j4][i4].ref_idx[LIST_0];
     short l1_ref = mv_info[j4][i4].ref_idx[LIST_1];
 
-    MotionVector **l0_mv_array = (bipred_me ? currSlice->bipred_mv[bipred_me-1][LIST_0][l0_ref][l0_mode]:currSlice->all_mv[LIST_0][l0_ref][l0_mode]);
-    MotionVector **l1_mv_array = (bipred_me ? currSlice->bipred_mv[bipred_me-1][LIST_1][l1_ref][l1_mode]:currSlice->all_mv[LIST_1][l1_ref][l1_mode]);
+    MotionVector (*l0_mv_array)[BLOCK_MULTIPLE] = (bipred_me ? currSlice->bipred_mv[bipred_me-1][LIST_0][l0_ref][l0_mode]:currSlice->all_mv[LIST_0][l0_ref][l0_mode]);
+    MotionVector (*l1_mv_array)[BLOCK_MULTIPLE] = (bipred_me ? currSlice->bipred_mv[bipred_me-1][LIST_1][l1_ref][l1_mode]:currSlice->all_mv[LIST_1][l1_ref][l1_mode]);
 
     vec1_x = i4 * mv_mul + l0_mv_array[j][i].mv_x;
     vec2_x = i4 * mv_mul + l1_mv_array[j][i].mv_x;
@@ -47,6 +47,7 @@
 #include "mv_prediction.h"
 #include "rdopt.h"
 #include "transform.h"
+#include "enc_profile.h"
 
 
 #if TRACE
@@ -346,8 +347,6 @@ void start_macroblock(Slice *currSlice, Macroblock **currMB, int mb_addr, Boolea
   int i, mb_qp;
   int use_bitstream_backing = (p_Inp->slice_mode == FIXED_RATE || p_Inp->slice_mode == CALL_BACK);
 
-  static Macroblock *last_coded_mb = NULL;    // used to find whether this is recoding an MB
-
   DataPartition *dataPart;
   Bitstream *currStream;
   int prev_mb;
@@ -423,7 +422,7 @@ void start_macroblock(Slice *currSlice, Macroblock **currMB, int mb_addr, Boolea
     (*currMB)->prev_dqp = 0;
   }
 
-  if(p_Inp->RCEnable && (last_coded_mb != *currMB))   //!< avoid decreasing the NumberofbasicUnit for the same MB twice
+  if(p_Inp->RCEnable && (p_Vid->last_coded_mb != *currMB))   //!< avoid decreasing the NumberofbasicUnit for the same MB twice
   {
     mb_qp = rc_handle_mb( *currMB, prev_mb);
   }
@@ -432,7 +431,8 @@ void start_macroblock(Slice *currSlice, Macroblock **currMB, int mb_addr, Boolea
     mb_qp = p_Vid->qp;
   }
 
-  last_coded_mb = *currMB;   // save the address of the last coded MB
+  if (p_Inp->RCEnable)
+    p_Vid->last_coded_mb = *currMB;   // save the address of the last coded MB
   
   if ((*currMB)->mbAddrX == 0)
     p_Vid->BasicUnitQP = mb_qp;
@@ -478,7 +478,7 @@ void start_macroblock(Slice *currSlice, Macroblock **currMB, int mb_addr, Boolea
   // Select appropriate MV predictor function
   if (currSlice->slice_type != I_SLICE && currSlice->slice_type != SI_SLICE)
   {
-    init_motion_vector_prediction(*currMB, currSlice->mb_aff_frame_flag);
+    (*currMB)->GetMVPredictor = currSlice->mb_aff_frame_flag ? GetMotionVectorPredictorMBAFF : GetMotionVectorPredictorNormal;
     init_ME_engine(*currMB);
   }
 
@@ -2815,6 +2815,7 @@ void write_macroblock (Macroblock* currMB, int eos_bit)
   BitCounter *mbBits = &currMB->bits;
   int i;
 
+  ENC_PROFILE_START(p_Vid, EPROF_ENTROPY);
   // enable writing of trace file
 #if TRACE
   if ( currMB->prev_recode_mb == FALSE )
@@ -2895,6 +2896,7 @@ void write_macroblock (Macroblock* currMB, int eos_bit)
   p_Vid->p_Stats->bit_slice += mbBits->mb_total;
 
   p_Vid->cabac_encoding = 0;
+  ENC_PROFILE_STOP(p_Vid, EPROF_ENTROPY);
 }
 
 
@@ -2969,7 +2971,7 @@ int writeMotionVector8x8 (Macroblock *currMB,
   DataPartition* dataPart = &(currSlice->partArr[partMap[SE_MVD]]);        
   int            refindex   = refframe;
 
-  MotionVector **all_mv     = currSlice->all_mv[list_idx][refindex][mv_mode];
+  MotionVector (*all_mv)[BLOCK_MULTIPLE]     = currSlice->all_mv[list_idx][refindex][mv_mode];
   MotionVector *cur_mv;
   MotionVector predMV; 
   PicMotionParams **motion = p_Vid->enc_picture->mv_info;
@@ -4827,9 +4829,9 @@ void make_frame_picture_JV(VideoParameters *p_Vid)
 Macroblock *alloc_mbs(VideoParameters *p_Vid, int mb_num, int layers)
 {
   int i, j;
-  Macroblock *pMBs = (Macroblock *)calloc(mb_num, sizeof(Macroblock)), *pMB;
-  if(!pMBs)
-    return NULL;
+  MemTag mem_tag = mem_set_tag(MEM_MB);
+  Macroblock *pMBs = (Macroblock *)mem_calloc(mb_num, sizeof(Macroblock)), *pMB;
+
   for(i=0; i<mb_num; i++)
   {
     pMB = pMBs+i;
@@ -4843,6 +4845,7 @@ Macroblock *alloc_mbs(VideoParameters *p_Vid, int mb_num, int layers)
     pMB->intra8x8_pred = pMB->intra8x8_pred_buf[0];
     pMB->intra16x16_pred = pMB->intra16x16_pred_buf[0];
   }
+  mem_set_tag(mem_tag);
   return pMBs;
 }
 
@@ -4878,5 +4881,5 @@ void free_mbs(Macroblock *pMBs, int mb_num)
     pMB->intra8x8_pred = NULL;
     pMB->intra16x16_pred = NULL;
   }
-  free(pMBs);
+  mem_free(pMBs);
 }
@@ -43,46 +43,53 @@ Boolean mb_is_available(int mbAddr, Macroblock *currMB)
  * \brief
  *    Checks the availability of neighboring macroblocks of
  *    the current macroblock for prediction and context determination;
+ *    the neighbours inside the picture are taken from the picture
+ *    neighbour table and are available if they belong to the current
+ *    slice (or when deblocking).
  ************************************************************************
  */
 void CheckAvailabilityOfNeighbors(Macroblock *currMB)
 {
   VideoParameters *p_Vid = currMB->p_Vid;
-  const int mb_nr = currMB->mbAddrX;
-  BlockPos *PicPos = p_Vid->PicPos;
-
-  // mark all neighbors as unavailable
-  currMB->mb_up   = NULL;
-  currMB->mb_left = NULL;
+  Macroblock *mb_data = p_Vid->mb_data;
+  MbNeighbours *nb;
+  int inside;
 
   if (p_Vid->mb_aff_frame_flag)
   {
-    int cur_mb_pair = mb_nr >> 1;
-    currMB->mbAddrA = 2 * (cur_mb_pair - 1);
-    currMB->mbAddrB = 2 * (cur_mb_pair - p_Vid->PicWidthInMbs);
-    currMB->mbAddrC = 2 * (cur_mb_pair - p_Vid->PicWidthInMbs + 1);
-    currMB->mbAddrD = 2 * (cur_mb_pair - p_Vid->PicWidthInMbs - 1);
-
-    currMB->mbAvailA = (byte) (mb_is_available(currMB->mbAddrA, currMB) && ((PicPos[cur_mb_pair    ].x)!=0));
-    currMB->mbAvailB = (byte) (mb_is_available(currMB->mbAddrB, currMB));
-    currMB->mbAvailC = (byte) (mb_is_available(currMB->mbAddrC, currMB) && ((PicPos[cur_mb_pair + 1].x)!=0));
-    currMB->mbAvailD = (byte) (mb_is_available(currMB->mbAddrD, currMB) && ((PicPos[cur_mb_pair    ].x)!=0));
+    nb = &p_Vid->PicNeighbours[currMB->mbAddrX >> 1];
+    currMB->mbAddrA = 2 * nb->mbAddrA;
+    currMB->mbAddrB = 2 * nb->mbAddrB;
+    currMB->mbAddrC = 2 * nb->mbAddrC;
+    currMB->mbAddrD = 2 * nb->mbAddrD;
   }
   else
   {
-    currMB->mbAddrA = mb_nr - 1;
-    currMB->mbAddrB = mb_nr - p_Vid->PicWidthInMbs;
-    currMB->mbAddrC = mb_nr - p_Vid->PicWidthInMbs + 1;
-    currMB->mbAddrD = mb_nr - p_Vid->PicWidthInMbs - 1;
+    nb = &p_Vid->PicNeighbours[currMB->mbAddrX];
+    currMB->mbAddrA = nb->mbAddrA;
+    currMB->mbAddrB = nb->mbAddrB;
+    currMB->mbAddrC = nb->mbAddrC;
+    currMB->mbAddrD = nb->mbAddrD;
+  }
+  inside = nb->inside;
 
-    currMB->mbAvailA = (byte) (mb_is_available(currMB->mbAddrA, currMB) && ((PicPos[mb_nr    ].x)!=0));
-    currMB->mbAvailB = (byte) (mb_is_available(currMB->mbAddrB, currMB));
-    currMB->mbAvailC = (byte) (mb_is_available(currMB->mbAddrC, currMB) && ((PicPos[mb_nr + 1].x)!=0));
-    currMB->mbAvailD = (byte) (mb_is_available(currMB->mbAddrD, currMB) && ((PicPos[mb_nr    ].x)!=0));
+  if (currMB->DeblockCall)
+  {
+    currMB->mbAvailA = (byte) ((inside & NB_A) != 0);
+    currMB->mbAvailB = (byte) ((inside & NB_B) != 0);
+    currMB->mbAvailC = (byte) ((inside & NB_C) != 0);
+    currMB->mbAvailD = (byte) ((inside & NB_D) != 0);
+  }
+  else
+  {
+    currMB->mbAvailA = (byte) ((inside & NB_A) && mb_data[currMB->mbAddrA].slice_nr == currMB->slice_nr);
+    currMB->mbAvailB = (byte) ((inside & NB_B) && mb_data[currMB->mbAddrB].slice_nr == currMB->slice_nr);
+    currMB->mbAvailC = (byte) ((inside & NB_C) && mb_data[currMB->mbAddrC].slice_nr == currMB->slice_nr);
+    currMB->mbAvailD = (byte) ((inside & NB_D) && mb_data[currMB->mbAddrD].slice_nr == currMB->slice_nr);
   }
 
-  if (currMB->mbAvailA) currMB->mb_left = &(p_Vid->mb_data[currMB->mbAddrA]);
-  if (currMB->mbAvailB) currMB->mb_up   = &(p_Vid->mb_data[currMB->mbAddrB]);
+  currMB->mb_left = (currMB->mbAvailA) ? &(mb_data[currMB->mbAddrA]) : NULL;
+  currMB->mb_up   = (currMB->mbAvailB) ? &(mb_data[currMB->mbAddrB]) : NULL;
 }
 
 
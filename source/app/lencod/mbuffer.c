@@ -409,6 +409,7 @@ StorablePicture* alloc_storable_picture(VideoParameters *p_Vid, PictureStructure
   StorablePicture *s;
   int   nplane;
   InputParameters *p_Inp = p_Vid->p_Inp;
+  MemTag mem_tag = mem_set_tag(MEM_DPB);
 
   //printf ("Allocating (%s) picture (x=%d, y=%d, x_cr=%d, y_cr=%d)\n", (type == FRAME)?"FRAME":(type == TOP_FIELD)?"TOP_FIELD":"BOTTOM_FIELD", size_x, size_y, size_x_cr, size_y_cr);
 
@@ -435,6 +436,7 @@ StorablePicture* alloc_storable_picture(VideoParameters *p_Vid, PictureStructure
   {
     if (!p_Inp->OnTheFlyFractMCP) // JLT : on-the-fly flag
     {
+      mem_set_tag(MEM_SUBPEL);
       get_mem4Dpel_pad(&(s->imgY_sub), 4, 4, size_y, size_x, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
       s->imgY = s->imgY_sub[0][0];
 
@@ -464,11 +466,14 @@ StorablePicture* alloc_storable_picture(VideoParameters *p_Vid, PictureStructure
       }
       else
       {
+        mem_set_tag(MEM_DPB);
         get_mem3Dpel_pad(&(s->imgUV), 2, size_y_cr, size_x_cr, p_Vid->pad_size_uv_y, p_Vid->pad_size_uv_x);
       }
+      mem_set_tag(MEM_DPB);
     }
     else if ( p_Inp->OnTheFlyFractMCP == OTF_L1 ) // OTF L1
     {
+      mem_set_tag(MEM_SUBPEL);
       get_mem4Dpel_pad(&(s->imgY_sub), 2, 2, size_y, size_x, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
       s->imgY = s->imgY_sub[0][0];
 
@@ -498,8 +503,10 @@ StorablePicture* alloc_storable_picture(VideoParameters *p_Vid, PictureStructure
       }
       else
       {
+        mem_set_tag(MEM_DPB);
         get_mem3Dpel_pad(&(s->imgUV), 2, size_y_cr, size_x_cr, p_Vid->pad_size_uv_y, p_Vid->pad_size_uv_x);
       }
+      mem_set_tag(MEM_DPB);
     }
     else // OTF_L2
     {
@@ -580,6 +587,8 @@ StorablePicture* alloc_storable_picture(VideoParameters *p_Vid, PictureStructure
   memset(s->ref_pic_na, 0xff, sizeof(int)*6);
 
   init_stats(p_Inp, &s->stats);
+
+  mem_set_tag(mem_tag);
   return s;
 }
 
@@ -1005,9 +1014,11 @@ void init_lists_p_slice(Slice *currSlice)
   FrameStore **fs_list0;
   FrameStore **fs_listlt;
 
+  // the lists of a pooled slice are kept from the previous picture
   for (i = 0; i < 6; i++)
   {
-    currSlice->listX[i] = calloc(MAX_LIST_SIZE, sizeof (StorablePicture*)); // +1 for reordering
+    if (currSlice->listX[i] == NULL)
+      currSlice->listX[i] = calloc(MAX_LIST_SIZE, sizeof (StorablePicture*)); // +1 for reordering
     if (NULL == currSlice->listX[i])
       no_mem_exit("init_dpb: currSlice->listX[i]");
   }
@@ -1218,9 +1229,11 @@ void init_lists_b_slice(Slice *currSlice)
   FrameStore **fs_listlt;
 
 
+  // the lists of a pooled slice are kept from the previous picture
   for (i = 0; i < 6; i++)
   {
-    currSlice->listX[i] = calloc(MAX_LIST_SIZE, sizeof (StorablePicture*)); // +1 for reordering
+    if (currSlice->listX[i] == NULL)
+      currSlice->listX[i] = calloc(MAX_LIST_SIZE, sizeof (StorablePicture*)); // +1 for reordering
     if (NULL == currSlice->listX[i])
       no_mem_exit("init_dpb: currSlice->listX[i]");
   }
@@ -2963,6 +2976,27 @@ void dpb_combine_field(VideoParameters *p_Vid, FrameStore *fs)
 }
 
 
+/*!
+ ************************************************************************
+ * \brief
+ *    Allocates a buffer for the reordering commands of one reference
+ *    list, or clears the buffer a pooled slice kept from a previous
+ *    picture. The buffer holds the commands of the longest list.
+ ************************************************************************
+ */
+static int *alloc_reordering_buffer(int *buffer)
+{
+  if (buffer == NULL)
+  {
+    if ((buffer = calloc(MAX_LIST_SIZE, sizeof(int))) == NULL)
+      no_mem_exit("alloc_ref_pic_list_reordering_buffer: buffer");
+  }
+  else
+    memset(buffer, 0, MAX_LIST_SIZE * sizeof(int));
+
+  return buffer;
+}
+
 /*!
  ************************************************************************
  * \brief
@@ -2971,53 +3005,20 @@ void dpb_combine_field(VideoParameters *p_Vid, FrameStore *fs)
  */
 void alloc_ref_pic_list_reordering_buffer(Slice *currSlice)
 {  
-  free_ref_pic_list_reordering_buffer(currSlice);
+  int list;
+  int num_lists = (currSlice->slice_type == B_SLICE) ? 2 : (currSlice->slice_type != I_SLICE && currSlice->slice_type != SI_SLICE) ? 1 : 0;
 
-  if (currSlice->slice_type != I_SLICE && currSlice->slice_type != SI_SLICE)
-  {
-    int size = currSlice->num_ref_idx_active[LIST_0] + 1;
-    if ((currSlice->modification_of_pic_nums_idc[LIST_0] = calloc(size, sizeof(int)))==NULL) 
-      no_mem_exit("alloc_ref_pic_list_reordering_buffer: modification_of_pic_nums_idc_l0");
-    if ((currSlice->abs_diff_pic_num_minus1[LIST_0] = calloc(size, sizeof(int)))==NULL) 
-      no_mem_exit("alloc_ref_pic_list_reordering_buffer: abs_diff_pic_num_minus1_l0");
-    if ((currSlice->long_term_pic_idx[LIST_0] = calloc(size, sizeof(int)))==NULL)
-      no_mem_exit("alloc_ref_pic_list_reordering_buffer: long_term_pic_idx_l0");
-#if (MVC_EXTENSION_ENABLE)
-    if ((currSlice->abs_diff_view_idx_minus1[LIST_0] = calloc(size, sizeof(int)))==NULL) 
-      no_mem_exit("alloc_ref_pic_list_reordering_buffer: abs_diff_view_idx_minus1_l0");
-#endif
-  }
-  else
-  {
-    currSlice->modification_of_pic_nums_idc[LIST_0] = NULL;
-    currSlice->abs_diff_pic_num_minus1[LIST_0] = NULL;
-    currSlice->long_term_pic_idx[LIST_0] = NULL;
-#if (MVC_EXTENSION_ENABLE)
-    currSlice->abs_diff_view_idx_minus1[LIST_0] = NULL;
-#endif
-  }
+  // buffers of lists the slice type does not use
+  if ((num_lists < 2 && currSlice->modification_of_pic_nums_idc[LIST_1] != NULL) || (num_lists < 1 && currSlice->modification_of_pic_nums_idc[LIST_0] != NULL))
+    free_ref_pic_list_reordering_buffer(currSlice);
 
-  if (currSlice->slice_type == B_SLICE)
+  for (list = LIST_0; list < num_lists; list++)
   {
-    int size = currSlice->num_ref_idx_active[LIST_1] + 1;
-    if ((currSlice->modification_of_pic_nums_idc[LIST_1] = calloc(size, sizeof(int)))==NULL) 
-      no_mem_exit("alloc_ref_pic_list_reordering_buffer: modification_of_pic_nums_idc_l1");
-    if ((currSlice->abs_diff_pic_num_minus1[LIST_1] = calloc(size, sizeof(int)))==NULL) 
-      no_mem_exit("alloc_ref_pic_list_reordering_buffer: abs_diff_pic_num_minus1_l1");
-    if ((currSlice->long_term_pic_idx[LIST_1] = calloc(size, sizeof(int)))==NULL) 
-      no_mem_exit("alloc_ref_pic_list_reordering_buffer: long_term_pic_idx_l1");
+    currSlice->modification_of_pic_nums_idc[list] = alloc_reordering_buffer(currSlice->modification_of_pic_nums_idc[list]);
+    currSlice->abs_diff_pic_num_minus1[list]      = alloc_reordering_buffer(currSlice->abs_diff_pic_num_minus1[list]);
+    currSlice->long_term_pic_idx[list]            = alloc_reordering_buffer(currSlice->long_term_pic_idx[list]);
 #if (MVC_EXTENSION_ENABLE)
-    if ((currSlice->abs_diff_view_idx_minus1[LIST_1] = calloc(size, sizeof(int)))==NULL) 
-      no_mem_exit("alloc_ref_pic_list_reordering_buffer: abs_diff_view_idx_minus1_l1");
-#endif
-  }
-  else
-  {
-    currSlice->modification_of_pic_nums_idc[LIST_1] = NULL;
-    currSlice->abs_diff_pic_num_minus1[LIST_1] = NULL;
-    currSlice->long_term_pic_idx[LIST_1] = NULL;
-#if (MVC_EXTENSION_ENABLE)
-    currSlice->abs_diff_view_idx_minus1[LIST_1] = NULL;
+    currSlice->abs_diff_view_idx_minus1[list]     = alloc_reordering_buffer(currSlice->abs_diff_view_idx_minus1[list]);
 #endif
   }
 }
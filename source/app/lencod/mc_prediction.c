@@ -161,7 +161,7 @@ void luma_prediction (Macroblock* currMB, //!< Current Macroblock
   int  pic_opix_y   = ((currMB->opix_y + block_y) << 2);
   int  bx           = block_x >> 2;
   int  by           = block_y >> 2;
-  MotionVector ***** mv_array = currSlice->all_mv;
+  MBMotionVectors **mv_array = currSlice->all_mv;
   MotionVector *curr_mv = NULL;
   imgpel **mb_pred = currSlice->mb_pred[0];
 
@@ -260,7 +260,7 @@ void luma_prediction_bi (Macroblock* currMB, //!< Current Macroblock
 
   int  apply_weights = ( currSlice->weighted_prediction != 0 );
 
-  MotionVector *****mv_array = currSlice->bipred_mv[list]; 
+  MBMotionVectors **mv_array = currSlice->bipred_mv[list]; 
   MotionVector *mv_arrayl0 = &mv_array[LIST_0][l0_ref_idx][l0_mode][by][bx];
   MotionVector *mv_arrayl1 = &mv_array[LIST_1][l1_ref_idx][l1_mode][by][bx];
   imgpel **mb_pred = currSlice->mb_pred[0];
@@ -294,7 +294,7 @@ void OneComponentChromaPrediction4x4_regenerate (
                                  imgpel*     mpred,      //!< array to store prediction values
                                  int         block_c_x,  //!< horizontal pixel coordinate of 4x4 block
                                  int         block_c_y,  //!< vertical   pixel coordinate of 4x4 block
-                                 MotionVector **mv,         //!< motion vector array
+                                 MotionVector (*mv)[BLOCK_MULTIPLE], //!< motion vector array
                                  StorablePicture *list,  //!< image components (color planes)
                                  int         uv)         //!< chroma component
 {
@@ -363,7 +363,7 @@ void OneComponentChromaPrediction4x4_retrieve (
                                  imgpel*     mpred,      //!< array to store prediction values
                                  int         block_c_x,  //!< horizontal pixel coordinate of 4x4 block
                                  int         block_c_y,  //!< vertical   pixel coordinate of 4x4 block
-                                 MotionVector **mv,         //!< motion vector array
+                                 MotionVector (*mv)[BLOCK_MULTIPLE], //!< motion vector array
                                  StorablePicture *list,  //!< image components (color planes)
                                  int         uv)         //!< chroma component
 {
@@ -491,7 +491,7 @@ void chroma_prediction (Macroblock* currMB, // <-- Current Macroblock
 
   int  bx           = block_x >> 2;
   int  by           = block_y >> 2;
-  MotionVector ***** mv_array = currSlice->all_mv;    
+  MBMotionVectors **mv_array = currSlice->all_mv;    
   int uv_comp = uv + 1;
   imgpel **mb_pred = currSlice->mb_pred[ uv_comp];
 
@@ -583,7 +583,7 @@ void chroma_prediction_4x4 (Macroblock* currMB,  // <-- Current Macroblock
   imgpel l0_pred[MB_PIXELS];
   imgpel l1_pred[MB_PIXELS];
 
-  MotionVector ***** mv_array = currSlice->all_mv;
+  MBMotionVectors **mv_array = currSlice->all_mv;
   int uv_comp = uv + 1;
   imgpel **mb_pred = currSlice->mb_pred[uv_comp];
   int     list_offset = currMB->list_offset;
@@ -26,8 +26,8 @@ extern void chroma_prediction_4x4 ( Macroblock* currMB, int, int, int, int, int,
 
 extern void rdo_low_intra_chroma_decision              (Macroblock *currMB, int mb_available_up, int mb_available_left[2], int mb_available_up_left);
 extern void rdo_low_intra_chroma_decision_mbaff        (Macroblock *currMB, int mb_available_up, int mb_available_left[2], int mb_available_up_left);
-extern void OneComponentChromaPrediction4x4_regenerate (Macroblock *currMB, imgpel* , int , int , MotionVector ** , StorablePicture *listX, int );
-extern void OneComponentChromaPrediction4x4_retrieve   (Macroblock *currMB, imgpel* , int , int , MotionVector ** , StorablePicture *listX, int );
+extern void OneComponentChromaPrediction4x4_regenerate (Macroblock *currMB, imgpel* , int , int , MotionVector (*)[BLOCK_MULTIPLE], StorablePicture *listX, int );
+extern void OneComponentChromaPrediction4x4_retrieve   (Macroblock *currMB, imgpel* , int , int , MotionVector (*)[BLOCK_MULTIPLE], StorablePicture *listX, int );
 
 extern void intra_chroma_prediction_mbaff(Macroblock *currMB, int*, int*, int*);
 extern void intra_chroma_prediction      (Macroblock *currMB, int*, int*, int*);
@@ -164,7 +164,7 @@ void luma_prediction_otf ( Macroblock* currMB, //!< Current Macroblock
   int  pic_opix_y   = ((currMB->opix_y + block_y) << 2);
   int  bx           = block_x >> 2;
   int  by           = block_y >> 2;
-  MotionVector ***** mv_array = currSlice->all_mv;
+  MBMotionVectors **mv_array = currSlice->all_mv;
   MotionVector *curr_mv = NULL;
   imgpel **mb_pred = currSlice->mb_pred[0];
   int  apply_weights = ( (currSlice->weighted_prediction == 1) || (currSlice->weighted_prediction == 2 && p_dir == 2) );
@@ -265,7 +265,7 @@ void luma_prediction_bi_otf ( Macroblock* currMB, //!< Current Macroblock
 
   int  apply_weights = ( currSlice->weighted_prediction != 0 );
 
-  MotionVector *****mv_array = currSlice->bipred_mv[list]; 
+  MBMotionVectors **mv_array = currSlice->bipred_mv[list]; 
   MotionVector *mv_arrayl0 = &mv_array[LIST_0][l0_ref_idx][l0_mode][by][bx];
   MotionVector *mv_arrayl1 = &mv_array[LIST_1][l1_ref_idx][l1_mode][by][bx];
   imgpel **mb_pred = currSlice->mb_pred[0];
@@ -320,7 +320,7 @@ void chroma_prediction_otf ( Macroblock* currMB, // <-- Current Macroblock
 
   int  bx           = block_x >> 2;
   int  by           = block_y >> 2;
-  MotionVector ***** mv_array = currSlice->all_mv;    
+  MBMotionVectors **mv_array = currSlice->all_mv;    
   int uv_comp = uv + 1;
   imgpel **mb_pred = currSlice->mb_pred[ uv_comp];
 
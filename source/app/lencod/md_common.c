@@ -24,7 +24,7 @@
  *    Copy rdo mv info to 16xN picture mv buffer
  *************************************************************************************
  */
-static inline void CopyMVBlock16(PicMotionParams **mv_info, MotionVector **rdo_mv, int list, int block_x, int block_y, int start, int end)
+static inline void CopyMVBlock16(PicMotionParams **mv_info, MotionVector (*rdo_mv)[BLOCK_MULTIPLE], int list, int block_x, int block_y, int start, int end)
 {
   int j, i;
   for (j = start; j < end; j++)
@@ -62,7 +62,7 @@ static inline void ResetMotionBlock16(PicMotionParams **mv_info, int list, int b
  *    Copy rdo mv info to 8xN picture mv buffer
  *************************************************************************************
  */
-static inline void CopyMVBlock8(PicMotionParams **mv_info, MotionVector **rdo_mv, int list, int block_x, int start, int end, int offset)
+static inline void CopyMVBlock8(PicMotionParams **mv_info, MotionVector (*rdo_mv)[BLOCK_MULTIPLE], int list, int block_x, int start, int end, int offset)
 {
   int j;
   for (j = start; j < end; j++)
@@ -106,7 +106,7 @@ void SetMotionVectorsMBPSlice (Macroblock* currMB)
   PicMotionParams **mv_info = p_Vid->enc_picture->mv_info;
 
   RD_DATA *rdopt = currSlice->rddata;
-  MotionVector ****all_mv  = currSlice->all_mv[LIST_0];
+  MBMotionVectors *all_mv  = currSlice->all_mv[LIST_0];
   int  l0_ref, mode8;
 
   if (currSlice->mb_aff_frame_flag || (currSlice->UseRDOQuant && currSlice->RDOQ_QP_Num > 1))
@@ -188,7 +188,7 @@ static void SetMVBSlice16x8(Slice *currSlice, PicMotionParams **motion, Macroblo
   else
   {
     int bipred_me = currMB->b8x8[pos].bipred;
-    MotionVector *****all_mv = bipred_me ? currSlice->bipred_mv[bipred_me - 1]: currSlice->all_mv;
+    MBMotionVectors **all_mv = bipred_me ? currSlice->bipred_mv[bipred_me - 1]: currSlice->all_mv;
     l0_ref = motion[currMB->block_y + pos][currMB->block_x].ref_idx[LIST_0];
     CopyMVBlock16 (motion, all_mv [LIST_0][l0_ref][P16x8], LIST_0, currMB->block_x, currMB->block_y, pos, pos + 2);
     
@@ -228,7 +228,7 @@ static void SetMVBSlice8x16(Slice *currSlice, PicMotionParams **motion, Macroblo
   else
   {
     int bipred_me = currMB->b8x8[pos >> 1].bipred;
-    MotionVector *****all_mv = bipred_me ? currSlice->bipred_mv[bipred_me - 1]: currSlice->all_mv;
+    MBMotionVectors **all_mv = bipred_me ? currSlice->bipred_mv[bipred_me - 1]: currSlice->all_mv;
 
     l0_ref = motion[currMB->block_y][currMB->block_x + pos].ref_idx[LIST_0];
     CopyMVBlock8(&motion[currMB->block_y], all_mv [LIST_0][l0_ref][P8x16], LIST_0, currMB->block_x + pos, 0, 4, pos);
@@ -280,7 +280,7 @@ static void SetMVBSlice8x8(Slice *currSlice, PicMotionParams **motion, Macrobloc
   else if (pdir == BI_PRED)
   {
     int bipred_me = currMB->b8x8[pos].bipred;
-    MotionVector *****all_mv = bipred_me ? currSlice->bipred_mv[bipred_me - 1]: currSlice->all_mv;
+    MBMotionVectors **all_mv = bipred_me ? currSlice->bipred_mv[bipred_me - 1]: currSlice->all_mv;
     l0_ref = motion[block_y][block_x].ref_idx[LIST_0];
     CopyMVBlock8(&motion[currMB->block_y], all_mv [LIST_0][l0_ref][mode], LIST_0, currMB->block_x + pos_x, pos_y, pos_y + 2, pos_x);
     
@@ -347,7 +347,7 @@ void SetMotionVectorsMBBSlice (Macroblock* currMB)
     else
     {
       int bipred_me = currMB->b8x8[0].bipred;
-      MotionVector *****all_mv  = bipred_me ? currSlice->bipred_mv[bipred_me - 1]: currSlice->all_mv;
+      MBMotionVectors **all_mv  = bipred_me ? currSlice->bipred_mv[bipred_me - 1]: currSlice->all_mv;
       l0_ref = motion[currMB->block_y][currMB->block_x].ref_idx[LIST_0];
       CopyMVBlock16 (motion, all_mv [LIST_0][l0_ref][P16x16], LIST_0, currMB->block_x, currMB->block_y, 0, 4);
       l1_ref = motion[currMB->block_y][currMB->block_x].ref_idx[LIST_1];
@@ -425,6 +425,47 @@ distblk computeSAD(StorablePicture *ref1,
   return (dist_scale((distblk)mcost));
 }
 
+/*!
+************************************************************************
+* \brief
+*    SAD of a blocksize_x x blocksize_y original block against num_cand
+*    (up to SAD_ROW_CANDS) consecutive full pel positions on one line,
+*    the first one starting at ref. All candidates are accumulated side
+*    by side, so the innermost loop runs over neighbouring reference
+*    samples and can be vectorised by the compiler. The computation
+*    stops as soon as all SADs exceed max_sad.
+************************************************************************
+*/
+void computeSADRow(imgpel *orig, int orig_stride, int blocksize_x, int blocksize_y, imgpel *ref, int ref_stride, int num_cand, int max_sad, int *sad)
+{
+  int acc[SAD_ROW_CANDS] = { 0 };
+  int x, y, c;
+
+  for (y = 0; y < blocksize_y; y++)
+  {
+    int min_sad;
+
+    for (x = 0; x < blocksize_x; x++)
+    {
+      int org = orig[x];
+      imgpel *ref_line = &ref[x];
+
+      for (c = 0; c < num_cand; c++)
+        acc[c] += iabs(ref_line[c] - org);
+    }
+    orig += orig_stride;
+    ref  += ref_stride;
+
+    min_sad = acc[0];
+    for (c = 1; c < num_cand; c++)
+      min_sad = imin(min_sad, acc[c]);
+    if (min_sad > max_sad)
+      break;
+  }
+
+  memcpy(sad, acc, num_cand * sizeof(int));
+}
+
 /*!
 ************************************************************************
 * \brief
@@ -18,6 +18,8 @@
 #ifndef _ME_DISTORTION_H_
 #define _ME_DISTORTION_H_
 
+#define SAD_ROW_CANDS  16     //!< maximum number of candidates evaluated by one computeSADRow call
+
 extern distblk distortion4x4SAD(short* diff, distblk min_mcost);
 extern distblk distortion4x4SSE(short* diff, distblk min_mcost);
 extern distblk distortion4x4SATD(short* diff, distblk min_cost);
@@ -28,6 +30,7 @@ extern distblk distortion8x8SATD(short* diff, distblk min_cost);
 extern int HadamardSAD4x4(short* diff);
 extern int HadamardSAD8x8(short* diff);
 // SAD functions
+extern void    computeSADRow      (imgpel *orig, int orig_stride, int blocksize_x, int blocksize_y, imgpel *ref, int ref_stride, int num_cand, int max_sad, int *sad);
 extern distblk computeSAD         (StorablePicture *ref1, MEBlock*, distblk, MotionVector *);
 extern distblk computeSAD16x16    (StorablePicture *ref1, MEBlock*, distblk, MotionVector *);
 extern distblk computeSAD16x8     (StorablePicture *ref1, MEBlock*, distblk, MotionVector *);
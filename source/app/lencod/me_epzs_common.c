@@ -438,6 +438,7 @@ EPZSStructInit (Slice * currSlice)
     1) << 2 : (2 * p_Inp->search_range[p_Vid->view_id] + 1) << 2;
   p_EPZS->p_Vid = p_Vid;
   p_EPZS->BlkCount = 1;
+  p_EPZS->searcharray = searcharray;
 
   //! In this implementation we keep threshold limits fixed.
   //! However one could adapt these limits based on lagrangian
@@ -609,6 +610,54 @@ EPZSStructDelete (Slice * currSlice)
   currSlice->p_EPZS = NULL;
 }
 
+/*!
+************************************************************************
+* \brief
+*    Reset the EPZS structure of a slice that is reused for a new
+*    picture of the same type, so that the search starts from the
+*    state left by EPZSStructInit()
+************************************************************************
+*/
+void
+EPZSStructReset (Slice * currSlice)
+{
+  VideoParameters *p_Vid = currSlice->p_Vid;
+  InputParameters *p_Inp = currSlice->p_Inp;
+  EPZSParameters *p_EPZS = currSlice->p_EPZS;
+  EPZSColocParams *p = p_EPZS->p_colocated;
+  int max_list_number = p_Vid->mb_aff_frame_flag ? 6 : 2;
+  int dist_size = max_list_number * 7 * ((p_Vid->width + MB_BLOCK_SIZE) / BLOCK_SIZE);
+
+  p_EPZS->BlkCount = 1;
+  memset(p_EPZS->mv_scale, 0, sizeof(p_EPZS->mv_scale));
+  memset(p_EPZS->mv_scale_update, 0, sizeof(p_EPZS->mv_scale_update));
+
+  memset(&p_EPZS->distortion[0][0][0], 0, dist_size * sizeof(distblk));
+  if (p_Inp->BiPredMotionEstimation)
+    memset(&p_EPZS->bi_distortion[0][0][0], 0, dist_size * sizeof(distblk));
+  memset(&p_EPZS->distortion_hpel[0][0][0], 0, dist_size * sizeof(distblk));
+  memset(&p_EPZS->EPZSMap[0][0], 0, p_EPZS->searcharray * p_EPZS->searcharray * sizeof(uint16));
+
+  if (p_Inp->EPZSSpatialMem)
+  {
+#if EPZSREF
+    memset(&p_EPZS->p_motion[0][0][0][0][0], 0, 6 * p_Vid->max_num_references * 7 * 4 * (p_Vid->width / BLOCK_SIZE) * sizeof(MotionVector));
+#else
+    memset(&p_EPZS->p_motion[0][0][0][0], 0, 6 * 7 * 4 * (p_Vid->width / BLOCK_SIZE) * sizeof(MotionVector));
+#endif
+  }
+
+  if (p != NULL)
+  {
+    memset(&p->frame[0][0][0], 0, 2 * (p->size_y >> BLOCK_SHIFT) * (p->size_x >> BLOCK_SHIFT) * sizeof(MotionVector));
+    if (p->mb_adaptive_frame_field_flag)
+    {
+      memset(&p->top[0][0][0], 0, 2 * (p->size_y >> (BLOCK_SHIFT + 1)) * (p->size_x >> BLOCK_SHIFT) * sizeof(MotionVector));
+      memset(&p->bot[0][0][0], 0, 2 * (p->size_y >> (BLOCK_SHIFT + 1)) * (p->size_x >> BLOCK_SHIFT) * sizeof(MotionVector));
+    }
+  }
+}
+
 //! For ME purposes restricting the co-located partition is not necessary.
 /*!
 ************************************************************************
@@ -1236,7 +1285,7 @@ EPZSBlockTypePredictorsMB (Slice * currSlice, MEBlock * mv_block, SPoint * point
   int list      = mv_block->list;
   int ref       = mv_block->ref_idx;
   EPZSParameters *p_EPZS = currSlice->p_EPZS;
-  MotionVector ****all_mv = currSlice->all_mv[list];
+  MBMotionVectors *all_mv = currSlice->all_mv[list];
   MotionVector *cur_mv = &point[*prednum].motion;
 
   if (blocktype != 1)
@@ -1619,7 +1668,7 @@ EPZSBlockTypePredictors (Slice * currSlice, MEBlock *mv_block, SPoint * point, i
   int block_y   = mv_block->block_y;
   int list      = mv_block->list;
   int ref       = mv_block->ref_idx; 
-  MotionVector ****all_mv = currSlice->all_mv[list];
+  MBMotionVectors *all_mv = currSlice->all_mv[list];
   MotionVector *cur_mv = &point[*prednum].motion;
 
   *cur_mv = all_mv[ref][BLOCK_PARENT[blocktype]][block_y][block_x];
@@ -108,6 +108,7 @@ extern void    EPZS_hierarchical_predictors    (EPZSParameters * p_EPZS, MEBlock
  
 extern void  EPZSDelete                (VideoParameters *p_Vid);
 extern void  EPZSStructDelete          (Slice *currSlice);
+extern void  EPZSStructReset           (Slice *currSlice);
 extern void  EPZSSliceInit             (Slice *currSlice);
 extern int   EPZSInit                  (VideoParameters *p_Vid);
 extern int   EPZSStructInit            (Slice *currSlice);
@@ -260,6 +260,60 @@ update_full_search_large_blocks (MEFullFast *p_ffast_me, int list, int refindex,
 }
 
 
+/*!
+ ***********************************************************************
+ * \brief
+ *    4x4 block SADs of the 16x16 luma block orig_pels for all full pel
+ *    positions of the search window around offset. Each line of the
+ *    window is evaluated SAD_ROW_CANDS positions at a time, the results
+ *    are stored at the spiral search positions of the candidates.
+ ***********************************************************************
+ */
+static void setup_block_sad_rows (VideoParameters *p_Vid, StorablePicture *ref_picture, imgpel *orig_pels, distpel **block_sad, MotionVector *offset, int search_range)
+{
+  int sad[BLOCK_MULTIPLE * BLOCK_MULTIPLE][SAD_ROW_CANDS];
+  int dx, dy, c, bindex;
+
+  for (dy = -search_range; dy <= search_range; dy++)
+  {
+    int cand_y = offset->mv_y + (dy << 2);
+
+    for (dx = -search_range; dx <= search_range; dx += SAD_ROW_CANDS)
+    {
+      int cand_x   = offset->mv_x + (dx << 2);
+      int num_cand = imin(SAD_ROW_CANDS, search_range - dx + 1);
+      int consecutive = UMVLine4XConsecutive(ref_picture, cand_x, num_cand);
+      imgpel *refptr = UMVLine4X (ref_picture, cand_y, cand_x);
+
+      for (bindex = 0; bindex < BLOCK_MULTIPLE * BLOCK_MULTIPLE; bindex++)
+      {
+        int blk_x = (bindex & 0x03) << 2;
+        int blk_y = (bindex >> 2) << 2;
+        imgpel *srcptr = &orig_pels[blk_y * MB_BLOCK_SIZE + blk_x];
+        int ref_offset = blk_y * p_Vid->padded_size_x + blk_x;
+
+        if (consecutive)
+        {
+          computeSADRow(srcptr, MB_BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE, refptr + ref_offset, p_Vid->padded_size_x, num_cand, INT_MAX, sad[bindex]);
+        }
+        else
+        {
+          for (c = 0; c < num_cand; c++)
+            computeSADRow(srcptr, MB_BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE, UMVLine4X (ref_picture, cand_y, cand_x + (c << 2)) + ref_offset, p_Vid->padded_size_x, 1, INT_MAX, &sad[bindex][c]);
+        }
+      }
+
+      for (c = 0; c < num_cand; c++)
+      {
+        int pos = spiral_search_pos(dx + c, dy);
+
+        for (bindex = 0; bindex < BLOCK_MULTIPLE * BLOCK_MULTIPLE; bindex++)
+          block_sad[bindex][pos] = (distpel) sad[bindex][c];
+      }
+    }
+  }
+}
+
 /*!
  ***********************************************************************
  * \brief
@@ -489,70 +543,83 @@ void setup_fast_full_search (Macroblock *currMB, MEBlock *mv_block, int list)  /
   }
   else
   {
-    for (pos = 0; pos < max_pos; pos++)
+    int row_sad = (p_Inp->MEErrorMetric[F_PEL] == ERROR_SAD);
+
+    //--- luma SAD: evaluate a line of positions at a time ---
+    if (row_sad)
+      setup_block_sad_rows(p_Vid, ref_picture, orig_pels, block_sad, &offset, p_me_ffast->max_search_range[list][ref]);
+
+    for (pos = 0; pos < max_pos && (!row_sad || mv_block->ChromaMEEnable); pos++)
     {
       cand = add_MVs(offset, &p_Vid->spiral_qpel_search[pos]);
       srcptr = orig_pels;
       bindex = 0;
 
-      refptr = UMVLine4X (ref_picture, cand.mv_y, cand.mv_x);
-
-      for (blky = 0; blky < 4; blky++)
+      if (row_sad)
       {
-        LineSadBlk0 = LineSadBlk1 = LineSadBlk2 = LineSadBlk3 = 0;
+        srcptr += MB_PIXELS;
+      }
+      else
+      {
+        refptr = UMVLine4X (ref_picture, cand.mv_y, cand.mv_x);
 
-        for (y = 0; y < 4; y++)
+        for (blky = 0; blky < 4; blky++)
         {
+          LineSadBlk0 = LineSadBlk1 = LineSadBlk2 = LineSadBlk3 = 0;
+
+          for (y = 0; y < 4; y++)
+          {
 #if (JM_MEM_DISTORTION)
-          // Distortion for first 4x4 block
-          LineSadBlk0 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk0 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk0 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk0 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          // Distortion for second 4x4 block
-          LineSadBlk1 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk1 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk1 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk1 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          // Distortion for third 4x4 block
-          LineSadBlk2 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk2 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk2 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk2 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          // Distortion for fourth 4x4 block
-          LineSadBlk3 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk3 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk3 += imgpel_dist[ *refptr++ - *srcptr++ ];
-          LineSadBlk3 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            // Distortion for first 4x4 block
+            LineSadBlk0 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk0 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk0 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk0 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            // Distortion for second 4x4 block
+            LineSadBlk1 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk1 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk1 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk1 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            // Distortion for third 4x4 block
+            LineSadBlk2 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk2 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk2 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk2 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            // Distortion for fourth 4x4 block
+            LineSadBlk3 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk3 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk3 += imgpel_dist[ *refptr++ - *srcptr++ ];
+            LineSadBlk3 += imgpel_dist[ *refptr++ - *srcptr++ ];
 #else
-          // Distortion for first 4x4 block
-          LineSadBlk0 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk0 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk0 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk0 += dist_method (*refptr++ - *srcptr++);
-          // Distortion for second 4x4 block
-          LineSadBlk1 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk1 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk1 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk1 += dist_method (*refptr++ - *srcptr++);
-          // Distortion for third 4x4 block
-          LineSadBlk2 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk2 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk2 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk2 += dist_method (*refptr++ - *srcptr++);
-          // Distortion for fourth 4x4 block
-          LineSadBlk3 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk3 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk3 += dist_method (*refptr++ - *srcptr++);
-          LineSadBlk3 += dist_method (*refptr++ - *srcptr++);
+            // Distortion for first 4x4 block
+            LineSadBlk0 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk0 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk0 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk0 += dist_method (*refptr++ - *srcptr++);
+            // Distortion for second 4x4 block
+            LineSadBlk1 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk1 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk1 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk1 += dist_method (*refptr++ - *srcptr++);
+            // Distortion for third 4x4 block
+            LineSadBlk2 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk2 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk2 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk2 += dist_method (*refptr++ - *srcptr++);
+            // Distortion for fourth 4x4 block
+            LineSadBlk3 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk3 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk3 += dist_method (*refptr++ - *srcptr++);
+            LineSadBlk3 += dist_method (*refptr++ - *srcptr++);
 #endif
 
-          refptr += p_Vid->padded_size_x - MB_BLOCK_SIZE;
+            refptr += p_Vid->padded_size_x - MB_BLOCK_SIZE;
+          }
+          block_sad[bindex++][pos] = (distpel) LineSadBlk0;
+          block_sad[bindex++][pos] = (distpel) LineSadBlk1;
+          block_sad[bindex++][pos] = (distpel) LineSadBlk2;
+          block_sad[bindex++][pos] = (distpel) LineSadBlk3;
         }
-        block_sad[bindex++][pos] = (distpel) LineSadBlk0;
-        block_sad[bindex++][pos] = (distpel) LineSadBlk1;
-        block_sad[bindex++][pos] = (distpel) LineSadBlk2;
-        block_sad[bindex++][pos] = (distpel) LineSadBlk3;
       }
 
       if (mv_block->ChromaMEEnable)
@@ -29,6 +29,130 @@
 #include "mv_search.h"
 
 // Functions
+/*!
+ ***********************************************************************
+ * \brief
+ *    Full pixel block motion search for luma only SAD. The lines of the
+ *    search window are scanned from the center outwards and the SADs of
+ *    up to SAD_ROW_CANDS neighbouring positions are computed by one
+ *    computeSADRow call. Positions whose motion cost alone exceeds the
+ *    minimum cost are skipped. Equal costs are resolved by the spiral
+ *    order, so the result is the same as the one of the spiral search.
+ ***********************************************************************
+ */
+static distblk
+full_search_rows (Macroblock   *currMB ,       // <--  current Macroblock
+                  MotionVector *pred_mv,       // <--  motion vector predictor in sub-pel units
+                  MEBlock      *mv_block,      // <--  motion estimation structure
+                  distblk       min_mcost,     // <--  minimum motion cost (cost for center or huge value)
+                  int           lambda_factor  // <--  lagrangian parameter for determining motion cost
+                  )
+{
+  VideoParameters *p_Vid = currMB->p_Vid;
+  InputParameters *p_Inp = currMB->p_Inp;
+  Slice *currSlice = currMB->p_Slice;
+  int  search_range = imin(mv_block->searchRange.max_x, mv_block->searchRange.max_y)>> 2;
+  distblk mcost, max_cost;
+  distblk mv_mcost[SAD_ROW_CANDS];
+  int   sad[SAD_ROW_CANDS];
+  int   line, dx, dy, c, first, last, pos, max_sad;
+  MotionVector cand, center, pred;
+  short ref = mv_block->ref_idx;
+
+  StorablePicture *ref_picture = currSlice->listX[mv_block->list+currMB->list_offset][ref];
+
+  int   best_pos      = 0;                                        // position with minimum motion cost
+  int   found         = FALSE;
+
+  MotionVector *mv    = &mv_block->mv[(short) mv_block->list];
+  int   check_for_00  = (mv_block->blocktype==1 && !p_Inp->rdopt && currSlice->slice_type!=B_SLICE && ref==0);
+  center.mv_x      = mv_block->pos_x_padded + mv->mv_x;                        // center position x (in sub-pel units)
+  center.mv_y      = mv_block->pos_y_padded + mv->mv_y;                        // center position y (in sub-pel units)
+  pred.mv_x        = mv_block->pos_x_padded + pred_mv->mv_x;       // predicted position x (in sub-pel units)
+  pred.mv_y        = mv_block->pos_y_padded + pred_mv->mv_y;       // predicted position y (in sub-pel units)
+
+  //===== loop over all lines of the search window: 0, -1, 1, -2, 2, ... =====
+  for (line = 0; line <= 2 * search_range; line++)
+  {
+    dy = (line & 0x01) ? -((line + 1) >> 1) : (line >> 1);
+    cand.mv_y = (short) (center.mv_y + (dy << 2));
+
+    for (dx = -search_range; dx <= search_range; dx += SAD_ROW_CANDS)
+    {
+      int num_cand = imin(SAD_ROW_CANDS, search_range - dx + 1);
+
+      //--- motion costs (cost for motion vector) of the positions ---
+      first = num_cand;
+      last  = -1;
+      max_cost = 0;
+      for (c = 0; c < num_cand; c++)
+      {
+        cand.mv_x = (short) (center.mv_x + ((dx + c) << 2));
+        mcost = mv_cost (p_Vid, lambda_factor, &cand, &pred);
+
+        if (check_for_00 && cand.mv_x == mv_block->pos_x_padded && cand.mv_y == mv_block->pos_y_padded)
+        {
+          distblk tmp = weighted_cost (lambda_factor, 16);
+          mcost = mcost > tmp? (mcost-tmp): 0;
+        }
+        mv_mcost[c] = mcost;
+
+        if (mcost <= min_mcost)
+        {
+          first    = imin(first, c);
+          last     = c;
+          max_cost = distblkmax(max_cost, min_mcost - mcost);
+        }
+      }
+      if (last < 0)
+        continue;
+      max_sad = dist_down(distblkmin(max_cost, dist_scale((distblk) INT_MAX)));
+      if (p_Vid->enc_profile)
+        mv_block->cand_count[F_PEL] += last - first + 1;
+
+      //--- residual cost of the positions first..last ---
+      cand.mv_x = (short) (center.mv_x + ((dx + first) << 2));
+      if (UMVLine4XConsecutive(ref_picture, cand.mv_x, last - first + 1))
+      {
+        computeSADRow(mv_block->orig_pic[0], mv_block->blocksize_x, mv_block->blocksize_x, mv_block->blocksize_y,
+          UMVLine4X(ref_picture, cand.mv_y, cand.mv_x), p_Vid->padded_size_x, last - first + 1, max_sad, &sad[first]);
+      }
+      else
+      {
+        for (c = first; c <= last; c++)
+        {
+          computeSADRow(mv_block->orig_pic[0], mv_block->blocksize_x, mv_block->blocksize_x, mv_block->blocksize_y,
+            UMVLine4X(ref_picture, cand.mv_y, center.mv_x + ((dx + c) << 2)), p_Vid->padded_size_x, 1, max_sad, &sad[c]);
+        }
+      }
+
+      //--- check if motion cost is less than minimum cost, ties go to the earlier spiral position ---
+      for (c = first; c <= last; c++)
+      {
+        mcost = mv_mcost[c] + dist_scale((distblk) sad[c]);
+
+        if (mcost < min_mcost)
+        {
+          best_pos  = spiral_search_pos(dx + c, dy);
+          min_mcost = mcost;
+          found     = TRUE;
+        }
+        else if (found && mcost == min_mcost && (pos = spiral_search_pos(dx + c, dy)) < best_pos)
+        {
+          best_pos  = pos;
+        }
+      }
+    }
+  }
+
+  //===== set best motion vector and return minimum motion cost =====
+  if (best_pos)
+  {
+    add_mvs(mv, &p_Vid->spiral_qpel_search[best_pos]);
+  }
+  return min_mcost;
+}
+
 /*!
  ***********************************************************************
  * \brief
@@ -64,6 +188,10 @@ full_search_motion_estimation (Macroblock   *currMB ,       // <--  current Macr
   pred.mv_x        = mv_block->pos_x_padded + pred_mv->mv_x;       // predicted position x (in sub-pel units)
   pred.mv_y        = mv_block->pos_y_padded + pred_mv->mv_y;       // predicted position y (in sub-pel units)
   
+  //===== luma SAD: evaluate a line of positions at a time =====
+  // (with ProfileFile the SAD function is wrapped by the candidate counter)
+  if ((p_Vid->enc_profile ? mv_block->countedPred[F_PEL] : mv_block->computePredFPel) == computeSAD && !mv_block->ChromaMEEnable)
+    return full_search_rows (currMB, pred_mv, mv_block, min_mcost, lambda_factor);
 
   //===== loop over all search positions =====
   for (pos=0; pos<max_pos; pos++)
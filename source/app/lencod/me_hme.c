@@ -110,6 +110,7 @@ void AllocHMEMemory(imgpel ****pHmeImage, VideoParameters *p_Vid, int size_y, in
 {
    int i, iSx, iSy;
    int iPyramidLevels = p_Vid->pHMEInfo->iPyramidLevels;
+   MemTag mem_tag = mem_set_tag(MEM_HME);
 
    *pHmeImage = (imgpel ***)malloc(sizeof(imgpel**)* iPyramidLevels);
    for(i=0; i<iStartLevel; i++)
@@ -120,6 +121,7 @@ void AllocHMEMemory(imgpel ****pHmeImage, VideoParameters *p_Vid, int size_y, in
      iSy = (size_y >> i);
      get_mem2Dpel_pad(&((*pHmeImage)[i]), iSy, iSx, offset_y, offset_x);
    }   
+   mem_set_tag(mem_tag);
 }
 
 void FreeHMEMemory(imgpel ****pHmeImage, VideoParameters *p_Vid, int iStartLevel, int iPadY, int iPadX)
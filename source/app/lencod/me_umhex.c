@@ -706,7 +706,7 @@ void UMHEX_skip_intrabk_SAD(Macroblock *currMB, int ref_max)
 }
 
 
-void UMHEX_setup(Macroblock *currMB, short ref, int list, int block_y, int block_x, int blocktype, MotionVector  *****all_mv)
+void UMHEX_setup(Macroblock *currMB, short ref, int list, int block_y, int block_x, int blocktype, MBMotionVectors **all_mv)
 {
   Slice *currSlice = currMB->p_Slice;
   VideoParameters *p_Vid = currMB->p_Vid;
@@ -930,7 +930,7 @@ UMHEXBipredIntegerPelBlockMotionSearch (Macroblock *currMB,      // <--  current
   {
     int  N_Bframe=0;
     int  n_Bframe=0;
-    MotionVector *****bipred_mv = currSlice->bipred_mv[list];
+    MBMotionVectors **bipred_mv = currSlice->bipred_mv[list];
     N_Bframe = p_Inp->NumberBFrames;
     n_Bframe = p_Vid->p_Stats->frame_ctr[B_SLICE]%(N_Bframe+1);
 
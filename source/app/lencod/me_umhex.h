@@ -114,7 +114,7 @@ extern void UMHEX_free_mem         (VideoParameters *p_Vid, InputParameters *p_I
 
 extern void UMHEX_decide_intrabk_SAD(Macroblock *currMB);
 extern void UMHEX_skip_intrabk_SAD  (Macroblock *currMB, int ref_max);
-extern void UMHEX_setup             (Macroblock *currMB, short ref, int list, int block_y, int block_x, int blocktype, MotionVector  *****all_mv);
+extern void UMHEX_setup             (Macroblock *currMB, short ref, int list, int block_y, int block_x, int blocktype, MBMotionVectors **all_mv);
 
 extern distblk                                     //  ==> minimum motion cost after search
 UMHEXIntegerPelBlockMotionSearch  (Macroblock *currMB,     // <--  current Macroblock
@@ -962,7 +962,7 @@ void smpUMHEX_setup(Macroblock *currMB,
                     int block_y,
                     int block_x,
                     int blocktype,
-                    MotionVector *****all_mv)
+                    MBMotionVectors **all_mv)
 {
   VideoParameters *p_Vid = currMB->p_Vid;
   UMHexSMPStruct *p_UMHexSMP = p_Vid->p_UMHexSMP;
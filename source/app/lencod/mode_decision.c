@@ -26,6 +26,7 @@
 #include "slice.h"
 #include "conformance.h"
 #include "rdopt.h"
+#include "complexity.h"
 
 
 /*!
@@ -142,6 +143,8 @@ void init_enc_mb_params(Macroblock* currMB, RD_PARAMS *enc_mb, int intra)
   enc_mb->valid[5]     = (short) (!intra && InterSearch[5] && !(p_Inp->Transform8x8Mode==2));
   enc_mb->valid[6]     = (short) (!intra && InterSearch[6] && !(p_Inp->Transform8x8Mode==2));
   enc_mb->valid[7]     = (short) (!intra && InterSearch[7] && !(p_Inp->Transform8x8Mode==2));
+  if (p_Vid->p_Cplx && p_Vid->p_Cplx->tools->no_sub8x8)
+    enc_mb->valid[5] = enc_mb->valid[6] = enc_mb->valid[7] = 0;
   enc_mb->valid[P8x8]  = (short) (enc_mb->valid[4] || enc_mb->valid[5] || enc_mb->valid[6] || enc_mb->valid[7]);
 
 
@@ -285,7 +288,7 @@ void list_prediction_cost(Macroblock *currMB, int list, int block, int mode, RD_
   //--- get cost and reference frame for forward prediction ---
   if (list < BI_PRED)
   {
-    distblk **motion_cost = p_Vid->motion_cost[mode][list];
+    MBMotionCosts *motion_cost = p_Vid->motion_cost[list];
 
     int sp_indicator = (p_Inp->sp2_frame_indicator || p_Inp->sp_output_indicator);
 
@@ -295,7 +298,7 @@ void list_prediction_cost(Macroblock *currMB, int list, int block, int mode, RD_
       {
         for (ref = 0; ref < currSlice->listXsize[cur_list]; ref++)
         {
-          update_mcost(currSlice, ref_lambda, ref, cur_list, motion_cost[ref][block], &bmcost[list], &best_ref[list]);
+          update_mcost(currSlice, ref_lambda, ref, cur_list, motion_cost[ref][mode][block], &bmcost[list], &best_ref[list]);
         }
       }
       else
@@ -305,7 +308,7 @@ void list_prediction_cost(Macroblock *currMB, int list, int block, int mode, RD_
           // limit the number of reference frames to 1 when switching SP frames are used
           if((((currSlice->slice_type != P_SLICE && currSlice->slice_type != SP_SLICE)) || (ref == 0)))
           {
-            update_mcost(currSlice, ref_lambda, ref, cur_list, motion_cost[ref][block], &bmcost[list], &best_ref[list]);
+            update_mcost(currSlice, ref_lambda, ref, cur_list, motion_cost[ref][mode][block], &bmcost[list], &best_ref[list]);
           }
         }
       }
@@ -319,7 +322,7 @@ void list_prediction_cost(Macroblock *currMB, int list, int block, int mode, RD_
           // limit the number of reference frames to 1 when switching SP frames are used
           if( !(sp_indicator) || (((currSlice->slice_type != P_SLICE && currSlice->slice_type != SP_SLICE))|| (ref == 0)))
           {
-            update_mcost(currSlice, ref_lambda, ref, cur_list, motion_cost[ref][block], &bmcost[list], &best_ref[list]);
+            update_mcost(currSlice, ref_lambda, ref, cur_list, motion_cost[ref][mode][block], &bmcost[list], &best_ref[list]);
           }
         }
       }
@@ -436,7 +439,7 @@ void compute_mode_RD_cost(Macroblock *currMB,
     do
     {
       // This seems to have a problem since we are not properly copying the right b8x8info (transform based)
-      terminate_16x16 = bslice_16x16_termination_control(p_Inp, p_Vid->b8x8info, &ctr16x16, mode, bslice);
+      terminate_16x16 = bslice_16x16_termination_control(p_Vid, p_Vid->b8x8info, &ctr16x16, mode, bslice);
       do
       {
         RD_8x8DATA *t8x8_data = currMB->luma_transform_size_8x8_flag ? p_RDO->tr8x8 : p_RDO->tr4x4;
@@ -686,7 +689,7 @@ int transform_termination_control(Macroblock* currMB, int mode)
  *    Update prediction direction for mode P16x16 to check all prediction directions
  *************************************************************************************
  */
-int bslice_16x16_termination_control(InputParameters *p_Inp, Block8x8Info *b8x8info, int *ctr16x16, int mode, int bslice)
+int bslice_16x16_termination_control(VideoParameters *p_Vid, Block8x8Info *b8x8info, int *ctr16x16, int mode, int bslice)
 {
   int lastcheck = 1;
   //--- for INTER16x16 in BSLICEs check all prediction directions ---
@@ -708,7 +711,7 @@ int bslice_16x16_termination_control(InputParameters *p_Inp, Block8x8Info *b8x8i
       break;
     case 2:
       pdir = 2;
-      if (p_Inp->BiPredMotionEstimation)
+      if (p_Vid->p_Inp->BiPredMotionEstimation && !(p_Vid->p_Cplx && p_Vid->p_Cplx->tools->no_bipred_me))
       {
         lastcheck = 0;
       }
@@ -47,7 +47,7 @@ extern void determine_prediction_list      (distblk [5], Info8x8 *, distblk *);
 extern void compute_mode_RD_cost           (Macroblock *currMB, RD_PARAMS *enc_mb, short mode, short *inter_skip);
 
 extern int transform_termination_control   (Macroblock* currMB, int mode);
-extern int bslice_16x16_termination_control(InputParameters *p_Inp, Block8x8Info *b8x8info, int *ctr16x16, int mode, int bslice);
+extern int bslice_16x16_termination_control(VideoParameters *p_Vid, Block8x8Info *b8x8info, int *ctr16x16, int mode, int bslice);
 
 distblk distblkminarray ( distblk arr[], int size, int *minind );
 extern int iminarray ( int arr[], int size, int *minind ); 
@@ -41,7 +41,7 @@ void Get_Direct_MV_Temporal (Macroblock *currMB)
 {
   Slice *currSlice = currMB->p_Slice; 
   int   block_x, block_y, pic_block_x, pic_block_y, opic_block_x, opic_block_y;
-  MotionVector *****all_mvs;
+  MBMotionVectors **all_mvs;
   int   mv_scale;
   int refList;
   int ref_idx;
@@ -530,7 +530,7 @@ void Get_Direct_MV_Spatial_Normal (Macroblock *currMB)
   MotionVector pmvfw = zero_mv, pmvbw = zero_mv;
 
   int   block_x, block_y, pic_block_x, pic_block_y, opic_block_x, opic_block_y;
-  MotionVector *****all_mvs;
+  MBMotionVectors **all_mvs;
   char  *direct_ref_idx;
   StorablePicture **list1 = currSlice->listX[LIST_1];
 
@@ -698,7 +698,7 @@ void Get_Direct_MV_Spatial_MBAFF (Macroblock *currMB)
   MotionVector pmvfw = zero_mv, pmvbw = zero_mv;
 
   int   block_x, block_y, pic_block_x, pic_block_y, opic_block_x, opic_block_y;
-  MotionVector *****all_mvs;
+  MBMotionVectors **all_mvs;
   char  *direct_ref_idx;
   int is_moving_block;
   Slice *currSlice = currMB->p_Slice;
@@ -52,6 +52,7 @@
 #include "me_umhex.h"
 #include "me_umhexsmp.h"
 #include "rdoq.h"
+#include "enc_profile.h"
 
 
 static const short bx0[5][4] = {{0,0,0,0}, {0,0,0,0}, {0,0,0,0}, {0,2,0,0}, {0,2,0,2}};
@@ -355,7 +356,7 @@ void init_motion_search_module (VideoParameters *p_Vid, InputParameters *p_Inp)
 #endif
 
   if (p_Vid->max_num_references)
-    get_mem4Ddistblk (&p_Vid->motion_cost, 8, 2, p_Vid->max_num_references, 4);
+    get_mem_MBcost (p_Vid->motion_cost, 2, p_Vid->max_num_references);
 
   //--- set array offsets ---
   p_Vid->mvbits      += max_mvd;
@@ -549,14 +550,14 @@ clear_motion_search_module (VideoParameters *p_Vid, InputParameters *p_Inp)
 #endif
 
 
-  if (p_Vid->motion_cost)
-    free_mem4Ddistblk (p_Vid->motion_cost);
+  if (p_Vid->motion_cost[0])
+    free_mem_MBcost (p_Vid->motion_cost);
 
   if ((p_Inp->SearchMode[0] == FAST_FULL_SEARCH || p_Inp->SearchMode[1] == FAST_FULL_SEARCH) && (!p_Inp->IntraProfile) )
     clear_fast_full_search (p_Vid);
 }
 
-static inline int mv_bit_cost(Macroblock *currMB, MotionVector **all_mv, int cur_list, short cur_ref, int by, int bx, int step_v0, int step_v, int step_h0, int step_h, int mvd_bits)
+static inline int mv_bit_cost(Macroblock *currMB, MotionVector (*all_mv)[BLOCK_MULTIPLE], int cur_list, short cur_ref, int by, int bx, int step_v0, int step_v, int step_h0, int step_h, int mvd_bits)
 {
   int v, h;
   MotionVector predMV;
@@ -615,8 +616,8 @@ distblk BPredPartitionCost (Macroblock *currMB,
   short block_size_x = block_size[blocktype][0];
   short block_size_y = block_size[blocktype][1];
 
-  MotionVector  **all_mv_l0 = currSlice->bipred_mv[list][LIST_0][ref_l0][blocktype]; 
-  MotionVector  **all_mv_l1 = currSlice->bipred_mv[list][LIST_1][ref_l1][blocktype]; 
+  MotionVector  (*all_mv_l0)[BLOCK_MULTIPLE] = currSlice->bipred_mv[list][LIST_0][ref_l0][blocktype]; 
+  MotionVector  (*all_mv_l1)[BLOCK_MULTIPLE] = currSlice->bipred_mv[list][LIST_1][ref_l1][blocktype]; 
   imgpel  **mb_pred    = currSlice->mb_pred[0];
 
   // List0 
@@ -766,6 +767,9 @@ void init_mv_block(Macroblock *currMB, MEBlock *mv_block, short blocktype, int l
     mv_block->computeBiPredHPel = p_Vid->computeBiPred1[H_PEL];
     mv_block->computeBiPredQPel = p_Vid->computeBiPred1[Q_PEL];
   }
+
+  if (p_Vid->enc_profile)
+    enc_profile_count_candidates(mv_block);
 }
 
 /*!
@@ -883,7 +887,7 @@ BlockMotionSearch (Macroblock *currMB,      //!< Current Macroblock
   short ref = mv_block->ref_idx;
   MotionVector *mv = &mv_block->mv[list], pred; 
 
-  MotionVector **all_mv = &currSlice->all_mv[list][ref][blocktype][block_y];
+  MotionVector (*all_mv)[BLOCK_MULTIPLE] = &currSlice->all_mv[list][ref][blocktype][block_y];
 
   distblk *prevSad = (p_Inp->SearchMode[p_Vid->view_id] == EPZS)? currSlice->p_EPZS->distortion[list + currMB->list_offset][blocktype - 1]: NULL;
 
@@ -1020,6 +1024,9 @@ BlockMotionSearch (Macroblock *currMB,      //!< Current Macroblock
     BiPredBlockMotionSearch(currMB, mv_block, &pred, mb_x, mb_y, lambda_factor);
   }
 
+  if (p_Vid->enc_profile)
+    enc_profile_me(p_Vid->enc_profile, mv_block);
+
   return min_mcost;
 }
 
@@ -1043,7 +1050,7 @@ static distblk BiPredBlockMotionSearch(Macroblock   *currMB,      //!< Current M
   int         list = mv_block->list;
   int         i, j;
   short       bipred_type = list ? 0 : 1;
-  MotionVector ***** bipred_mv = currSlice->bipred_mv[bipred_type];
+  MBMotionVectors **bipred_mv = currSlice->bipred_mv[bipred_type];
   distblk     min_mcostbi = DISTBLK_MAX;
   MotionVector *mv = &mv_block->mv[list];
   MotionVector bimv, tempmv;
@@ -1183,8 +1190,8 @@ distblk BIDPartitionCost (Macroblock *currMB,
   short block_size_x = block_size[blocktype][0]; // this is the same as step_h and could be removed
   short block_size_y = block_size[blocktype][1]; // this is the same as step_v and could be removed
 
-  MotionVector **all_mv_l0 = currSlice->all_mv [LIST_0][(int) cur_ref[LIST_0]][blocktype];
-  MotionVector **all_mv_l1 = currSlice->all_mv [LIST_1][(int) cur_ref[LIST_1]][blocktype];
+  MotionVector (*all_mv_l0)[BLOCK_MULTIPLE] = currSlice->all_mv [LIST_0][(int) cur_ref[LIST_0]][blocktype];
+  MotionVector (*all_mv_l1)[BLOCK_MULTIPLE] = currSlice->all_mv [LIST_1][(int) cur_ref[LIST_1]][blocktype];
   short bipred_me =  0; //no bipred for this case 
   imgpel  **mb_pred = currSlice->mb_pred[0];
   int   list_mode[2];
@@ -1336,7 +1343,7 @@ void FindSkipModeMotionVector (Macroblock *currMB)
   VideoParameters *p_Vid = currMB->p_Vid;
   PicMotionParams **motion = p_Vid->enc_picture->mv_info;
   int   bx, by;
-  MotionVector **all_mv = currSlice->all_mv[0][0][0];
+  MotionVector (*all_mv)[BLOCK_MULTIPLE] = currSlice->all_mv[0][0][0];
 
   MotionVector pmv;
 
@@ -1575,6 +1582,7 @@ void PartitionMotionSearch (Macroblock *currMB,
   int64 me_tmp_time;
   gettime( &me_time_start );    // start time ms
 #endif
+  ENC_PROFILE_START(p_Vid, EPROF_ME);
 
   if (currSlice->rdoq_motion_copy == 1)
   {
@@ -1598,7 +1606,7 @@ void PartitionMotionSearch (Macroblock *currMB,
     {
       for (ref=0; ref < currSlice->listXsize[list+list_offset]; ref++)
       {
-        m_cost = &p_Vid->motion_cost[blocktype][list][ref][block8x8];
+        m_cost = &p_Vid->motion_cost[list][ref][blocktype][block8x8];
 
         //===== LOOP OVER SUB MACRO BLOCK partitions
         updateMV_mp(currMB, m_cost, ref, list, bx, by, blocktype, block8x8);
@@ -1651,7 +1659,7 @@ void PartitionMotionSearch (Macroblock *currMB,
         for (ref=0; ref < currSlice->listXsize[list+list_offset]; ref++) 
         {
             mv_block.ref_idx = (char) ref;
-            m_cost = &p_Vid->motion_cost[blocktype][list][ref][block8x8];
+            m_cost = &p_Vid->motion_cost[list][ref][blocktype][block8x8];
 
             {
               //----- set search range ---
@@ -1675,6 +1683,7 @@ void PartitionMotionSearch (Macroblock *currMB,
   p_Vid->me_tot_time += me_tmp_time;
   p_Vid->me_time += me_tmp_time;
 #endif
+  ENC_PROFILE_STOP(p_Vid, EPROF_ME);
 }
 
 /*!
@@ -1698,6 +1707,7 @@ void SubPartitionMotionSearch (Macroblock *currMB,
   int64 me_tmp_time;
   gettime( &me_time_start );    // start time ms
 #endif
+  ENC_PROFILE_START(p_Vid, EPROF_ME);
 
   if (currSlice->rdoq_motion_copy == 1)
   {
@@ -1725,7 +1735,7 @@ void SubPartitionMotionSearch (Macroblock *currMB,
     {
       for (ref=0; ref < currSlice->listXsize[list+list_offset]; ref++)
       {
-        m_cost = &p_Vid->motion_cost[blocktype][list][ref][block8x8];
+        m_cost = &p_Vid->motion_cost[list][ref][blocktype][block8x8];
 
         //===== LOOP OVER SUB MACRO BLOCK partitions
         for (v=by; v<by + step_v0; v += step_v)
@@ -1799,7 +1809,7 @@ void SubPartitionMotionSearch (Macroblock *currMB,
       for (ref=0; ref < currSlice->listXsize[list+list_offset]; ref++)
       {
           mv_block.ref_idx = (char) ref;
-          m_cost = &p_Vid->motion_cost[blocktype][list][ref][block8x8];
+          m_cost = &p_Vid->motion_cost[list][ref][blocktype][block8x8];
           //----- set search range ---
           get_search_range(&mv_block, p_Inp, ref, blocktype);
 
@@ -1856,6 +1866,7 @@ void SubPartitionMotionSearch (Macroblock *currMB,
   p_Vid->me_tot_time += me_tmp_time;
   p_Vid->me_time += me_tmp_time;
 #endif
+  ENC_PROFILE_STOP(p_Vid, EPROF_ME);
 }
 
 
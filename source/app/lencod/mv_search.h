@@ -71,6 +71,26 @@ static inline MotionVector pad_MVs(MotionVector mv0, MEBlock *mv_block)
   return (mv0);
 }
 
+/*!
+ ************************************************************************
+ * \brief
+ *    Index of the full pel offset (dx, dy) in the spiral search pattern
+ *    (spiral_search, spiral_qpel_search)
+ ************************************************************************
+ */
+static inline int spiral_search_pos(int dx, int dy)
+{
+  int l = imax(iabs(dx), iabs(dy));
+  int ring = (2 * l - 1) * (2 * l - 1);
+
+  if (l == 0)
+    return 0;
+  else if (iabs(dx) < l) // top and bottom line of the ring
+    return ring + 2 * (dx + l - 1) + (dy > 0);
+  else                   // left and right column of the ring
+    return ring + 2 * (2 * l - 1) + 2 * (dy + l) + (dx > 0);
+}
+
 static inline int64 overflow_weight_cost(int lambda, int bits)
 {  
 #if JCOST_CALC_SCALEUP  
@@ -17,6 +17,7 @@
 #include "image.h"
 #include "input.h"
 #include "output.h"
+#include "enc_profile.h"
 
 /*!
  ************************************************************************
@@ -450,6 +451,7 @@ void flush_direct_output(VideoParameters *p_Vid, FrameFormat *output, int p_out)
  */
 void write_stored_frame( VideoParameters *p_Vid, FrameStore *fs, FrameFormat *output, int p_out)
 {
+  ENC_PROFILE_START(p_Vid, EPROF_OUTPUT);
   // make sure no direct output field is pending
   flush_direct_output(p_Vid, output, p_out);
 
@@ -463,6 +465,7 @@ void write_stored_frame( VideoParameters *p_Vid, FrameStore *fs, FrameFormat *ou
   }
 
   fs->is_output = 1;
+  ENC_PROFILE_STOP(p_Vid, EPROF_OUTPUT);
 }
 
 
@@ -488,8 +491,10 @@ void direct_output(VideoParameters *p_Vid, StorablePicture *p, FrameFormat *outp
   case FRAME:
     // we have a frame (or complementary field pair)
     // so output it directly
+    ENC_PROFILE_START(p_Vid, EPROF_OUTPUT);
     flush_direct_output(p_Vid, output, p_out);
     write_picture (p, output, p_out);
+    ENC_PROFILE_STOP(p_Vid, EPROF_OUTPUT);
     free_storable_picture(p_Vid, p);
     return;
     break;
@@ -514,7 +519,9 @@ void direct_output(VideoParameters *p_Vid, StorablePicture *p, FrameFormat *outp
   {
     // we have both fields, so output them
     dpb_combine_field_yuv(p_Vid, p_Vid->out_buffer);
+    ENC_PROFILE_START(p_Vid, EPROF_OUTPUT);
     write_picture (p_Vid->out_buffer->frame, output, p_out);
+    ENC_PROFILE_STOP(p_Vid, EPROF_OUTPUT);
     free_storable_picture(p_Vid, p_Vid->out_buffer->frame);
     p_Vid->out_buffer->frame = NULL;
     free_storable_picture(p_Vid, p_Vid->out_buffer->top_field);
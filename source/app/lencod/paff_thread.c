@@ -0,0 +1,406 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    paff_thread.c
+ * \brief
+ *    Concurrent frame/field candidates of picture adaptive frame/field
+ *    coding (PicInterlace = 2). The frame candidate is encoded by a
+ *    worker thread on a private copy of the VideoParameters while the
+ *    calling thread encodes the top field. The worker is started once
+ *    and waits for the pictures. Each candidate codes its
+ *    own slices with their own entropy coding state. The calling
+ *    thread waits for the worker before the top field is stored in the
+ *    DPB, which the frame candidate still references, and encodes the
+ *    bottom field afterwards. The worker lists its references through
+ *    copies of the short term frame stores, as both candidates set
+ *    their frame_num_wrap. The candidate that loses the picture
+ *    structure decision is discarded as in the serial encoder; the
+ *    adaptive rounding offsets of the winner are kept.
+ ***********************************************************************
+ */
+
+#include "global.h"
+#include "paff_thread.h"
+#include "image.h"
+#include "macroblock.h"
+#include "memalloc.h"
+#include "sei.h"
+#include "slice.h"
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    allocates the private buffers of the frame candidate
+ ***********************************************************************
+ */
+static void alloc_paff_buffers(PaffThread *pt, VideoParameters *p_Vid)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  int max_bitdepth = imax(p_Inp->output.bit_depth[0], p_Inp->output.bit_depth[1]);
+  int max_qp = (3 + 6*(max_bitdepth));
+  int qp_scale = p_Vid->bitdepth_luma_qp_scale;
+
+  if ((pt->mb_data = alloc_mbs(p_Vid, p_Vid->FrameSizeInMbs, p_Vid->num_of_layers)) == NULL)
+    no_mem_exit("alloc_paff_buffers: pt->mb_data");
+  if ((pt->b8x8info = (Block8x8Info *) calloc(1, sizeof(Block8x8Info))) == NULL)
+    no_mem_exit("alloc_paff_buffers: pt->b8x8info");
+  if (p_Vid->intra_block && (pt->intra_block = (short *) calloc(p_Vid->FrameSizeInMbs, sizeof(short))) == NULL)
+    no_mem_exit("alloc_paff_buffers: pt->intra_block");
+  if (p_Vid->mb16x16_cost_frame && (pt->mb16x16_cost_frame = (double *) calloc(p_Vid->FrameSizeInMbs, sizeof(double))) == NULL)
+    no_mem_exit("alloc_paff_buffers: pt->mb16x16_cost_frame");
+
+  get_mem2D((byte***) &pt->ipredmode, p_Vid->height_blk, p_Vid->width_blk);
+  get_mem2D((byte***) &pt->ipredmode8x8, p_Vid->height_blk, p_Vid->width_blk);
+  memset(&pt->ipredmode[0][0], -1, p_Vid->height_blk * p_Vid->width_blk * sizeof(char));
+  memset(&pt->ipredmode8x8[0][0], -1, p_Vid->height_blk * p_Vid->width_blk * sizeof(char));
+  get_mem3Dint(&pt->nz_coeff, p_Vid->FrameSizeInMbs, 4, 4 + p_Vid->num_blk8x8_uv);
+
+  get_mem2Dolm    (&pt->lambda   , 10, 52 + qp_scale, qp_scale);
+  get_mem2Dodouble(&pt->lambda_md, 10, 52 + qp_scale, qp_scale);
+  get_mem3Dodouble(&pt->lambda_me, 10, 52 + qp_scale, 3, qp_scale);
+  get_mem3Doint   (&pt->lambda_mf, 10, 52 + qp_scale, 3, qp_scale);
+  if (p_Inp->UseRDOQuant)
+    get_mem2Dodouble(&pt->lambda_rdoq, 10, 52 + qp_scale, qp_scale);
+  if (p_Inp->CtxAdptLagrangeMult == 1)
+    get_mem2Dodouble(&pt->lambda_mf_factor, 10, 52 + qp_scale, qp_scale);
+
+  if (p_Vid->ARCofAdj4x4)
+  {
+    int planes = (p_Vid->yuv_format != YUV400) ? 3 : 1;
+    get_mem4Dint(&pt->ARCofAdj4x4, planes, MAXMODE, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+    get_mem4Dint(&pt->ARCofAdj8x8, (p_Vid->yuv_format != YUV400 && p_Vid->P444_joined) ? 3 : 1, MAXMODE, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+  }
+  if (p_Vid->wp_weights)
+  {
+    get_mem4Dshort(&pt->wp_weights, 3, 2, MAX_REFERENCE_PICTURES, p_Vid->num_slices_wp);
+    get_mem4Dshort(&pt->wp_offsets, 3, 2, MAX_REFERENCE_PICTURES, p_Vid->num_slices_wp);
+    get_mem5Dshort(&pt->wbp_weight, 3, 2, MAX_REFERENCE_PICTURES, MAX_REFERENCE_PICTURES, p_Vid->num_slices_wp);
+  }
+  if (p_Vid->motion_cost[0])
+    get_mem_MBcost(pt->motion_cost, 2, p_Vid->max_num_references);
+  if (p_Vid->imgY_sub_tmp)
+  {
+    MemTag mem_tag = mem_set_tag(MEM_SUBPEL);
+    get_mem2Dint_pad(&pt->imgY_sub_tmp, p_Vid->height, p_Vid->width, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
+    mem_set_tag(mem_tag);
+  }
+  pt->slice_pool = alloc_slice_pool();
+
+  if ((pt->fs_ref = (FrameStore **) calloc(p_Vid->p_Dpb_layer[0]->size, sizeof(FrameStore *))) == NULL)
+    no_mem_exit("alloc_paff_buffers: pt->fs_ref");
+  if ((pt->fs_ref_copy = (FrameStore *) calloc(p_Vid->p_Dpb_layer[0]->size, sizeof(FrameStore))) == NULL)
+    no_mem_exit("alloc_paff_buffers: pt->fs_ref_copy");
+
+  // the q matrices are computed for each picture, the offsets are taken over at dispatch
+  memcpy(&pt->quant, p_Vid->p_Quant, sizeof(QuantParameters));
+  get_mem5Dquant(&pt->quant.q_params_4x4, 3, 2, max_qp + 1, 4, 4);
+  get_mem5Dquant(&pt->quant.q_params_8x8, 3, 2, max_qp + 1, 8, 8);
+  get_mem3Dshort(&pt->quant.OffsetList4x4, p_Inp->AdaptRoundingFixed ? 1 : max_qp + 1, 25, 16);
+  get_mem3Dshort(&pt->quant.OffsetList8x8, p_Inp->AdaptRoundingFixed ? 1 : max_qp + 1, 15, 64);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    frees the private buffers of the frame candidate
+ ***********************************************************************
+ */
+static void free_paff_buffers(PaffThread *pt, VideoParameters *p_Vid)
+{
+  int qp_scale = p_Vid->bitdepth_luma_qp_scale;
+
+  free_mbs(pt->mb_data, p_Vid->FrameSizeInMbs);
+  free(pt->b8x8info);
+  free(pt->intra_block);
+  free(pt->mb16x16_cost_frame);
+  free_mem2D((byte**) pt->ipredmode);
+  free_mem2D((byte**) pt->ipredmode8x8);
+  free_mem3Dint(pt->nz_coeff);
+
+  free_mem2Dolm    (pt->lambda, qp_scale);
+  free_mem2Dodouble(pt->lambda_md, qp_scale);
+  free_mem3Dodouble(pt->lambda_me, 10, 52 + qp_scale, qp_scale);
+  free_mem3Doint   (pt->lambda_mf, 10, 52 + qp_scale, qp_scale);
+  if (pt->lambda_rdoq)
+    free_mem2Dodouble(pt->lambda_rdoq, qp_scale);
+  if (pt->lambda_mf_factor)
+    free_mem2Dodouble(pt->lambda_mf_factor, qp_scale);
+
+  if (pt->ARCofAdj4x4)
+  {
+    free_mem4Dint(pt->ARCofAdj4x4);
+    free_mem4Dint(pt->ARCofAdj8x8);
+  }
+  if (pt->wp_weights)
+  {
+    free_mem4Dshort(pt->wp_weights);
+    free_mem4Dshort(pt->wp_offsets);
+    free_mem5Dshort(pt->wbp_weight);
+  }
+  if (pt->motion_cost[0])
+    free_mem_MBcost(pt->motion_cost);
+  if (pt->imgY_sub_tmp)
+    free_mem2Dint_pad(pt->imgY_sub_tmp, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
+  free(pt->MapUnitToSliceGroupMap);
+  free(pt->MBAmap);
+  free_slice_pool(pt->slice_pool);
+  free(pt->fs_ref);
+  free(pt->fs_ref_copy);
+
+  free_mem5Dquant(pt->quant.q_params_4x4);
+  free_mem5Dquant(pt->quant.q_params_8x8);
+  free_mem3Dshort(pt->quant.OffsetList4x4);
+  free_mem3Dshort(pt->quant.OffsetList8x8);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    copies the adaptive rounding offsets from one quantizer to another
+ ***********************************************************************
+ */
+static void copy_offsets(QuantParameters *dst, QuantParameters *src, InputParameters *p_Inp)
+{
+  int max_bitdepth = imax(p_Inp->output.bit_depth[0], p_Inp->output.bit_depth[1]);
+  int offsets = p_Inp->AdaptRoundingFixed ? 1 : (3 + 6*(max_bitdepth)) + 1;
+
+  memcpy(&dst->OffsetList4x4[0][0][0], &src->OffsetList4x4[0][0][0], offsets * 25 * 16 * sizeof(short));
+  memcpy(&dst->OffsetList8x8[0][0][0], &src->OffsetList8x8[0][0][0], offsets * 15 * 64 * sizeof(short));
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    points the short term references of the worker DPB to copies of
+ *    the frame stores; the pictures themselves are shared
+ ***********************************************************************
+ */
+static void copy_ref_frames(PaffThread *pt, DecodedPictureBuffer *p_Dpb)
+{
+  unsigned int i;
+
+  for (i = 0; i < p_Dpb->ref_frames_in_buffer; i++)
+  {
+    memcpy(&pt->fs_ref_copy[i], p_Dpb->fs_ref[i], sizeof(FrameStore));
+    pt->fs_ref[i] = &pt->fs_ref_copy[i];
+  }
+  pt->dpb.fs_ref = pt->fs_ref;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    worker thread: encodes the frame candidate of each dispatched
+ *    picture
+ ***********************************************************************
+ */
+static void paff_worker(void *arg)
+{
+  PaffThread *pt = (PaffThread *) arg;
+
+  mutex_lock(&pt->lock);
+  while (!pt->quit)
+  {
+    if (!pt->busy)
+    {
+      cond_wait(&pt->cond, &pt->lock);
+      continue;
+    }
+    mutex_unlock(&pt->lock);
+
+    frame_picture(pt->p_Vid, pt->p_Vid->frame_pic[0], &pt->p_Vid->imgData, 0);
+
+    mutex_lock(&pt->lock);
+    pt->busy = 0;
+    cond_broadcast(&pt->cond);
+  }
+  mutex_unlock(&pt->lock);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    enables concurrent frame/field candidates if requested and
+ *    possible with the encoder configuration. Tools that keep state
+ *    in buffers that are not duplicated for the worker, or that pass
+ *    state from the frame to the field candidate, stay serial.
+ ***********************************************************************
+ */
+void init_paff_thread(VideoParameters *p_Vid)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  PaffThread *pt;
+
+  // profiling and tracing need the pictures in coding order
+  if (p_Inp->PAFFThreads <= 0 || p_Inp->PicInterlace != ADAPTIVE_CODING || p_Vid->num_of_layers != 1 || p_Vid->enc_profile != NULL || TRACE)
+    return;
+
+  if (p_Inp->RCEnable || p_Inp->RDPictureDecision || p_Inp->RDPictureDeblocking || p_Inp->rdopt == 3 || p_Inp->redundant_pic_flag
+    || p_Inp->WeightedPrediction || p_Inp->WeightedBiprediction || p_Inp->WPMCPrecision || p_Inp->RestrictRef || p_Inp->RandomIntraMBRefresh
+    || p_Inp->partition_mode || p_Inp->sp_periodicity || p_Inp->si_frame_indicator || p_Inp->separate_colour_plane_flag
+    || p_Inp->HMEEnable || p_Inp->DistortionYUVtoRGB)
+    return;
+
+  // MBAFF sets the sub-pel and chroma offsets of the reference fields shared by both candidates
+  if (p_Inp->MbInterlace)
+    return;
+
+  // the fast motion searches keep per picture state in the VideoParameters
+  if (p_Inp->SearchMode[0] != EPZS && p_Inp->SearchMode[0] != FULL_SEARCH)
+    return;
+
+  if ((pt = (PaffThread *) calloc(1, sizeof(PaffThread))) == NULL)
+    no_mem_exit("init_paff_thread: pt");
+  if ((pt->p_Vid = (VideoParameters *) calloc(1, sizeof(VideoParameters))) == NULL)
+    no_mem_exit("init_paff_thread: pt->p_Vid");
+
+  alloc_paff_buffers(pt, p_Vid);
+  mutex_init(&pt->lock);
+  cond_init(&pt->cond);
+  if (thread_create(&pt->thread, paff_worker, pt))
+    error("init_paff_thread: cannot create frame/field thread", 500);
+  p_Vid->p_PaffThread = pt;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    stops the frame candidate thread and frees its resources
+ ***********************************************************************
+ */
+void free_paff_thread(VideoParameters *p_Vid)
+{
+  PaffThread *pt = p_Vid->p_PaffThread;
+
+  if (pt == NULL)
+    return;
+
+  paff_thread_join(p_Vid);
+
+  mutex_lock(&pt->lock);
+  pt->quit = 1;
+  cond_broadcast(&pt->cond);
+  mutex_unlock(&pt->lock);
+  thread_join(pt->thread);
+  mutex_destroy(&pt->lock);
+  cond_destroy(&pt->cond);
+  free_paff_buffers(pt, p_Vid);
+  free(pt->p_Vid);
+  free(pt);
+  p_Vid->p_PaffThread = NULL;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    starts encoding the frame candidate of the current picture on the
+ *    worker thread; returns without waiting for it
+ ***********************************************************************
+ */
+void paff_thread_dispatch(VideoParameters *p_Vid)
+{
+  PaffThread *pt = p_Vid->p_PaffThread;
+  VideoParameters *p_Job = pt->p_Vid;
+
+  paff_thread_join(p_Vid);
+
+  copy_offsets(&pt->quant, p_Vid->p_Quant, p_Vid->p_Inp);
+  if (pt->mb16x16_cost_frame)
+    memcpy(pt->mb16x16_cost_frame, p_Vid->mb16x16_cost_frame, p_Vid->FrameSizeInMbs * sizeof(double));
+  memcpy(&pt->stats, p_Vid->p_Stats, sizeof(StatParameters));
+  memcpy(&pt->dist, p_Vid->p_Dist, sizeof(DistortionParams));
+  memcpy(&pt->dpb, p_Vid->p_Dpb_layer[0], sizeof(DecodedPictureBuffer));
+  pt->me_time = p_Vid->me_time;
+
+  memcpy(p_Job, p_Vid, sizeof(VideoParameters));
+  p_Job->p_PaffThread       = NULL;
+  p_Job->p_Stats            = &pt->stats;
+  p_Job->p_Dist             = &pt->dist;
+  p_Job->p_Quant            = &pt->quant;
+  p_Job->p_Dpb_layer[0]     = &pt->dpb;
+  p_Job->mb_data            = pt->mb_data;
+  p_Job->b8x8info           = pt->b8x8info;
+  p_Job->intra_block        = pt->intra_block;
+  p_Job->mb16x16_cost_frame = pt->mb16x16_cost_frame;
+  p_Job->ipredmode          = pt->ipredmode;
+  p_Job->ipredmode8x8       = pt->ipredmode8x8;
+  p_Job->nz_coeff           = pt->nz_coeff;
+  p_Job->lambda             = pt->lambda;
+  p_Job->lambda_md          = pt->lambda_md;
+  p_Job->lambda_me          = pt->lambda_me;
+  p_Job->lambda_mf          = pt->lambda_mf;
+  p_Job->lambda_rdoq        = pt->lambda_rdoq;
+  p_Job->lambda_mf_factor   = pt->lambda_mf_factor;
+  p_Job->ARCofAdj4x4        = pt->ARCofAdj4x4;
+  p_Job->ARCofAdj8x8        = pt->ARCofAdj8x8;
+  p_Job->wp_weights         = pt->wp_weights;
+  p_Job->wp_offsets         = pt->wp_offsets;
+  p_Job->wbp_weight         = pt->wbp_weight;
+  p_Job->motion_cost[0]     = pt->motion_cost[0];
+  p_Job->motion_cost[1]     = pt->motion_cost[1];
+  p_Job->imgY_sub_tmp       = pt->imgY_sub_tmp;
+  p_Job->MapUnitToSliceGroupMap = pt->MapUnitToSliceGroupMap;
+  p_Job->MBAmap             = pt->MBAmap;
+  p_Job->p_SlicePool        = pt->slice_pool;
+  pt->dpb.p_Vid             = p_Job;
+  copy_ref_frames(pt, p_Vid->p_Dpb_layer[0]);
+
+  // the frame based marking commands belong to the frame candidate, the fields start without
+  p_Vid->dec_ref_pic_marking_buffer = NULL;
+  p_Vid->rd_pass = 0;
+
+  pt->pending = 1;
+
+  mutex_lock(&pt->lock);
+  pt->busy = 1;
+  cond_broadcast(&pt->cond);
+  mutex_unlock(&pt->lock);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    waits for the frame candidate, if it is still being encoded
+ ***********************************************************************
+ */
+void paff_thread_join(VideoParameters *p_Vid)
+{
+  PaffThread *pt = p_Vid->p_PaffThread;
+  VideoParameters *p_Job;
+
+  if (pt == NULL || !pt->pending)
+    return;
+
+  p_Job = pt->p_Vid;
+  mutex_lock(&pt->lock);
+  while (pt->busy)
+    cond_wait(&pt->cond, &pt->lock);
+  mutex_unlock(&pt->lock);
+  pt->pending = 0;
+
+  p_Vid->me_time += p_Job->me_time - pt->me_time;
+
+  free_drpm_buffer(p_Job->dec_ref_pic_marking_buffer);
+  p_Job->dec_ref_pic_marking_buffer = NULL;
+
+  // FmoInit() reallocates the slice group maps for each picture
+  pt->MapUnitToSliceGroupMap = p_Job->MapUnitToSliceGroupMap;
+  pt->MBAmap                 = p_Job->MBAmap;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    takes over the adaptive rounding offsets of the frame candidate
+ *    if it has won the picture structure decision
+ ***********************************************************************
+ */
+void paff_thread_merge(VideoParameters *p_Vid)
+{
+  PaffThread *pt = p_Vid->p_PaffThread;
+
+  paff_thread_join(p_Vid);
+
+  if (!p_Vid->fld_flag)
+    copy_offsets(p_Vid->p_Quant, &pt->quant, p_Vid->p_Inp);
+}
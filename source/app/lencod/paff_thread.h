@@ -0,0 +1,70 @@
+/*!
+ **************************************************************************
+ *  \file paff_thread.h
+ *
+ *  \brief
+ *     Concurrent encoding of the frame and the field candidate of picture
+ *     adaptive frame/field coding (enabled with the PAFFThreads parameter)
+ *
+ **************************************************************************
+ */
+
+#ifndef _PAFF_THREAD_H_
+#define _PAFF_THREAD_H_
+#include "global.h"
+#include "mbuffer.h"
+#include "enc_statistics.h"
+#include "quant_params.h"
+
+//! frame candidate encoded by a worker thread while the calling thread encodes the top field
+typedef struct paff_thread
+{
+  VideoParameters      *p_Vid;                //!< private copy of the encoder state the frame is encoded with
+  ThreadHandle          thread;
+  ThreadMutex           lock;                 //!< protects busy and quit
+  ThreadCond            cond;                 //!< signals a dispatched frame to the worker and its completion to the caller
+  int                   busy;                 //!< the frame has been dispatched and not encoded yet
+  int                   quit;
+  int                   pending;              //!< the frame has been dispatched and not joined yet
+  int64                 me_time;              //!< motion estimation time of the calling thread at dispatch
+
+  DecodedPictureBuffer  dpb;                  //!< DPB of the worker: memory management commands go to its p_Vid
+  FrameStore          **fs_ref;               //!< short term reference frames of the worker DPB
+  FrameStore           *fs_ref_copy;          //!< copies of the short term frame stores, the worker sets their frame_num_wrap
+
+  // buffers written while a picture is encoded, private to the job
+  StatParameters        stats;
+  DistortionParams      dist;
+  QuantParameters       quant;
+  Macroblock           *mb_data;
+  Block8x8Info         *b8x8info;
+  short                *intra_block;
+  double               *mb16x16_cost_frame;
+  char                **ipredmode;
+  char                **ipredmode8x8;
+  int                ***nz_coeff;
+  LambdaParams        **lambda;
+  double              **lambda_md;
+  double             ***lambda_me;
+  int                ***lambda_mf;
+  double              **lambda_rdoq;
+  double              **lambda_mf_factor;
+  int               ****ARCofAdj4x4;
+  int               ****ARCofAdj8x8;
+  short             ****wp_weights;
+  short             ****wp_offsets;
+  short            *****wbp_weight;
+  MBMotionCosts       *motion_cost[2];
+  int                 **imgY_sub_tmp;
+  byte                 *MapUnitToSliceGroupMap;
+  byte                 *MBAmap;
+  struct slice_pool    *slice_pool;
+} PaffThread;
+
+extern void init_paff_thread    (VideoParameters *p_Vid);
+extern void free_paff_thread    (VideoParameters *p_Vid);
+extern void paff_thread_dispatch(VideoParameters *p_Vid);
+extern void paff_thread_join    (VideoParameters *p_Vid);
+extern void paff_thread_merge   (VideoParameters *p_Vid);
+
+#endif
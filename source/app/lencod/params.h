@@ -71,6 +71,7 @@ struct inp_par_enc
   int num_of_views;                     //!< number of views to encode (1=1view, 2=2views)
 #if (MVC_EXTENSION_ENABLE)
   char View1ConfigName[FILE_NAME_SIZE];    //!<Filename for View1 configuration
+  int ViewThreads;                      //!< encode the non-base view concurrently with the next base view picture
   int EnhLayerDFDisableIdc[2][NUM_SLICE_TYPES];
   int EnhLayerDFAlpha     [2][NUM_SLICE_TYPES];
   int EnhLayerDFBeta      [2][NUM_SLICE_TYPES];
@@ -89,6 +90,8 @@ struct inp_par_enc
   char ReconFile2    [FILE_NAME_SIZE];  //!< Reconstructed Pictures (view 1)
   char TraceFile     [FILE_NAME_SIZE];  //!< Trace Outputs
   char StatsFile     [FILE_NAME_SIZE];  //!< Stats File
+  char ProfileFile   [FILE_NAME_SIZE];  //!< Per module timing and ME statistics (JSON)
+  char MemoryFile    [FILE_NAME_SIZE];  //!< Current and peak memory per subsystem (JSON)
   char QmatrixFile   [FILE_NAME_SIZE];  //!< Q matrix cfg file
   int  ProcessInput;                    //!< Filter Input Sequence
   int  EnableOpenGOP;                   //!< support for open gops.
@@ -226,15 +229,21 @@ struct inp_par_enc
   int nobskip;
   int BiasSkipRDO;
   int ForceTrueRateRDO;
+  int ComplexityControl;      //!< adapt search range, references, partitions and mode decision to a target encoding frame rate
+  double ComplexityTargetFps; //!< target encoding frame rate of the complexity control (0: FrameRate)
 
 #ifdef _LEAKYBUCKET_
   int  NumberLeakyBuckets;
   char LeakyBucketRateFile[FILE_NAME_SIZE];
   char LeakyBucketParamFile[FILE_NAME_SIZE];
+  int  LeakyBucketOnlineRates;   //!< default rates from the first second instead of the whole sequence
 #endif
 
   int PicInterlace;           //!< picture adaptive frame/field
   int MbInterlace;            //!< macroblock adaptive frame/field
+  int PAFFThreads;            //!< encode the frame and the field candidate of adaptive frame/field coding concurrently
+  int FieldAnalysis;          //!< decide frame or field coding of pictures and MB pairs by analysis of the source where possible
+  int FieldAnalysisMargin;    //!< activity difference in percent above which the analysis decides
   int IntraBottom;            //!< Force Intra Bottom at GOP periods.
 
   // Error resilient RDO parameters
@@ -243,6 +252,7 @@ struct inp_par_enc
   double LossRateC;              //!< assumed loss probablility of partition C, in per cent, used for loss-aware R/D
   int FirstFrameCorrect;      //!< the first frame is encoded under the assumption that it is always correctly received.
   int NoOfDecoders;
+  int DecoderThreads;            //!< number of threads simulating the decoders of the loss-aware R/D optimization
   int ErrorConcealment;       //!< Error concealment method used for loss-aware RDO (0: Copy Concealment)
   int RestrictRef;
   int NumFramesInELSubSeq;
@@ -30,6 +30,7 @@
 #include "q_matrix.h"
 #include "quant4x4.h"
 #include "rdoq.h"
+#include "enc_profile.h"
 
 /*!
  ************************************************************************
@@ -65,6 +66,7 @@ int quant_4x4_trellis(Macroblock *currMB, int **tblock, struct quant_methods *q_
 
   int levelTrellis[16];
 
+  ENC_PROFILE_START(currMB->p_Vid, EPROF_TRELLIS);
   currSlice->rdoq_4x4(currMB, tblock, q_method, levelTrellis);
 
   // Quantization
@@ -112,6 +114,7 @@ int quant_4x4_trellis(Macroblock *currMB, int **tblock, struct quant_methods *q_
 
   *ACL = 0;
 
+  ENC_PROFILE_STOP(currMB->p_Vid, EPROF_TRELLIS);
   return nonzero;
 }
 
@@ -207,6 +210,7 @@ int quant_ac4x4_trellis(Macroblock *currMB, int **tblock, struct quant_methods *
 
   int levelTrellis[16]; 
 
+  ENC_PROFILE_START(currMB->p_Vid, EPROF_TRELLIS);
   currSlice->rdoq_ac4x4(currMB, tblock, q_method, levelTrellis);
 
   // Quantization
@@ -256,6 +260,7 @@ int quant_ac4x4_trellis(Macroblock *currMB, int **tblock, struct quant_methods *
 
   *ACL = 0;
 
+  ENC_PROFILE_STOP(currMB->p_Vid, EPROF_TRELLIS);
   return nonzero;
 }
 
@@ -345,6 +350,7 @@ int quant_dc4x4_trellis(Macroblock *currMB, int **tblock, int qp, int* DCLevel,
 
   int levelTrellis[16];
 
+  ENC_PROFILE_START(currMB->p_Vid, EPROF_TRELLIS);
   currSlice->rdoq_dc(currMB, tblock, qp_per, qp_rem, q_params_4x4, pos_scan, levelTrellis, LUMA_16DC);
 
   // Quantization
@@ -386,6 +392,7 @@ int quant_dc4x4_trellis(Macroblock *currMB, int **tblock, int qp, int* DCLevel,
 
   *DCL = 0;
 
+  ENC_PROFILE_STOP(currMB->p_Vid, EPROF_TRELLIS);
   return nonzero;
 }
 
@@ -26,6 +26,7 @@
 #include "q_matrix.h"
 #include "quant8x8.h"
 #include "rdoq.h"
+#include "enc_profile.h"
 
 /*!
 ************************************************************************
@@ -111,6 +112,7 @@ int quant_8x8_trellis(Macroblock *currMB, int **tblock, struct quant_methods *q_
   int*  ACR = &ACRun[0];
   int   levelTrellis[64];
 
+  ENC_PROFILE_START(currMB->p_Vid, EPROF_TRELLIS);
   rdoq_8x8_CABAC(currMB, tblock, block_x, qp_per, qp_rem, q_params_8x8, p_scan, levelTrellis);
 
   // Quantization
@@ -151,6 +153,7 @@ int quant_8x8_trellis(Macroblock *currMB, int **tblock, struct quant_methods *q_
 
   *ACL = 0;
 
+  ENC_PROFILE_STOP(currMB->p_Vid, EPROF_TRELLIS);
   return nonzero;
 }
 
@@ -190,6 +193,7 @@ int quant_8x8cavlc_trellis(Macroblock *currMB, int **tblock, struct quant_method
 
   int levelTrellis[4][16];
 
+  ENC_PROFILE_START(currMB->p_Vid, EPROF_TRELLIS);
   rdoq_8x8_CAVLC(currMB, tblock, block_y, block_x, qp_per, qp_rem, q_params_8x8, p_scan, levelTrellis);
 
   for (k = 0; k < 4; k++)
@@ -242,6 +246,7 @@ int quant_8x8cavlc_trellis(Macroblock *currMB, int **tblock, struct quant_method
   for(k = 0; k < 4; k++)
     *(ACL[k]) = 0;
 
+  ENC_PROFILE_STOP(currMB->p_Vid, EPROF_TRELLIS);
   return nonzero;
 }
 
@@ -22,6 +22,7 @@
 #include "quant4x4.h"
 #include "quantChroma.h"
 #include "rdoq.h"
+#include "enc_profile.h"
 
 /*!
  ************************************************************************
@@ -54,6 +55,7 @@ int quant_dc2x2_trellis(Macroblock *currMB, int **tblock, int qp, int* DCLevel,
 
   int levelTrellis[16];
 
+  ENC_PROFILE_START(currMB->p_Vid, EPROF_TRELLIS);
   currSlice->rdoq_dc_cr(currMB, tblock,qp_per,qp_rem, q_params_4x4, pos_scan, levelTrellis, CHROMA_DC);
 
   m7 = *tblock;
@@ -97,6 +99,7 @@ int quant_dc2x2_trellis(Macroblock *currMB, int **tblock, int qp, int* DCLevel,
 
   *DCL = 0;
 
+  ENC_PROFILE_STOP(currMB->p_Vid, EPROF_TRELLIS);
   return nonzero;
 }
 
@@ -131,6 +134,7 @@ int quant_dc4x2_trellis(Macroblock *currMB, int **tblock, int qp, int* DCLevel,
 
   int levelTrellis[16];
 
+  ENC_PROFILE_START(currMB->p_Vid, EPROF_TRELLIS);
   currSlice->rdoq_dc_cr(currMB, tblock,qp_per,qp_rem, q_params_4x4,pos_scan, levelTrellis, CHROMA_DC_2x4);
 
   for (coeff_ctr=0; coeff_ctr < 8; coeff_ctr++)
@@ -172,6 +176,7 @@ int quant_dc4x2_trellis(Macroblock *currMB, int **tblock, int qp, int* DCLevel,
 
   *DCL = 0;
 
+  ENC_PROFILE_STOP(currMB->p_Vid, EPROF_TRELLIS);
   return nonzero;
 }
 
@@ -188,11 +188,16 @@ void setupDistCost(Slice *currSlice, InputParameters *p_Inp)
  *    create structure for RD-optimized mode decision
  ************************************************************************
  */
-void init_rdopt (Slice *currSlice)
+void alloc_rdopt (Slice *currSlice)
 {
   VideoParameters *p_Vid = currSlice->p_Vid;
   InputParameters *p_Inp = currSlice->p_Inp; 
-  RDOPTStructure  *p_RDO = currSlice->p_RDO;
+  RDOPTStructure  *p_RDO;
+  MemTag mem_tag = mem_set_tag(MEM_RDO);
+
+  if (((currSlice->p_RDO)  = (RDOPTStructure *) calloc(1, sizeof(RDOPTStructure)))==NULL) 
+    no_mem_exit("alloc_rdopt: p_RDO");
+  p_RDO = currSlice->p_RDO;
 
   get_mem_DCcoeff (&p_RDO->cofDC);
   get_mem_ACcoeff (p_Vid, &p_RDO->cofAC);
@@ -237,6 +242,33 @@ void init_rdopt (Slice *currSlice)
     p_RDO->cofAC4x4CbCr[1] = p_RDO->cofAC4x4CbCrintern[0][1][0];    
   }
 
+  // structure for saving the coding state
+  p_RDO->cs_mb  = create_coding_state (p_Inp);
+  p_RDO->cs_b8  = create_coding_state (p_Inp);
+  p_RDO->cs_cm  = create_coding_state (p_Inp);
+  p_RDO->cs_tmp = create_coding_state (p_Inp);
+
+  mem_set_tag(mem_tag);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    initialize structure for RD-optimized mode decision of a new slice
+ ************************************************************************
+ */
+void init_rdopt (Slice *currSlice)
+{
+  VideoParameters *p_Vid = currSlice->p_Vid;
+  InputParameters *p_Inp = currSlice->p_Inp; 
+  RDOPTStructure  *p_RDO = currSlice->p_RDO;
+
+  // the buffers may have been used by a previous slice
+  p_RDO->cbp = 0;
+  memset(p_RDO->best8x8, 0, 4 * sizeof(Info8x8));
+  memset(&p_RDO->mode_best, 0, sizeof(BestMode));
+  p_RDO->lambda_mf_factor = 0.0;
+
   currSlice->set_lagrangian_multipliers = p_Inp->rdopt == 0 ? SetLagrangianMultipliersOff : SetLagrangianMultipliersOn;
 
   switch (p_Inp->rdopt)
@@ -268,12 +300,7 @@ void init_rdopt (Slice *currSlice)
     else
       currSlice->set_stored_mb_parameters = set_stored_macroblock_parameters;
   }
-  
-  // structure for saving the coding state
-  p_RDO->cs_mb  = create_coding_state (p_Inp);
-  p_RDO->cs_b8  = create_coding_state (p_Inp);
-  p_RDO->cs_cm  = create_coding_state (p_Inp);
-  p_RDO->cs_tmp = create_coding_state (p_Inp);
+
   if (p_Inp->CtxAdptLagrangeMult == 1)
   {
     p_Vid->mb16x16_cost = CALM_MF_FACTOR_THRESHOLD;
@@ -3153,7 +3180,7 @@ void StoreMVBlock8x8(Slice *currSlice, int dir, int block8x8, int mode, Info8x8
   int j0 = (block8x8 >> 1) << 1;
   int j1 = j0 + 1;
 
-  MotionVector *****all_mv  = currSlice->all_mv;
+  MBMotionVectors **all_mv  = currSlice->all_mv;
   MotionVector **lc_l0_mv8x8 = p_RDO->all_mv8x8[dir][LIST_0];
   MotionVector **lc_l1_mv8x8 = p_RDO->all_mv8x8[dir][LIST_1];
 
@@ -3228,7 +3255,7 @@ void StoreMV8x8(Slice *currSlice, int dir)
 void RestoreMVBlock8x8(Slice *currSlice, int dir, int block8x8, RD_8x8DATA *tr)
 {
   RDOPTStructure  *p_RDO = currSlice->p_RDO;
-  MotionVector *****all_mv  = currSlice->all_mv;
+  MBMotionVectors **all_mv  = currSlice->all_mv;
   MotionVector **lc_l0_mv8x8 = p_RDO->all_mv8x8[dir][LIST_0];
   MotionVector **lc_l1_mv8x8 = p_RDO->all_mv8x8[dir][LIST_1];
 
@@ -3311,8 +3338,8 @@ void StoreNewMotionVectorsBlock8x8(Slice *currSlice, int dir, int block8x8, Info
   int j0 = (block8x8 >> 1) << 1;
   int j1 = j0 + 1;
 
-  MotionVector ****all_mv_l0  = currSlice->all_mv[LIST_0];
-  MotionVector ****all_mv_l1  = currSlice->all_mv[LIST_1];
+  MBMotionVectors *all_mv_l0  = currSlice->all_mv[LIST_0];
+  MBMotionVectors *all_mv_l1  = currSlice->all_mv[LIST_1];
   MotionVector **lc_l0_mv8x8 = &p_RDO->all_mv8x8[dir][LIST_0][j0];
   MotionVector **lc_l1_mv8x8 = &p_RDO->all_mv8x8[dir][LIST_1][j0];
 
@@ -3398,7 +3425,7 @@ void store_8x8_motion_vectors_p_slice(Slice *currSlice, int dir, int block8x8, I
   else
   {
     int j1 = j0 + 1;
-    MotionVector **all_mv_l0  = currSlice->all_mv[LIST_0][(short) B8x8Info->ref[LIST_0]][(short)B8x8Info->mode];
+    MotionVector (*all_mv_l0)[BLOCK_MULTIPLE]  = currSlice->all_mv[LIST_0][(short) B8x8Info->ref[LIST_0]][(short)B8x8Info->mode];
     memcpy(&lc_l0_mv8x8[0][i0], &all_mv_l0[j0][i0], 2 * sizeof(MotionVector));
     memcpy(&lc_l0_mv8x8[1][i0], &all_mv_l0[j1][i0], 2 * sizeof(MotionVector));
     memset(&lc_l1_mv8x8[0][i0], 0, 2 * sizeof(MotionVector));
@@ -3433,8 +3460,8 @@ void store_8x8_motion_vectors_b_slice(Slice *currSlice, int dir, int block8x8, I
   {
     int   mode = B8x8Info->mode;
     int   j1 = j0 + 1;
-    MotionVector ****all_mv_l0  = currSlice->all_mv[LIST_0];
-    MotionVector ****all_mv_l1  = currSlice->all_mv[LIST_1];
+    MBMotionVectors *all_mv_l0  = currSlice->all_mv[LIST_0];
+    MBMotionVectors *all_mv_l1  = currSlice->all_mv[LIST_1];
 
     int bipred_me = B8x8Info->bipred;
     int pdir8     = B8x8Info->pdir;
@@ -3582,7 +3609,7 @@ void assign_enc_picture_params (Macroblock *currMB, int mode, Info8x8 *best, int
   int i,j;
   int block_y, block_x;
   int list;
-  MotionVector **curr_mv = NULL;
+  MotionVector (*curr_mv)[BLOCK_MULTIPLE] = NULL;
   int list_offset = currMB->list_offset;
   VideoParameters *p_Vid  = currMB->p_Vid;
   Slice *currSlice = currMB->p_Slice;
@@ -83,6 +83,7 @@ extern void init_md_best(BestMode  *best);
 
 //============= rate-distortion optimization ===================
 extern void  clear_rdopt (Slice *currSlice);
+extern void  alloc_rdopt (Slice *currSlice);
 extern void  init_rdopt  (Slice *currSlice);
 
 extern void UpdatePixelMap(VideoParameters *p_Vid, InputParameters *p_Inp);
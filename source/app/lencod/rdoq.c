@@ -20,6 +20,7 @@
 #include "rdopt.h"
 #include "rdoq.h"
 #include "mv_search.h"
+#include "enc_profile.h"
 
 #define RDOQ_BASE 0
 
@@ -303,7 +304,9 @@ void trellis_mp(Macroblock *currMB)
     currMB->qp       = (short) p_Vid->qp;
     update_qp (currMB);
 
+    ENC_PROFILE_START(p_Vid, EPROF_MODE_DECISION);
     currSlice->encode_one_macroblock (currMB);
+    ENC_PROFILE_STOP(p_Vid, EPROF_MODE_DECISION);
     end_encode_one_macroblock(currMB);
 
 
@@ -362,7 +365,9 @@ void trellis_sp(Macroblock *currMB)
     }
   }
 
+  ENC_PROFILE_START(p_Vid, EPROF_MODE_DECISION);
   currSlice->encode_one_macroblock (currMB);
+  ENC_PROFILE_STOP(p_Vid, EPROF_MODE_DECISION);
   end_encode_one_macroblock(currMB);
 
   write_macroblock (currMB, 1);    
@@ -25,6 +25,18 @@ static inline imgpel *UMVLine4X (StorablePicture *ref, int y, int x)
   return &(ref->p_curr_img_sub[(y & 0x03)][(x & 0x03)][iClip3( -IMG_PAD_SIZE_Y, ref->size_y_pad, y >> 2)][iClip3(-IMG_PAD_SIZE_X, ref->size_x_pad, x >> 2)]);
 }
 
+/*!
+ ************************************************************************
+ * \brief
+ *    Checks if the num full pel positions x, x + 4, ... on one line are
+ *    not clipped by UMVLine4X, i.e. their pel lines are consecutive
+ ************************************************************************
+ */
+static inline int UMVLine4XConsecutive (StorablePicture *ref, int x, int num)
+{
+  return ((x >> 2) >= -IMG_PAD_SIZE_X && (x >> 2) + num - 1 <= ref->size_x_pad);
+}
+
 /*!
  ************************************************************************
  * \brief
@@ -23,12 +23,14 @@
 #include "image.h"
 #include "intrarefresh.h"
 #include "leaky_bucket.h"
+#include "memalloc.h"
 #include "me_epzs.h"
 #include "me_epzs_int.h"
 #include "output.h"
 #include "parset.h"
 #include "report.h"
 #include "img_process_types.h"
+#include "complexity.h"
 
 
 static const char DistortionType[3][20] = {"SAD", "SSE", "Hadamard SAD"};
@@ -800,7 +802,10 @@ void report( VideoParameters *p_Vid, InputParameters *p_Inp, StatParameters *p_S
 #endif
 
     fprintf(stdout,  " Total encoding time for the seq.  : %7.3f sec (%3.2f fps)\n", (float) p_Vid->tot_time * 0.001, 1000.0 * (float) (p_Stats->frame_counter) / (float)p_Vid->tot_time);
-    fprintf(stdout,  " Total ME time for sequence        : %7.3f sec \n\n", (float)p_Vid->me_tot_time * 0.001);
+    fprintf(stdout,  " Total ME time for sequence        : %7.3f sec \n", (float)p_Vid->me_tot_time * 0.001);
+    if (p_Vid->p_Cplx && p_Vid->p_Cplx->frames)
+      fprintf(stdout,  " Complexity level (average/peak)   : %7.3f / %d \n", (double) p_Vid->p_Cplx->level_sum / (double) p_Vid->p_Cplx->frames, p_Vid->p_Cplx->peak_level);
+    fprintf(stdout,  "\n");
 
     fprintf(stdout," Y { PSNR (dB), cSNR (dB), MSE }   : { %7.3f, %7.3f, %9.5f }\n", 
       snr->average[0], csnr_y, sse->average[0]/(float)impix);
@@ -982,6 +987,8 @@ void report( VideoParameters *p_Vid, InputParameters *p_Inp, StatParameters *p_S
   fprintf(stdout, " Bits to avoid Startcode Emulation : %" FORMAT_OFF_T  " \n", p_Stats->bit_ctr_emulation_prevention);
   fprintf(stdout, " Bits for parameter sets           : %d \n", p_Stats->bit_ctr_parametersets);
   fprintf(stdout, " Bits for filler data              : %" FORMAT_OFF_T  " \n\n", p_Stats->bit_ctr_filler_data);
+  print_mem_usage(stdout, 34);
+  fprintf(stdout, "\n");
 
   switch (p_Inp->Verbose)
   {
@@ -20,6 +20,7 @@
 #include "global.h"
 #include "rtp.h"
 #include "sei.h"
+#include "enc_profile.h"
 
 // A little trick to avoid those horrible #if TRACE all over the source code
 #if TRACE
@@ -176,6 +177,7 @@ int WriteRTPNALU (VideoParameters *p_Vid, NALU_t *n, FILE **f_rtp)
   
   byte first_byte;
 
+  ENC_PROFILE_START(p_Vid, EPROF_OUTPUT);
   assert ((*f_rtp) != NULL);
   assert (n != NULL);
   assert (n->len < 65000);
@@ -226,6 +228,7 @@ int WriteRTPNALU (VideoParameters *p_Vid, NALU_t *n, FILE **f_rtp)
   free (p->packet);
   free (p->payload);
   free (p);
+  ENC_PROFILE_STOP(p_Vid, EPROF_OUTPUT);
   return (n->len * 8);
 }
 
@@ -250,13 +253,12 @@ int WriteRTPNALU (VideoParameters *p_Vid, NALU_t *n, FILE **f_rtp)
 void RTPUpdateTimestamp (VideoParameters *p_Vid, int tr)
 {
   int delta;
-  static int oldtr = -1;
 
-  if (oldtr == -1)            // First invocation
+  if (p_Vid->LastRTPTr == -1)            // First invocation
   {
     p_Vid->CurrentRTPTimestamp = 0;  //! This is a violation of the security req. of
                               //! RTP (random timestamp), but easier to debug
-    oldtr = 0;
+    p_Vid->LastRTPTr = 0;
     return;
   }
 
@@ -270,13 +272,13 @@ void RTPUpdateTimestamp (VideoParameters *p_Vid, int tr)
       a wrap around.
   */
 
-  delta = tr - oldtr;
+  delta = tr - p_Vid->LastRTPTr;
 
   if (delta < -10)        // wrap-around
     delta+=256;
 
   p_Vid->CurrentRTPTimestamp += delta * RTP_TR_TIMESTAMP_MULT;
-  oldtr = tr;
+  p_Vid->LastRTPTr = tr;
 }
 
 
@@ -859,11 +859,9 @@ static void FinalizeSpareMBMap(VideoParameters *p_Vid)
  */
 void InitSubseqInfo(SEIParameters *p_SEI, int currLayer)
 {
-  static uint16 id = 0;
-
   p_SEI->seiHasSubseqInfo = TRUE;
   p_SEI->seiSubseqInfo[currLayer].subseq_layer_num = currLayer;
-  p_SEI->seiSubseqInfo[currLayer].subseq_id = id++;
+  p_SEI->seiSubseqInfo[currLayer].subseq_id = p_SEI->seiSubseqId++;
   p_SEI->seiSubseqInfo[currLayer].last_picture_flag = 0;
   p_SEI->seiSubseqInfo[currLayer].stored_frame_cnt = (unsigned int) -1;
   p_SEI->seiSubseqInfo[currLayer].payloadSize = 0;
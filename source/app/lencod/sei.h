@@ -332,6 +332,7 @@ struct sei_params {
   spare_picture_struct seiSparePicturePayload;
   Boolean seiHasSubseqInfo;
   subseq_information_struct seiSubseqInfo[MAX_LAYER_NUMBER];
+  uint16 seiSubseqId;                   //!< next sub-sequence id
   Boolean seiHasSubseqLayerInfo;
   subseq_layer_information_struct seiSubseqLayerInfo;
   Boolean seiHasSubseqChar;
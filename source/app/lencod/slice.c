@@ -61,10 +61,16 @@
 #include "mc_prediction.h"
 #include "rd_intra_jm.h"
 #include "rd_intra_jm444.h"
+#include "enc_profile.h"
+#include "field_analysis.h"
+#include "complexity.h"
 
 // Local declarations
 static Slice *malloc_slice(VideoParameters *p_Vid, InputParameters *p_Inp);
+static Slice *get_slice(VideoParameters *p_Vid, InputParameters *p_Inp);
 static Slice *malloc_slice_lite(VideoParameters *p_Vid, InputParameters *p_Inp);
+static void free_slice_picture_data (Slice *currSlice);
+static void clear_slice_picture_data(Slice *currSlice);
 
 int allocate_block_mem(Slice *currSlice)
 {
@@ -107,6 +113,13 @@ static void CAVLC_init(Slice *currSlice)
 static int alloc_rddata(Slice *currSlice, RD_DATA *rd_data)
 {
   int alloc_size = 0;
+  MemTag mem_tag;
+
+  // kept by a pooled slice from the previous picture
+  if (rd_data->rec_mb != NULL)
+    return 0;
+
+  mem_tag = mem_set_tag(MEM_RDO);
 
   alloc_size += get_mem3Dpel(&(rd_data->rec_mb), 3, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
 
@@ -115,13 +128,14 @@ static int alloc_rddata(Slice *currSlice, RD_DATA *rd_data)
 
   if ((currSlice->slice_type != I_SLICE) && currSlice->slice_type != SI_SLICE)
   {          
-    alloc_size += get_mem5Dmv (&(rd_data->all_mv), 2, currSlice->max_num_references, 9, 4, 4);
+    alloc_size += get_mem_MBmv (rd_data->all_mv, 2, currSlice->max_num_references);
   }
   
   // Why is this stored as height_blk * width_blk?
   alloc_size += get_mem2D((byte***)&(rd_data->ipredmode), currSlice->height_blk, currSlice->width_blk);
   alloc_size += get_mem3D((byte****)&(rd_data->refar), 2, 4, 4);
 
+  mem_set_tag(mem_tag);
   return alloc_size;
 }
 
@@ -132,13 +146,12 @@ static void nullify_rddata(RD_DATA *rd_data)
 
   rd_data->cofAC = NULL;
   rd_data->cofDC = NULL;  
-  rd_data->all_mv = NULL;
   
   rd_data->ipredmode = NULL;
   rd_data->refar = NULL;
 
-  rd_data->all_mv = NULL;
-  rd_data->bipred_mv = NULL;
+  memset(rd_data->all_mv, 0, sizeof(rd_data->all_mv));
+  memset(rd_data->bipred_mv, 0, sizeof(rd_data->bipred_mv));
 }
 
 static void free_rddata(Slice *currSlice, RD_DATA *rd_data)
@@ -150,8 +163,8 @@ static void free_rddata(Slice *currSlice, RD_DATA *rd_data)
 
   if ((currSlice->slice_type != I_SLICE) && currSlice->slice_type != SI_SLICE)
   {  
-    if(rd_data->all_mv)
-      free_mem5Dmv (rd_data->all_mv);
+    if(rd_data->all_mv[0])
+      free_mem_MBmv (rd_data->all_mv);
   }
 
   if(rd_data->cofDC)
@@ -161,6 +174,22 @@ static void free_rddata(Slice *currSlice, RD_DATA *rd_data)
 
   if(rd_data->rec_mb)
     free_mem3Dpel(rd_data->rec_mb);
+
+  nullify_rddata(rd_data);
+}
+
+static void clear_rddata(Slice *currSlice, RD_DATA *rd_data)
+{
+  if (rd_data->rec_mb != NULL)
+  {
+    memset(&rd_data->rec_mb[0][0][0], 0, 3 * MB_PIXELS * sizeof(imgpel));
+    memset(&rd_data->cofAC[0][0][0][0], 0, (BLOCK_SIZE + currSlice->p_Vid->num_blk8x8_uv) * BLOCK_SIZE * 2 * 65 * sizeof(int));
+    memset(&rd_data->cofDC[0][0][0], 0, 3 * 2 * 18 * sizeof(int));
+    if (rd_data->all_mv[0])
+      memset(rd_data->all_mv[0], 0, 2 * currSlice->max_num_references * sizeof(MBMotionVectors));
+    memset(&rd_data->ipredmode[0][0], 0, currSlice->height_blk * currSlice->width_blk * sizeof(char));
+    memset(&rd_data->refar[0][0][0], 0, 2 * 4 * 4 * sizeof(char));
+  }
 }
 
 
@@ -415,6 +444,8 @@ static void init_bipred_enabled(VideoParameters *p_Vid)
   memset(p_Vid->bipred_enabled, 0, sizeof(int)*MAXMODE);
   if (p_Vid->currentSlice->slice_type != B_SLICE || !p_Inp->BiPredMotionEstimation)
     return;
+  if (p_Vid->p_Cplx && p_Vid->p_Cplx->tools->no_bipred_me)
+    return;
 
   for(mode = 1; mode < 5; mode++)
     p_Vid->bipred_enabled[mode] = (p_Inp->BiPredSearch[mode - 1]) ? 1: 0;
@@ -509,7 +540,9 @@ int encode_one_slice (VideoParameters *p_Vid, int SliceGroupId, int TotalCodedMB
     {
       p_Vid->masterQP = p_Vid->qp;
 
+      ENC_PROFILE_START(p_Vid, EPROF_MODE_DECISION);
       currSlice->encode_one_macroblock (currMB);
+      ENC_PROFILE_STOP(p_Vid, EPROF_MODE_DECISION);
       end_encode_one_macroblock(currMB);
 
       write_macroblock (currMB, 1);
@@ -574,6 +607,7 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
   Boolean end_of_slice = FALSE;
   Boolean recode_macroblock;
   int len;
+  int mb_interlace;
   int NumberOfCodedMBs = 0;
   Macroblock* currMB = NULL;
   int CurrentMbAddr;
@@ -658,8 +692,13 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
     //!   2. would it be an option to allocate Bitstreams with zero data in them (or copy the
     //!      already generated bitstream) for the "test coding"?
 
+    // pairs the source analysis can decide are coded with one structure only
+    mb_interlace = p_Inp->MbInterlace;
+    if (mb_interlace == ADAPTIVE_CODING && p_Inp->FieldAnalysis)
+      mb_interlace = field_analysis_mb_pair(p_Vid, CurrentMbAddr);
+
     p_Vid->write_macroblock = FALSE;
-    if (p_Inp->MbInterlace == ADAPTIVE_CODING || p_Inp->MbInterlace == FRAME_MB_PAIR_CODING)
+    if (mb_interlace == ADAPTIVE_CODING || mb_interlace == FRAME_MB_PAIR_CODING)
     {
       //================ code MB pair as frame MB ================
       //----------------------------------------------------------
@@ -677,10 +716,10 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
       // save RC state only when it is going to change
       if ( p_Inp->RCEnable && p_Inp->RCUpdateMode <= MAX_RC_MODE )
       {
-        if ( p_Inp->MbInterlace == ADAPTIVE_CODING
+        if ( mb_interlace == ADAPTIVE_CODING
           && p_Vid->NumberofCodedMacroBlocks > 0 && (p_Vid->NumberofCodedMacroBlocks % p_Vid->BasicUnit) == 0 )
           rc_copy_quadratic( p_Vid, p_Inp, p_Vid->p_rc_quad_init, p_Vid->p_rc_quad ); // save initial RC status
-        if ( p_Inp->MbInterlace == ADAPTIVE_CODING )
+        if ( mb_interlace == ADAPTIVE_CODING )
           rc_copy_generic( p_Vid, p_Vid->p_rc_gen_init, p_Vid->p_rc_gen ); // save initial RC status
       }
 
@@ -688,7 +727,9 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
 
       currSlice->rddata = &currSlice->rddata_top_frame_mb; // store data in top frame MB
       p_Vid->masterQP = p_Vid->qp;
+      ENC_PROFILE_START(p_Vid, EPROF_MODE_DECISION);
       currSlice->encode_one_macroblock (currMB);   // code the MB as frame
+      ENC_PROFILE_STOP(p_Vid, EPROF_MODE_DECISION);
       end_encode_one_macroblock(currMB);
 
       FrameRDCost = currSlice->rddata->min_rdcost;
@@ -703,16 +744,18 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
       start_macroblock (currSlice, &currMB, CurrentMbAddr + 1, FALSE);
       currSlice->rddata = &currSlice->rddata_bot_frame_mb; // store data in top frame MB
       p_Vid->masterQP = p_Vid->qp;
+      ENC_PROFILE_START(p_Vid, EPROF_MODE_DECISION);
       currSlice->encode_one_macroblock (currMB);         // code the MB as frame
+      ENC_PROFILE_STOP(p_Vid, EPROF_MODE_DECISION);
       end_encode_one_macroblock(currMB);
 
       if ( p_Inp->RCEnable && p_Inp->RCUpdateMode <= MAX_RC_MODE )
       {
-        if ( p_Inp->MbInterlace == ADAPTIVE_CODING
+        if ( mb_interlace == ADAPTIVE_CODING
           && p_Vid->NumberofCodedMacroBlocks > 0 && (p_Vid->NumberofCodedMacroBlocks % p_Vid->BasicUnit) == 0 )
           rc_copy_quadratic( p_Vid, p_Inp, p_Vid->p_rc_quad_best, p_Vid->p_rc_quad ); // restore initial RC status
 
-        if ( p_Inp->MbInterlace == ADAPTIVE_CODING )
+        if ( mb_interlace == ADAPTIVE_CODING )
           rc_copy_generic( p_Vid, p_Vid->p_rc_gen_best, p_Vid->p_rc_gen ); // save frame RC stats
       }
 
@@ -720,7 +763,7 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
       //***   Bottom MB coded as frame MB ***//
     }
 
-    if ((p_Inp->MbInterlace == ADAPTIVE_CODING) || (p_Inp->MbInterlace == FIELD_CODING))
+    if ((mb_interlace == ADAPTIVE_CODING) || (mb_interlace == FIELD_CODING))
     {
       //Rate control
       p_Vid->bot_MB = FALSE;
@@ -737,11 +780,11 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
 
       if ( p_Inp->RCEnable && p_Inp->RCUpdateMode <= MAX_RC_MODE )
       {
-        if ( p_Inp->MbInterlace == ADAPTIVE_CODING
+        if ( mb_interlace == ADAPTIVE_CODING
           && p_Vid->NumberofCodedMacroBlocks > 0 && (p_Vid->NumberofCodedMacroBlocks % p_Vid->BasicUnit) == 0 )
           rc_copy_quadratic( p_Vid, p_Inp, p_Vid->p_rc_quad, p_Vid->p_rc_quad_init ); // restore initial RC status
 
-        if ( p_Inp->MbInterlace == ADAPTIVE_CODING )
+        if ( mb_interlace == ADAPTIVE_CODING )
           rc_copy_generic( p_Vid, p_Vid->p_rc_gen, p_Vid->p_rc_gen_init ); // reset RC stats
       }
 
@@ -750,7 +793,9 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
       currSlice->rddata = &currSlice->rddata_top_field_mb; // store data in top frame MB
       //        TopFieldIsSkipped = 0;        // set the top field MB skipped flag to 0
       p_Vid->masterQP = p_Vid->qp;
+      ENC_PROFILE_START(p_Vid, EPROF_MODE_DECISION);
       currSlice->encode_one_macroblock (currMB);         // code the MB as field
+      ENC_PROFILE_STOP(p_Vid, EPROF_MODE_DECISION);
       end_encode_one_macroblock(currMB);
 
       FieldRDCost = currSlice->rddata->min_rdcost;
@@ -762,7 +807,9 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
       start_macroblock (currSlice, &currMB, CurrentMbAddr+1, TRUE);
       currSlice->rddata = &currSlice->rddata_bot_field_mb; // store data in top frame MB
       p_Vid->masterQP = p_Vid->qp;
+      ENC_PROFILE_START(p_Vid, EPROF_MODE_DECISION);
       currSlice->encode_one_macroblock (currMB);         // code the MB as field
+      ENC_PROFILE_STOP(p_Vid, EPROF_MODE_DECISION);
       end_encode_one_macroblock(currMB);
 
       FieldRDCost += currSlice->rddata->min_rdcost;
@@ -774,12 +821,12 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
 
     //=========== decide between frame/field MB pair ============
     //-----------------------------------------------------------
-    if ( ((p_Inp->MbInterlace == ADAPTIVE_CODING) && (FrameRDCost < FieldRDCost)) || p_Inp->MbInterlace == FRAME_MB_PAIR_CODING )
+    if ( ((mb_interlace == ADAPTIVE_CODING) && (FrameRDCost < FieldRDCost)) || mb_interlace == FRAME_MB_PAIR_CODING )
     {
       p_Vid->field_mode = FALSE;
       p_Vid->MBPairIsField = FALSE;
 
-      if ( p_Inp->MbInterlace != FRAME_MB_PAIR_CODING )
+      if ( mb_interlace != FRAME_MB_PAIR_CODING )
       {
         p_Inp->num_ref_frames >>= 1;
         currSlice->num_ref_idx_active[LIST_0] -= 1;
@@ -788,11 +835,11 @@ int encode_one_slice_MBAFF (VideoParameters *p_Vid, int SliceGroupId, int TotalC
 
       if ( p_Inp->RCEnable && p_Inp->RCUpdateMode <= MAX_RC_MODE )
       {
-        if ( p_Inp->MbInterlace == ADAPTIVE_CODING
+        if ( mb_interlace == ADAPTIVE_CODING
           && p_Vid->NumberofCodedMacroBlocks > 0 && (p_Vid->NumberofCodedMacroBlocks % p_Vid->BasicUnit) == 0 )
           rc_copy_quadratic( p_Vid, p_Inp, p_Vid->p_rc_quad, p_Vid->p_rc_quad_best ); // restore initial RC status
 
-        if ( p_Inp->MbInterlace == ADAPTIVE_CODING )
+        if ( mb_interlace == ADAPTIVE_CODING )
           rc_copy_generic( p_Vid, p_Vid->p_rc_gen, p_Vid->p_rc_gen_best ); // restore frame RC stats
       }
 
@@ -1347,7 +1394,7 @@ void init_slice (VideoParameters *p_Vid, Slice **currSlice, int start_mb_addr)
   if (currPic->no_slices >= MAXSLICEPERPICTURE)
     error ("Too many slices per picture, increase MAXSLICEPERPICTURE in global.h.", -1);
 
-  currPic->slices[currPic->no_slices - 1] = malloc_slice(p_Vid, p_Inp);
+  currPic->slices[currPic->no_slices - 1] = get_slice(p_Vid, p_Inp);
   *currSlice = currPic->slices[currPic->no_slices-1];
 
   p_Vid->currentSlice = *currSlice;
@@ -1444,8 +1491,20 @@ void init_slice (VideoParameters *p_Vid, Slice **currSlice, int start_mb_addr)
       }
 #endif
     }
-    get_mem3D((byte ****)(void*)&(*currSlice)->direct_ref_idx, (*currSlice)->height_blk, (*currSlice)->width_blk, 2);
-    get_mem2D((byte ***) (void*)&(*currSlice)->direct_pdir,    (*currSlice)->height_blk, (*currSlice)->width_blk);
+    if ((*currSlice)->direct_pdir == NULL)
+    {
+      get_mem3D((byte ****)(void*)&(*currSlice)->direct_ref_idx, (*currSlice)->height_blk, (*currSlice)->width_blk, 2);
+      get_mem2D((byte ***) (void*)&(*currSlice)->direct_pdir,    (*currSlice)->height_blk, (*currSlice)->width_blk);
+    }
+  }
+
+  // references limited by the complexity control
+  if (p_Vid->p_Cplx && p_Vid->p_Cplx->tools->max_refs)
+  {
+    int max_refs = p_Vid->p_Cplx->tools->max_refs * ((p_Vid->structure !=0) + 1);
+
+    (*currSlice)->num_ref_idx_active[LIST_0] = (char) imin((*currSlice)->num_ref_idx_active[LIST_0], max_refs);
+    (*currSlice)->num_ref_idx_active[LIST_1] = (char) imin((*currSlice)->num_ref_idx_active[LIST_1], max_refs);
   }
 
   setup_slice(*currSlice);
@@ -1610,13 +1669,17 @@ void init_slice (VideoParameters *p_Vid, Slice **currSlice, int start_mb_addr)
 
   (*currSlice)->max_num_references = (short) p_Vid->max_num_references;
 
-  if (((*currSlice)->slice_type != I_SLICE) && (*currSlice)->slice_type != SI_SLICE)
+  // the motion vector arrays of a pooled slice are kept from the previous picture
+  if (((*currSlice)->slice_type != I_SLICE) && (*currSlice)->slice_type != SI_SLICE && (*currSlice)->all_mv[0] == NULL)
   {
-    alloc_size += get_mem5Dmv (&((*currSlice)->all_mv), 2, (*currSlice)->max_num_references, 9, 4, 4);
+    MemTag mem_tag = mem_set_tag(MEM_ME);
+
+    alloc_size += get_mem_MBmv ((*currSlice)->all_mv, 2, (*currSlice)->max_num_references);
 
     if (p_Inp->BiPredMotionEstimation && ((*currSlice)->slice_type == B_SLICE))
     {
-      alloc_size += get_mem6Dmv (&((*currSlice)->bipred_mv), 2, 2, (*currSlice)->max_num_references, 9, 4, 4);
+      alloc_size += get_mem_MBmv ((*currSlice)->bipred_mv[0], 2, (*currSlice)->max_num_references);
+      alloc_size += get_mem_MBmv ((*currSlice)->bipred_mv[1], 2, (*currSlice)->max_num_references);
     }
 
     if (p_Inp->UseRDOQuant && p_Inp->RDOQ_QP_Num > 1)
@@ -1629,6 +1692,7 @@ void init_slice (VideoParameters *p_Vid, Slice **currSlice, int start_mb_addr)
         get_mem3Ddistblk(&(*currSlice)->motion_cost4, 2, (*currSlice)->max_num_references, 4);
       }
     }
+    mem_set_tag(mem_tag);
   }
 
   if (p_Vid->mb_aff_frame_flag)
@@ -1655,16 +1719,29 @@ void init_slice (VideoParameters *p_Vid, Slice **currSlice, int start_mb_addr)
 
   if ((*currSlice)->slice_type != I_SLICE && (*currSlice)->slice_type != SI_SLICE)
   {
-    p_Vid->searchRange.min_x = -p_Inp->search_range[layer_id] << 2;
-    p_Vid->searchRange.max_x =  p_Inp->search_range[layer_id] << 2;
-    p_Vid->searchRange.min_y = -p_Inp->search_range[layer_id] << 2;
-    p_Vid->searchRange.max_y =  p_Inp->search_range[layer_id] << 2;
+    int search_range = p_Inp->search_range[layer_id];
+
+    // range of the full search reduced by the complexity control, but not below 8;
+    // the predictive searches hardly get faster with a smaller range
+    if (p_Vid->p_Cplx && p_Inp->SearchMode[layer_id] == FULL_SEARCH)
+      search_range = imax(search_range >> p_Vid->p_Cplx->tools->search_shift, imin(search_range, 8));
+
+    p_Vid->searchRange.min_x = -search_range << 2;
+    p_Vid->searchRange.max_x =  search_range << 2;
+    p_Vid->searchRange.min_y = -search_range << 2;
+    p_Vid->searchRange.max_y =  search_range << 2;
 
     if (p_Inp->SearchMode[layer_id] == EPZS)
     {
-      if (((*currSlice)->p_EPZS =  (EPZSParameters*) calloc(1, sizeof(EPZSParameters)))==NULL) 
-        no_mem_exit("init_slice: p_EPZS");
-      EPZSStructInit (*currSlice);
+      if ((*currSlice)->p_EPZS == NULL)
+      {
+        MemTag mem_tag = mem_set_tag(MEM_EPZS);
+
+        if (((*currSlice)->p_EPZS =  (EPZSParameters*) calloc(1, sizeof(EPZSParameters)))==NULL) 
+          no_mem_exit("init_slice: p_EPZS");
+        EPZSStructInit (*currSlice);
+        mem_set_tag(mem_tag);
+      }
       EPZSSliceInit  (*currSlice);
     }
   }
@@ -1695,7 +1772,7 @@ void init_slice (VideoParameters *p_Vid, Slice **currSlice, int start_mb_addr)
 
   if (p_Inp->UseRDOQuant)
   {
-    if (((*currSlice)->estBitsCabac = (estBitsCabacStruct*) calloc(NUM_BLOCK_TYPES, sizeof(estBitsCabacStruct)))==NULL) 
+    if ((*currSlice)->estBitsCabac == NULL && ((*currSlice)->estBitsCabac = (estBitsCabacStruct*) calloc(NUM_BLOCK_TYPES, sizeof(estBitsCabacStruct)))==NULL) 
       no_mem_exit("init_slice: (*currSlice)->estBitsCabac"); 
 
     init_rdoq_slice(*currSlice);
@@ -1731,17 +1808,6 @@ void init_slice (VideoParameters *p_Vid, Slice **currSlice, int start_mb_addr)
     (*currSlice)->set_motion_vectors_mb = SetMotionVectorsMBISlice;
   }
 
-  get_mem3Dpel(&((*currSlice)->mb_pred),   MAX_PLANE, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
-  get_mem3Dint(&((*currSlice)->mb_rres),   MAX_PLANE, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
-  get_mem3Dint(&((*currSlice)->mb_ores),   MAX_PLANE, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
-  get_mem4Dpel(&((*currSlice)->mpr_4x4),   MAX_PLANE, 9, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
-  get_mem4Dpel(&((*currSlice)->mpr_8x8),   MAX_PLANE, 9, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
-  get_mem4Dpel(&((*currSlice)->mpr_16x16), MAX_PLANE, 5, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
-
-  get_mem_ACcoeff (p_Vid, &((*currSlice)->cofAC));
-  get_mem_DCcoeff (&((*currSlice)->cofDC));
-
-  allocate_block_mem(*currSlice);
   init_coding_state_methods(*currSlice);
   init_rdopt(*currSlice);
 }
@@ -1898,8 +1964,8 @@ void init_slice_lite (VideoParameters *p_Vid, Slice **currSlice, int start_mb_ad
     }
   }
 
-  (*currSlice)->all_mv    = NULL;  
-  (*currSlice)->bipred_mv = NULL;
+  memset((*currSlice)->all_mv, 0, sizeof((*currSlice)->all_mv));
+  memset((*currSlice)->bipred_mv, 0, sizeof((*currSlice)->bipred_mv));
 
   (*currSlice)->tmp_mv8      = NULL;
   (*currSlice)->motion_cost8 = NULL;
@@ -1927,10 +1993,25 @@ void init_slice_lite (VideoParameters *p_Vid, Slice **currSlice, int start_mb_ad
   init_coding_state_methods(*currSlice);
 }
 
+/*!
+ ************************************************************************
+ * \brief
+ *    number of data partitions of the slices of the current picture
+ ************************************************************************
+ */
+static int slice_partitions(VideoParameters *p_Vid, InputParameters *p_Inp)
+{
+  //for IDR p_Vid there should be only one partition
+  if (p_Inp->partition_mode == 0 || p_Vid->currentPicture->idr_flag)
+    return 1;
+  return 3;
+}
+
 /*!
  ************************************************************************
  * \brief
  *    Allocates a slice structure along with its dependent data structures
+ *    that do not depend on the slice type
  * \return
  *    Pointer to a Slice
  ************************************************************************
@@ -1941,6 +2022,7 @@ static Slice *malloc_slice(VideoParameters *p_Vid, InputParameters *p_Inp)
   DataPartition *dataPart;
   Slice *currSlice;
   int cr_size = (p_Inp->separate_colour_plane_flag != 0) ? 0 : 512;
+  MemTag mem_tag = mem_set_tag(MEM_SLICE);
 
   int buffer_size;
 
@@ -1959,13 +2041,12 @@ static Slice *malloc_slice(VideoParameters *p_Vid, InputParameters *p_Inp)
   }
 
   // KS: this is approx. max. allowed code picture size
-  if ((currSlice = (Slice *) calloc(1, sizeof(Slice))) == NULL) no_mem_exit ("malloc_slice: currSlice structure");
+  if ((currSlice = (Slice *) mem_calloc(1, sizeof(Slice))) == NULL) no_mem_exit ("malloc_slice: currSlice structure");
 
   currSlice->p_Vid             = p_Vid;
   currSlice->p_Inp             = p_Inp;
 
-  if (((currSlice->p_RDO)  = (RDOPTStructure *) calloc(1, sizeof(RDOPTStructure)))==NULL) 
-    no_mem_exit("malloc_slice: p_RDO");
+  alloc_rdopt(currSlice);
 
   currSlice->symbol_mode  = (char) p_Inp->symbol_mode;
 
@@ -1976,19 +2057,7 @@ static Slice *malloc_slice(VideoParameters *p_Vid, InputParameters *p_Inp)
     currSlice->tex_ctx = create_contexts_TextureInfo();
   }
 
-  currSlice->max_part_nr = p_Inp->partition_mode==0?1:3;
-
-  //for IDR p_Vid there should be only one partition
-  if(p_Vid->currentPicture->idr_flag)
-    currSlice->max_part_nr = 1;
-
-  assignSE2partition[0] = assignSE2partition_NoDP;
-  //ZL
-  //for IDR p_Vid all the syntax element should be mapped to one partition
-  if(!p_Vid->currentPicture->idr_flag && p_Inp->partition_mode == 1)
-    assignSE2partition[1] =  assignSE2partition_DP;
-  else
-    assignSE2partition[1] =  assignSE2partition_NoDP;
+  currSlice->max_part_nr = slice_partitions(p_Vid, p_Inp);
 
   currSlice->num_mb = 0;          // no coded MBs so far
 
@@ -2017,9 +2086,216 @@ static Slice *malloc_slice(VideoParameters *p_Vid, InputParameters *p_Inp)
     get_mem4Dshort(&currSlice->wbp_weight, 6, MAX_REFERENCE_PICTURES, MAX_REFERENCE_PICTURES, 3);
   }
 
+  get_mem3Dpel(&(currSlice->mb_pred),   MAX_PLANE, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+  get_mem3Dint(&(currSlice->mb_rres),   MAX_PLANE, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+  get_mem3Dint(&(currSlice->mb_ores),   MAX_PLANE, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+  get_mem4Dpel(&(currSlice->mpr_4x4),   MAX_PLANE, 9, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+  get_mem4Dpel(&(currSlice->mpr_8x8),   MAX_PLANE, 9, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+  get_mem4Dpel(&(currSlice->mpr_16x16), MAX_PLANE, 5, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+
+  get_mem_ACcoeff (p_Vid, &(currSlice->cofAC));
+  get_mem_DCcoeff (&(currSlice->cofDC));
+
+  allocate_block_mem(currSlice);
+  mem_set_tag(mem_tag);
+
   return currSlice;
 }
 
+/*!
+ ************************************************************************
+ * \brief
+ *    Clears a slice for reuse. The buffers are kept, those that depend
+ *    on the slice type and picture structure have been either cleared
+ *    or freed before.
+ ************************************************************************
+ */
+static void reset_slice(Slice *currSlice)
+{
+  Slice keep = *currSlice;
+  int i;
+
+  memset(currSlice, 0, sizeof(Slice));
+
+  currSlice->p_Vid       = keep.p_Vid;
+  currSlice->p_Inp       = keep.p_Inp;
+  currSlice->p_RDO       = keep.p_RDO;
+  currSlice->symbol_mode = keep.symbol_mode;
+  currSlice->mot_ctx     = keep.mot_ctx;
+  currSlice->tex_ctx     = keep.tex_ctx;
+  currSlice->max_part_nr = keep.max_part_nr;
+  currSlice->partArr     = keep.partArr;
+  currSlice->wp_weight   = keep.wp_weight;
+  currSlice->wp_offset   = keep.wp_offset;
+  currSlice->wbp_weight  = keep.wbp_weight;
+  currSlice->mb_pred     = keep.mb_pred;
+  currSlice->mb_rres     = keep.mb_rres;
+  currSlice->mb_ores     = keep.mb_ores;
+  currSlice->mpr_4x4     = keep.mpr_4x4;
+  currSlice->mpr_8x8     = keep.mpr_8x8;
+  currSlice->mpr_16x16   = keep.mpr_16x16;
+  currSlice->cofAC       = keep.cofAC;
+  currSlice->cofDC       = keep.cofDC;
+  currSlice->tblk4x4     = keep.tblk4x4;
+  currSlice->tblk16x16   = keep.tblk16x16;
+  currSlice->i16blk4x4   = keep.i16blk4x4;
+
+  // picture data
+  memcpy(currSlice->listX, keep.listX, sizeof(keep.listX));
+  memcpy(currSlice->modification_of_pic_nums_idc, keep.modification_of_pic_nums_idc, sizeof(keep.modification_of_pic_nums_idc));
+  memcpy(currSlice->abs_diff_pic_num_minus1, keep.abs_diff_pic_num_minus1, sizeof(keep.abs_diff_pic_num_minus1));
+  memcpy(currSlice->long_term_pic_idx, keep.long_term_pic_idx, sizeof(keep.long_term_pic_idx));
+#if (MVC_EXTENSION_ENABLE)
+  memcpy(currSlice->abs_diff_view_idx_minus1, keep.abs_diff_view_idx_minus1, sizeof(keep.abs_diff_view_idx_minus1));
+#endif
+  memcpy(currSlice->all_mv, keep.all_mv, sizeof(keep.all_mv));
+  memcpy(currSlice->bipred_mv, keep.bipred_mv, sizeof(keep.bipred_mv));
+  currSlice->tmp_mv8             = keep.tmp_mv8;
+  currSlice->motion_cost8        = keep.motion_cost8;
+  currSlice->tmp_mv4             = keep.tmp_mv4;
+  currSlice->motion_cost4        = keep.motion_cost4;
+  currSlice->direct_ref_idx      = keep.direct_ref_idx;
+  currSlice->direct_pdir         = keep.direct_pdir;
+  currSlice->estBitsCabac        = keep.estBitsCabac;
+  currSlice->rddata_trellis_curr = keep.rddata_trellis_curr;
+  currSlice->rddata_trellis_best = keep.rddata_trellis_best;
+  currSlice->rddata_top_frame_mb = keep.rddata_top_frame_mb;
+  currSlice->rddata_bot_frame_mb = keep.rddata_bot_frame_mb;
+  currSlice->rddata_top_field_mb = keep.rddata_top_field_mb;
+  currSlice->rddata_bot_field_mb = keep.rddata_bot_field_mb;
+  currSlice->p_EPZS              = keep.p_EPZS;
+
+  for (i = 0; i < currSlice->max_part_nr; i++)
+  {
+    DataPartition *dataPart = &currSlice->partArr[i];
+    Bitstream *currStream = dataPart->bitstream;
+    byte *streamBuffer = currStream->streamBuffer;
+    int buffer_size = currStream->buffer_size;
+
+    memset(dataPart, 0, sizeof(DataPartition));
+    dataPart->p_Slice   = currSlice;
+    dataPart->p_Vid     = currSlice->p_Vid;
+    dataPart->p_Inp     = currSlice->p_Inp;
+    dataPart->bitstream = currStream;
+
+    memset(currStream, 0, sizeof(Bitstream));
+    currStream->streamBuffer = streamBuffer;
+    currStream->buffer_size  = buffer_size;
+  }
+
+  if (currSlice->wp_weight)
+  {
+    memset(&currSlice->wp_weight[0][0][0], 0, 6 * MAX_REFERENCE_PICTURES * 3 * sizeof(short));
+    memset(&currSlice->wp_offset[0][0][0], 0, 6 * MAX_REFERENCE_PICTURES * 3 * sizeof(short));
+    memset(&currSlice->wbp_weight[0][0][0][0], 0, 6 * MAX_REFERENCE_PICTURES * MAX_REFERENCE_PICTURES * 3 * sizeof(short));
+  }
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Checks whether the picture data a pooled slice kept from its last
+ *    picture fits the current picture: same slice type, picture
+ *    structure and number of references, and the same view, which
+ *    selects the motion search settings of the layer
+ ************************************************************************
+ */
+static int slice_data_matches(VideoParameters *p_Vid, Slice *currSlice)
+{
+  return (currSlice->slice_type         == p_Vid->type
+       && currSlice->structure          == p_Vid->structure
+       && currSlice->mb_aff_frame_flag  == p_Vid->mb_aff_frame_flag
+       && currSlice->max_num_references == p_Vid->max_num_references
+       && currSlice->view_id            == p_Vid->view_id);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Takes a slice with the partitions of the current picture from the
+ *    slice pool or allocates a new one. A slice whose picture data fits
+ *    the current picture is preferred and keeps that data; otherwise
+ *    the picture data of the reused slice is freed.
+ * \return
+ *    Pointer to a Slice
+ ************************************************************************
+ */
+static Slice *get_slice(VideoParameters *p_Vid, InputParameters *p_Inp)
+{
+  SlicePool *pool = p_Vid->p_SlicePool;
+  int max_part_nr = slice_partitions(p_Vid, p_Inp);
+  int i, reuse = -1;
+
+  //ZL
+  //for IDR p_Vid all the syntax element should be mapped to one partition
+  if (p_Inp->partition_mode == 1)
+    assignSE2partition[1] = p_Vid->currentPicture->idr_flag ? assignSE2partition_NoDP : assignSE2partition_DP;
+
+  if (pool != NULL)
+  {
+    for (i = pool->count - 1; i >= 0; i--)
+    {
+      if (pool->slices[i]->max_part_nr == max_part_nr)
+      {
+        if (slice_data_matches(p_Vid, pool->slices[i]))
+        {
+          reuse = i;
+          break;
+        }
+        if (reuse < 0)
+          reuse = i;
+      }
+    }
+
+    if (reuse >= 0)
+    {
+      Slice *currSlice = pool->slices[reuse];
+
+      pool->slices[reuse] = pool->slices[--pool->count];
+      if (slice_data_matches(p_Vid, currSlice))
+        clear_slice_picture_data(currSlice);
+      else
+        free_slice_picture_data(currSlice);
+      reset_slice(currSlice);
+      return currSlice;
+    }
+  }
+
+  return malloc_slice(p_Vid, p_Inp);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    allocates an empty slice pool
+ ************************************************************************
+ */
+SlicePool *alloc_slice_pool(void)
+{
+  SlicePool *pool;
+
+  if ((pool = (SlicePool *) calloc(1, sizeof(SlicePool))) == NULL)
+    no_mem_exit("alloc_slice_pool: pool");
+
+  return pool;
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    frees a slice pool and the slices in it
+ ************************************************************************
+ */
+void free_slice_pool(SlicePool *pool)
+{
+  if (pool != NULL)
+  {
+    while (pool->count > 0)
+      free_slice(pool->slices[--pool->count]);
+    free(pool->slices);
+    free(pool);
+  }
+}
 
 
 
@@ -2034,9 +2310,10 @@ static Slice *malloc_slice(VideoParameters *p_Vid, InputParameters *p_Inp)
 static Slice *malloc_slice_lite(VideoParameters *p_Vid, InputParameters *p_Inp)
 {
   Slice *currSlice;
+  MemTag mem_tag = mem_set_tag(MEM_SLICE);
   //int cr_size = (p_Inp->separate_colour_plane_flag != 0) ? 0 : 512;
 
-  if ((currSlice = (Slice *) calloc(1, sizeof(Slice))) == NULL) no_mem_exit ("malloc_slice: currSlice structure");
+  if ((currSlice = (Slice *) mem_calloc(1, sizeof(Slice))) == NULL) no_mem_exit ("malloc_slice: currSlice structure");
 
   currSlice->p_Vid = p_Vid;
   currSlice->p_Inp = p_Inp;
@@ -2055,13 +2332,10 @@ static Slice *malloc_slice_lite(VideoParameters *p_Vid, InputParameters *p_Inp)
   if(p_Vid->currentPicture->idr_flag)
     currSlice->max_part_nr = 1;
 
-  assignSE2partition[0] = assignSE2partition_NoDP;
   //ZL
   //for IDR p_Vid all the syntax element should be mapped to one partition
-  if(!p_Vid->currentPicture->idr_flag && p_Inp->partition_mode == 1)
-    assignSE2partition[1] =  assignSE2partition_DP;
-  else
-    assignSE2partition[1] =  assignSE2partition_NoDP;
+  if (p_Inp->partition_mode == 1)
+    assignSE2partition[1] = p_Vid->currentPicture->idr_flag ? assignSE2partition_NoDP : assignSE2partition_DP;
 
   currSlice->num_mb = 0;          // no coded MBs so far
 
@@ -2074,6 +2348,7 @@ static Slice *malloc_slice_lite(VideoParameters *p_Vid, InputParameters *p_Inp)
     get_mem3Dshort(&currSlice->wp_offset, 6, MAX_REFERENCE_PICTURES, 3);
     get_mem4Dshort(&currSlice->wbp_weight, 6, MAX_REFERENCE_PICTURES, MAX_REFERENCE_PICTURES, 3);
   }
+  mem_set_tag(mem_tag);
 
   return currSlice;
 }
@@ -2117,6 +2392,146 @@ static void free_nal_unit(Picture *pic)
 }
 
 
+/*!
+ ************************************************************************
+ * \brief
+ *    Memory frees of the data structures of a slice that depend on the
+ *    slice type and picture structure
+ ************************************************************************
+ */
+static void free_slice_picture_data(Slice *currSlice)
+{
+  InputParameters *p_Inp = currSlice->p_Inp;
+  int i;
+
+  for (i=0; i<6; i++)
+  {
+    if (currSlice->listX[i])
+    {
+      free (currSlice->listX[i]);
+      currSlice->listX[i] = NULL;
+    }
+  }
+
+  if (currSlice->slice_type != I_SLICE && currSlice->slice_type != SI_SLICE)
+    free_ref_pic_list_reordering_buffer (currSlice);
+
+  if (currSlice->UseRDOQuant)
+  {
+    free(currSlice->estBitsCabac);
+    currSlice->estBitsCabac = NULL;
+
+    free_rddata(currSlice, &currSlice->rddata_trellis_curr);
+    if(currSlice->RDOQ_QP_Num > 1)
+    {
+      free_rddata(currSlice, &currSlice->rddata_trellis_best);
+    }
+  }
+
+  if(currSlice->mb_aff_frame_flag)
+  {
+    free_rddata(currSlice, &currSlice->rddata_top_frame_mb);
+    free_rddata(currSlice, &currSlice->rddata_bot_frame_mb);
+
+    if ( p_Inp->MbInterlace != FRAME_MB_PAIR_CODING )
+    {
+      free_rddata(currSlice, &currSlice->rddata_top_field_mb);
+      free_rddata(currSlice, &currSlice->rddata_bot_field_mb);
+    }
+  }
+
+  if ((currSlice->slice_type == P_SLICE) || (currSlice->slice_type == SP_SLICE) || (currSlice->slice_type == B_SLICE))
+  {
+    if(currSlice->all_mv[0])
+      free_mem_MBmv (currSlice->all_mv);
+    if (p_Inp->BiPredMotionEstimation && (currSlice->slice_type == B_SLICE) && currSlice->bipred_mv[0][0])
+    {
+      free_mem_MBmv (currSlice->bipred_mv[0]);
+      free_mem_MBmv (currSlice->bipred_mv[1]);
+    }
+    memset(currSlice->all_mv, 0, sizeof(currSlice->all_mv));
+    memset(currSlice->bipred_mv, 0, sizeof(currSlice->bipred_mv));
+
+    if (currSlice->UseRDOQuant && currSlice->RDOQ_QP_Num > 1)
+    {
+      if (p_Inp->Transform8x8Mode && p_Inp->RDOQ_CP_MV)
+      {
+        if(currSlice->tmp_mv8)
+          free_mem4Dmv (currSlice->tmp_mv8);
+        if(currSlice->motion_cost8)
+          free_mem3Ddistblk(currSlice->motion_cost8);
+        if(currSlice->tmp_mv4)
+          free_mem4Dmv (currSlice->tmp_mv4);
+        if(currSlice->motion_cost4)
+          free_mem3Ddistblk(currSlice->motion_cost4);
+        currSlice->tmp_mv8      = NULL;
+        currSlice->motion_cost8 = NULL;
+        currSlice->tmp_mv4      = NULL;
+        currSlice->motion_cost4 = NULL;
+      }
+    }
+  }
+
+  if (currSlice->slice_type == B_SLICE)
+  {
+    if(currSlice->direct_ref_idx)
+      free_mem3D((byte ***)currSlice->direct_ref_idx);
+    if(currSlice->direct_pdir)
+      free_mem2D((byte **) currSlice->direct_pdir);
+    currSlice->direct_ref_idx = NULL;
+    currSlice->direct_pdir    = NULL;
+  }
+
+  if(currSlice->p_EPZS)
+    EPZSStructDelete (currSlice);
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Clears the data structures a pooled slice kept from its previous
+ *    picture, so that a new picture of the same type starts from the
+ *    state of freshly allocated ones
+ ************************************************************************
+ */
+static void clear_slice_picture_data(Slice *currSlice)
+{
+  int num_refs = 2 * currSlice->max_num_references;
+  int num_blks = currSlice->height_blk * currSlice->width_blk;
+
+  if (currSlice->all_mv[0])
+    memset(currSlice->all_mv[0], 0, num_refs * sizeof(MBMotionVectors));
+  if (currSlice->bipred_mv[0][0])
+  {
+    memset(currSlice->bipred_mv[0][0], 0, num_refs * sizeof(MBMotionVectors));
+    memset(currSlice->bipred_mv[1][0], 0, num_refs * sizeof(MBMotionVectors));
+  }
+  if (currSlice->tmp_mv8)
+  {
+    memset(&currSlice->tmp_mv8[0][0][0][0], 0, num_refs * 4 * 4 * sizeof(MotionVector));
+    memset(&currSlice->motion_cost8[0][0][0], 0, num_refs * 4 * sizeof(distblk));
+    memset(&currSlice->tmp_mv4[0][0][0][0], 0, num_refs * 4 * 4 * sizeof(MotionVector));
+    memset(&currSlice->motion_cost4[0][0][0], 0, num_refs * 4 * sizeof(distblk));
+  }
+  if (currSlice->direct_pdir)
+  {
+    memset(&currSlice->direct_ref_idx[0][0][0], 0, num_blks * 2 * sizeof(char));
+    memset(&currSlice->direct_pdir[0][0], 0, num_blks * sizeof(char));
+  }
+  if (currSlice->estBitsCabac)
+    memset(currSlice->estBitsCabac, 0, NUM_BLOCK_TYPES * sizeof(estBitsCabacStruct));
+
+  clear_rddata(currSlice, &currSlice->rddata_trellis_curr);
+  clear_rddata(currSlice, &currSlice->rddata_trellis_best);
+  clear_rddata(currSlice, &currSlice->rddata_top_frame_mb);
+  clear_rddata(currSlice, &currSlice->rddata_bot_frame_mb);
+  clear_rddata(currSlice, &currSlice->rddata_top_field_mb);
+  clear_rddata(currSlice, &currSlice->rddata_bot_field_mb);
+
+  if (currSlice->p_EPZS)
+    EPZSStructReset(currSlice);
+}
+
 /*!
  ************************************************************************
  * \brief
@@ -2130,20 +2545,12 @@ void free_slice(Slice *currSlice)
 {
   if (currSlice != NULL)
   {
-    VideoParameters *p_Vid = currSlice->p_Vid;
     InputParameters *p_Inp = currSlice->p_Inp;
 
     int i;
     DataPartition *dataPart;
 
-    for (i=0; i<6; i++)
-    {
-      if (currSlice->listX[i])
-      {
-        free (currSlice->listX[i]);
-        currSlice->listX[i] = NULL;
-      }
-    }
+    free_slice_picture_data(currSlice);
 
     for (i = 0; i < currSlice->max_part_nr; i++) // loop over all data partitions
     {
@@ -2167,9 +2574,6 @@ void free_slice(Slice *currSlice)
       }
     }
 
-    if (currSlice->slice_type != I_SLICE && currSlice->slice_type != SI_SLICE)
-      free_ref_pic_list_reordering_buffer (currSlice);
-
     // free structure for rd-opt. mode decision
     if(currSlice->p_RDO)
     {
@@ -2217,80 +2621,44 @@ void free_slice(Slice *currSlice)
       free_mem4Dshort(currSlice->wbp_weight);
     }
 
-    if (currSlice->UseRDOQuant)
-    {
-      free(currSlice->estBitsCabac);
-
-      free_rddata(currSlice, &currSlice->rddata_trellis_curr);
-      if(currSlice->RDOQ_QP_Num > 1)
-      {
-        free_rddata(currSlice, &currSlice->rddata_trellis_best);
-      }
-    }
-
-    if(currSlice->mb_aff_frame_flag)
-    {
-      free_rddata(currSlice, &currSlice->rddata_top_frame_mb);
-      free_rddata(currSlice, &currSlice->rddata_bot_frame_mb);
-
-      if ( p_Inp->MbInterlace != FRAME_MB_PAIR_CODING )
-      {
-        free_rddata(currSlice, &currSlice->rddata_top_field_mb);
-        free_rddata(currSlice, &currSlice->rddata_bot_field_mb);
-      }
-    }
-
-    if ((currSlice->slice_type == P_SLICE) || (currSlice->slice_type == SP_SLICE) || (currSlice->slice_type == B_SLICE))
-    {
-      if(currSlice->all_mv)
-        free_mem5Dmv (currSlice->all_mv);
-      if (p_Inp->BiPredMotionEstimation && (currSlice->slice_type == B_SLICE) && currSlice->bipred_mv)
-        free_mem6Dmv(currSlice->bipred_mv);
-
-      if (currSlice->UseRDOQuant && currSlice->RDOQ_QP_Num > 1)
-      {
-        if (p_Inp->Transform8x8Mode && p_Inp->RDOQ_CP_MV)
-        {
-          if(currSlice->tmp_mv8)
-            free_mem4Dmv (currSlice->tmp_mv8);
-          if(currSlice->motion_cost8)
-            free_mem3Ddistblk(currSlice->motion_cost8);
-          if(currSlice->tmp_mv4)
-            free_mem4Dmv (currSlice->tmp_mv4);
-          if(currSlice->motion_cost4)
-            free_mem3Ddistblk(currSlice->motion_cost4);
-        }
-      }
-    }
+    free_block_mem(currSlice);
 
-    if (currSlice->slice_type == B_SLICE)
-    {
-      if(currSlice->direct_ref_idx)
-        free_mem3D((byte ***)currSlice->direct_ref_idx);
-      if(currSlice->direct_pdir)
-        free_mem2D((byte **) currSlice->direct_pdir);
-    }
+    mem_free(currSlice);
+  }
+}
 
-    free_block_mem(currSlice);
+/*!
+ ************************************************************************
+ * \brief
+ *    Returns a slice to the slice pool of its encoder. The slice keeps
+ *    its picture data until it is taken again by get_slice().
+ ************************************************************************
+ */
+static void release_slice(Slice *currSlice)
+{
+  SlicePool *pool = currSlice->p_Vid->p_SlicePool;
 
-    if (currSlice->slice_type != I_SLICE && currSlice->slice_type != SI_SLICE)
-    {
-      if (p_Inp->SearchMode[p_Vid->view_id] == EPZS)
-      {
-        if(currSlice->p_EPZS)
-          EPZSStructDelete (currSlice);    
-      }
-    }
+  if (pool == NULL)
+  {
+    free_slice(currSlice);
+    return;
+  }
 
-    free(currSlice);
+  if (pool->count == pool->size)
+  {
+    pool->size = imax(2 * pool->size, 4);
+    if ((pool->slices = (Slice **) realloc(pool->slices, pool->size * sizeof(Slice *))) == NULL)
+      no_mem_exit("release_slice: pool->slices");
   }
+  pool->slices[pool->count++] = currSlice;
 }
 
 /*!
  ************************************************************************
  * \brief
  *    Memory frees of all Slice structures and of its dependent
- *    data structures
+ *    data structures. The slices are kept in the slice pool for the
+ *    following pictures.
  * \par Input:
  *    Picture *currPic
  ************************************************************************
@@ -2305,7 +2673,8 @@ void free_slice_list(Picture *currPic)
 
     for (i = 0; i < currPic->no_slices; i++)
     {
-      free_slice (currPic->slices[i]);
+      if (currPic->slices[i] != NULL)
+        release_slice (currPic->slices[i]);
       currPic->slices[i] = NULL;
     }
   }
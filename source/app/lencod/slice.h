@@ -33,6 +33,13 @@ static const int QP2QUANT[40]=
   40,45,51,57,64,72,81,91
 };
 
+//! slices of the previous pictures kept for reuse
+typedef struct slice_pool
+{
+  Slice **slices;
+  int     count;       //!< number of slices in the pool
+  int     size;        //!< allocated size of slices
+} SlicePool;
 
 extern int  encode_one_slice       ( VideoParameters *p_Vid, int SliceGroupId, int TotalCodedMBs );
 extern int  encode_one_slice_MBAFF ( VideoParameters *p_Vid, int SliceGroupId, int TotalCodedMBs );
@@ -44,5 +51,8 @@ extern void SetLagrangianMultipliersOn (Slice *currSlice);
 extern void SetLagrangianMultipliersOff(Slice *currSlice);
 extern void  free_slice                (Slice *currSlice);
 
+extern SlicePool *alloc_slice_pool(void);
+extern void       free_slice_pool (SlicePool *pool);
+
 
 #endif
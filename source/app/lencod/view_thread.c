@@ -0,0 +1,424 @@
+/*!
+ ***********************************************************************
+ * \file
+ *    view_thread.c
+ * \brief
+ *    Pipelined encoding of the non-base view of stereo sequences.
+ *    Each view 1 picture is encoded by a worker thread on a private
+ *    copy of the VideoParameters while the calling thread encodes the
+ *    next view 0 picture, which never references view 1. The calling
+ *    thread waits for the worker before the view 0 picture is written,
+ *    so the NAL units keep their order and view 1 finds its inter-view
+ *    reference in the DPB. The worker is started once and waits for
+ *    the pictures. The buffers the views share in the serial encoder
+ *    are duplicated for the worker. The adaptive rounding offsets, the
+ *    adaptive context initialization and the context adaptive
+ *    Lagrangian costs are adapted by each picture for the next one in
+ *    coding order; these tools keep the views serial, so that the
+ *    bitstream does not depend on ViewThreads.
+ ***********************************************************************
+ */
+
+#include "global.h"
+#include "view_thread.h"
+#include "macroblock.h"
+#include "memalloc.h"
+#include "context_ini.h"
+#include "input.h"
+#include "slice.h"
+
+#if (MVC_EXTENSION_ENABLE)
+
+extern Picture *malloc_picture   (void);
+extern void     free_picture     (Picture *pic);
+extern int      init_orig_buffers(VideoParameters *p_Vid, ImageData *imgData);
+extern void     free_orig_planes (VideoParameters *p_Vid, ImageData *imgData);
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    allocates the private buffers of the view 1 encoder
+ ***********************************************************************
+ */
+static void alloc_view_buffers(ViewThreads *vt, VideoParameters *p_Vid)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  int max_bitdepth = imax(p_Inp->output.bit_depth[0], p_Inp->output.bit_depth[1]);
+  int max_qp = (3 + 6*(max_bitdepth));
+  int qp_scale = p_Vid->bitdepth_luma_qp_scale;
+  int j;
+
+  if ((vt->mb_data = alloc_mbs(p_Vid, p_Vid->FrameSizeInMbs, p_Vid->num_of_layers)) == NULL)
+    no_mem_exit("alloc_view_buffers: vt->mb_data");
+  if ((vt->b8x8info = (Block8x8Info *) calloc(1, sizeof(Block8x8Info))) == NULL)
+    no_mem_exit("alloc_view_buffers: vt->b8x8info");
+  if (p_Vid->intra_block && (vt->intra_block = (short *) calloc(p_Vid->FrameSizeInMbs, sizeof(short))) == NULL)
+    no_mem_exit("alloc_view_buffers: vt->intra_block");
+
+  get_mem2D((byte***) &vt->ipredmode, p_Vid->height_blk, p_Vid->width_blk);
+  get_mem2D((byte***) &vt->ipredmode8x8, p_Vid->height_blk, p_Vid->width_blk);
+  memset(&vt->ipredmode[0][0], -1, p_Vid->height_blk * p_Vid->width_blk * sizeof(char));
+  memset(&vt->ipredmode8x8[0][0], -1, p_Vid->height_blk * p_Vid->width_blk * sizeof(char));
+
+  // a separate buffer for view 1 exists already if the views differ in the chroma format
+  if (p_Vid->nz_coeff_buf[1] == p_Vid->nz_coeff_buf[0])
+    get_mem3Dint(&vt->nz_coeff, p_Vid->FrameSizeInMbs, 4, 4 + p_Vid->num_blk8x8_uv);
+
+  get_mem2Dolm    (&vt->lambda   , 10, 52 + qp_scale, qp_scale);
+  get_mem2Dodouble(&vt->lambda_md, 10, 52 + qp_scale, qp_scale);
+  get_mem3Dodouble(&vt->lambda_me, 10, 52 + qp_scale, 3, qp_scale);
+  get_mem3Doint   (&vt->lambda_mf, 10, 52 + qp_scale, 3, qp_scale);
+  if (p_Inp->UseRDOQuant)
+    get_mem2Dodouble(&vt->lambda_rdoq, 10, 52 + qp_scale, qp_scale);
+  if (p_Inp->CtxAdptLagrangeMult == 1)
+    get_mem2Dodouble(&vt->lambda_mf_factor, 10, 52 + qp_scale, qp_scale);
+
+  if (p_Vid->ARCofAdj4x4)
+  {
+    int planes = (p_Vid->yuv_format != YUV400) ? 3 : 1;
+    get_mem4Dint(&vt->ARCofAdj4x4, planes, MAXMODE, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+    get_mem4Dint(&vt->ARCofAdj8x8, (p_Vid->yuv_format != YUV400 && p_Vid->P444_joined) ? 3 : 1, MAXMODE, MB_BLOCK_SIZE, MB_BLOCK_SIZE);
+  }
+  if (p_Vid->wp_weights)
+  {
+    get_mem4Dshort(&vt->wp_weights, 3, 2, MAX_REFERENCE_PICTURES, p_Vid->num_slices_wp);
+    get_mem4Dshort(&vt->wp_offsets, 3, 2, MAX_REFERENCE_PICTURES, p_Vid->num_slices_wp);
+    get_mem5Dshort(&vt->wbp_weight, 3, 2, MAX_REFERENCE_PICTURES, MAX_REFERENCE_PICTURES, p_Vid->num_slices_wp);
+  }
+  if (p_Vid->motion_cost[0])
+    get_mem_MBcost(vt->motion_cost, 2, p_Vid->max_num_references);
+  if (p_Vid->imgY_sub_tmp)
+  {
+    MemTag mem_tag = mem_set_tag(MEM_SUBPEL);
+    get_mem2Dint_pad(&vt->imgY_sub_tmp, p_Vid->height, p_Vid->width, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
+    mem_set_tag(mem_tag);
+  }
+
+  init_orig_buffers(p_Vid, &vt->imgData);
+  init_orig_buffers(p_Vid, &vt->imgData0);
+  if (p_Inp->MDReference[0] || p_Inp->MDReference[1])
+    init_orig_buffers(p_Vid, &vt->imgRefData);
+  if ((vt->buf = malloc(p_Inp->source.size * p_Inp->source.pic_unit_size_shift3)) == NULL)
+    no_mem_exit("alloc_view_buffers: vt->buf");
+  if (p_Vid->ibuf && (vt->ibuf = malloc(p_Inp->source.size * p_Inp->source.pic_unit_size_shift3)) == NULL)
+    no_mem_exit("alloc_view_buffers: vt->ibuf");
+
+  if ((vt->enc_frame_picture = (StorablePicture **) calloc(6, sizeof(StorablePicture *))) == NULL)
+    no_mem_exit("alloc_view_buffers: vt->enc_frame_picture");
+  if ((vt->enc_field_picture = (StorablePicture **) calloc(2, sizeof(StorablePicture *))) == NULL)
+    no_mem_exit("alloc_view_buffers: vt->enc_field_picture");
+  if ((vt->frame_pic = (Picture **) calloc(p_Vid->frm_iter, sizeof(Picture *))) == NULL)
+    no_mem_exit("alloc_view_buffers: vt->frame_pic");
+  for (j = 0; j < p_Vid->frm_iter; j++)
+    vt->frame_pic[j] = malloc_picture();
+  vt->slice_pool = alloc_slice_pool();
+
+  // the q matrices are computed for each picture, the offsets are constant without adaptive rounding
+  memcpy(&vt->quant, p_Vid->p_Quant, sizeof(QuantParameters));
+  get_mem5Dquant(&vt->quant.q_params_4x4, 3, 2, max_qp + 1, 4, 4);
+  get_mem5Dquant(&vt->quant.q_params_8x8, 3, 2, max_qp + 1, 8, 8);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    frees the private buffers of the view 1 encoder
+ ***********************************************************************
+ */
+static void free_view_buffers(ViewThreads *vt, VideoParameters *p_Vid)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  int qp_scale = p_Vid->bitdepth_luma_qp_scale;
+  int j;
+
+  free_mbs(vt->mb_data, p_Vid->FrameSizeInMbs);
+  free(vt->b8x8info);
+  free(vt->intra_block);
+  free_mem2D((byte**) vt->ipredmode);
+  free_mem2D((byte**) vt->ipredmode8x8);
+  if (vt->nz_coeff)
+    free_mem3Dint(vt->nz_coeff);
+
+  free_mem2Dolm    (vt->lambda, qp_scale);
+  free_mem2Dodouble(vt->lambda_md, qp_scale);
+  free_mem3Dodouble(vt->lambda_me, 10, 52 + qp_scale, qp_scale);
+  free_mem3Doint   (vt->lambda_mf, 10, 52 + qp_scale, qp_scale);
+  if (vt->lambda_rdoq)
+    free_mem2Dodouble(vt->lambda_rdoq, qp_scale);
+  if (vt->lambda_mf_factor)
+    free_mem2Dodouble(vt->lambda_mf_factor, qp_scale);
+
+  if (vt->ARCofAdj4x4)
+  {
+    free_mem4Dint(vt->ARCofAdj4x4);
+    free_mem4Dint(vt->ARCofAdj8x8);
+  }
+  if (vt->wp_weights)
+  {
+    free_mem4Dshort(vt->wp_weights);
+    free_mem4Dshort(vt->wp_offsets);
+    free_mem5Dshort(vt->wbp_weight);
+  }
+  if (vt->motion_cost[0])
+    free_mem_MBcost(vt->motion_cost);
+  if (vt->imgY_sub_tmp)
+    free_mem2Dint_pad(vt->imgY_sub_tmp, IMG_PAD_SIZE_Y, IMG_PAD_SIZE_X);
+
+  free_orig_planes(p_Vid, &vt->imgData);
+  free_orig_planes(p_Vid, &vt->imgData0);
+  if (p_Inp->MDReference[0] || p_Inp->MDReference[1])
+    free_orig_planes(p_Vid, &vt->imgRefData);
+  free(vt->buf);
+  free(vt->ibuf);
+  free(vt->MapUnitToSliceGroupMap);
+  free(vt->MBAmap);
+
+  free(vt->enc_frame_picture);
+  free(vt->enc_field_picture);
+  for (j = 0; j < p_Vid->frm_iter; j++)
+    free_picture(vt->frame_pic[j]);
+  free(vt->frame_pic);
+  free_slice_pool(vt->slice_pool);
+
+  free_mem5Dquant(vt->quant.q_params_4x4);
+  free_mem5Dquant(vt->quant.q_params_8x8);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    worker thread: encodes each dispatched view 1 picture
+ ***********************************************************************
+ */
+static void view_worker(void *arg)
+{
+  ViewThreads *vt = (ViewThreads *) arg;
+
+  mutex_lock(&vt->lock);
+  while (!vt->quit)
+  {
+    if (!vt->busy)
+    {
+      cond_wait(&vt->cond, &vt->lock);
+      continue;
+    }
+    mutex_unlock(&vt->lock);
+
+    encode_current_frame(vt->p_Vid, vt->p_Vid->p_Inp, vt->curr_frame_to_code);
+
+    mutex_lock(&vt->lock);
+    vt->busy = 0;
+    cond_broadcast(&vt->cond);
+  }
+  mutex_unlock(&vt->lock);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    enables pipelined view encoding if requested and possible with
+ *    the encoder configuration. Tools that keep state in the input
+ *    parameters or in buffers that are not duplicated for the worker,
+ *    and tools that adapt their state from picture to picture, keep
+ *    the views serial.
+ ***********************************************************************
+ */
+void init_view_threads(VideoParameters *p_Vid)
+{
+  InputParameters *p_Inp = p_Vid->p_Inp;
+  ViewThreads *vt;
+  int i;
+
+  // profiling and tracing need the pictures in coding order
+  if (p_Inp->ViewThreads <= 0 || p_Vid->num_of_layers != 2 || p_Vid->enc_profile != NULL || TRACE)
+    return;
+
+  if (p_Inp->PicInterlace || p_Inp->MbInterlace || p_Inp->RCEnable || p_Inp->rdopt == 3 || p_Inp->redundant_pic_flag
+    || p_Inp->ExplicitSeqCoding || p_Inp->ReportFrameStats || p_Inp->RestrictRef || p_Inp->RandomIntraMBRefresh
+    || p_Inp->partition_mode || p_Inp->sp_periodicity || p_Inp->si_frame_indicator || p_Inp->separate_colour_plane_flag
+    || p_Inp->HMEEnable || p_Inp->WPMCPrecision || p_Inp->ProcessInput || p_Inp->enable_32_pulldown || p_Inp->DistortionYUVtoRGB)
+    return;
+
+  // the next picture in coding order depends on these updates, which the views would otherwise make out of order
+  if (p_Inp->AdaptiveRounding || p_Inp->context_init_method || p_Inp->CtxAdptLagrangeMult)
+    return;
+
+  // the fast motion searches keep per picture state in the VideoParameters
+  for (i = 0; i < 2; i++)
+  {
+    if (p_Inp->SearchMode[i] != EPZS && p_Inp->SearchMode[i] != FULL_SEARCH)
+      return;
+  }
+
+  if ((vt = (ViewThreads *) calloc(1, sizeof(ViewThreads))) == NULL)
+    no_mem_exit("init_view_threads: vt");
+  if ((vt->p_Vid = (VideoParameters *) calloc(1, sizeof(VideoParameters))) == NULL)
+    no_mem_exit("init_view_threads: vt->p_Vid");
+
+  alloc_view_buffers(vt, p_Vid);
+  mutex_init(&vt->lock);
+  cond_init(&vt->cond);
+  if (thread_create(&vt->thread, view_worker, vt))
+    error("init_view_threads: cannot create view thread", 500);
+  p_Vid->p_ViewThreads = vt;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    stops the view thread and frees its resources
+ ***********************************************************************
+ */
+void free_view_threads(VideoParameters *p_Vid)
+{
+  ViewThreads *vt = p_Vid->p_ViewThreads;
+
+  if (vt == NULL)
+    return;
+
+  view_threads_drain(p_Vid);
+
+  mutex_lock(&vt->lock);
+  vt->quit = 1;
+  cond_broadcast(&vt->cond);
+  mutex_unlock(&vt->lock);
+  thread_join(vt->thread);
+  mutex_destroy(&vt->lock);
+  cond_destroy(&vt->cond);
+
+  free_view_buffers(vt, p_Vid);
+  free(vt->p_Vid);
+  free(vt);
+  p_Vid->p_ViewThreads = NULL;
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    starts encoding the current (view 1) picture on the worker
+ *    thread; returns without waiting for it
+ ***********************************************************************
+ */
+void view_threads_dispatch(VideoParameters *p_Vid, int curr_frame_to_code)
+{
+  ViewThreads *vt = p_Vid->p_ViewThreads;
+  VideoParameters *p_Job = vt->p_Vid;
+
+  view_threads_drain(p_Vid);
+
+  memcpy(&vt->stats, p_Vid->p_Stats, sizeof(StatParameters));
+  memcpy(&vt->dist, p_Vid->p_Dist, sizeof(DistortionParams));
+  vt->tot_time     = p_Vid->tot_time;
+  vt->me_tot_time  = p_Vid->me_tot_time;
+  vt->frame_ctr    = p_Vid->p_Dist->frame_ctr;
+  vt->frame_ctr_v0 = p_Vid->p_Dist->frame_ctr_v[0];
+
+  memcpy(p_Job, p_Vid, sizeof(VideoParameters));
+  p_Job->p_ViewThreads      = NULL;
+  p_Job->p_Stats            = &vt->stats;
+  p_Job->p_Dist             = &vt->dist;
+  p_Job->p_Quant            = &vt->quant;
+  p_Job->mb_data            = vt->mb_data;
+  p_Job->b8x8info           = vt->b8x8info;
+  p_Job->intra_block        = vt->intra_block;
+  p_Job->ipredmode          = vt->ipredmode;
+  p_Job->ipredmode8x8       = vt->ipredmode8x8;
+  if (vt->nz_coeff)
+    p_Job->nz_coeff_buf[1]  = vt->nz_coeff;
+  p_Job->lambda_buf[1]           = vt->lambda;
+  p_Job->lambda_md_buf[1]        = vt->lambda_md;
+  p_Job->lambda_me_buf[1]        = vt->lambda_me;
+  p_Job->lambda_mf_buf[1]        = vt->lambda_mf;
+  p_Job->lambda_rdoq_buf[1]      = vt->lambda_rdoq;
+  p_Job->lambda_mf_factor_buf[1] = vt->lambda_mf_factor;
+  p_Job->ARCofAdj4x4        = vt->ARCofAdj4x4;
+  p_Job->ARCofAdj8x8        = vt->ARCofAdj8x8;
+  p_Job->wp_weights         = vt->wp_weights;
+  p_Job->wp_offsets         = vt->wp_offsets;
+  p_Job->wbp_weight         = vt->wbp_weight;
+  p_Job->motion_cost[0]     = vt->motion_cost[0];
+  p_Job->motion_cost[1]     = vt->motion_cost[1];
+  p_Job->imgY_sub_tmp       = vt->imgY_sub_tmp;
+  p_Job->imgData            = vt->imgData;
+  p_Job->imgData0           = vt->imgData0;
+  p_Job->imgRefData         = vt->imgRefData;
+  p_Job->buf                = vt->buf;
+  p_Job->ibuf               = vt->ibuf;
+  p_Job->MapUnitToSliceGroupMap = vt->MapUnitToSliceGroupMap;
+  p_Job->MBAmap             = vt->MBAmap;
+  p_Job->enc_frame_picture  = vt->enc_frame_picture;
+  p_Job->enc_field_picture  = vt->enc_field_picture;
+  p_Job->frame_pic          = vt->frame_pic;
+  p_Job->p_SlicePool        = vt->slice_pool;
+
+  // pictures stored into the view 1 DPB are output with the state of the worker
+  p_Vid->p_Dpb_layer[1]->p_Vid = p_Job;
+
+  // a view 1 picture never passes its anchor status on to the next view 0 picture
+  p_Vid->prev_view_is_anchor = 0;
+
+  vt->curr_frame_to_code = curr_frame_to_code;
+  vt->pending = 1;
+
+  mutex_lock(&vt->lock);
+  vt->busy = 1;
+  cond_broadcast(&vt->cond);
+  mutex_unlock(&vt->lock);
+}
+
+/*!
+ ***********************************************************************
+ * \brief
+ *    waits for the pending view 1 picture, if any, and merges the
+ *    statistics and sequence counters of the worker into the calling
+ *    thread. The calling thread may be in the middle of a view 0
+ *    picture: its own updates of the bit and frame counters are kept.
+ ***********************************************************************
+ */
+void view_threads_drain(VideoParameters *p_Vid)
+{
+  ViewThreads *vt = p_Vid->p_ViewThreads;
+  VideoParameters *p_Job;
+  int bit_slice, stored_bit_slice, frame_ctr, frame_ctr_v0;
+
+  if (vt == NULL || !vt->pending)
+    return;
+
+  p_Job = vt->p_Vid;
+  mutex_lock(&vt->lock);
+  while (vt->busy)
+    cond_wait(&vt->cond, &vt->lock);
+  mutex_unlock(&vt->lock);
+  vt->pending = 0;
+
+  bit_slice        = p_Vid->p_Stats->bit_slice;
+  stored_bit_slice = p_Vid->p_Stats->stored_bit_slice;
+  memcpy(p_Vid->p_Stats, &vt->stats, sizeof(StatParameters));
+  p_Vid->p_Stats->bit_slice        = bit_slice;
+  p_Vid->p_Stats->stored_bit_slice = stored_bit_slice;
+
+  frame_ctr    = p_Vid->p_Dist->frame_ctr - vt->frame_ctr;
+  frame_ctr_v0 = p_Vid->p_Dist->frame_ctr_v[0] - vt->frame_ctr_v0;
+  memcpy(p_Vid->p_Dist, &vt->dist, sizeof(DistortionParams));
+  p_Vid->p_Dist->frame_ctr      += frame_ctr;
+  p_Vid->p_Dist->frame_ctr_v[0] += frame_ctr_v0;
+
+  p_Vid->tot_time    += p_Job->tot_time - vt->tot_time;
+  p_Vid->me_tot_time += p_Job->me_tot_time - vt->me_tot_time;
+  p_Vid->consecutive_non_reference_pictures = p_Job->consecutive_non_reference_pictures;
+  p_Vid->prev_frame_no            = p_Job->prev_frame_no;
+  p_Vid->CurrentRTPSequenceNumber = p_Job->CurrentRTPSequenceNumber;
+  p_Vid->lastINTRA                = p_Job->lastINTRA;
+  p_Vid->lastIntraNumber          = p_Job->lastIntraNumber;
+  p_Vid->last_idr_disp_order      = p_Job->last_idr_disp_order;
+  p_Vid->last_idr_code_order      = p_Job->last_idr_code_order;
+  p_Vid->last_valid_reference     = p_Job->last_valid_reference;
+
+  // FmoInit() reallocates the slice group maps for each picture
+  vt->MapUnitToSliceGroupMap = p_Job->MapUnitToSliceGroupMap;
+  vt->MBAmap                 = p_Job->MBAmap;
+
+  p_Vid->p_Dpb_layer[1]->p_Vid = p_Vid;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*!
+ **************************************************************************
+ *  \file view_thread.h
+ *
+ *  \brief
+ *     Pipelined encoding of the non-base view of stereo sequences
+ *     (enabled with the ViewThreads parameter)
+ *
+ **************************************************************************
+ */
+
+#ifndef _VIEW_THREAD_H_
+#define _VIEW_THREAD_H_
+#include "global.h"
+#include "mbuffer.h"
+#include "enc_statistics.h"
+#include "quant_params.h"
+
+//! view 1 picture encoded by a worker thread while the calling thread encodes the next view 0 picture
+typedef struct view_threads
+{
+  VideoParameters      *p_Vid;                //!< private copy of the encoder state view 1 is encoded with
+  ThreadHandle          thread;
+  ThreadMutex           lock;                 //!< protects busy and quit
+  ThreadCond            cond;                 //!< signals a dispatched picture to the worker and its completion to the caller
+  int                   busy;                 //!< a view 1 picture has been dispatched and not encoded yet
+  int                   quit;
+  int                   pending;              //!< a view 1 picture has been dispatched and not merged yet
+  int                   curr_frame_to_code;
+
+  // counters of the calling thread when the picture was dispatched
+  int64                 tot_time;
+  int64                 me_tot_time;
+  int                   frame_ctr;
+  int                   frame_ctr_v0;
+
+  // state updated by both views in the calling thread, private to the job
+  StatParameters        stats;
+  DistortionParams      dist;
+  QuantParameters       quant;
+  Macroblock           *mb_data;
+  Block8x8Info         *b8x8info;
+  short                *intra_block;
+  char                **ipredmode;
+  char                **ipredmode8x8;
+  int                ***nz_coeff;
+  LambdaParams        **lambda;
+  double              **lambda_md;
+  double             ***lambda_me;
+  int                ***lambda_mf;
+  double              **lambda_rdoq;
+  double              **lambda_mf_factor;
+  int               ****ARCofAdj4x4;
+  int               ****ARCofAdj8x8;
+  short             ****wp_weights;
+  short             ****wp_offsets;
+  short            *****wbp_weight;
+  MBMotionCosts       *motion_cost[2];
+  int                 **imgY_sub_tmp;
+  ImageData             imgData;
+  ImageData             imgData0;
+  ImageData             imgRefData;
+  byte                 *buf;
+  byte                 *ibuf;
+  byte                 *MapUnitToSliceGroupMap;
+  byte                 *MBAmap;
+  StorablePicture     **enc_frame_picture;
+  StorablePicture     **enc_field_picture;
+  Picture             **frame_pic;
+  struct slice_pool    *slice_pool;
+} ViewThreads;
+
+extern void init_view_threads    (VideoParameters *p_Vid);
+extern void free_view_threads    (VideoParameters *p_Vid);
+extern void view_threads_dispatch(VideoParameters *p_Vid, int curr_frame_to_code);
+extern void view_threads_drain   (VideoParameters *p_Vid);
+
+#endif
@@ -25,9 +25,6 @@
 #include "memalloc.h"
 #include "fast_memory.h"
 
-void buf2img_basic    ( imgpel** imgX, unsigned char* buf, int size_x, int size_y, int o_size_x, int o_size_y, int symbol_size_in_bytes, int bitshift);
-void buf2img_endian   ( imgpel** imgX, unsigned char* buf, int size_x, int size_y, int o_size_x, int o_size_y, int symbol_size_in_bytes, int bitshift);
-void buf2img_bitshift ( imgpel** imgX, unsigned char* buf, int size_x, int size_y, int o_size_x, int o_size_y, int symbol_size_in_bytes, int bitshift);
 void fillPlane        ( imgpel** imgX, int nVal, int size_x, int size_y);
 
 /*!
@@ -808,7 +805,11 @@ int read_one_frame (VideoParameters *p_Vid, VideoDataFile *input_file, int Frame
 
   Boolean rgb_input = (Boolean) (source->color_model == CM_RGB && source->yuv_format == YUV444);
 
-  if (input_file->is_concatenated == 0)
+  if (input_file->vdtype == VIDEO_MEMORY)
+  {
+    file_read = ReadFrameMemory   (input_file, FrameNoInFile, source, p_Vid->buf);
+  }
+  else if (input_file->is_concatenated == 0)
   {    
     if (input_file->vdtype == VIDEO_TIFF)
     {
@@ -202,3 +202,38 @@ int ReadFrameSeparate (InputParameters *p_Inp, VideoDataFile *input_file, int Fr
 
   return file_read;
 }
+
+/*!
+ ************************************************************************
+ * \brief
+ *    Reads one new frame from the frames an application has handed
+ *    over to the encoder (VIDEO_MEMORY)
+ *
+ * \param input_file
+ *    Input "file" holding the frames
+ * \param FrameNoInFile
+ *    Frame number in the source sequence
+ * \param source
+ *    source frame information
+ * \param buf
+ *    image buffer data
+ ************************************************************************
+ */
+int ReadFrameMemory (VideoDataFile *input_file, int FrameNoInFile, FrameFormat *source, unsigned char *buf)
+{
+  unsigned int symbol_size_in_bytes = source->pic_unit_size_shift3;
+  int framesize_in_bytes = (source->size_cmp[0] + 2 * source->size_cmp[1]) * symbol_size_in_bytes;
+  int i;
+
+  for (i = 0; i < input_file->num_mem_frames; i++)
+  {
+    if (input_file->mem_frames[i].frame_no == FrameNoInFile)
+    {
+      memcpy(buf, input_file->mem_frames[i].buf, framesize_in_bytes);
+      return 1;
+    }
+  }
+
+  printf ("read_one_frame: frame %d has not been passed to the encoder\n", FrameNoInFile);
+  return 0;
+}
@@ -17,6 +17,7 @@
 
 extern int ReadFrameConcatenated  (InputParameters *p_Inp, VideoDataFile *input_file, int FrameNoInFile, int HeaderSize, FrameFormat *source, unsigned char *buf);
 extern int ReadFrameSeparate      (InputParameters *p_Inp, VideoDataFile *input_file, int FrameNoInFile, int HeaderSize, FrameFormat *source, unsigned char *buf);
+extern int ReadFrameMemory        (VideoDataFile *input_file, int FrameNoInFile, FrameFormat *source, unsigned char *buf);
 
 #endif
 
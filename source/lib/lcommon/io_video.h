@@ -28,9 +28,18 @@ typedef enum {
   VIDEO_RGB     =  1,
   VIDEO_XYZ     =  2,
   VIDEO_TIFF    =  3,
-  VIDEO_AVI     =  4
+  VIDEO_AVI     =  4,
+  VIDEO_MEMORY  =  5   //!< frames handed over by an application, see h264encoder.h
 } VideoFileType;
 
+//! one frame of a VIDEO_MEMORY source
+typedef struct memory_frame
+{
+  int            frame_no;             //!< frame number of the frame held, -1 if the entry is free
+  int64          pts;                  //!< presentation time stamp given by the application
+  unsigned char *buf;                  //!< frame in the layout of a planar raw file
+} MemoryFrame;
+
 typedef struct video_data_file
 {
   //char*         fname;          //!< video file name
@@ -52,6 +61,9 @@ typedef struct video_data_file
   int           crop_x_offset;         //!< crop offset (x component);
   int           crop_y_offset;         //!< crop offset (y component);
 
+  MemoryFrame  *mem_frames;            //!< frames of a VIDEO_MEMORY source that are not coded yet
+  int           num_mem_frames;        //!< number of entries in mem_frames
+
   // AVI related information to be added here
   int* avi;
   //avi_t* avi;
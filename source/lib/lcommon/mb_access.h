@@ -16,6 +16,14 @@
 #ifndef _MB_ACCESS_H_
 #define _MB_ACCESS_H_
 
+//! bits of MbNeighbours::inside
+enum {
+  NB_A = 1,
+  NB_B = 2,
+  NB_C = 4,
+  NB_D = 8
+};
+
 extern void CheckAvailabilityOfNeighbors(Macroblock *currMB);
 extern void CheckAvailabilityOfNeighborsMBAFF(Macroblock *currMB);
 extern void CheckAvailabilityOfNeighborsNormal(Macroblock *currMB);
@@ -28,6 +36,7 @@ extern Boolean mb_is_available      (int mbAddr, Macroblock *currMB);
 extern void get_mb_pos              (VideoParameters *p_Vid, int mb_addr, int mb_size[2], short *x, short *y);
 extern void get_mb_block_pos_normal (BlockPos *PicPos, int mb_addr, short *x, short *y);
 extern void get_mb_block_pos_mbaff  (BlockPos *PicPos, int mb_addr, short *x, short *y);
+extern void init_mb_neighbours      (MbNeighbours *PicNeighbours, int PicWidthInMbs, int FrameSizeInMbs);
 
 
 #endif
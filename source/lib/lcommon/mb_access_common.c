@@ -0,0 +1,50 @@
+/*!
+ *************************************************************************************
+ * \file mb_access_common.c
+ *
+ * \brief
+ *    Common (Encoder/Decoder) functions for macroblock neighborhoods
+ *
+ *************************************************************************************
+ */
+
+#include "global.h"
+#include "mb_access.h"
+
+/*!
+ ************************************************************************
+ * \brief
+ *    fills the neighbour table of a picture with the given size.
+ *    The entry of a macroblock address (of a macroblock pair address in
+ *    MBAFF frames) holds the addresses of its neighbours A, B, C and D
+ *    and which of them lie inside the picture. Whether a neighbour
+ *    belongs to the same slice is left to the caller.
+ ************************************************************************
+ */
+void init_mb_neighbours(MbNeighbours *PicNeighbours, int PicWidthInMbs, int FrameSizeInMbs)
+{
+  int i;
+
+  for (i = 0; i < FrameSizeInMbs; i++)
+  {
+    MbNeighbours *nb = &PicNeighbours[i];
+    int x = i % PicWidthInMbs;
+
+    nb->mbAddrA = i - 1;
+    nb->mbAddrB = i - PicWidthInMbs;
+    nb->mbAddrC = i - PicWidthInMbs + 1;
+    nb->mbAddrD = i - PicWidthInMbs - 1;
+
+    nb->inside = 0;
+    if (x != 0)
+      nb->inside |= NB_A;
+    if (i >= PicWidthInMbs)
+    {
+      nb->inside |= NB_B;
+      if (x != PicWidthInMbs - 1)
+        nb->inside |= NB_C;
+      if (x != 0)
+        nb->inside |= NB_D;
+    }
+  }
+}
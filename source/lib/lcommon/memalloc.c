@@ -18,6 +18,147 @@
 #include "global.h"
 #include "memalloc.h"
 
+//! bytes in front of every mem_malloc() block: its size and tag, keeps the malloc() alignment
+#define MEM_HEADER_SIZE 16
+
+typedef struct mem_header
+{
+  size_t size;
+  int    tag;
+} MemHeader;
+
+static const char *mem_tag_name[MEM_NUM_TAGS] = { "other", "dpb", "subpel", "me", "rdo", "hme", "epzs", "mb", "slice" };
+
+// current and peak bytes per tag, the last entry holds the sum over all tags
+static int64 mem_current[MEM_NUM_TAGS + 1];
+static int64 mem_peak   [MEM_NUM_TAGS + 1];
+
+static THREAD_LOCAL MemTag mem_tag = MEM_OTHER;
+
+static void mem_update_peak(int64 *peak, int64 value)
+{
+  int64 old = atomic_load64(peak);
+
+  while (value > old && !atomic_cas64(peak, old, value))
+    old = atomic_load64(peak);
+}
+
+static void mem_account(int tag, int64 size)
+{
+  mem_update_peak(&mem_peak[tag], atomic_add64(&mem_current[tag], size));
+  mem_update_peak(&mem_peak[MEM_NUM_TAGS], atomic_add64(&mem_current[MEM_NUM_TAGS], size));
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    sets the tag the following allocations of the calling thread are
+ *    accounted to and returns the previous one to restore it
+ ************************************************************************/
+MemTag mem_set_tag(MemTag tag)
+{
+  MemTag prev = mem_tag;
+  mem_tag = tag;
+  return prev;
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    allocate memory, accounted to the current tag of the thread
+ ************************************************************************/
+void* mem_malloc(size_t nitems)
+{
+  byte *d;
+  MemHeader *hdr;
+
+  if((d = (byte *) malloc(nitems + MEM_HEADER_SIZE)) == NULL)
+  {
+    no_mem_exit("malloc failed.\n");
+    return NULL;
+  }
+  hdr = (MemHeader *) d;
+  hdr->size = nitems;
+  hdr->tag  = mem_tag;
+  mem_account(hdr->tag, (int64) nitems);
+
+  return d + MEM_HEADER_SIZE;
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    allocate and set memory aligned at SSE_MEMORY_ALIGNMENT
+ *
+ ************************************************************************/
+void* mem_calloc(size_t nitems, size_t size)
+{
+  size_t padded_size = nitems * size; 
+  void *d = mem_malloc(padded_size);
+  memset(d, 0, padded_size);
+  return d;
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    free memory allocated with mem_malloc() or mem_calloc()
+ ************************************************************************/
+void mem_free(void *a)
+{
+  if (a != NULL)
+  {
+    MemHeader *hdr = (MemHeader *) ((byte *) a - MEM_HEADER_SIZE);
+
+    mem_account(hdr->tag, -(int64) hdr->size);
+    free(hdr);
+  }
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    prints the current and the peak memory per tag, tags never used are
+ *    skipped. Only the allocations of mem_malloc()/mem_calloc() and the
+ *    get_mem*() functions are tracked, not plain malloc() calls.
+ ************************************************************************/
+void print_mem_usage(FILE *f, int label_width)
+{
+  int tag;
+
+  fprintf(f, " %-*s: %.2f MB (current %.2f MB)\n", label_width, "Peak tracked memory", (double) mem_peak[MEM_NUM_TAGS] / (1024.0 * 1024.0), (double) mem_current[MEM_NUM_TAGS] / (1024.0 * 1024.0));
+  for (tag = 0; tag < MEM_NUM_TAGS; tag++)
+  {
+    if (mem_peak[tag])
+      fprintf(f, "   %-*s: %.2f MB (current %.2f MB)\n", label_width - 2, mem_tag_name[tag], (double) mem_peak[tag] / (1024.0 * 1024.0), (double) mem_current[tag] / (1024.0 * 1024.0));
+  }
+}
+
+/*!
+ ************************************************************************
+ * \brief
+ *    writes the current and the peak bytes per tag as JSON, tracked
+ *    allocations only (see print_mem_usage())
+ ************************************************************************/
+void write_mem_usage(const char *filename)
+{
+  FILE *f;
+  int tag;
+
+  if ((f = fopen(filename, "w")) == NULL)
+  {
+    fprintf(stderr, "Error open file %s for writing the memory usage\n", filename);
+    return;
+  }
+
+  fprintf(f, "{\n  \"scope\": \"tracked allocations\",\n  \"total\": {\"current\": %" FORMAT_OFF_T ", \"peak\": %" FORMAT_OFF_T "},\n  \"tags\": {", mem_current[MEM_NUM_TAGS], mem_peak[MEM_NUM_TAGS]);
+  for (tag = 0; tag < MEM_NUM_TAGS; tag++)
+    fprintf(f, "%s\n    \"%s\": {\"current\": %" FORMAT_OFF_T ", \"peak\": %" FORMAT_OFF_T "}", tag ? "," : "", mem_tag_name[tag], mem_current[tag], mem_peak[tag]);
+  fprintf(f, "\n  }\n}\n");
+
+  fclose(f);
+}
+
 /*!
  ************************************************************************
  * \brief
@@ -917,7 +1058,7 @@ int get_mem3Dpel(imgpel ****array3D, int dim0, int dim1, int dim2)
 {
   int i, mem_size = dim0 * sizeof(imgpel**);
 
-  if(((*array3D) = (imgpel***)malloc(dim0 * sizeof(imgpel**))) == NULL)
+  if(((*array3D) = (imgpel***)mem_malloc(dim0 * sizeof(imgpel**))) == NULL)
     no_mem_exit("get_mem3Dpel: array3D");
 
   mem_size += get_mem2Dpel(*array3D, dim0 * dim1, dim2);
@@ -2713,7 +2854,7 @@ void free_mem2Ddistblk(distblk **array2D)
       mem_free (*array2D);
     else 
       error ("free_mem2Ddistblk: trying to free unused memory",100);
-    free (array2D);
+    mem_free (array2D);
   } 
   else
   {
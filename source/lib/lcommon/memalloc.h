@@ -184,35 +184,28 @@ extern void free_mem2Dpel_2SLayers(imgpel ***buf0, imgpel ***buf1);
 extern void free_mem3Dpel_2SLayers(imgpel ****buf0, imgpel ****buf1);
 
 
-static inline void* mem_malloc(size_t nitems)
+//! subsystems the memory allocated with mem_malloc() and mem_calloc() is accounted to
+typedef enum
 {
-  void *d;
-  if((d = malloc(nitems)) == NULL)
-  {
-    no_mem_exit("malloc failed.\n");
-    return NULL;
-  }
-  return d;
-}
-
-/*!
- ************************************************************************
- * \brief
- *    allocate and set memory aligned at SSE_MEMORY_ALIGNMENT
- *
- ************************************************************************/
-static inline void* mem_calloc(size_t nitems, size_t size)
-{
-  size_t padded_size = nitems * size; 
-  void *d = mem_malloc(padded_size);
-  memset(d, 0, (int)padded_size);
-  return d;
-}
-
-static inline void mem_free(void *a)
-{
-  free_pointer(a);
-}
+  MEM_OTHER = 0,    //!< everything not tagged otherwise
+  MEM_DPB,          //!< decoded pictures (samples and motion)
+  MEM_SUBPEL,       //!< sub-pel interpolated planes and interpolation buffers
+  MEM_ME,           //!< motion estimation arrays
+  MEM_RDO,          //!< rate distortion optimization buffers
+  MEM_HME,          //!< hierarchical motion estimation pyramids
+  MEM_EPZS,         //!< EPZS predictor and window maps
+  MEM_MB,           //!< macroblock arrays and other frame size buffers
+  MEM_SLICE,        //!< slice structures and their buffers
+  MEM_NUM_TAGS
+} MemTag;
+
+extern void*  mem_malloc(size_t nitems);
+extern void*  mem_calloc(size_t nitems, size_t size);
+extern void   mem_free  (void *a);
+extern MemTag mem_set_tag(MemTag tag);
+
+extern void print_mem_usage(FILE *f, int label_width);
+extern void write_mem_usage(const char *filename);
 
 #endif
 
@@ -21,7 +21,7 @@
  *    Get motion vector predictor
  ************************************************************************
  */
-static void GetMotionVectorPredictorMBAFF (Macroblock *currMB, 
+void GetMotionVectorPredictorMBAFF (Macroblock *currMB, 
                                     PixelPos *block,        // <--> block neighbors
                                     MotionVector *pmv,
                                     short  ref_frame,
@@ -189,7 +189,7 @@ static void GetMotionVectorPredictorMBAFF (Macroblock *currMB,
  *    Get motion vector predictor
  ************************************************************************
  */
-static void GetMotionVectorPredictorNormal (Macroblock *currMB, 
+void GetMotionVectorPredictorNormal (Macroblock *currMB, 
                                             PixelPos *block,      // <--> block neighbors
                                             MotionVector *pmv,
                                             short  ref_frame,
@@ -302,11 +302,3 @@ static void GetMotionVectorPredictorNormal (Macroblock *currMB,
     break;
   }
 }
-
-void init_motion_vector_prediction(Macroblock *currMB, int mb_aff_frame_flag)
-{
-  if (mb_aff_frame_flag)
-    currMB->GetMVPredictor = GetMotionVectorPredictorMBAFF;
-  else
-    currMB->GetMVPredictor = GetMotionVectorPredictorNormal;
-}
@@ -14,6 +14,9 @@
 #ifndef _MV_PREDICTION_H_
 #define _MV_PREDICTION_H_
 
-extern void init_motion_vector_prediction(Macroblock *currMB, int mb_aff_frame_flag);
+extern void GetMotionVectorPredictorMBAFF (Macroblock *currMB, PixelPos *block, MotionVector *pmv, short ref_frame,
+                                           PicMotionParams **mv_info, int list, int mb_x, int mb_y, int blockshape_x, int blockshape_y);
+extern void GetMotionVectorPredictorNormal(Macroblock *currMB, PixelPos *block, MotionVector *pmv, short ref_frame,
+                                           PicMotionParams **mv_info, int list, int mb_x, int mb_y, int blockshape_x, int blockshape_y);
 
 #endif
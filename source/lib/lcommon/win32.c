@@ -49,6 +49,67 @@ int64 timenorm(int64  cur_time)
 #endif
 }
 
+int64 gettime_ns(void)
+{
+#ifndef TIMING_DISABLE
+  LARGE_INTEGER cur_time;
+  QueryPerformanceCounter(&cur_time);
+  return (int64)((double) cur_time.QuadPart * 1e9 / (double) freq.QuadPart);
+#else
+  return 0;
+#endif
+}
+
+typedef struct thread_start
+{
+  void (*func)(void *arg);
+  void  *arg;
+} ThreadStart;
+
+static DWORD WINAPI thread_entry(LPVOID param)
+{
+  ThreadStart start = *(ThreadStart *) param;
+
+  free(param);
+  start.func(start.arg);
+  return 0;
+}
+
+int thread_create(ThreadHandle *thread, void (*func)(void *arg), void *arg)
+{
+  ThreadStart *start = (ThreadStart *) malloc(sizeof(ThreadStart));
+
+  if (start == NULL)
+    return -1;
+  start->func = func;
+  start->arg  = arg;
+  if ((*thread = CreateThread(NULL, 0, thread_entry, start, 0, NULL)) == NULL)
+  {
+    free(start);
+    return -1;
+  }
+  return 0;
+}
+
+void thread_join(ThreadHandle thread)
+{
+  WaitForSingleObject(thread, INFINITE);
+  CloseHandle(thread);
+}
+
+void mutex_init    (ThreadMutex *mutex) { InitializeCriticalSection(mutex); }
+void mutex_destroy (ThreadMutex *mutex) { DeleteCriticalSection(mutex);     }
+void mutex_lock    (ThreadMutex *mutex) { EnterCriticalSection(mutex);      }
+void mutex_unlock  (ThreadMutex *mutex) { LeaveCriticalSection(mutex);      }
+void cond_init     (ThreadCond *cond)   { InitializeConditionVariable(cond); }
+void cond_destroy  (ThreadCond *cond)   { (void) cond;                       }
+void cond_broadcast(ThreadCond *cond)   { WakeAllConditionVariable(cond);    }
+
+void cond_wait(ThreadCond *cond, ThreadMutex *mutex)
+{
+  SleepConditionVariableCS(cond, mutex, INFINITE);
+}
+
 #else
 
 static struct timezone tz;
@@ -75,4 +136,61 @@ int64 timenorm(int64 cur_time)
 {
   return cur_time / 1000;
 }
+
+int64 gettime_ns(void)
+{
+  struct timespec cur_time;
+
+  clock_gettime(CLOCK_MONOTONIC, &cur_time);
+  return (int64) cur_time.tv_sec * 1000000000 + cur_time.tv_nsec;
+}
+
+typedef struct thread_start
+{
+  void (*func)(void *arg);
+  void  *arg;
+} ThreadStart;
+
+static void *thread_entry(void *param)
+{
+  ThreadStart start = *(ThreadStart *) param;
+
+  free(param);
+  start.func(start.arg);
+  return NULL;
+}
+
+int thread_create(ThreadHandle *thread, void (*func)(void *arg), void *arg)
+{
+  ThreadStart *start = (ThreadStart *) malloc(sizeof(ThreadStart));
+
+  if (start == NULL)
+    return -1;
+  start->func = func;
+  start->arg  = arg;
+  if (pthread_create(thread, NULL, thread_entry, start) != 0)
+  {
+    free(start);
+    return -1;
+  }
+  return 0;
+}
+
+void thread_join(ThreadHandle thread)
+{
+  pthread_join(thread, NULL);
+}
+
+void mutex_init    (ThreadMutex *mutex) { pthread_mutex_init(mutex, NULL); }
+void mutex_destroy (ThreadMutex *mutex) { pthread_mutex_destroy(mutex);    }
+void mutex_lock    (ThreadMutex *mutex) { pthread_mutex_lock(mutex);       }
+void mutex_unlock  (ThreadMutex *mutex) { pthread_mutex_unlock(mutex);     }
+void cond_init     (ThreadCond *cond)   { pthread_cond_init(cond, NULL);   }
+void cond_destroy  (ThreadCond *cond)   { pthread_cond_destroy(cond);      }
+void cond_broadcast(ThreadCond *cond)   { pthread_cond_broadcast(cond);    }
+
+void cond_wait(ThreadCond *cond, ThreadMutex *mutex)
+{
+  pthread_cond_wait(cond, mutex);
+}
 #endif
@@ -98,9 +98,55 @@ typedef unsigned long long  uint64;
 # endif
 #endif
 
+// threads, mutexes and condition variables (frame threaded decoding)
+#if defined(WIN32) || defined (WIN64)
+typedef HANDLE             ThreadHandle;
+typedef CRITICAL_SECTION   ThreadMutex;
+typedef CONDITION_VARIABLE ThreadCond;
+#else
+# include <pthread.h>
+typedef pthread_t          ThreadHandle;
+typedef pthread_mutex_t    ThreadMutex;
+typedef pthread_cond_t     ThreadCond;
+#endif
+
+//! counters published by one thread and polled by others without taking a lock
+#if defined(_MSC_VER)
+# define load_acquire(p)      (*(volatile int *) (p))
+# define store_release(p, v)  (*(volatile int *) (p) = (v))
+#else
+# define load_acquire(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+# define store_release(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
+
+//! 64 bit counters shared by all threads (memory accounting) and per thread variables
+#if defined(_MSC_VER)
+# define THREAD_LOCAL              __declspec(thread)
+# define atomic_load64(p)          InterlockedCompareExchange64((volatile LONGLONG *) (p), 0, 0)
+# define atomic_add64(p, v)        (InterlockedExchangeAdd64((volatile LONGLONG *) (p), (v)) + (v))
+# define atomic_cas64(p, old, v)   (InterlockedCompareExchange64((volatile LONGLONG *) (p), (v), (old)) == (old))
+#else
+# define THREAD_LOCAL              __thread
+# define atomic_load64(p)          __atomic_load_n((p), __ATOMIC_RELAXED)
+# define atomic_add64(p, v)        __atomic_add_fetch((p), (v), __ATOMIC_RELAXED)
+# define atomic_cas64(p, old, v)   __atomic_compare_exchange_n((p), &(old), (v), 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#endif
+
+extern int   thread_create (ThreadHandle *thread, void (*func)(void *arg), void *arg);
+extern void  thread_join   (ThreadHandle thread);
+extern void  mutex_init    (ThreadMutex *mutex);
+extern void  mutex_destroy (ThreadMutex *mutex);
+extern void  mutex_lock    (ThreadMutex *mutex);
+extern void  mutex_unlock  (ThreadMutex *mutex);
+extern void  cond_init     (ThreadCond *cond);
+extern void  cond_destroy  (ThreadCond *cond);
+extern void  cond_wait     (ThreadCond *cond, ThreadMutex *mutex);
+extern void  cond_broadcast(ThreadCond *cond);
+
 extern void   gettime(TIME_T* time);
 extern void   init_time(void);
 extern int64 timediff(TIME_T* start, TIME_T* end);
 extern int64 timenorm(int64 cur_time);
+extern int64 gettime_ns(void);
 
 #endif